@@ -32,4 +32,5 @@
 
 // Cerata back-ends
 #include "cerata/vhdl/vhdl.h"
+#include "cerata/verilog/verilog.h"
 #include "cerata/dot/dot.h"
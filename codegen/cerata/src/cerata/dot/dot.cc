@@ -14,8 +14,10 @@
 
 #include "cerata/dot/dot.h"
 
+#include <deque>
 #include <sstream>
 #include <fstream>
+#include <vector>
 
 #include "cerata/logging.h"
 #include "cerata/edge.h"
@@ -29,13 +31,16 @@ namespace cerata::dot {
 
 void DOTOutputGenerator::Generate() {
   CreateDir(subdir());
-  cerata::dot::Grapher dot;
-  for (const auto &o : outputs_) {
-    if (o.comp != nullptr) {
-      CERATA_LOG(INFO, "DOT: Generating output for Graph: " + o.comp->name());
-      dot.GenFile(*o.comp, subdir() + "/" + o.comp->name() + ".dot");
-    }
-  }
+  std::vector<OutputFile> files(outputs_.size());
+  ForEachOutput([&](size_t i) {
+    const auto &o = outputs_[i];
+    CERATA_LOG(INFO, "DOT: Generating output for Graph: " + o.comp->name());
+    // Graphers keep track of the edges they've drawn, so every thread needs its own.
+    cerata::dot::Grapher dot;
+    files[i] = WriteIfChanged(subdir() + "/" + o.comp->name() + ".dot", dot.GenGraph(*o.comp));
+  });
+  manifest_ = std::deque<OutputFile>(files.begin(), files.end());
+  WriteManifest();
 }
 
 static std::string ToHex(const Node &n) {
@@ -23,7 +23,7 @@
 namespace cerata::dot {
 
 Style Style::normal() {
-  static Style ret;
+  Style ret;
 
   ret.config = Config::normal();
 
@@ -107,7 +107,7 @@ bool Config::operator()(const std::shared_ptr<Node> &node) {
 }
 
 Config Config::streams() {
-  static Config ret;
+  Config ret;
   ret.nodes.parameters = false;
   ret.nodes.literals = false;
   ret.nodes.signals = true;
@@ -123,7 +123,7 @@ Config Config::streams() {
 }
 
 Config Config::normal() {
-  static Config ret;
+  Config ret;
   ret.nodes.parameters = true;
   ret.nodes.literals = false;
   ret.nodes.signals = true;
@@ -145,7 +145,7 @@ Config Config::normal() {
 }
 
 Config Config::all() {
-  static Config ret;
+  Config ret;
 
   ret.nodes.parameters = true;
   ret.nodes.literals = true;
@@ -168,7 +168,7 @@ Config Config::all() {
 }
 
 Palette Palette::normal() {
-  static Palette ret;
+  Palette ret;
   ret.black = "#000000";
   ret.white = "#ffffff";
   ret.gray = "#A0A0A0";
@@ -18,9 +18,18 @@
 
 namespace cerata {
 
-std::shared_ptr<Expression> Expression::Make(Op op, std::shared_ptr<const Node> lhs, std::shared_ptr<const Node> rhs) {
-  auto e = new Expression(op, std::move(lhs), std::move(rhs));
-  return std::shared_ptr<Expression>(e);
+std::shared_ptr<Node> Expression::Make(Op op, std::shared_ptr<const Node> lhs, std::shared_ptr<const Node> rhs) {
+  auto e = std::shared_ptr<Expression>(new Expression(op, std::move(lhs), std::move(rhs)));
+  // The operands were minimized when they were made, so only this level of the tree needs to be folded.
+  std::shared_ptr<const Node> min = EliminateZeroOne(e.get());
+  if (min->IsExpression()) {
+    min = MergeIntLiterals(dynamic_cast<const Expression *>(min.get()));
+  }
+  if (min != e) {
+    // Minimization resulted in an operand or a literal, which are not constant outside the expression.
+    return std::const_pointer_cast<Node>(min);
+  }
+  return default_node_pool()->GetExpression(e);
 }
 
 Expression::Expression(Expression::Op op, std::shared_ptr<const Node> lhs, std::shared_ptr<const Node> rhs)
@@ -88,7 +97,11 @@ std::shared_ptr<const Node> Expression::Minimize(const Node *node) {
 
     // If minimization took place in either node, create a new expression with the minimized nodes.
     if ((min_lhs != expr->lhs_) || (min_rhs != expr->rhs_)) {
-      expr = Expression::Make(expr->operation_, min_lhs, min_rhs);
+      result = Expression::Make(expr->operation_, min_lhs, min_rhs);
+      if (!result->IsExpression()) {
+        return result;
+      }
+      expr = std::dynamic_pointer_cast<const Expression>(result);
     }
 
     // Apply zero/one elimination on the minimized expression.
@@ -133,6 +146,10 @@ std::shared_ptr<Object> Expression::Copy() const {
                           std::dynamic_pointer_cast<Node>(rhs_->Copy()));
 }
 
+std::shared_ptr<Expression> Expression::CopyUnshared() const {
+  return std::shared_ptr<Expression>(new Expression(operation_, lhs_, rhs_));
+}
+
 std::shared_ptr<Edge> Expression::AddSource(Node *source) {
   throw std::runtime_error("Cannot drive an expression node.");
 }
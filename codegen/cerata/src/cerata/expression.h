@@ -36,8 +36,14 @@ class Expression : public MultiOutputNode {
   /// Binary expression operator enum class
   enum class Op { ADD, SUB, MUL, DIV };
 
-  /// @brief Short-hand to create a smart pointer to an expression.
-  static std::shared_ptr<Expression> Make(Op op, std::shared_ptr<const Node> lhs, std::shared_ptr<const Node> rhs);
+  /**
+   * @brief Obtain a node representing an expression.
+   *
+   * The expression is minimized first, which may result in a literal or one of the operands rather than an expression.
+   * Otherwise, the expression is interned in the default node pool, such that structurally identical expressions are
+   * represented by the same node.
+   */
+  static std::shared_ptr<Node> Make(Op op, std::shared_ptr<const Node> lhs, std::shared_ptr<const Node> rhs);
 
   /// @brief Add an input to this node.
   std::shared_ptr<Edge> AddSource(Node *source) override;
@@ -45,9 +51,13 @@ class Expression : public MultiOutputNode {
   /// @brief Copy this expression.
   std::shared_ptr<Object> Copy() const override;
 
+  /// @brief Return a new expression with the same operation and operands, that is not shared through the node pool.
+  std::shared_ptr<Expression> CopyUnshared() const;
+
   /// @brief Minimize the expression and convert it to a human-readable string.
   std::string ToString() const override;
 
+  Op operation() const { return operation_; }
   const Node *lhs() const { return lhs_.get(); }
   const Node *rhs() const { return rhs_.get(); }
 
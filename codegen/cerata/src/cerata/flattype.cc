@@ -14,6 +14,8 @@
 
 #include "cerata/flattype.h"
 
+#include <atomic>
+#include <mutex>
 #include <optional>
 #include <utility>
 #include <memory>
@@ -104,10 +106,33 @@ void Flatten(std::deque<FlatType> *list,
   }
 }
 
+namespace {
+std::atomic<uint64_t> cache_generation(1);
+std::mutex flatten_mutex;
+}  // namespace
+
+void InvalidateTypeCaches() {
+  cache_generation++;
+}
+
+uint64_t type_cache_generation() {
+  return cache_generation;
+}
+
 std::deque<FlatType> Flatten(Type *type) {
-  std::deque<FlatType> result;
-  Flatten(&result, type, {}, "", false);
-  return result;
+  auto generation = type_cache_generation();
+  {
+    std::lock_guard<std::mutex> lock(flatten_mutex);
+    if ((type->flat_ != nullptr) && (type->flat_generation_ == generation)) {
+      return *type->flat_;
+    }
+  }
+  auto result = std::make_shared<std::deque<FlatType>>();
+  Flatten(result.get(), type, {}, "", false);
+  std::lock_guard<std::mutex> lock(flatten_mutex);
+  type->flat_ = result;
+  type->flat_generation_ = generation;
+  return *result;
 }
 
 std::string ToString(std::deque<FlatType> flat_type_list) {
@@ -152,7 +177,7 @@ TypeMapper::TypeMapper(Type *a, Type *b)
   // The matrix will be the identity matrix.
   if (a_ == b_) {
     for (size_t i = 0; i < fa_.size(); i++) {
-      matrix_(i, i) = 1;
+      matrix_.Set(i, i, 1);
     }
   }
 }
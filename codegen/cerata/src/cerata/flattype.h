@@ -15,6 +15,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <tuple>
 #include <optional>
 #include <utility>
@@ -85,9 +86,23 @@ void Flatten(std::deque<FlatType> *list,
              bool invert,
              bool sep = true);
 
-/// @brief Flatten and return a list of FlatTypes.
+/**
+ * @brief Flatten and return a list of FlatTypes.
+ *
+ * The result is memoized per Type, until the structure of any type changes.
+ */
 std::deque<FlatType> Flatten(Type *type);
 
+/**
+ * @brief Invalidate memoized flattened types and cached implicit type mappers.
+ *
+ * Must be called whenever the structure of a type changes, e.g. when fields are added to a Record.
+ */
+void InvalidateTypeCaches();
+
+/// @brief Return the current generation of the type caches. Cached results of older generations are invalid.
+uint64_t type_cache_generation();
+
 /// @brief Return true if some Type is contained in a list of FlatTypes, false otherwise.
 bool ContainsFlatType(const std::deque<FlatType> &flat_types_list, const Type *type);
 
@@ -98,120 +113,100 @@ int64_t IndexOfFlatType(const std::deque<FlatType> &flat_types_list, const Type
 std::string ToString(std::deque<FlatType> flat_type_list);
 
 /**
- * @brief A matrix used for TypeMapper.
+ * @brief A sparse matrix used for TypeMapper.
+ *
+ * Mapping matrices of large flattened types are mostly zero, typically with a single non-zero element per row and
+ * column. Non-zero elements are stored per row, sorted by column, as well as per column, sorted by row, like the
+ * compressed sparse row and column formats. Rows and columns are traversed in time proportional to their number of
+ * non-zero elements, rather than the dimensions of the matrix.
+ *
  * @tparam T The type of matrix elements.
  */
 template<typename T>
 class MappingMatrix {
- private:
-  std::vector<T> elements_;
-  int64_t height_;
-  int64_t width_;
-
  public:
-  MappingMatrix(int64_t height, int64_t width) : height_(height), width_(width) {
-    elements_ = std::vector<T>(height_ * width_, static_cast<T>(0));
-  }
+  /// A non-zero element, consisting of its column (in a row) or row (in a column) index and its value.
+  using Element = std::pair<int64_t, T>;
+
+  MappingMatrix(int64_t height, int64_t width) : height_(height), width_(width), rows_(height), columns_(width) {}
 
   static MappingMatrix Identity(int64_t dim) {
     MappingMatrix ret(dim, dim);
     for (int64_t i = 0; i < dim; i++) {
-      ret(i, i) = 1;
+      ret.Set(i, i, 1);
     }
+    return ret;
   }
 
-  int64_t height() { return height_; }
-  int64_t width() { return width_; }
+  int64_t height() const { return height_; }
+  int64_t width() const { return width_; }
 
-  T &get(int64_t y, int64_t x) {
-    if (y >= height_ || x >= width_) {
-      CERATA_LOG(FATAL, "Indices exceed matrix dimensions.");
+  /// @brief Return the number of non-zero elements.
+  int64_t num_nonzero() const {
+    int64_t ret = 0;
+    for (const auto &row : rows_) {
+      ret += row.size();
     }
-    return elements_[width_ * y + x];
+    return ret;
   }
 
-  const T &get(int64_t y, int64_t x) const {
-    if (y >= height_ || x >= width_) {
-      CERATA_LOG(FATAL, "Indices exceed matrix dimensions.");
-    }
-    return elements_[width_ * y + x];
+  T get(int64_t y, int64_t x) const {
+    CheckIndices(y, x);
+    const auto &row = rows_[y];
+    auto it = Find(row, x);
+    return (it != row.end()) && (it->first == x) ? it->second : static_cast<T>(0);
   }
 
-  T &operator()(int64_t y, int64_t x) {
+  T operator()(int64_t y, int64_t x) const {
     return get(y, x);
   }
 
-  const T &operator()(int64_t y, int64_t x) const {
-    return get(y, x);
+  /// @brief Set the element at row y and column x. Setting an element to zero removes it.
+  MappingMatrix &Set(int64_t y, int64_t x, T value) {
+    CheckIndices(y, x);
+    Store(&rows_[y], x, value);
+    Store(&columns_[x], y, value);
+    return *this;
   }
 
   T MaxOfColumn(int64_t x) const {
     T max = 0;
-    for (int64_t y = 0; y < height_; y++) {
-      if (get(y, x) > max) {
-        max = get(y, x);
-      }
+    for (const auto &e : columns_[x]) {
+      max = std::max(max, e.second);
     }
     return max;
   }
 
   T MaxOfRow(int64_t y) const {
     T max = 0;
-    for (int64_t x = 0; x < width_; x++) {
-      if (get(y, x) > max) {
-        max = get(y, x);
-      }
+    for (const auto &e : rows_[y]) {
+      max = std::max(max, e.second);
     }
     return max;
   }
 
   /// @brief Obtain non-zero element indices and value from column x, sorted by value.
-  std::deque<std::pair<int64_t, T>> mapping_column(int64_t x) {
-    std::deque<std::pair<int64_t, T>> ret;
-    for (int64_t y = 0; y < height_; y++) {
-      auto val = get(y, x);
-      if (val > 0) {
-        ret.emplace_back(y, val);
-      }
-    }
-    std::sort(ret.begin(), ret.end(), [](const auto &x, const auto &y) -> bool {
-      return x.second < y.second;
-    });
-    return ret;
+  std::deque<Element> mapping_column(int64_t x) const {
+    return SortedByValue(columns_[x]);
   }
 
   /// @brief Obtain non-zero element indices and value from row y, sorted by value.
-  std::deque<std::pair<int64_t, T>> mapping_row(int64_t y) {
-    using pair = std::pair<int64_t, T>;
-    std::deque<pair> ret;
-    for (int64_t x = 0; x < width_; x++) {
-      auto val = get(y, x);
-      if (val > 0) {
-        ret.emplace_back(x, val);
-      }
-    }
-    std::sort(ret.begin(), ret.end(), [](const auto &x, const auto &y) -> bool {
-      return x.second < y.second;
-    });
-    return ret;
+  std::deque<Element> mapping_row(int64_t y) const {
+    return SortedByValue(rows_[y]);
   }
 
   MappingMatrix &SetNext(int64_t y, int64_t x) {
-    get(y, x) = std::max(MaxOfColumn(x), MaxOfRow(y)) + 1;
-    return *this;
+    return Set(y, x, std::max(MaxOfColumn(x), MaxOfRow(y)) + 1);
   }
 
   MappingMatrix Transpose() const {
     MappingMatrix ret(width_, height_);
-    for (int64_t y = 0; y < height_; y++) {
-      for (int64_t x = 0; x < width_; x++) {
-        ret(x, y) = get(y, x);
-      }
-    }
+    ret.rows_ = columns_;
+    ret.columns_ = rows_;
     return ret;
   }
 
-  std::string ToString() {
+  std::string ToString() const {
     std::stringstream ret;
     for (int64_t y = 0; y < height_; y++) {
       for (int64_t x = 0; x < width_; x++) {
@@ -221,6 +216,50 @@ class MappingMatrix {
     }
     return ret.str();
   }
+
+ private:
+  void CheckIndices(int64_t y, int64_t x) const {
+    if ((y < 0) || (x < 0) || (y >= height_) || (x >= width_)) {
+      CERATA_LOG(FATAL, "Indices exceed matrix dimensions.");
+    }
+  }
+
+  /// @brief Return an iterator to the first element in a sorted row or column with an index not less than i.
+  static typename std::vector<Element>::const_iterator Find(const std::vector<Element> &list, int64_t i) {
+    return std::lower_bound(list.begin(), list.end(), i, [](const Element &e, int64_t i) { return e.first < i; });
+  }
+
+  /// @brief Insert, update or remove an element in a sorted row or column.
+  static void Store(std::vector<Element> *list, int64_t i, T value) {
+    auto it = list->begin() + (Find(*list, i) - list->cbegin());
+    if ((it != list->end()) && (it->first == i)) {
+      if (value == 0) {
+        list->erase(it);
+      } else {
+        it->second = value;
+      }
+    } else if (value != 0) {
+      list->insert(it, Element(i, value));
+    }
+  }
+
+  static std::deque<Element> SortedByValue(const std::vector<Element> &list) {
+    std::deque<Element> ret;
+    for (const auto &e : list) {
+      if (e.second > 0) {
+        ret.push_back(e);
+      }
+    }
+    std::stable_sort(ret.begin(), ret.end(), [](const Element &a, const Element &b) -> bool {
+      return a.second < b.second;
+    });
+    return ret;
+  }
+
+  int64_t height_;
+  int64_t width_;
+  std::vector<std::vector<Element>> rows_;
+  std::vector<std::vector<Element>> columns_;
 };
 
 /**
@@ -14,6 +14,7 @@
 
 #include "cerata/graph.h"
 
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <map>
@@ -21,6 +22,7 @@
 #include "cerata/utils.h"
 #include "cerata/node.h"
 #include "cerata/edge.h"
+#include "cerata/expression.h"
 #include "cerata/logging.h"
 #include "cerata/object.h"
 #include "cerata/pool.h"
@@ -42,18 +44,29 @@ static void AddParamSources(Graph *graph, const Object &obj) {
   }
 }
 
-static void AddObjectParams(Graph *comp, const Object &obj) {
-  if (obj.IsNode()) {
-    auto &node = dynamic_cast<const Node &>(obj);
-    auto params = node.type()->GetParameters();
+/// @brief Return true if a node is an expression that is owned by another graph.
+static bool IsForeignExpression(const Graph *graph, const Object &obj) {
+  return obj.IsNode() && dynamic_cast<const Node &>(obj).IsExpression() && obj.parent() && (*obj.parent() != graph);
+}
+
+static void AddObjectParams(Graph *comp, Object *obj) {
+  if (obj->IsNode()) {
+    auto node = dynamic_cast<Node *>(obj);
+    auto params = node->type()->GetParameters();
     for (const auto &p : params) {
       // Take ownership of the node and add it to the component.
       comp->AddObject(p->shared_from_this());
-      AddParamSources(comp, obj);
+      AddParamSources(comp, *obj);
+    }
+  } else if (obj->IsArray()) {
+    auto array = dynamic_cast<NodeArray *>(obj);
+    auto array_size = array->size()->shared_from_this();
+    // Expressions are interned, so the size may be shared with an array of another graph. Give the array a size of its
+    // own, such that incrementing the size of this array does not remove a node that the other graph still uses.
+    if (IsForeignExpression(comp, *array_size)) {
+      array_size = dynamic_cast<const Expression &>(*array_size).CopyUnshared();
+      array->SetSize(array_size);
     }
-  } else if (obj.IsArray()) {
-    auto &array = dynamic_cast<const NodeArray &>(obj);
-    auto array_size = array.size()->shared_from_this();
     comp->AddObject(array_size);
     AddParamSources(comp, *array_size);
   }
@@ -61,28 +74,65 @@ static void AddObjectParams(Graph *comp, const Object &obj) {
 
 Graph &Graph::AddObject(const std::shared_ptr<Object> &obj) {
   // Check for duplicates in name / ownership
-  for (const auto &o : objects_) {
-    if (o->name() == obj->name()) {
-      if (o.get() == obj.get()) {
-        CERATA_LOG(DEBUG, "Graph " + name() + " already owns object " + obj->name() + ". Skipping...");
-        return *this;
-      } else {
-        CERATA_LOG(FATAL, "Graph " + name() + " already contains an object with name " + obj->name());
-      }
+  auto existing = objects_by_name_.find(obj->name());
+  if (existing != objects_by_name_.end()) {
+    if (existing->second == obj.get()) {
+      CERATA_LOG(DEBUG, "Graph " + name() + " already owns object " + obj->name() + ". Skipping...");
+      return *this;
+    } else {
+      CERATA_LOG(FATAL, "Graph " + name() + " already contains an object with name " + obj->name());
     }
   }
   objects_.push_back(obj);
-  obj->SetParent(this);
-  AddObjectParams(this, *obj);
+  objects_by_name_[obj->name()] = obj.get();
+  if (obj->IsNode()) {
+    auto node = static_cast<Node *>(obj.get());
+    nodes_.push_back(node);
+    nodes_of_type_[static_cast<size_t>(node->node_id())].push_back(node);
+  } else if (obj->IsArray()) {
+    auto array = static_cast<NodeArray *>(obj.get());
+    arrays_.push_back(array);
+    arrays_of_type_[static_cast<size_t>(array->node_id())].push_back(array);
+  }
+  // Interned expressions may be shared by several graphs, e.g. through a type. They keep the graph that owned them first
+  // as their parent.
+  if (!IsForeignExpression(this, *obj)) {
+    obj->SetParent(this);
+  }
+  AddObjectParams(this, obj.get());
   return *this;
 }
 
+template<typename T>
+static void EraseFrom(std::deque<T *> *list, Object *obj) {
+  auto it = std::find(list->begin(), list->end(), obj);
+  if (it != list->end()) {
+    list->erase(it);
+  }
+}
+
 Graph &Graph::RemoveObject(Object *obj) {
-  for (auto o = objects_.begin(); o < objects_.end(); o++) {
-    if (o->get() == obj) {
-      objects_.erase(o);
-    }
+  auto it = std::find_if(objects_.begin(), objects_.end(), [obj](const std::shared_ptr<Object> &o) {
+    return o.get() == obj;
+  });
+  if (it == objects_.end()) {
+    return *this;
+  }
+  if (obj->IsNode()) {
+    auto node = static_cast<Node *>(obj);
+    EraseFrom(&nodes_, node);
+    EraseFrom(&nodes_of_type_[static_cast<size_t>(node->node_id())], node);
+  } else if (obj->IsArray()) {
+    auto array = static_cast<NodeArray *>(obj);
+    EraseFrom(&arrays_, array);
+    EraseFrom(&arrays_of_type_[static_cast<size_t>(array->node_id())], array);
   }
+  auto named = objects_by_name_.find(obj->name());
+  if ((named != objects_by_name_.end()) && (named->second == obj)) {
+    objects_by_name_.erase(named);
+  }
+  // Erase the owning pointer last, as it may be the last owner.
+  objects_.erase(it);
   return *this;
 }
 
@@ -142,91 +192,72 @@ std::deque<const Component *> Component::GetAllUniqueComponents() const {
   return ret;
 }
 
+std::optional<Object *> Graph::GetObject(const std::string &name) const {
+  auto it = objects_by_name_.find(name);
+  if (it == objects_by_name_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
 NodeArray *Graph::GetArray(Node::NodeID node_id, const std::string &array_name) const {
-  for (const auto &a : GetAll<NodeArray>()) {
-    if ((a->name() == array_name) && (a->node_id() == node_id)) return a;
+  auto obj = GetObject(array_name);
+  if (obj && (*obj)->IsArray()) {
+    auto array = static_cast<NodeArray *>(*obj);
+    if (array->node_id() == node_id) return array;
   }
   CERATA_LOG(FATAL, "NodeArray " + array_name + " does not exist on Graph " + this->name());
   // TODO(johanpel): use std::optional
 }
 
 std::optional<Node *>Graph::GetNode(const std::string &node_name) const {
-  for (const auto &n : GetAll<Node>()) {
-    if (n->name() == node_name) {
-      return n;
-    }
+  auto obj = GetObject(node_name);
+  if (obj && (*obj)->IsNode()) {
+    return static_cast<Node *>(*obj);
   }
   return std::nullopt;
 }
 
 Node *Graph::GetNode(Node::NodeID node_id, const std::string &node_name) const {
-  for (const auto &n : GetAll<Node>()) {
-    if (n->name() == node_name) {
-      if (n->Is(node_id)) {
-        return n;
-      }
-    }
+  auto node = GetNode(node_name);
+  if (node && (*node)->Is(node_id)) {
+    return *node;
   }
   CERATA_LOG(FATAL, "Node " + node_name + " does not exist on Graph " + this->name());
 }
 
 size_t Graph::CountNodes(Node::NodeID id) const {
-  size_t count = 0;
-  for (const auto &n : GetAll<Node>()) {
-    if (n->Is(id)) {
-      count++;
-    }
-  }
-  return count;
+  return nodes_of_type(id).size();
 }
 
 size_t Graph::CountArrays(Node::NodeID id) const {
-  size_t count = 0;
-  for (const auto &n : GetAll<NodeArray>()) {
-    if (n->node_id() == id) {
-      count++;
-    }
-  }
-  return count;
+  return arrays_of_type(id).size();
 }
 
 std::deque<Node *> Graph::GetNodesOfType(Node::NodeID id) const {
-  std::deque<Node *> result;
-  for (const auto &n : GetAll<Node>()) {
-    if (n->Is(id)) {
-      result.push_back(n);
-    }
-  }
-  return result;
+  return nodes_of_type(id);
 }
 
 std::deque<NodeArray *> Graph::GetArraysOfType(Node::NodeID id) const {
-  std::deque<NodeArray *> result;
-  auto arrays = GetAll<NodeArray>();
-  for (const auto &a : arrays) {
-    if (a->node_id() == id) {
-      result.push_back(a);
-    }
-  }
-  return result;
+  return arrays_of_type(id);
 }
 
 Port *Graph::port(const std::string &port_name) const {
-  return dynamic_cast<Port *>(GetNode(Node::NodeID::PORT, port_name));
+  return static_cast<Port *>(GetNode(Node::NodeID::PORT, port_name));
 }
 Signal *Graph::sig(const std::string &signal_name) const {
-  return dynamic_cast<Signal *>(GetNode(Node::NodeID::SIGNAL, signal_name));
+  return static_cast<Signal *>(GetNode(Node::NodeID::SIGNAL, signal_name));
 }
 Parameter *Graph::par(const std::string &signal_name) const {
-  return dynamic_cast<Parameter *>(GetNode(Node::NodeID::PARAMETER, signal_name));
+  return static_cast<Parameter *>(GetNode(Node::NodeID::PARAMETER, signal_name));
 }
 PortArray *Graph::porta(const std::string &port_name) const {
-  return dynamic_cast<PortArray *>(GetArray(Node::NodeID::PORT, port_name));
+  return static_cast<PortArray *>(GetArray(Node::NodeID::PORT, port_name));
 }
 
 std::deque<Node *> Graph::GetImplicitNodes() const {
   std::deque<Node *> result;
-  for (const auto &n : GetAll<Node>()) {
+  for (const auto &n : nodes_) {
     for (const auto &i : n->sources()) {
       if (i->src()) {
         if (!i->src()->parent()) {
@@ -242,7 +273,7 @@ std::deque<Node *> Graph::GetImplicitNodes() const {
 
 std::deque<Node *> Graph::GetNodesOfTypes(std::initializer_list<Node::NodeID> ids) const {
   std::deque<Node *> result;
-  for (const auto &n : GetAll<Node>()) {
+  for (const auto &n : nodes_) {
     for (const auto &id : ids) {
       if (n->node_id() == id) {
         result.push_back(n);
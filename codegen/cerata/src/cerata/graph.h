@@ -14,9 +14,11 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 #include <optional>
+#include <type_traits>
 #include <utility>
 #include <deque>
 #include <unordered_map>
@@ -34,6 +36,10 @@ ComponentPool *default_component_pool();
 
 /**
  * @brief A graph representing a hardware structure.
+ *
+ * Besides owning its objects in insertion order, a graph maintains an index of its objects by name and lists of its
+ * nodes and arrays per node type, such that lookups by name and iteration over objects of a specific type do not
+ * have to scan all objects. Objects must therefore not be renamed while they are owned by a graph.
  */
 class Graph : public Named {
  public:
@@ -61,18 +67,48 @@ class Graph : public Named {
   /// @brief Remove an object from the component
   virtual Graph &RemoveObject(Object *obj);
 
-  /// @brief Get all objects of a specific type.
+  /**
+   * @brief Get all objects of a specific type.
+   *
+   * For the node and array types of Cerata, the result is obtained from the per-type lists. Types derived from these
+   * are filtered through RTTI from the list of the closest Cerata type only.
+   */
   template<typename T>
   std::deque<T *> GetAll() const {
-    std::deque<T *> ret;
-    for (const auto &o : objects_) {
-      auto co = std::dynamic_pointer_cast<T>(o);
-      if (co != nullptr)
-        ret.push_back(co.get());
+    if constexpr (std::is_same_v<T, Object>) {
+      return objects();
+    } else if constexpr (std::is_same_v<T, Node>) {
+      return nodes_;
+    } else if constexpr (std::is_same_v<T, NodeArray>) {
+      return arrays_;
+    } else if constexpr (std::is_same_v<T, Port>) {
+      return CastAll<T>(nodes_of_type(Node::NodeID::PORT));
+    } else if constexpr (std::is_same_v<T, Signal>) {
+      return CastAll<T>(nodes_of_type(Node::NodeID::SIGNAL));
+    } else if constexpr (std::is_same_v<T, Parameter>) {
+      return CastAll<T>(nodes_of_type(Node::NodeID::PARAMETER));
+    } else if constexpr (std::is_same_v<T, Literal>) {
+      return CastAll<T>(nodes_of_type(Node::NodeID::LITERAL));
+    } else if constexpr (std::is_same_v<T, Expression>) {
+      return CastAll<T>(nodes_of_type(Node::NodeID::EXPRESSION));
+    } else if constexpr (std::is_same_v<T, PortArray>) {
+      return CastAll<T>(arrays_of_type(Node::NodeID::PORT));
+    } else if constexpr (std::is_base_of_v<Port, T>) {
+      return DynamicCastAll<T>(nodes_of_type(Node::NodeID::PORT));
+    } else if constexpr (std::is_base_of_v<PortArray, T>) {
+      return DynamicCastAll<T>(arrays_of_type(Node::NodeID::PORT));
+    } else if constexpr (std::is_base_of_v<Node, T>) {
+      return DynamicCastAll<T>(nodes_);
+    } else if constexpr (std::is_base_of_v<NodeArray, T>) {
+      return DynamicCastAll<T>(arrays_);
+    } else {
+      return DynamicCastAll<T>(objects());
     }
-    return ret;
   }
 
+  /// @brief Get an object by name, if it exists.
+  std::optional<Object *> GetObject(const std::string &name) const;
+
   /// @brief Get a NodeArray object of a specific type with a specific name
   NodeArray *GetArray(Node::NodeID node_id, const std::string &array_name) const;
   /// @brief Get a Node of a specific type with a specific name
@@ -86,7 +122,7 @@ class Graph : public Named {
   /// @brief Count nodes of a specific array type
   size_t CountArrays(Node::NodeID id) const;
   /// @brief Get all nodes.
-  std::deque<Node *> GetNodes() const { return GetAll<Node>(); }
+  std::deque<Node *> GetNodes() const { return nodes_; }
   /// @brief Get all nodes of a specific type.
   std::deque<Node *> GetNodesOfType(Node::NodeID id) const;
   /// @brief Get all arrays of a specific type.
@@ -112,10 +148,53 @@ class Graph : public Named {
   Graph &SetMeta(const std::string &key, std::string value);
 
  protected:
+  /// @brief Number of Node::NodeIDs.
+  static constexpr size_t NUM_NODE_IDS = static_cast<size_t>(Node::NodeID::EXPRESSION) + 1;
+
+  /// @brief Return the nodes of a specific type, in order of addition.
+  const std::deque<Node *> &nodes_of_type(Node::NodeID id) const { return nodes_of_type_[static_cast<size_t>(id)]; }
+  /// @brief Return the arrays of a specific type, in order of addition.
+  const std::deque<NodeArray *> &arrays_of_type(Node::NodeID id) const {
+    return arrays_of_type_[static_cast<size_t>(id)];
+  }
+
+  /// @brief Cast a list of objects to type T that are known to be of type T.
+  template<typename T, typename U>
+  static std::deque<T *> CastAll(const std::deque<U *> &list) {
+    std::deque<T *> ret;
+    for (const auto &o : list) {
+      ret.push_back(static_cast<T *>(o));
+    }
+    return ret;
+  }
+
+  /// @brief Return the objects in a list that are of type T.
+  template<typename T, typename U>
+  static std::deque<T *> DynamicCastAll(const std::deque<U *> &list) {
+    std::deque<T *> ret;
+    for (const auto &o : list) {
+      auto co = dynamic_cast<T *>(o);
+      if (co != nullptr) {
+        ret.push_back(co);
+      }
+    }
+    return ret;
+  }
+
   /// @brief Graph type id for convenience
   ID id_;
   /// @brief Graph objects.
   std::deque<std::shared_ptr<Object>> objects_;
+  /// @brief Graph objects by name.
+  std::unordered_map<std::string, Object *> objects_by_name_;
+  /// @brief Graph nodes, in order of addition.
+  std::deque<Node *> nodes_;
+  /// @brief Graph arrays, in order of addition.
+  std::deque<NodeArray *> arrays_;
+  /// @brief Graph nodes per Node::NodeID, in order of addition.
+  std::array<std::deque<Node *>, NUM_NODE_IDS> nodes_of_type_;
+  /// @brief Graph arrays per Node::NodeID, in order of addition.
+  std::array<std::deque<NodeArray *>, NUM_NODE_IDS> arrays_of_type_;
   /// @brief KV storage for metadata of tools or specific backend implementations
   std::unordered_map<std::string, std::string> meta_;
 };
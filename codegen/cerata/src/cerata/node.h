@@ -234,6 +234,17 @@ LITERAL_DECL_FACTORY(Int, int)
   StorageType storage_type() const { return storage_type_; }
 };
 
+// Literal template specializations for the supported storage types.
+template<> std::shared_ptr<Literal> Literal::Make(bool value);
+template<> std::shared_ptr<Literal> Literal::Make(int value);
+template<> std::shared_ptr<Literal> Literal::Make(std::string value);
+template<> bool Literal::raw_value();
+template<> int Literal::raw_value();
+template<> std::string Literal::raw_value();
+template<> bool Literal::IsRaw<bool>();
+template<> bool Literal::IsRaw<int>();
+template<> bool Literal::IsRaw<std::string>();
+
 /**
  * @brief A Signal Node.
  *
@@ -12,14 +12,69 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <memory>
+#include <thread>
+#include <vector>
 
+#include "cerata/logging.h"
 #include "cerata/graph.h"
+#include "cerata/utils.h"
 #include "cerata/output.h"
 
 namespace cerata {
 
+std::string ToString(OutputFile::Status status) {
+  switch (status) {
+    case OutputFile::Status::CREATED: return "created";
+    case OutputFile::Status::CHANGED: return "changed";
+    case OutputFile::Status::UNCHANGED: return "unchanged";
+  }
+  return "unknown";
+}
+
+uint64_t ContentHash(const std::string &contents) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (auto c : contents) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+OutputFile WriteIfChanged(const std::string &path, const std::string &contents) {
+  OutputFile result;
+  result.path = path;
+  result.hash = ContentHash(contents);
+  result.status = OutputFile::Status::CREATED;
+
+  std::ifstream existing(path, std::ios::binary);
+  if (existing.good()) {
+    std::stringstream existing_contents;
+    existing_contents << existing.rdbuf();
+    existing.close();
+    if (ContentHash(existing_contents.str()) == result.hash) {
+      result.status = OutputFile::Status::UNCHANGED;
+      return result;
+    }
+    result.status = OutputFile::Status::CHANGED;
+  }
+
+  std::ofstream out(path, std::ios::binary);
+  out << contents;
+  out.close();
+  if (!out.good()) {
+    CERATA_LOG(FATAL, "Could not write to " + path);
+  }
+  return result;
+}
+
 OutputGenerator::OutputGenerator(std::string root_dir, std::deque<OutputSpec> outputs)
     : root_dir_(std::move(root_dir)), outputs_(std::move(outputs)) {}
 
@@ -32,4 +87,66 @@ OutputGenerator &OutputGenerator::AddOutput(const OutputSpec& output) {
   return *this;
 }
 
+OutputGenerator &OutputGenerator::SetNumThreads(size_t num_threads) {
+  num_threads_ = num_threads;
+  return *this;
+}
+
+size_t OutputGenerator::num_changed() const {
+  return std::count_if(manifest_.begin(), manifest_.end(), [](const OutputFile &f) {
+    return f.status != OutputFile::Status::UNCHANGED;
+  });
+}
+
+void OutputGenerator::ForEachOutput(const std::function<void(size_t)> &func) const {
+  size_t num_threads = num_threads_ == 0 ? std::thread::hardware_concurrency() : num_threads_;
+  num_threads = std::max<size_t>(1, std::min(num_threads, outputs_.size()));
+
+  std::atomic<size_t> next(0);
+  std::exception_ptr error = nullptr;
+  std::mutex error_mutex;
+
+  auto worker = [&]() {
+    for (size_t i = next++; i < outputs_.size(); i = next++) {
+      try {
+        func(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        // Stop handing out new outputs.
+        next = outputs_.size();
+      }
+    }
+  };
+
+  if (num_threads == 1) {
+    worker();
+  } else {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back(worker);
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+  }
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void OutputGenerator::WriteManifest() {
+  std::stringstream str;
+  for (const auto &f : manifest_) {
+    str << std::hex;
+    str.width(16);
+    str.fill('0');
+    str << f.hash << std::dec << " " << ToString(f.status) << " " << f.path << "\n";
+  }
+  WriteIfChanged(subdir() + "/manifest", str.str());
+}
+
 }  // namespace cerata
@@ -15,7 +15,9 @@
 #pragma once
 
 #include <unordered_map>
+#include <cstdint>
 #include <deque>
+#include <functional>
 #include <utility>
 #include <string>
 #include <memory>
@@ -30,6 +32,32 @@ struct OutputSpec {
   std::unordered_map<std::string, std::string> meta = {};
 };
 
+/// @brief Structure to describe a file produced by an OutputGenerator.
+struct OutputFile {
+  /// @brief What happened to the file on disk.
+  enum class Status {
+    CREATED,    ///< The file did not exist and was created.
+    CHANGED,    ///< The file existed with other contents and was overwritten.
+    UNCHANGED   ///< The file existed with the same contents and was not touched.
+  };
+  std::string path;
+  uint64_t hash = 0;
+  Status status = Status::UNCHANGED;
+};
+
+/// @brief Return a human-readable string of an OutputFile status.
+std::string ToString(OutputFile::Status status);
+
+/// @brief Return the 64-bit FNV-1a hash of some file contents.
+uint64_t ContentHash(const std::string &contents);
+
+/**
+ * @brief Write a file only if its contents differ from what is on disk.
+ *
+ * Leaving unchanged files untouched preserves their modification time, such that downstream tools do not rebuild them.
+ */
+OutputFile WriteIfChanged(const std::string &path, const std::string &contents);
+
 /**
  * @brief Abstract class to generate language specific output from Graphs
  */
@@ -40,15 +68,37 @@ class OutputGenerator {
   /// @brief Add a graph to the list of graphs to generate output for.
   OutputGenerator &AddOutput(const OutputSpec &output);
 
+  /// @brief Set the number of threads used to generate outputs. Zero selects the number of hardware threads.
+  OutputGenerator &SetNumThreads(size_t num_threads);
+
   /// @brief Start the output generation.
   virtual void Generate() = 0;
 
   /// @brief Return the subdirectory this OutputGenerator will generate into.
   virtual std::string subdir() = 0;
 
+  /// @brief Return the files produced by the last call to Generate(), in the order of the outputs.
+  const std::deque<OutputFile> &manifest() const { return manifest_; }
+
+  /// @brief Return the number of files that were created or changed by the last call to Generate().
+  size_t num_changed() const;
+
  protected:
+  /**
+   * @brief Call a function for every output, on a pool of threads.
+   *
+   * The function is called with the index of the output. If any call throws, the first exception is rethrown after all
+   * threads have finished.
+   */
+  void ForEachOutput(const std::function<void(size_t)> &func) const;
+
+  /// @brief Write the manifest to a file named "manifest" in the subdirectory.
+  void WriteManifest();
+
   std::string root_dir_;
   std::deque<OutputSpec> outputs_;
+  std::deque<OutputFile> manifest_;
+  size_t num_threads_ = 0;
 };
 
 }  // namespace cerata
@@ -12,11 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <functional>
 #include <vector>
 #include <memory>
 
 #include "cerata/pool.h"
 #include "cerata/node.h"
+#include "cerata/expression.h"
 #include "cerata/graph.h"
 
 namespace cerata {
@@ -70,11 +72,40 @@ void ComponentPool::Clear() {
 }
 
 void NodePool::Add(const std::shared_ptr<Node> &node) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   nodes_.push_back(node);
 }
 
 void NodePool::Clear() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   nodes_.clear();
+  int_literals_.clear();
+  bool_literals_.clear();
+  string_literals_.clear();
+  expressions_.clear();
+}
+
+static size_t HashExpression(const Expression &expression) {
+  size_t h = std::hash<int>()(static_cast<int>(expression.operation()));
+  h = h * 31 + std::hash<const Node *>()(expression.lhs());
+  h = h * 31 + std::hash<const Node *>()(expression.rhs());
+  return h;
+}
+
+std::shared_ptr<Expression> NodePool::GetExpression(const std::shared_ptr<Expression> &expression) {
+  auto hash = HashExpression(*expression);
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto range = expressions_.equal_range(hash);
+  for (auto e = range.first; e != range.second; e++) {
+    if ((e->second->operation() == expression->operation())
+        && (e->second->lhs() == expression->lhs())
+        && (e->second->rhs() == expression->rhs())) {
+      return e->second;
+    }
+  }
+  Add(expression);
+  expressions_.emplace(hash, expression);
+  return expression;
 }
 
 }  // namespace cerata
@@ -17,7 +17,10 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <utility>
+#include <type_traits>
+#include <unordered_map>
 
 #include "cerata/node.h"
 
@@ -27,6 +30,7 @@ namespace cerata {
 class Component;
 class Node;
 class Literal;
+class Expression;
 class Type;
 
 /**
@@ -65,33 +69,61 @@ inline ComponentPool *default_component_pool() {
   return &pool;
 }
 
+/**
+ * @brief A node pool to keep nodes that are not owned by a graph.
+ *
+ * Literals and expressions are interned; requesting a literal with the same value or an expression with the same
+ * operation and operands twice results in the same node. The pool may be used from multiple threads concurrently.
+ */
 class NodePool {
  public:
   void Add(const std::shared_ptr<Node> &node);
   void Clear();
 
+  /// @brief Return the literal node holding some value, creating it if it doesn't exist yet.
   template<typename T>
   std::shared_ptr<Literal> GetLiteral(T value) {
-    // Attempt to find and return an already existing literal
-    for (const auto &node : nodes_) {
-      if (node->IsLiteral()) {
-        auto lit_node = std::dynamic_pointer_cast<Literal>(node);
-        if (lit_node->IsRaw<T>()) {
-          T raw_value = lit_node->raw_value<T>();
-          if (raw_value == value) {
-            return lit_node;
-          }
-        }
-      }
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto literals = GetLiteralMap<T>();
+    auto existing = literals->find(value);
+    if (existing != literals->end()) {
+      return existing->second;
     }
     // No literal found, make a new one.
     std::shared_ptr<Literal> ret = Literal::Make<T>(value);
     Add(ret);
+    (*literals)[value] = ret;
     return ret;
   }
 
+  /**
+   * @brief Return an expression with the same operation and operands as some expression.
+   *
+   * If the pool already holds such an expression, it is returned. Otherwise, the expression is added to the pool.
+   * Operands are compared by identity, so expressions are structurally identical if their operands are interned too.
+   */
+  std::shared_ptr<Expression> GetExpression(const std::shared_ptr<Expression> &expression);
+
  protected:
+  template<typename T>
+  std::unordered_map<T, std::shared_ptr<Literal>> *GetLiteralMap() {
+    if constexpr (std::is_same_v<T, int>) {
+      return &int_literals_;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return &bool_literals_;
+    } else {
+      static_assert(std::is_same_v<T, std::string>, "Literal storage type not supported.");
+      return &string_literals_;
+    }
+  }
+
+  std::recursive_mutex mutex_;
   std::vector<std::shared_ptr<Node>> nodes_;
+  std::unordered_map<int, std::shared_ptr<Literal>> int_literals_;
+  std::unordered_map<bool, std::shared_ptr<Literal>> bool_literals_;
+  std::unordered_map<std::string, std::shared_ptr<Literal>> string_literals_;
+  /// Interned expressions by hash of their operation and operands.
+  std::unordered_multimap<size_t, std::shared_ptr<Expression>> expressions_;
 };
 
 /**
@@ -14,6 +14,7 @@
 
 #include "cerata/type.h"
 
+#include <mutex>
 #include <utility>
 #include <string>
 #include <iostream>
@@ -137,22 +138,47 @@ std::optional<std::shared_ptr<TypeMapper>> Type::GetMapper(Type *other) {
       return m;
     }
   }
-  // Implicit type mappers maybe be generated in two cases:
+  // Otherwise, an implicit type mapper may exist.
+  auto implicit = GetImplicitMapper(other);
+  if (implicit != nullptr) {
+    return implicit;
+  }
+  // There is no mapper
+  return {};
+}
+
+namespace {
+std::mutex implicit_mappers_mutex;
+}  // namespace
 
-  // If it's exactly the same type object,
-  // TODO(johanpel): clarify previous comment
+std::shared_ptr<TypeMapper> Type::GetImplicitMapper(Type *other) {
+  auto generation = type_cache_generation();
+  {
+    std::lock_guard<std::mutex> lock(implicit_mappers_mutex);
+    auto cached = implicit_mappers_.find(other);
+    if ((cached != implicit_mappers_.end()) && (cached->second.generation == generation)
+        && (cached->second.other.lock().get() == other)) {
+      return cached->second.mapper;
+    }
+  }
+
+  // Implicit type mappers maybe be generated in two cases:
+  std::shared_ptr<TypeMapper> mapper;
   if (other == this) {
-    // Generate a type mapper to itself using the TypeMapper constructor.
-    return TypeMapper::Make(this);
+    // If it's exactly the same type object, generate a type mapper to itself using the TypeMapper constructor.
+    mapper = TypeMapper::Make(this);
+  } else if (IsEqual(*other)) {
+    // Or if its an "equal" type, where each flattened type is equal, generate an implicit type mapping.
+    mapper = TypeMapper::MakeImplicit(this, other);
   }
 
-  // Or if its an "equal" type, where each flattened type is equal.
-  if (IsEqual(*other)) {
-    // Generate an implicit type mapping.
-    return TypeMapper::MakeImplicit(this, other);
+  // Types that are not owned by a shared pointer cannot be tracked, and their mappers are not cached.
+  auto other_ptr = other->weak_from_this();
+  if (!other_ptr.expired()) {
+    std::lock_guard<std::mutex> lock(implicit_mappers_mutex);
+    implicit_mappers_[other] = {other_ptr, generation, mapper};
   }
-  // There is no mapper
-  return {};
+  return mapper;
 }
 
 int Type::RemoveMappersTo(Type *other) {
@@ -358,6 +384,7 @@ std::shared_ptr<Record> Record::Make(const std::string &name, std::deque<std::sh
 
 Record &Record::AddField(const std::shared_ptr<RecField> &field) {
   fields_.push_back(field);
+  InvalidateTypeCaches();
   return *this;
 }
 
@@ -402,6 +429,7 @@ void Stream::SetElementType(std::shared_ptr<Type> type) {
   mappers_ = {};
   // Set the new element type
   element_type_ = std::move(type);
+  InvalidateTypeCaches();
 }
 
 bool Record::IsEqual(const Type &other) const {
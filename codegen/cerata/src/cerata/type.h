@@ -122,6 +122,29 @@ class Type : public Named, public std::enable_shared_from_this<Type> {
  protected:
   ID id_;
   std::deque<std::shared_ptr<TypeMapper>> mappers_;
+
+ private:
+  friend std::deque<FlatType> Flatten(Type *type);
+
+  /// @brief A cached implicit type mapper, or the absence thereof, to some other type.
+  struct ImplicitMapper {
+    /// The other type, to detect when the other type was destroyed and its address was reused.
+    std::weak_ptr<Type> other;
+    /// The type cache generation in which the mapper was obtained.
+    uint64_t generation = 0;
+    /// The mapper, or nullptr if the types cannot be mapped implicitly.
+    std::shared_ptr<TypeMapper> mapper;
+  };
+
+  /// @brief Return an implicit mapper to another type, or nullptr if there is none. Results are cached.
+  std::shared_ptr<TypeMapper> GetImplicitMapper(Type *other);
+
+  /// Memoized result of Flatten.
+  std::shared_ptr<const std::deque<FlatType>> flat_;
+  /// The type cache generation in which flat_ was obtained.
+  uint64_t flat_generation_ = 0;
+  /// Cached implicit mappers to other types.
+  std::unordered_map<const Type *, ImplicitMapper> implicit_mappers_;
 };
 
 /**
@@ -286,8 +309,14 @@ class RecField : public Named {
   bool invert() const { return invert_; }
   /// @brief Return true if in name generation of this field name for flattened types a separator should be placed.
   bool sep() const { return sep_; }
-  void NoSep() { sep_ = false; }
-  void UseSep() { sep_ = true; }
+  void NoSep() {
+    sep_ = false;
+    InvalidateTypeCaches();
+  }
+  void UseSep() {
+    sep_ = true;
+    InvalidateTypeCaches();
+  }
   /// @brief Metadata for back-end implementations
   std::unordered_map<std::string, std::string> meta;
  private:
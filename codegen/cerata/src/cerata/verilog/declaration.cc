@@ -0,0 +1,187 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cerata/verilog/declaration.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "cerata/node.h"
+#include "cerata/expression.h"
+#include "cerata/type.h"
+#include "cerata/graph.h"
+#include "cerata/vhdl/vhdl.h"
+#include "cerata/vhdl/vhdl_types.h"
+
+namespace cerata::verilog {
+
+std::string ToVerilog(const Literal &lit) {
+  switch (lit.type()->id()) {
+    default:return lit.ToString();
+    case Type::STRING:return "\"" + lit.ToString() + "\"";
+    case Type::BOOLEAN:return lit.BoolValue() ? "1'b1" : "1'b0";
+  }
+}
+
+std::string ValueOf(const Parameter &par) {
+  auto value = par.GetValue();
+  if (!value) {
+    return "";
+  }
+  const Node *val = value.value();
+  if (val->IsLiteral()) {
+    return ToVerilog(dynamic_cast<const Literal &>(*val));
+  }
+  return val->ToString();
+}
+
+static std::string ToString(Term::Dir dir) {
+  return dir == Term::IN ? "input" : "output";
+}
+
+/// @brief Return whether a node should be declared as a vector, even if its type is a single bit.
+static bool IsForcedVector(const Node &node) {
+  return node.type()->meta.count(vhdl::metakeys::FORCE_VECTOR) > 0;
+}
+
+std::string Decl::Generate(const Type &type, const std::optional<std::shared_ptr<Node>> &multiplier, bool vector) {
+  switch (type.id()) {
+    default: {
+      if (multiplier) {
+        return "[" + (*multiplier - 1)->ToString() + ":0] ";
+      } else if (vector) {
+        return "[0:0] ";
+      } else {
+        return "";
+      }
+    }
+    case Type::VECTOR: {
+      auto &vec = dynamic_cast<const Vector &>(type);
+      auto width = vec.width();
+      if (!width) {
+        CERATA_LOG(FATAL, "Vector type " + type.name() + " has no width.");
+      }
+      if (!multiplier) {
+        return "[" + (*width.value() - 1)->ToString() + ":0] ";
+      } else {
+        return "[" + (*multiplier * width.value() - 1)->ToString() + ":0] ";
+      }
+    }
+    case Type::INTEGER:
+    case Type::NATURAL: {
+      if (!multiplier) {
+        return "[31:0] ";
+      } else {
+        return "[" + (*multiplier * 32 - 1)->ToString() + ":0] ";
+      }
+    }
+  }
+}
+
+Block Decl::Generate(const Parameter &par, int depth) {
+  Block ret(depth);
+  Line l;
+  l << "parameter " << par.name();
+  auto value = ValueOf(par);
+  if (!value.empty()) {
+    l << " = " + value;
+  }
+  ret << l;
+  return ret;
+}
+
+Block Decl::Generate(const Port &port, int depth) {
+  Block ret(depth);
+  // Filter out abstract types and flatten
+  auto flat_types = vhdl::FilterForVHDL(Flatten(port.type()));
+  for (const auto &ft : flat_types) {
+    Line l;
+    l << ToString(ft.invert_ ? Term::Invert(port.dir()) : port.dir()) + " ";
+    l << "wire " + Generate(*ft.type_, std::nullopt, IsForcedVector(port));
+    l << ft.name(NamePart(port.name(), true));
+    ret << l;
+  }
+  return ret;
+}
+
+Block Decl::Generate(const PortArray &port, int depth) {
+  Block ret(depth);
+  auto flat_types = vhdl::FilterForVHDL(Flatten(port.type()));
+  for (const auto &ft : flat_types) {
+    Line l;
+    l << ToString(ft.invert_ ? Term::Invert(port.dir()) : port.dir()) + " ";
+    l << "wire " + Generate(*ft.type_, std::dynamic_pointer_cast<Node>(port.size()->Copy()));
+    l << ft.name(NamePart(port.name(), true));
+    ret << l;
+  }
+  return ret;
+}
+
+Block Decl::Generate(const Signal &sig, int depth) {
+  Block ret(depth);
+  auto flat_types = vhdl::FilterForVHDL(Flatten(sig.type()));
+  for (const auto &ft : flat_types) {
+    Line l;
+    l << "wire " + Generate(*ft.type_, std::nullopt, IsForcedVector(sig));
+    l << ft.name(NamePart(sig.name(), true)) + ";";
+    ret << l;
+  }
+  return ret;
+}
+
+MultiBlock Decl::Generate(const Component &comp) {
+  MultiBlock ret;
+
+  auto parameters = comp.GetAll<Parameter>();
+  auto ports = comp.GetAll<Port>();
+  auto array_ports = comp.GetAll<PortArray>();
+
+  Line hl;
+  hl << "module " + comp.name();
+  if (!parameters.empty()) {
+    hl += " #(";
+    ret << hl;
+    Block pd(1);
+    for (const auto &par : parameters) {
+      pd << Generate(*par);
+    }
+    pd <<= ",";
+    ret << pd;
+    Line pf;
+    pf << ") (";
+    ret << pf;
+  } else {
+    hl += " (";
+    ret << hl;
+  }
+
+  Block pd(1);
+  for (const auto &port : ports) {
+    pd << Generate(*port);
+  }
+  for (const auto &array_port : array_ports) {
+    pd << Generate(*array_port);
+  }
+  pd <<= ",";
+  ret << pd;
+
+  Line fl;
+  fl << ");";
+  ret << fl;
+
+  return ret;
+}
+
+}  // namespace cerata::verilog
@@ -0,0 +1,59 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "cerata/node.h"
+#include "cerata/type.h"
+#include "cerata/graph.h"
+
+#include "cerata/vhdl/block.h"
+
+namespace cerata::verilog {
+
+// The Verilog back-end uses the same source formatting structures as the VHDL back-end.
+using vhdl::Line;
+using vhdl::Block;
+using vhdl::MultiBlock;
+
+/// @brief Return a literal as a Verilog constant.
+std::string ToVerilog(const Literal &lit);
+
+/// @brief Return the value of a parameter as a Verilog expression.
+std::string ValueOf(const Parameter &par);
+
+struct Decl {
+  /**
+   * @brief Generate the packed range of a type, e.g. "[7:0] ".
+   * @param type        The type.
+   * @param multiplier  Number of elements, for port arrays.
+   * @param vector      Whether to declare a single bit as a vector.
+   * @return            The range, or an empty string for single bits.
+   */
+  static std::string Generate(const Type &type,
+                              const std::optional<std::shared_ptr<Node>> &multiplier = std::nullopt,
+                              bool vector = false);
+  static Block Generate(const Parameter &par, int depth = 0);
+  static Block Generate(const Port &port, int depth = 0);
+  static Block Generate(const PortArray &port, int depth = 0);
+  static Block Generate(const Signal &sig, int depth = 0);
+  /// @brief Generate the module header of a component.
+  static MultiBlock Generate(const Component &comp);
+};
+
+}  // namespace cerata::verilog
@@ -0,0 +1,66 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cerata/verilog/design.h"
+
+#include <memory>
+#include <string>
+
+#include "cerata/logging.h"
+#include "cerata/graph.h"
+#include "cerata/vhdl/resolve.h"
+#include "cerata/verilog/declaration.h"
+#include "cerata/verilog/instantiation.h"
+
+namespace cerata::verilog {
+
+void Design::Transform() {
+  if (transformed_) {
+    return;
+  }
+  CERATA_LOG(DEBUG, "Verilog: Transforming Cerata graph to Verilog-compatible.");
+  vhdl::Resolve::ResolvePortToPort(component_.get());
+  vhdl::Resolve::ExpandStreams(component_.get());
+  transformed_ = true;
+}
+
+MultiBlock Design::Generate() {
+  MultiBlock ret;
+
+  Transform();
+
+  if (!notice_.empty()) {
+    ret << Line(notice_);
+  }
+
+  ret << Decl::Generate(*component_);
+
+  // Net declarations
+  for (const auto &s : component_->GetAll<Signal>()) {
+    ret << Decl::Generate(*s, 1);
+  }
+
+  // Module instantiations
+  for (const auto &i : component_->children()) {
+    ret << Inst::Generate(*i);
+  }
+
+  Line footer;
+  footer << "endmodule";
+  ret << footer;
+
+  return ret;
+}
+
+}  // namespace cerata::verilog
@@ -0,0 +1,50 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "cerata/graph.h"
+#include "cerata/verilog/declaration.h"
+
+namespace cerata::verilog {
+
+struct Design {
+  std::shared_ptr<Component> component_;
+  std::string notice_;
+
+  Design() = default;
+  explicit Design(std::shared_ptr<Component> component, std::string notice = "")
+      : component_(std::move(component)), notice_(std::move(notice)) {}
+
+  /**
+   * @brief Resolve Verilog-specific problems in the component graph.
+   *
+   * Verilog has the same restrictions on port-to-port connections and abstract streams as VHDL, so this applies the
+   * VHDL transformations. Like those, it modifies the component and the types it uses, so it is not safe to transform
+   * multiple designs concurrently.
+   */
+  void Transform();
+
+  /// @brief Generate the Verilog source of the design. Transforms the design first if that didn't happen yet.
+  MultiBlock Generate();
+
+ private:
+  bool transformed_ = false;
+};
+
+}  // namespace cerata::verilog
@@ -0,0 +1,236 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cerata/verilog/instantiation.h"
+
+#include <algorithm>
+#include <deque>
+#include <string>
+
+#include "cerata/logging.h"
+#include "cerata/edge.h"
+#include "cerata/node.h"
+#include "cerata/expression.h"
+#include "cerata/node_array.h"
+#include "cerata/type.h"
+#include "cerata/graph.h"
+#include "cerata/vhdl/vhdl.h"
+
+namespace cerata::verilog {
+
+void PortConnections::Connect(const std::string &port, const std::string &net) {
+  auto it = index_.find(port);
+  if (it == index_.end()) {
+    index_[port] = connections_.size();
+    connections_.emplace_back(port, std::vector<std::string>({net}));
+  } else {
+    CERATA_LOG(FATAL, "Port " + port + " is connected to both " + connections_[it->second].second.front() + " and "
+        + net);
+  }
+}
+
+void PortConnections::Append(const std::string &port, const std::string &net) {
+  auto it = index_.find(port);
+  if (it == index_.end()) {
+    index_[port] = connections_.size();
+    connections_.emplace_back(port, std::vector<std::string>({net}));
+  } else {
+    connections_[it->second].second.push_back(net);
+  }
+}
+
+Block PortConnections::Generate() const {
+  Block ret;
+  for (const auto &c : connections_) {
+    Line l;
+    l << "." + c.first;
+    const auto &nets = c.second;
+    if (nets.size() == 1) {
+      l << "(" + nets.front() + ")";
+    } else {
+      // The most significant slice comes first in a concatenation.
+      std::string concat = "({";
+      for (auto n = nets.rbegin(); n != nets.rend(); n++) {
+        if (n != nets.rbegin()) {
+          concat += ", ";
+        }
+        concat += *n;
+      }
+      l << concat + "})";
+    }
+    ret << l;
+  }
+  return ret;
+}
+
+static bool IsInputTerminator(const Object &obj) {
+  auto term = dynamic_cast<const Term *>(&obj);
+  return (term != nullptr) && (term->dir() == Term::IN);
+}
+
+static std::string Slice(const FlatType &ft,
+                         const std::shared_ptr<Node> &offset,
+                         const std::shared_ptr<Node> &next_offset) {
+  if (ft.type_->Is(Type::BIT)) {
+    return "[" + offset->ToString() + "]";
+  } else {
+    return "[" + (next_offset - 1)->ToString() + ":" + offset->ToString() + "]";
+  }
+}
+
+void Inst::GenerateMappingPair(const MappingPair &p,
+                               size_t ia,
+                               size_t ib,
+                               const std::shared_ptr<Node> &offset_b,
+                               const std::string &lh_prefix,
+                               const std::string &rh_prefix,
+                               bool a_is_array,
+                               bool b_is_array,
+                               PortConnections *connections) {
+  // Don't output anything for abstract stream and record types.
+  if (p.flat_type_a(0).type_->Is(Type::STREAM) || p.flat_type_a(0).type_->Is(Type::RECORD)) {
+    return;
+  }
+
+  auto a_width = p.flat_type_a(ia).type_->width();
+  auto next_offset_b = (offset_b + (a_width ? a_width.value() : rintl(0)));
+
+  auto port = p.flat_type_a(ia).name(NamePart(lh_prefix, true));
+  auto net = p.flat_type_b(ib).name(NamePart(rh_prefix, true));
+  if ((p.num_a() > 1) || b_is_array) {
+    net += Slice(p.flat_type_b(ib), offset_b, next_offset_b);
+  }
+
+  // If the right side is concatenated onto the left side, or the left side is an array, the net is a slice of the port.
+  if ((p.num_b() > 1) || a_is_array) {
+    connections->Append(port, net);
+  } else {
+    connections->Connect(port, net);
+  }
+}
+
+void Inst::GeneratePortMappingPair(std::deque<MappingPair> pairs,
+                                   const Node &a,
+                                   const Node &b,
+                                   PortConnections *connections) {
+  // Sort the pair in order of appearance on the flatmap
+  std::sort(pairs.begin(), pairs.end(), [](const MappingPair &x, const MappingPair &y) -> bool {
+    return x.index_a(0) < y.index_a(0);
+  });
+  bool a_array = false;
+  bool b_array = false;
+  size_t b_idx = 0;
+  // Figure out if these nodes are on NodeArrays and what their index is
+  if (a.array()) {
+    a_array = true;
+  }
+  if (b.array()) {
+    b_array = true;
+    b_idx = b.array().value()->IndexOf(b);
+  }
+  if (a.type()->meta.count(vhdl::metakeys::FORCE_VECTOR) > 0) {
+    a_array = true;
+  }
+  if (b.type()->meta.count(vhdl::metakeys::FORCE_VECTOR) > 0) {
+    b_array = true;
+  }
+  for (const auto &pair : pairs) {
+    std::shared_ptr<Node> b_offset = pair.width_a(intl(1)) * intl(b_idx);
+    for (int64_t ia = 0; ia < pair.num_a(); ia++) {
+      auto a_width = pair.flat_type_a(ia).type_->width();
+      for (int64_t ib = 0; ib < pair.num_b(); ib++) {
+        GenerateMappingPair(pair, ia, ib, b_offset, a.name(), b.name(), a_array, b_array, connections);
+      }
+      b_offset = b_offset + (a_width ? a_width.value() : rintl(1));
+    }
+  }
+}
+
+void Inst::GeneratePortMaps(const Port &port, PortConnections *connections) {
+  auto edges = IsInputTerminator(port) ? port.sources() : port.sinks();
+  for (const auto &edge : edges) {
+    auto other = *edge->GetOtherNode(port);
+    auto type_mapper = port.type()->GetMapper(other->type());
+    if (!type_mapper) {
+      CERATA_LOG(FATAL, "No type mapping available for: Port[" + port.name() + ": " + port.type()->name()
+          + "] to Other[" + other->name() + " : " + other->type()->name() + "]");
+    }
+    GeneratePortMappingPair((*type_mapper)->GetUniqueMappingPairs(), port, *other, connections);
+  }
+}
+
+void Inst::GeneratePortArrayMaps(const PortArray &port_array, PortConnections *connections) {
+  // The nodes are visited in order of their index, such that slices of the array port are concatenated in order.
+  for (const auto &node : port_array.nodes()) {
+    if (!node->IsPort()) {
+      CERATA_LOG(FATAL, "Port Array contains non-port node.");
+    }
+    GeneratePortMaps(dynamic_cast<const Port &>(*node), connections);
+  }
+}
+
+MultiBlock Inst::Generate(const Graph &graph) {
+  MultiBlock ret(1);
+
+  if (!graph.IsInstance()) {
+    return ret;
+  }
+  auto &inst = dynamic_cast<const Instance &>(graph);
+
+  Line ih;
+  ih << inst.component()->name();
+
+  // Parameter overrides
+  auto parameters = inst.GetAll<Parameter>();
+  if (!parameters.empty()) {
+    ih += " #(";
+    ret << ih;
+    Block pb(ret.indent + 1);
+    for (const auto &par : parameters) {
+      Line l;
+      l << "." + par->name();
+      l << "(" + ValueOf(*par) + ")";
+      pb << l;
+    }
+    pb <<= ",";
+    ret << pb;
+    Line pf;
+    pf << ") " + inst.name() + " (";
+    ret << pf;
+  } else {
+    ih += " " + inst.name() + " (";
+    ret << ih;
+  }
+
+  // Port connections
+  PortConnections connections;
+  for (const auto &p : inst.GetAll<Port>()) {
+    GeneratePortMaps(*p, &connections);
+  }
+  for (const auto &a : inst.GetAll<PortArray>()) {
+    GeneratePortArrayMaps(*a, &connections);
+  }
+  auto cb = connections.Generate();
+  cb.indent = ret.indent + 1;
+  cb <<= ",";
+  ret << cb;
+
+  Line f;
+  f << ");";
+  ret << f;
+
+  return ret;
+}
+
+}  // namespace cerata::verilog
@@ -0,0 +1,71 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cerata/node.h"
+#include "cerata/type.h"
+#include "cerata/graph.h"
+
+#include "cerata/verilog/declaration.h"
+
+namespace cerata::verilog {
+
+/**
+ * @brief The actual nets connected to every port of an instance.
+ *
+ * Verilog does not allow slices of a port to be connected separately, like VHDL does. When multiple nets are mapped
+ * onto one port, they are concatenated, with the first mapped net in the least significant bits.
+ */
+class PortConnections {
+ public:
+  /// @brief Connect a net to a whole port.
+  void Connect(const std::string &port, const std::string &net);
+  /// @brief Connect a net to the next slice of a port.
+  void Append(const std::string &port, const std::string &net);
+  /// @brief Generate the port connections.
+  Block Generate() const;
+
+ private:
+  std::vector<std::pair<std::string, std::vector<std::string>>> connections_;
+  std::unordered_map<std::string, size_t> index_;
+};
+
+struct Inst {
+  static void GenerateMappingPair(const MappingPair &p,
+                                  size_t ia,
+                                  size_t ib,
+                                  const std::shared_ptr<Node> &offset_b,
+                                  const std::string &lh_prefix,
+                                  const std::string &rh_prefix,
+                                  bool a_is_array,
+                                  bool b_is_array,
+                                  PortConnections *connections);
+  static void GeneratePortMappingPair(std::deque<MappingPair> pairs,
+                                      const Node &a,
+                                      const Node &b,
+                                      PortConnections *connections);
+  static void GeneratePortMaps(const Port &port, PortConnections *connections);
+  static void GeneratePortArrayMaps(const PortArray &array, PortConnections *connections);
+  static MultiBlock Generate(const Graph &graph);
+};
+
+}  // namespace cerata::verilog
@@ -0,0 +1,61 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cerata/verilog/verilog.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "cerata/logging.h"
+#include "cerata/graph.h"
+#include "cerata/utils.h"
+
+namespace cerata::verilog {
+
+void VerilogOutputGenerator::Generate() {
+  // Make sure the subdirectory exists.
+  CreateDir(subdir());
+
+  // Transformations may modify types shared between components, so they are applied to all designs up front.
+  std::vector<Design> designs;
+  for (const auto &o : outputs_) {
+    CERATA_LOG(INFO, "Verilog: Transforming Component " + o.comp->name() + " to Verilog-compatible version.");
+    designs.emplace_back(o.comp, notice_);
+    designs.back().Transform();
+  }
+
+  std::vector<OutputFile> files(outputs_.size());
+  ForEachOutput([&](size_t i) {
+    const auto &o = outputs_[i];
+    CERATA_LOG(INFO, "Verilog: Generating sources for component " + o.comp->name());
+    auto source = designs[i].Generate().ToString();
+    auto path = subdir() + "/" + o.comp->name() + ".v";
+
+    bool overwrite = (o.meta.count(metakeys::OVERWRITE_FILE) > 0) && (o.meta.at(metakeys::OVERWRITE_FILE) == "true");
+    if (FileExists(path) && !overwrite) {
+      CERATA_LOG(INFO, "Verilog: File exists, saving to " + path + "t");
+      path += "t";
+    }
+    files[i] = WriteIfChanged(path, source);
+    CERATA_LOG(INFO, "Verilog: Design saved to " + path + " (" + ToString(files[i].status) + ")");
+  });
+
+  manifest_ = std::deque<OutputFile>(files.begin(), files.end());
+  WriteManifest();
+  CERATA_LOG(INFO, "Verilog: Generated output for " + std::to_string(outputs_.size()) + " graphs, "
+      + std::to_string(num_changed()) + " files changed.");
+}
+
+}  // namespace cerata::verilog
@@ -0,0 +1,55 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <utility>
+
+#include "cerata/verilog/declaration.h"
+#include "cerata/verilog/design.h"
+#include "cerata/verilog/instantiation.h"
+
+#include "cerata/output.h"
+#include "cerata/logging.h"
+
+namespace cerata::verilog {
+
+constexpr char DEFAULT_SUBDIR[] = "verilog";
+
+// Metadata that this back-end understands
+namespace metakeys {
+  /// Forces overwriting of generated files.
+  constexpr char OVERWRITE_FILE[] = "overwrite";
+}  // namespace metakeys
+
+/**
+ * @brief Generates Verilog modules from components.
+ *
+ * The output is plain Verilog-2005 that can be compiled by Verilator. Components that are primitive to the VHDL
+ * back-end are instantiated by name, so a Verilog implementation of them must be supplied to the simulator.
+ */
+class VerilogOutputGenerator : public OutputGenerator {
+ public:
+  std::string notice_;
+  explicit VerilogOutputGenerator(std::string root_dir,
+                                  std::deque<OutputSpec> outputs = {},
+                                  std::string notice = "")
+      : OutputGenerator(std::move(root_dir), std::move(outputs)), notice_(std::move(notice)) {}
+  void Generate() override;
+  std::string subdir() override { return DEFAULT_SUBDIR; }
+};
+
+}  // namespace cerata::verilog
@@ -16,7 +16,6 @@
 
 #include <iostream>
 #include <sstream>
-#include <regex>
 #include <string>
 
 namespace cerata::vhdl {
@@ -72,7 +71,9 @@ std::string Block::str() const {
       }
     }
     // strip trailing whitespace
-    ret << std::regex_replace(m.str(), std::regex("\\s+$"), std::string("")) + "\n";
+    auto line = m.str();
+    line.erase(line.find_last_not_of(" \t\n\v\f\r") + 1);
+    ret << line + "\n";
   }
   return ret.str();
 }
@@ -28,9 +28,10 @@
 
 namespace cerata::vhdl {
 
-MultiBlock Design::Generate() {
-  MultiBlock ret;
-
+void Design::Transform() {
+  if (transformed_) {
+    return;
+  }
   // TODO(johanpel): when proper copy is in place, make a copy of the whole structure before sanitizing,
   // in case multiple back ends are processing the graph. This currently modifies the original structure.
 
@@ -38,6 +39,13 @@ MultiBlock Design::Generate() {
   CERATA_LOG(DEBUG, "VHDL: Transforming Cerata graph to VHDL-compatible.");
   Resolve::ResolvePortToPort(component_.get());
   Resolve::ExpandStreams(component_.get());
+  transformed_ = true;
+}
+
+MultiBlock Design::Generate() {
+  MultiBlock ret;
+
+  Transform();
 
   // Place header
   if (!libs_.empty()) {
@@ -33,7 +33,21 @@ struct Design {
   Design() = default;
   explicit Design(std::shared_ptr<Component> component, std::string notice = "", std::string header = DEFAULT_LIBS)
       : component_(std::move(component)), notice_(std::move(notice)), libs_(std::move(header)) {}
+
+  /**
+   * @brief Resolve VHDL-specific problems in the component graph.
+   *
+   * This modifies the component and the types it uses, which may be shared with other components. It is therefore not
+   * safe to transform multiple designs concurrently. Once all designs are transformed, they may be generated
+   * concurrently.
+   */
+  void Transform();
+
+  /// @brief Generate the VHDL source of the design. Transforms the design first if that didn't happen yet.
   MultiBlock Generate();
+
+ private:
+  bool transformed_ = false;
 };
 
 }  // namespace cerata::vhdl
@@ -164,25 +164,25 @@ static void ExpandMappers(Type *type, const std::deque<std::shared_ptr<TypeMappe
         auto bt = flat_b[new_col].type_;
         // Figure out if we're dealing with a matching, expanded type on both sides.
         if (IsExpandType(at, "stream") && IsExpandType(bt, "stream")) {
-          new_matrix(new_row, new_col) = old_matrix(old_row, old_col);
+          new_matrix.Set(new_row, new_col, old_matrix(old_row, old_col));
           new_col += 4;  // Skip over record, valid and ready
           old_col += 1;
         } else if (IsExpandType(at, "record") && IsExpandType(bt, "record")) {
-          new_matrix(new_row, new_col) = old_matrix(old_row, old_col);
+          new_matrix.Set(new_row, new_col, old_matrix(old_row, old_col));
           new_col += 3;  // Skip over valid and ready
           old_col += 1;
         } else if (IsExpandType(at, "valid") && IsExpandType(bt, "valid")) {
-          new_matrix(new_row, new_col) = old_matrix(old_row, old_col);
+          new_matrix.Set(new_row, new_col, old_matrix(old_row, old_col));
           new_col += 2;  // Skip over ready
           old_col += 1;
         } else if (IsExpandType(at, "ready") && IsExpandType(bt, "ready")) {
-          new_matrix(new_row, new_col) = old_matrix(old_row, old_col);
+          new_matrix.Set(new_row, new_col, old_matrix(old_row, old_col));
           new_col += 1;
         } else {
           // We're not dealing with a *matching* expanded type. However, if the A side was expanded and the type is
           // not matching, we shouldn't make a copy. That will happen later on, on another row.
           if (!IsExpandType(at)) {
-            new_matrix(new_row, new_col) = old_matrix(old_row, old_col);
+            new_matrix.Set(new_row, new_col, old_matrix(old_row, old_col));
           }
           new_col += 1;
         }
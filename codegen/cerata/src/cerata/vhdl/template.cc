@@ -14,24 +14,117 @@
 
 #include "cerata/vhdl/template.h"
 
+#include <cctype>
 #include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
 #include "cerata/logging.h"
 
 namespace cerata::vhdl {
 
-Template::Template(const std::string &filename) {
+struct Template::Compiled {
+  /// Literal text segments. Segment i is followed by placeholder i, if any.
+  std::vector<std::string> literals;
+  /// Index into names of every placeholder occurrence.
+  std::vector<size_t> slots;
+  /// Unique placeholder names, in order of first appearance.
+  std::vector<std::string> names;
+  /// Map from placeholder names to their index.
+  std::unordered_map<std::string, size_t> index;
+  /// Total length of all literal text.
+  size_t literal_size = 0;
+
+  /// @brief Parse a template string.
+  static std::shared_ptr<const Compiled> Parse(const std::string &str) {
+    auto result = std::make_shared<Compiled>();
+    std::string literal;
+    size_t pos = 0;
+    while (pos < str.length()) {
+      size_t start = str.find("${", pos);
+      if (start == std::string::npos) {
+        break;
+      }
+      // Placeholder names consist of alphanumeric characters and underscores.
+      size_t end = start + 2;
+      while ((end < str.length()) && (std::isalnum(static_cast<unsigned char>(str[end])) || (str[end] == '_'))) {
+        end++;
+      }
+      if ((end == start + 2) || (end == str.length()) || (str[end] != '}')) {
+        // Not a placeholder.
+        literal.append(str, pos, end - pos);
+        pos = end;
+        continue;
+      }
+      literal.append(str, pos, start - pos);
+      result->literal_size += literal.length();
+      result->literals.push_back(std::move(literal));
+      literal.clear();
+      auto name = str.substr(start + 2, end - start - 2);
+      auto it = result->index.find(name);
+      if (it == result->index.end()) {
+        it = result->index.emplace(name, result->names.size()).first;
+        result->names.push_back(name);
+      }
+      result->slots.push_back(it->second);
+      pos = end + 1;
+    }
+    literal.append(str, pos, std::string::npos);
+    result->literal_size += literal.length();
+    result->literals.push_back(std::move(literal));
+    return result;
+  }
+};
+
+namespace {
+std::mutex cache_mutex;
+std::unordered_map<std::string, std::shared_ptr<const Template::Compiled>> cache;
+}  // namespace
+
+Template::Template(std::shared_ptr<const Compiled> compiled)
+    : compiled_(std::move(compiled)),
+      values_(compiled_->names.size()),
+      replaced_(compiled_->names.size(), false) {}
+
+static std::shared_ptr<const Template::Compiled> CompileFile(const std::string &filename) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto it = cache.find(filename);
+  if (it != cache.end()) {
+    return it->second;
+  }
   std::ifstream ifs(filename);
   if (!ifs.is_open()) {
     throw std::runtime_error("Could not open VHDL template file " + filename);
   } else {
     CERATA_LOG(DEBUG, "Opened template file " + filename);
   }
-  std::string line;
-  while (std::getline(ifs, line)) {
-    lines_.push_back(line);
+  std::stringstream str;
+  str << ifs.rdbuf();
+  auto result = Template::Compiled::Parse(str.str());
+  cache[filename] = result;
+  return result;
+}
+
+Template::Template(const std::string &filename) : Template(CompileFile(filename)) {}
+
+Template Template::FromString(const std::string &str) {
+  return Template(Compiled::Parse(str));
+}
+
+void Template::ClearCache() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache.clear();
+}
+
+std::string *Template::value(const std::string &str) {
+  auto it = compiled_->index.find(str);
+  if (it == compiled_->index.end()) {
+    return nullptr;
   }
-  Analyze();
-  ifs.close();
+  replaced_[it->second] = true;
+  return &values_[it->second];
 }
 
 void Template::Replace(const std::string &str, int with) {
@@ -39,48 +132,74 @@ void Template::Replace(const std::string &str, int with) {
 }
 
 void Template::Replace(const std::string &str, const std::string &with) {
-  if (replace_list_.find(str) != replace_list_.end()) {
-    for (const auto& loc : replace_list_[str]) {
-      // +3 for ${}
-      lines_[loc.line].replace(loc.start, str.length() + 3, with);
+  auto val = value(str);
+  if (val != nullptr) {
+    *val = with;
+  }
+}
+
+void Template::Replace(const std::string &str, const std::vector<std::string> &items, const std::string &separator) {
+  auto val = value(str);
+  if (val == nullptr) {
+    return;
+  }
+  size_t length = 0;
+  for (const auto &item : items) {
+    length += item.length() + separator.length();
+  }
+  val->clear();
+  val->reserve(length);
+  for (size_t i = 0; i < items.size(); i++) {
+    if (i > 0) {
+      val->append(separator);
     }
+    val->append(items[i]);
+  }
+}
+
+void Template::Append(const std::string &str, const std::string &item) {
+  auto val = value(str);
+  if (val != nullptr) {
+    val->append(item);
   }
 }
 
-std::string Template::ToString() {
+size_t Template::size() const {
+  size_t result = compiled_->literal_size;
+  for (auto slot : compiled_->slots) {
+    // +3 for ${}
+    result += replaced_[slot] ? values_[slot].length() : compiled_->names[slot].length() + 3;
+  }
+  return result;
+}
+
+std::string Template::ToString() const {
   std::string out;
-  for (const auto &l : lines_) {
-    out.append(l);
-    out.append("\n");
+  out.reserve(size());
+  for (size_t i = 0; i < compiled_->slots.size(); i++) {
+    out.append(compiled_->literals[i]);
+    auto slot = compiled_->slots[i];
+    if (replaced_[slot]) {
+      out.append(values_[slot]);
+    } else {
+      out.append("${").append(compiled_->names[slot]).append("}");
+    }
   }
+  out.append(compiled_->literals.back());
   return out;
 }
 
-void Template::Analyze() {
-  // Replacement string regex
-  const std::regex rs_regex(R"(\$\{[a-zA-Z0-9_]+\})");
-
-  // Empty the replace list
-  replace_list_ = {};
-
-  // Analyze every line for replacement regex
-  size_t line_num = 0;
-  for (const auto& line : lines_) {
-    // Check if the line has any matches
-    auto rs_begin = std::sregex_iterator(line.begin(), line.end(), rs_regex);
-    auto rs_end = std::sregex_iterator();
-
-    // Find the matches in this line
-    for (std::sregex_iterator i = rs_begin; i != rs_end; ++i) {
-      std::smatch match = *i;
-      std::string match_string = match.str();
-      std::string replace_string = match_string.substr(2, match_string.length() - 3);
-      trloc loc(trloc(line_num, static_cast<size_t>(match.position(0))));
-      replace_list_[replace_string].push_back(loc);
+void Template::Render(std::ostream *out) const {
+  for (size_t i = 0; i < compiled_->slots.size(); i++) {
+    out->write(compiled_->literals[i].data(), compiled_->literals[i].length());
+    auto slot = compiled_->slots[i];
+    if (replaced_[slot]) {
+      out->write(values_[slot].data(), values_[slot].length());
+    } else {
+      *out << "${" << compiled_->names[slot] << "}";
     }
-
-    line_num++;
   }
+  out->write(compiled_->literals.back().data(), compiled_->literals.back().length());
 }
 
 }  // namespace cerata::vhdl
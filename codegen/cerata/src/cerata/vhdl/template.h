@@ -14,40 +14,61 @@
 
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <ostream>
 #include <string>
 #include <vector>
-#include <fstream>
-#include <regex>
-#include <map>
 
 namespace cerata::vhdl {
 
-// @brief Structure to hold a template replacement string location
-struct trloc {
-  trloc(size_t line, size_t start) : line(line), start(start) {}
-  size_t line;
-  size_t start;
-};
-
-/// @brief Class to hold and modify a VHDL template file.
+/**
+ * @brief Class to hold and fill in a VHDL template file.
+ *
+ * Templates contain placeholders of the form ${NAME}. A template is parsed once into a sequence of literal text
+ * segments and placeholders. The parsed form of a template file is cached, such that subsequent uses of the same file
+ * only have to fill in the placeholders. Placeholders that are not replaced are rendered as they appear in the file.
+ */
 class Template {
  public:
+  /// @brief A parsed template.
+  struct Compiled;
+
   /// @brief Construct a VHDL template file holder.
   explicit Template(const std::string &filename);
-  /// @brief Mark the locations of all replacable template strings.
-  void Analyze();
+  /// @brief Construct a template from a string.
+  static Template FromString(const std::string &str);
+
   /// @brief Replace a template replacement string with some number.
   void Replace(const std::string &str, int with);
   /// @brief Replace a template replacement string with some other string.
   void Replace(const std::string &str, const std::string &with);
+  /// @brief Replace a template replacement string with a list of strings, separated by some separator.
+  void Replace(const std::string &str, const std::vector<std::string> &items, const std::string &separator = "");
+  /// @brief Append a string to a template replacement string.
+  void Append(const std::string &str, const std::string &item);
+
+  /// @brief Return the length of the rendered template.
+  size_t size() const;
   /// @brief Return the file as a string.
-  std::string ToString();
+  std::string ToString() const;
+  /// @brief Write the file to an output stream.
+  void Render(std::ostream *out) const;
+
+  /// @brief Clear the cache of parsed template files.
+  static void ClearCache();
 
  private:
-  /// Map from a template replacement string to a vector of line numbers.
-  std::map<std::string, std::vector<trloc>> replace_list_;
-  /// Lines of the file.
-  std::vector<std::string> lines_;
+  explicit Template(std::shared_ptr<const Compiled> compiled);
+  /// @brief Return the value of a placeholder, or nullptr if it does not appear in the template.
+  std::string *value(const std::string &str);
+
+  /// The parsed template.
+  std::shared_ptr<const Compiled> compiled_;
+  /// Values of the placeholders.
+  std::vector<std::string> values_;
+  /// Whether a value was supplied for a placeholder.
+  std::vector<bool> replaced_;
 };
 
 }  // namespace cerata::vhdl
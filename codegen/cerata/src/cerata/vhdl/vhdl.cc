@@ -15,6 +15,7 @@
 #include "cerata/vhdl/vhdl.h"
 
 #include <algorithm>
+#include <deque>
 #include <vector>
 #include <string>
 #include <memory>
@@ -34,14 +35,21 @@ namespace cerata::vhdl {
 void VHDLOutputGenerator::Generate() {
   // Make sure the subdirectory exists.
   CreateDir(subdir());
-  size_t num_graphs = 0;
+
+  // Transformations may modify types shared between components, so they are applied to all designs up front.
+  std::vector<Design> designs;
   for (const auto &o : outputs_) {
     CERATA_LOG(INFO, "VHDL: Transforming Component " + o.comp->name() + " to VHDL-compatible version.");
-    auto vhdl_design = Design(o.comp, notice_, DEFAULT_LIBS);
+    designs.emplace_back(o.comp, notice_, DEFAULT_LIBS);
+    designs.back().Transform();
+  }
 
+  // Generating the sources of the transformed designs does not modify them, so it is done concurrently.
+  std::vector<OutputFile> files(outputs_.size());
+  ForEachOutput([&](size_t i) {
+    const auto &o = outputs_[i];
     CERATA_LOG(INFO, "VHDL: Generating sources for component " + o.comp->name());
-    auto vhdl_source = vhdl_design.Generate();
-    vhdl_source.ToString();
+    auto vhdl_source = designs[i].Generate().ToString();
     auto vhdl_path = subdir() + "/" + o.comp->name() + ".vhd";
 
     bool overwrite = false;
@@ -52,22 +60,19 @@ void VHDLOutputGenerator::Generate() {
       }
     }
 
-    CERATA_LOG(INFO, "VHDL: Saving design to: " + vhdl_path);
-    if (!FileExists(vhdl_path) || overwrite) {
-      auto vhdl_file = std::ofstream(vhdl_path);
-      vhdl_file << vhdl_source.ToString();
-      vhdl_file.close();
-    } else {
+    if (FileExists(vhdl_path) && !overwrite) {
       CERATA_LOG(INFO, "VHDL: File exists, saving to " + vhdl_path + "t");
       // Save as a vhdt file.
-      auto vhdl_file = std::ofstream(vhdl_path + "t");
-      vhdl_file << vhdl_source.ToString();
-      vhdl_file.close();
+      vhdl_path += "t";
     }
+    files[i] = WriteIfChanged(vhdl_path, vhdl_source);
+    CERATA_LOG(INFO, "VHDL: Design saved to " + vhdl_path + " (" + ToString(files[i].status) + ")");
+  });
 
-    num_graphs++;
-  }
-  CERATA_LOG(INFO, "VHDL: Generated output for " + std::to_string(num_graphs) + " graphs.");
+  manifest_ = std::deque<OutputFile>(files.begin(), files.end());
+  WriteManifest();
+  CERATA_LOG(INFO, "VHDL: Generated output for " + std::to_string(outputs_.size()) + " graphs, "
+      + std::to_string(num_changed()) + " files changed.");
 }
 
 }  // namespace cerata::vhdl
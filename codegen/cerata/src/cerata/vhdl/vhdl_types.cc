@@ -24,14 +24,20 @@
 namespace cerata::vhdl {
 
 std::shared_ptr<Type> valid() {
-  static std::shared_ptr<Type> result = std::make_shared<Bit>("valid");
-  result->meta[metakeys::EXPAND_TYPE] = "valid";
+  static std::shared_ptr<Type> result = []() {
+    auto type = std::make_shared<Bit>("valid");
+    type->meta[metakeys::EXPAND_TYPE] = "valid";
+    return type;
+  }();
   return result;
 }
 
 std::shared_ptr<Type> ready() {
-  static std::shared_ptr<Type> result = std::make_shared<Bit>("ready");
-  result->meta[metakeys::EXPAND_TYPE] = "ready";
+  static std::shared_ptr<Type> result = []() {
+    auto type = std::make_shared<Bit>("ready");
+    type->meta[metakeys::EXPAND_TYPE] = "ready";
+    return type;
+  }();
   return result;
 }
 
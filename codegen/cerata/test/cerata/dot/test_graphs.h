@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 #include <cerata/api.h>
 
+#include <cstdio>
+
 #include "cerata/test_designs.h"
 
 namespace cerata {
@@ -37,4 +39,22 @@ TEST(Dot, Example) {
   dot.GenFile(*top, "Dot_Example.dot");
 }
 
+TEST(Dot, OutputGenerator) {
+  default_component_pool()->Clear();
+  auto top = GetExampleDesign();
+  auto all = GetAllPortTypesComponent();
+  std::remove(("dot/" + top->name() + ".dot").c_str());
+  std::remove(("dot/" + all->name() + ".dot").c_str());
+
+  dot::DOTOutputGenerator first("", {{top}, {all}});
+  first.SetNumThreads(2).Generate();
+  ASSERT_EQ(first.num_changed(), 2);
+  ASSERT_EQ(first.manifest()[0].status, OutputFile::Status::CREATED);
+
+  dot::DOTOutputGenerator second("", {{top}, {all}});
+  second.SetNumThreads(2).Generate();
+  ASSERT_EQ(second.num_changed(), 0);
+  ASSERT_EQ(second.manifest()[1].hash, first.manifest()[1].hash);
+}
+
 }  // namespace cerata
@@ -18,11 +18,16 @@
 #include "cerata/test_expressions.h"
 #include "cerata/test_types.h"
 #include "cerata/test_pool.h"
+#include "cerata/test_graph.h"
 
 // VHDL backend tests
 #include "cerata/vhdl/test_declarators.h"
 #include "cerata/vhdl/test_instantiators.h"
 #include "cerata/vhdl/test_designs.h"
+#include "cerata/vhdl/test_template.h"
+
+// Verilog backend tests
+#include "cerata/verilog/test_designs.h"
 
 // DOT backend tests
 #include "cerata/dot/test_graphs.h"
@@ -0,0 +1,126 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cerata/api.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace cerata {
+
+TEST(Graph, ObjectIndex) {
+  default_component_pool()->Clear();
+  auto data = Vector::Make<8>();
+  auto size = Parameter::Make("size", integer(), intl(0));
+  auto a = Port::Make("a", data, Term::IN);
+  auto b = Signal::Make("b", data);
+  auto c = PortArray::Make("c", data, size, Term::OUT);
+  auto comp = Component::Make("comp", {a, b, c});
+
+  // Lookups by name and kind.
+  ASSERT_EQ(comp->port("a"), a.get());
+  ASSERT_EQ(comp->sig("b"), b.get());
+  ASSERT_EQ(comp->par("size"), size.get());
+  ASSERT_EQ(comp->porta("c"), c.get());
+  ASSERT_TRUE(comp->GetObject("a"));
+  ASSERT_FALSE(comp->GetObject("d"));
+  ASSERT_FALSE(comp->GetNode("c"));
+
+  // Typed iteration.
+  ASSERT_EQ(comp->GetAll<Port>().size(), 1);
+  ASSERT_EQ(comp->GetAll<Signal>().size(), 1);
+  ASSERT_EQ(comp->GetAll<PortArray>().size(), 1);
+  ASSERT_EQ(comp->GetAll<NodeArray>().size(), 1);
+  ASSERT_EQ(comp->CountNodes(Node::NodeID::PARAMETER), 1);
+  ASSERT_EQ(comp->GetNodes().size(), comp->GetAll<Node>().size());
+  ASSERT_EQ(comp->objects().size(), comp->GetNodes().size() + comp->GetAll<NodeArray>().size());
+
+  // Adding the same object again is skipped.
+  comp->AddObject(a);
+  ASSERT_EQ(comp->GetAll<Port>().size(), 1);
+
+  // Removal updates the indices.
+  comp->RemoveObject(b.get());
+  ASSERT_FALSE(comp->GetNode("b"));
+  ASSERT_EQ(comp->GetAll<Signal>().size(), 0);
+  ASSERT_EQ(comp->CountNodes(Node::NodeID::SIGNAL), 0);
+
+  // The name can be used again after removal.
+  auto b2 = Port::Make("b", data, Term::OUT);
+  comp->AddObject(b2);
+  ASSERT_EQ(comp->port("b"), b2.get());
+  auto ports = comp->GetAll<Port>();
+  ASSERT_EQ(ports.size(), 2);
+  ASSERT_EQ(ports[0], a.get());
+  ASSERT_EQ(ports[1], b2.get());
+}
+
+TEST(Graph, WideComponent) {
+  default_component_pool()->Clear();
+  auto data = Vector::Make<8>();
+
+  for (size_t width : {100, 1000, 4000}) {
+    auto start = std::chrono::steady_clock::now();
+
+    auto comp = Component::Make("wide_" + std::to_string(width));
+    for (size_t i = 0; i < width; i++) {
+      comp->AddObject(Port::Make("p" + std::to_string(i), data, Term::IN));
+    }
+    auto inst = Instance::Make(comp.get());
+    for (size_t i = 0; i < width; i++) {
+      ASSERT_EQ(inst->port("p" + std::to_string(i))->name(), "p" + std::to_string(i));
+    }
+    ASSERT_EQ(inst->GetAll<Port>().size(), width);
+    ASSERT_EQ(comp->CountNodes(Node::NodeID::PORT), width);
+    ASSERT_EQ(inst->port("p" + std::to_string(width - 1))->parent().value(), inst.get());
+
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    std::cout << "Component with " << width << " ports: " << time.count() << " s" << std::endl;
+  }
+}
+
+TEST(Graph, SharedSizeExpression) {
+  default_component_pool()->Clear();
+  auto data = Vector::Make<8>();
+  auto n = Parameter::Make("n", integer(), intl(2));
+
+  // Structurally identical size expressions are interned, so both arrays start out with the same size node.
+  auto a = PortArray::Make("a", data, n * intl(2), Term::OUT);
+  auto b = PortArray::Make("b", data, n * intl(2), Term::OUT);
+  ASSERT_EQ(a->size(), b->size());
+
+  // Every graph owns its own size node.
+  auto x = Component::Make("x", {a});
+  auto y = Component::Make("y", {b});
+  ASSERT_NE(a->size(), b->size());
+  ASSERT_EQ(a->size()->parent().value(), x.get());
+  ASSERT_EQ(b->size()->parent().value(), y.get());
+  ASSERT_EQ(b->size()->ToString(), a->size()->ToString());
+
+  // Incrementing the size of one array does not touch the other graph.
+  auto b_size = b->size();
+  a->Append();
+  ASSERT_EQ(b->size(), b_size);
+  ASSERT_EQ(b_size->parent().value(), y.get());
+  auto y_nodes = y->GetNodes();
+  ASSERT_NE(std::find(y_nodes.begin(), y_nodes.end(), b_size), y_nodes.end());
+}
+
+}  // namespace cerata
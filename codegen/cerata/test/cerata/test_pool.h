@@ -43,4 +43,26 @@ TEST(Pool, StringPool) {
   ASSERT_EQ(some.get(), rsome);
 }
 
+TEST(Pool, ExpressionPool) {
+  cerata::default_node_pool()->Clear();
+  auto a = Parameter::Make("a", integer());
+  auto b = Parameter::Make("b", integer());
+
+  // Structurally identical expressions result in the same node.
+  auto e0 = a + intl(1);
+  auto e1 = a + intl(1);
+  ASSERT_EQ(e0.get(), e1.get());
+  ASSERT_EQ((e0 * b).get(), (e1 * b).get());
+
+  // Different operations or operands result in different nodes.
+  ASSERT_NE((a + b).get(), (a - b).get());
+  ASSERT_NE((a + b).get(), (b + a).get());
+
+  // Expressions are minimized before they are interned.
+  ASSERT_EQ((intl(2) + intl(3)).get(), intl(5).get());
+  ASSERT_EQ((e0 * intl(1)).get(), e0.get());
+  ASSERT_EQ((a + intl(0)).get(), a.get());
+  ASSERT_EQ((e0 * intl(0)).get(), intl(0).get());
+}
+
 }
\ No newline at end of file
@@ -91,4 +91,78 @@ TEST(Types, TypeMapper) {
 
 }
 
+TEST(Types, MappingMatrix) {
+  MappingMatrix<int64_t> m(1000, 2000);
+  m.SetNext(3, 5).SetNext(3, 7).SetNext(4, 7);
+  ASSERT_EQ(m.num_nonzero(), 3);
+  ASSERT_EQ(m(3, 5), 1);
+  ASSERT_EQ(m(3, 7), 2);
+  ASSERT_EQ(m(4, 7), 3);
+  ASSERT_EQ(m(5, 3), 0);
+  ASSERT_EQ(m.MaxOfColumn(7), 3);
+  ASSERT_EQ(m.MaxOfRow(3), 2);
+
+  auto row = m.mapping_row(3);
+  ASSERT_EQ(row.size(), 2);
+  ASSERT_EQ(row[0].first, 5);
+  ASSERT_EQ(row[1].first, 7);
+  auto column = m.mapping_column(7);
+  ASSERT_EQ(column.size(), 2);
+  ASSERT_EQ(column[0].first, 3);
+  ASSERT_EQ(column[1].first, 4);
+
+  // Setting an element to zero removes it.
+  m.Set(3, 5, 0);
+  ASSERT_EQ(m.num_nonzero(), 2);
+  ASSERT_TRUE(m.mapping_column(5).empty());
+
+  auto t = m.Transpose();
+  ASSERT_EQ(t.height(), 2000);
+  ASSERT_EQ(t.width(), 1000);
+  ASSERT_EQ(t(7, 4), 3);
+  ASSERT_EQ(t.mapping_row(7).size(), 2);
+
+  auto id = MappingMatrix<int64_t>::Identity(4);
+  ASSERT_EQ(id.num_nonzero(), 4);
+  ASSERT_EQ(id(2, 2), 1);
+
+  ASSERT_THROW(m(1000, 0), std::runtime_error);
+}
+
+TEST(Types, FlattenCache) {
+  auto v = Vector::Make<8>();
+  auto r = Record::Make("rec", {RecField::Make("a", v)});
+  auto s = Stream::Make(r);
+  ASSERT_EQ(Flatten(s.get()).size(), 3);
+  ASSERT_EQ(Flatten(s.get()).size(), 3);
+  // Changing a nested type must invalidate the memoized result.
+  r->AddField(RecField::Make("b", v));
+  auto flat = Flatten(s.get());
+  ASSERT_EQ(flat.size(), 4);
+  ASSERT_EQ(flat[3].name(), "b");
+  s->SetElementType(v);
+  ASSERT_EQ(Flatten(s.get()).size(), 2);
+}
+
+TEST(Types, ImplicitMapperCache) {
+  auto make = []() {
+    return Stream::Make(Record::Make("rec", {RecField::Make("a", Vector::Make<8>()),
+                                             RecField::Make("b", Vector::Make<8>())}));
+  };
+  auto a = make();
+  auto b = make();
+  auto m0 = a->GetMapper(b.get());
+  auto m1 = a->GetMapper(b.get());
+  ASSERT_TRUE(m0);
+  ASSERT_EQ(*m0, *m1);
+  ASSERT_EQ((*m0)->map_matrix().num_nonzero(), 4);
+  // Different types cannot be mapped, which is cached as well.
+  auto c = Stream::Make(Vector::Make<8>());
+  ASSERT_FALSE(a->GetMapper(c.get()));
+  ASSERT_FALSE(a->GetMapper(c.get()));
+  // Changing a type invalidates the cached mappers.
+  std::dynamic_pointer_cast<Record>(b->element_type())->AddField(RecField::Make("c", Vector::Make<8>()));
+  ASSERT_FALSE(a->GetMapper(b.get()));
+}
+
 }  // namespace cerata
@@ -0,0 +1,148 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cerata/api.h>
+
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "cerata/test_designs.h"
+
+namespace cerata {
+
+TEST(VERILOG_DESIGN, Simple) {
+  default_component_pool()->Clear();
+  auto static_vec = Vector::Make<8>();
+  auto param = Parameter::Make("vec_width", natural(), intl(8));
+  auto param_vec = Vector::Make("param_vec_type", param);
+  auto veca = Port::Make("static_vec", static_vec);
+  auto vecb = Port::Make("param_vec", param_vec, Port::Dir::OUT);
+  auto bitc = Port::Make("c", bit());
+  auto comp = Component::Make("simple", {veca, vecb, bitc});
+  auto source = verilog::Design(comp).Generate().ToString();
+  auto expected =
+      "module simple #(\n"
+      "  parameter vec_width = 8\n"
+      ") (\n"
+      "  input  wire [7:0]           static_vec,\n"
+      "  output wire [vec_width-1:0] param_vec,\n"
+      "  input  wire                 c\n"
+      ");\n"
+      "endmodule\n";
+  ASSERT_EQ(source, expected);
+}
+
+TEST(VERILOG_DESIGN, CompInst) {
+  default_component_pool()->Clear();
+  auto a = Port::Make("a", bit(), Port::Dir::IN);
+  auto b = Port::Make("b", bit(), Port::Dir::OUT);
+  auto ca = Component::Make("comp_a", {a});
+  auto cb = Component::Make("comp_b", {b});
+  auto top = Component::Make("top");
+  auto ia = top->AddInstanceOf(ca.get());
+  auto ib = top->AddInstanceOf(cb.get());
+  Connect(ia->port("a"), ib->port("b"));
+  auto source = verilog::Design(top).Generate().ToString();
+  auto expected =
+      "module top (\n"
+      ");\n"
+      "  wire comp_b_inst_b;\n"
+      "  comp_a comp_a_inst (\n"
+      "    .a(comp_b_inst_b)\n"
+      "  );\n"
+      "  comp_b comp_b_inst (\n"
+      "    .b(comp_b_inst_b)\n"
+      "  );\n"
+      "endmodule\n";
+  ASSERT_EQ(source, expected);
+}
+
+TEST(VERILOG_DESIGN, StreamConcat) {
+  default_component_pool()->Clear();
+  auto comp = GetStreamConcatComponent();
+  // Generating VHDL first transforms the design in the same way, which must not affect the Verilog output.
+  vhdl::Design(comp).Generate();
+  auto source = verilog::Design(comp).Generate().ToString();
+  auto expected =
+      "module X (\n"
+      "  output wire A0_valid,\n"
+      "  input  wire A0_ready,\n"
+      "  output wire A0_other,\n"
+      "  output wire A0_child_valid,\n"
+      "  input  wire A0_child_ready,\n"
+      "  output wire A0_child,\n"
+      "  output wire A1_valid,\n"
+      "  input  wire A1_ready,\n"
+      "  output wire A1_other,\n"
+      "  output wire A1_child_valid,\n"
+      "  input  wire A1_child_ready,\n"
+      "  output wire A1_child\n"
+      ");\n"
+      "  Y Y_inst (\n"
+      "    .B_valid({A0_child_valid, A0_valid}),\n"
+      "    .B_ready({A0_child_ready, A0_ready}),\n"
+      "    .B_data ({A0_child, A0_other}),\n"
+      "    .C_valid({A1_child_valid, A1_valid}),\n"
+      "    .C_ready({A1_child_ready, A1_ready}),\n"
+      "    .C_data ({A1_child, A1_other})\n"
+      "  );\n"
+      "endmodule\n";
+  ASSERT_EQ(source, expected);
+}
+
+TEST(VERILOG_DESIGN, ArrayPorts) {
+  default_component_pool()->Clear();
+  auto source = verilog::Design(GetArrayComponent()).Generate().ToString();
+  auto expected =
+      "module top (\n"
+      ");\n"
+      "  X #(\n"
+      "    .size(2)\n"
+      "  ) X_inst (\n"
+      "    .A({C, B})\n"
+      "  );\n"
+      "  Y Y_inst (\n"
+      "    .B(A[7:0]),\n"
+      "    .C(A[15:8])\n"
+      "  );\n"
+      "endmodule\n";
+  ASSERT_EQ(source, expected);
+}
+
+TEST(VERILOG_DESIGN, OutputGenerator) {
+  default_component_pool()->Clear();
+  std::deque<OutputSpec> outputs;
+  for (int i = 0; i < 4; i++) {
+    auto name = "vgen_" + std::to_string(i);
+    auto comp = Component::Make(name, {Port::Make("p", Vector::Make(i + 1), Port::Dir::IN)});
+    outputs.push_back({comp, {{verilog::metakeys::OVERWRITE_FILE, "true"}}});
+  }
+  verilog::VerilogOutputGenerator gen("", outputs);
+  gen.Generate();
+  ASSERT_EQ(gen.manifest().size(), outputs.size());
+  for (size_t i = 0; i < outputs.size(); i++) {
+    const auto &f = gen.manifest()[i];
+    ASSERT_EQ(f.path, "verilog/vgen_" + std::to_string(i) + ".v");
+    std::stringstream contents;
+    contents << std::ifstream(f.path).rdbuf();
+    ASSERT_NE(contents.str().find("module vgen_" + std::to_string(i) + " ("), std::string::npos);
+  }
+}
+
+}  // namespace cerata
@@ -17,7 +17,10 @@
 #include <gtest/gtest.h>
 #include <cerata/api.h>
 
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include "cerata/test_designs.h"
@@ -109,4 +112,46 @@ TEST(VHDL_DESIGN, CompInst) {
   VHDL_DUMP_TEST(expected);
 }
 
+TEST(VHDL_DESIGN, OutputGenerator) {
+  default_component_pool()->Clear();
+  std::deque<OutputSpec> outputs;
+  for (int i = 0; i < 8; i++) {
+    auto name = "gen_" + std::to_string(i);
+    auto comp = Component::Make(name, {Port::Make("p", Vector::Make(i + 1), Port::Dir::IN)});
+    outputs.push_back({comp, {{vhdl::metakeys::OVERWRITE_FILE, "true"}}});
+    std::remove(("vhdl/" + name + ".vhd").c_str());
+  }
+
+  // First run creates all files.
+  vhdl::VHDLOutputGenerator first("", outputs);
+  first.SetNumThreads(4).Generate();
+  ASSERT_EQ(first.manifest().size(), outputs.size());
+  ASSERT_EQ(first.num_changed(), outputs.size());
+  for (size_t i = 0; i < outputs.size(); i++) {
+    const auto &f = first.manifest()[i];
+    ASSERT_EQ(f.path, "vhdl/gen_" + std::to_string(i) + ".vhd");
+    ASSERT_EQ(f.status, OutputFile::Status::CREATED);
+    std::stringstream contents;
+    contents << std::ifstream(f.path).rdbuf();
+    ASSERT_EQ(ContentHash(contents.str()), f.hash);
+    ASSERT_NE(contents.str().find("entity gen_" + std::to_string(i) + " is"), std::string::npos);
+  }
+
+  // Regenerating the same designs leaves all files untouched.
+  vhdl::VHDLOutputGenerator second("", outputs);
+  second.SetNumThreads(4).Generate();
+  ASSERT_EQ(second.num_changed(), 0);
+  for (size_t i = 0; i < outputs.size(); i++) {
+    ASSERT_EQ(second.manifest()[i].status, OutputFile::Status::UNCHANGED);
+    ASSERT_EQ(second.manifest()[i].hash, first.manifest()[i].hash);
+  }
+
+  // Changing a design only rewrites its own file.
+  outputs[3].comp->AddObject(Port::Make("q", bit(), Port::Dir::OUT));
+  vhdl::VHDLOutputGenerator third("", outputs);
+  third.Generate();
+  ASSERT_EQ(third.num_changed(), 1);
+  ASSERT_EQ(third.manifest()[3].status, OutputFile::Status::CHANGED);
+}
+
 }  // namespace cerata
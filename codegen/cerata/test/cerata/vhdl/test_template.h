@@ -0,0 +1,88 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cerata/api.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cerata {
+
+TEST(VHDL_TEMPLATE, Replace) {
+  auto t = vhdl::Template::FromString("entity ${NAME} is\n"
+                                      "  generic (W : natural := ${WIDTH});\n"
+                                      "end ${NAME}; -- ${UNUSED} ${not a placeholder} $\n");
+  t.Replace("NAME", "${WIDTH}");
+  t.Replace("WIDTH", 32);
+  t.Replace("DOES_NOT_EXIST", "x");
+  auto expected = "entity ${WIDTH} is\n"
+                  "  generic (W : natural := 32);\n"
+                  "end ${WIDTH}; -- ${UNUSED} ${not a placeholder} $\n";
+  ASSERT_EQ(t.ToString(), expected);
+  ASSERT_EQ(t.size(), std::string(expected).length());
+
+  std::stringstream str;
+  t.Render(&str);
+  ASSERT_EQ(str.str(), expected);
+}
+
+TEST(VHDL_TEMPLATE, List) {
+  auto t = vhdl::Template::FromString("(${ITEMS})\n${LINES}");
+  t.Replace("ITEMS", {"a", "b", "c"}, ", ");
+  t.Append("LINES", "x;\n");
+  t.Append("LINES", "y;\n");
+  ASSERT_EQ(t.ToString(), "(a, b, c)\nx;\ny;\n");
+  t.Replace("ITEMS", std::vector<std::string>());
+  ASSERT_EQ(t.ToString(), "()\nx;\ny;\n");
+}
+
+TEST(VHDL_TEMPLATE, WideSimulationTop) {
+  // Synthetic simulation top-level with MMIO writes for a schema with 10k buffers.
+  constexpr int num_buffers = 10000;
+  std::stringstream src;
+  src << "entity ${NAME} is\nend ${NAME};\n";
+  for (int i = 0; i < 100; i++) {
+    src << "  -- padding line " << i << " of the simulation top-level template\n";
+  }
+  src << "${SREC_BUFFER_ADDRESSES}\n";
+  auto text = src.str();
+
+  auto start = std::chrono::steady_clock::now();
+  auto t = vhdl::Template::FromString(text);
+  t.Replace("NAME", "sim_top");
+  for (int i = 0; i < 2 * num_buffers; i++) {
+    std::stringstream line;
+    line << "    mmio_write(" << i << ", X\"" << std::setfill('0') << std::setw(8) << std::hex << i << "\","
+         << " mmio_source, mmio_sink);\n";
+    t.Append("SREC_BUFFER_ADDRESSES", line.str());
+  }
+  std::stringstream out;
+  t.Render(&out);
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  std::cout << "Template with " << num_buffers << " buffers: " << time.count() << " s" << std::endl;
+
+  auto result = out.str();
+  ASSERT_EQ(result.length(), t.size());
+  ASSERT_EQ(result.find("${"), std::string::npos);
+  ASSERT_NE(result.find("mmio_write(19999, X\"00004e1f\""), std::string::npos);
+}
+
+}  // namespace cerata
@@ -0,0 +1,17 @@
+# Writes a header defining FLETCHGEN_GENERATOR_HASH, a hash of the sources fletchgen is built from. The cache of
+# incremental runs includes it in every fingerprint, such that any change to the generator invalidates the cache.
+#
+# Usage: cmake -DSOURCE_LIST=<file with one source per line> -DOUTPUT=<header> -P GeneratorHash.cmake
+
+file(STRINGS ${SOURCE_LIST} sources)
+set(hashes "")
+foreach (source ${sources})
+  file(SHA1 ${source} source_hash)
+  string(APPEND hashes ${source_hash})
+endforeach ()
+string(SHA1 hash "${hashes}")
+string(SUBSTRING ${hash} 0 16 hash)
+
+file(WRITE ${OUTPUT}.tmp "#pragma once\n\n#define FLETCHGEN_GENERATOR_HASH \"${hash}\"\n")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
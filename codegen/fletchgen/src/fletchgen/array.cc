@@ -18,6 +18,8 @@
 #include <fletcher/common.h>
 #include <memory>
 #include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <vector>
 #include <deque>
 #include <string>
@@ -78,6 +80,19 @@ std::shared_ptr<Type> unlock(const std::shared_ptr<Node> &tag_width) {
   return unlock_stream;
 }
 
+std::shared_ptr<Type> burst_max_len(const std::shared_ptr<Node> &len_width) {
+  return Vector::Make("burst_max_len", len_width);
+}
+
+std::shared_ptr<Type> profile_counters() {
+  auto busy = RecField::Make("busy_cycles", Vector::Make(PROFILE_COUNT_WIDTH));
+  auto req = RecField::Make("req_beats", Vector::Make(PROFILE_COUNT_WIDTH));
+  auto dat = RecField::Make("dat_beats", Vector::Make(PROFILE_COUNT_WIDTH));
+  auto stall = RecField::Make("stall_cycles", Vector::Make(PROFILE_COUNT_WIDTH));
+  auto bytes = RecField::Make("bytes", Vector::Make(PROFILE_COUNT_WIDTH));
+  return Record::Make("profile", {busy, req, dat, stall, bytes});
+}
+
 std::shared_ptr<Type> read_data(const std::shared_ptr<Node> &width) {
   auto d = RecField::Make(data(width));
   auto dv = RecField::Make(dvalid());
@@ -141,7 +156,8 @@ static std::shared_ptr<Component> Array(Mode mode) {
   std::deque<std::shared_ptr<cerata::Object>> objects;
 
   // Insert some parameters
-  objects.insert(objects.end(), {bus_addr_width(), bus_len_width(), bus_data_width()});
+  auto len_width = bus_len_width();
+  objects.insert(objects.end(), {bus_addr_width(), len_width, bus_data_width()});
 
   // Insert bus strobe width for writers
   if (mode == Mode::WRITE) {
@@ -150,13 +166,19 @@ static std::shared_ptr<Component> Array(Mode mode) {
 
   // Insert other parameters
   objects.insert(objects.end(), {
-      Parameter::Make("BUS_BURST_STEP_LEN", integer(), intl(4)),
-      Parameter::Make("BUS_BURST_MAX_LEN", integer(), intl(16)),
+      Parameter::Make("BUS_BURST_STEP_LEN", integer(), intl(DEFAULT_BURST_STEP_LEN)),
+      Parameter::Make("BUS_BURST_MAX_LEN", integer(), intl(DEFAULT_BURST_MAX_LEN)),
       Parameter::Make("INDEX_WIDTH", integer(), intl(32)),
       Parameter::Make("CFG", string(), strl("")),
       Parameter::Make("CMD_TAG_ENABLE", boolean(), booll(false)),
       Parameter::Make("CMD_TAG_WIDTH", integer(), intl(1))});
 
+  // Readers can split their bursts to a maximum length that is set at run time.
+  if (mode == Mode::READ) {
+    objects.push_back(Parameter::Make("BURST_LIMIT_ENABLE", boolean(), booll(false)));
+  }
+  objects.push_back(Parameter::Make("PROFILE_ENABLE", boolean(), booll(false)));
+
   // Insert ports
   objects.insert(objects.end(), {
       Port::Make(bus_cr()),
@@ -166,6 +188,11 @@ static std::shared_ptr<Component> Array(Mode mode) {
       Port::Make("unl", unlock(), Port::Dir::OUT),
       data});
 
+  if (mode == Mode::READ) {
+    objects.push_back(Port::Make("burst_max_len", burst_max_len(len_width), Port::Dir::IN));
+  }
+  objects.push_back(Port::Make("prof", profile_counters(), Port::Dir::OUT));
+
   auto ret = Component::Make(ArrayName(mode), objects);
 
   ret->SetMeta(cerata::vhdl::metakeys::PRIMITIVE, "true");
@@ -257,6 +284,42 @@ std::shared_ptr<Node> GetWidth(const arrow::DataType *type) {
   }
 }
 
+int GetEPC(const arrow::Field &field) {
+  // Fall back to the key used by older versions of Fletchgen.
+  return fletcher::GetIntMeta(field, "fletcher_epc", fletcher::GetIntMeta(field, "epc", 1));
+}
+
+int GetLEPC(const arrow::Field &field) {
+  return fletcher::GetIntMeta(field, "fletcher_lepc", fletcher::GetIntMeta(field, "lepc", 1));
+}
+
+/// @brief Return a positive integer from the metadata of a field, or else of its schema, or some default.
+static int GetBurstMeta(const arrow::Schema &schema, const arrow::Field &field, const std::string &key, int default_to) {
+  auto value = fletcher::GetMeta(field, key);
+  if (value.empty()) {
+    value = fletcher::GetMeta(schema, key);
+  }
+  if (value.empty()) {
+    return default_to;
+  }
+  char *end = nullptr;
+  auto result = std::strtol(value.c_str(), &end, 10);
+  if ((*end != '\0') || (result <= 0) || (result > std::numeric_limits<int>::max())) {
+    FLETCHER_LOG(ERROR, "Field " + field.name() + " has invalid metadata " + key + "=\"" + value
+        + "\". Using default value " + std::to_string(default_to) + ".");
+    return default_to;
+  }
+  return static_cast<int>(result);
+}
+
+int GetBurstMaxLen(const arrow::Schema &schema, const arrow::Field &field) {
+  return GetBurstMeta(schema, field, "fletcher_burst_max_len", DEFAULT_BURST_MAX_LEN);
+}
+
+int GetBurstStepLen(const arrow::Schema &schema, const arrow::Field &field) {
+  return GetBurstMeta(schema, field, "fletcher_burst_step_len", DEFAULT_BURST_STEP_LEN);
+}
+
 std::string GenerateConfigString(const arrow::Field &field, int level) {
   std::string ret;
   ConfigType ct = GetConfigType(field.type().get());
@@ -266,8 +329,8 @@ std::string GenerateConfigString(const arrow::Field &field, int level) {
     level++;
   }
 
-  int epc = fletcher::GetIntMeta(field, "epc", 1);
-  int lepc = fletcher::GetIntMeta(field, "lepc", 1);
+  int epc = GetEPC(field);
+  int lepc = GetLEPC(field);
 
   if (ct == ConfigType::PRIM) {
     auto w = GetWidth(field.type().get());
@@ -298,7 +361,7 @@ std::string GenerateConfigString(const arrow::Field &field, int level) {
     }
   }
   if (lepc > 1) {
-    ret += "lepc=" + std::to_string(epc);
+    ret += "lepc=" + std::to_string(lepc);
   }
 
   // Append children
@@ -350,8 +413,8 @@ std::shared_ptr<Type> GetStreamType(const arrow::Field &field, fletcher::Mode mo
   // WARNING: Modifications to this function must be reflected in the manual hardware implementation of Fletcher
   // components! See: hardware/arrays/ArrayConfig_pkg.vhd
 
-  int epc = fletcher::GetIntMeta(field, "epc", 1);
-  int lepc = fletcher::GetIntMeta(field, "lepc", 1);
+  int epc = GetEPC(field);
+  int lepc = GetLEPC(field);
 
   std::shared_ptr<Type> type;
 
@@ -27,6 +27,31 @@ using cerata::Component;
 using cerata::Instance;
 using cerata::intl;
 
+/// Default maximum burst length of Array(Reader/Writer)s, in beats.
+constexpr int DEFAULT_BURST_MAX_LEN = 16;
+/// Default burst step length of Array(Reader/Writer)s, in beats.
+constexpr int DEFAULT_BURST_STEP_LEN = 4;
+/// Width of the profile counters of Array(Reader/Writer)s, in bits.
+constexpr int PROFILE_COUNT_WIDTH = 32;
+
+/// @brief Return the elements-per-cycle of a field. Settable through Arrow metadata key "fletcher_epc". Default = 1.
+int GetEPC(const arrow::Field &field);
+
+/// @brief Return the lengths-per-cycle of a list field. Settable through Arrow metadata key "fletcher_lepc".
+/// Default = 1.
+int GetLEPC(const arrow::Field &field);
+
+/**
+ * @brief Return the maximum burst length in beats of the Array(Reader/Writer) of a field.
+ *
+ * Settable per field, or for all fields of a schema, through Arrow metadata key "fletcher_burst_max_len". Values that
+ * are not positive integers are reported and ignored. Default = DEFAULT_BURST_MAX_LEN.
+ */
+int GetBurstMaxLen(const arrow::Schema &schema, const arrow::Field &field);
+
+/// @brief Return the burst step length in beats of a field, like GetBurstMaxLen(), through "fletcher_burst_step_len".
+int GetBurstStepLen(const arrow::Schema &schema, const arrow::Field &field);
+
 /// @brief Return the width of the control data of this field.
 std::shared_ptr<Node> ctrl_width(const arrow::Field &field);
 
@@ -40,6 +65,10 @@ std::shared_ptr<Type> cmd(const std::shared_ptr<Node> &ctrl_width = intl(1),
                           const std::shared_ptr<Node> &tag_width = intl(1));
 ///< @brief Fletcher unlock stream
 std::shared_ptr<Type> unlock(const std::shared_ptr<Node> &tag_width = intl(1));
+///< @brief Fletcher run-time maximum burst length
+std::shared_ptr<Type> burst_max_len(const std::shared_ptr<Node> &len_width = intl(8));
+///< @brief Fletcher profile counters
+std::shared_ptr<Type> profile_counters();
 ///< @brief Fletcher read data
 std::shared_ptr<Type> read_data(const std::shared_ptr<Node> &data_width = intl(1));
 ///< @brief Fletcher write data
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <deque>
+#include <string>
 
 #include "fletchgen/basic_types.h"
 
@@ -96,7 +97,8 @@ static std::shared_ptr<Component> BusArbiter(BusSpec spec) {
   objects.insert(objects.end(), {
       nslaves,
       Parameter::Make("ARB_METHOD", string(), strl("ROUND-ROBIN")),
-      Parameter::Make("MAX_OUTSTANDING", integer(), intl(4)),
+      Parameter::Make("SLV_WEIGHTS", string(), empty_str),
+      Parameter::Make("MAX_OUTSTANDING", integer(), intl(DEFAULT_ARBITER_MAX_OUTSTANDING)),
       Parameter::Make("RAM_CONFIG", string(), empty_str),
       Parameter::Make("SLV_REQ_SLICES", boolean(), booll(true)),
       Parameter::Make("MST_REQ_SLICE", boolean(), booll(true)),
@@ -118,7 +120,12 @@ static std::shared_ptr<Component> BusArbiter(BusSpec spec) {
 std::unique_ptr<Instance> BusArbiterInstance(BusSpec spec) {
   auto optional_existing_component = cerata::default_component_pool()->Get(BusArbiterName(spec));
   if (optional_existing_component) {
-    return Instance::Make(optional_existing_component.value());
+    auto component = optional_existing_component.value();
+    if (spec.channel > 0) {
+      // Arbiters of all memory channels are instances of the same component.
+      return Instance::Make(component, component->name() + "_ch" + std::to_string(spec.channel) + "_inst");
+    }
+    return Instance::Make(component);
   } else {
     auto new_component = BusArbiter(spec);
     return BusArbiterInstance(spec);
@@ -151,7 +158,8 @@ std::shared_ptr<Component> BusReadSerializer() {
 
 bool operator==(const BusSpec &lhs, const BusSpec &rhs) {
   return (lhs.data_width == rhs.data_width) && (lhs.addr_width == rhs.addr_width) && (lhs.len_width == rhs.len_width) &&
-      (lhs.burst_step == rhs.burst_step) && (lhs.max_burst == rhs.max_burst) && (lhs.function == rhs.function);
+      (lhs.burst_step == rhs.burst_step) && (lhs.max_burst == rhs.max_burst) && (lhs.function == rhs.function) &&
+      (lhs.channel == rhs.channel);
 }
 std::shared_ptr<Type> bus(BusSpec spec) {
   std::shared_ptr<Type> result;
@@ -190,6 +198,7 @@ std::shared_ptr<BusPort> BusPort::Make(Port::Dir dir, BusSpec spec) {
 
 std::shared_ptr<cerata::Object> BusPort::Copy() const {
   auto result = Make(name(), dir_, spec_);
+  result->weight_ = weight_;
   // Take shared ownership of the type
   auto typ = type()->shared_from_this();
   result->SetType(typ);
@@ -216,6 +225,7 @@ std::string BusSpec::ToString() const {
   str << ", dat=" << data_width;
   str << ", step=" << burst_step;
   str << ", max=" << max_burst;
+  str << ", ch=" << channel;
   str << "]";
   return str.str();
 }
@@ -33,6 +33,9 @@ using cerata::PortArray;
 using cerata::integer;
 using cerata::Type;
 
+/// Default maximum number of outstanding requests of a bus arbiter.
+constexpr int DEFAULT_ARBITER_MAX_OUTSTANDING = 4;
+
 // Bus channel classes:
 
 enum class BusFunction {
@@ -48,6 +51,8 @@ struct BusSpec {
   size_t burst_step = 1;
   size_t max_burst = 128;
   BusFunction function = BusFunction::READ;
+  /// Memory channel, i.e. the bus master of the Mantle through which the bus accesses memory.
+  size_t channel = 0;
 
   std::string ToString() const;
   std::string ToBusTypeName() const;
@@ -68,6 +73,8 @@ std::shared_ptr<Type> bus_write(const std::shared_ptr<Node> &addr_width,
 /// @brief Bus port
 struct BusPort : public Port {
   BusSpec spec_;
+  /// Arbitration weight of the port on its arbiter. Ports with a larger weight get more requests granted per round.
+  int weight_ = 1;
   BusPort(Port::Dir dir, BusSpec spec, const std::string &name = "")
       : Port(name.empty() ? "bus" : name, bus(spec), dir), spec_(spec) {}
   static std::shared_ptr<BusPort> Make(std::string name, Port::Dir dir, BusSpec spec);
@@ -102,6 +109,6 @@ std::shared_ptr<Component> BusWriteArbiter();
 template<>
 struct std::hash<fletchgen::BusSpec> {
   size_t operator()(fletchgen::BusSpec const &s) const noexcept {
-    return s.data_width + s.addr_width + s.len_width + s.burst_step + s.max_burst;
+    return s.data_width + s.addr_width + s.len_width + s.burst_step + s.max_burst + (s.channel << 16);
   }
 };
@@ -0,0 +1,158 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fletchgen/cache.h"
+
+#include <fletcher/common.h>
+#include <cerata/api.h>
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "fletchgen/utils.h"
+#include "fletchgen/generator_hash.h"
+
+namespace fletchgen {
+
+/// Name of the file holding the cache entries, inside the cache directory.
+static constexpr char CACHE_FILE[] = "fletchgen.cache";
+
+static std::string ToHex(uint64_t value) {
+  std::stringstream str;
+  str << std::hex << std::setw(16) << std::setfill('0') << value;
+  return str.str();
+}
+
+static void AppendMetadata(std::stringstream *str, const std::shared_ptr<const arrow::KeyValueMetadata> &meta) {
+  if (meta == nullptr) {
+    return;
+  }
+  for (int64_t i = 0; i < meta->size(); i++) {
+    *str << "[" << meta->key(i) << "=" << meta->value(i) << "]";
+  }
+}
+
+static void AppendField(std::stringstream *str, const arrow::Field &field) {
+  *str << "(" << field.name() << ":" << field.type()->ToString() << (field.nullable() ? "?" : "");
+  AppendMetadata(str, field.metadata());
+  for (const auto &child : field.type()->children()) {
+    AppendField(str, *child);
+  }
+  *str << ")";
+}
+
+static std::string OptionsString(const Options &options) {
+  std::stringstream str;
+  // Options that change the generated components. Autotuning changes the schemas, so the RecordBatches it is based on
+  // are covered by the schema fingerprints.
+  str << FLETCHGEN_GENERATOR_HASH << ":" << options.kernel_name << ":" << options.autotune << ":"
+      << options.target_bandwidth;
+  return str.str();
+}
+
+static std::string SchemaString(const arrow::Schema &schema) {
+  std::stringstream str;
+  AppendMetadata(&str, schema.metadata());
+  for (const auto &field : schema.fields()) {
+    AppendField(&str, *field);
+  }
+  return str.str();
+}
+
+std::string Fingerprint(const arrow::Schema &schema, const Options &options) {
+  return ToHex(cerata::ContentHash(OptionsString(options) + SchemaString(schema)));
+}
+
+std::string Fingerprint(const SchemaSet &schema_set, const Options &options) {
+  std::stringstream str;
+  str << OptionsString(options) << schema_set.name();
+  for (const auto &fs : schema_set.schemas()) {
+    str << "{" << SchemaString(*fs->arrow_schema()) << "}";
+  }
+  return ToHex(cerata::ContentHash(str.str()));
+}
+
+Cache Cache::Load(const std::string &dir) {
+  Cache result(dir);
+  std::ifstream file(dir + "/" + CACHE_FILE);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::stringstream str(line);
+    std::string key;
+    Entry entry;
+    str >> key >> entry.fingerprint >> std::hex >> entry.hash >> std::ws;
+    std::getline(str, entry.path);
+    if (str.fail() || key.empty() || entry.path.empty()) {
+      FLETCHER_LOG(WARNING, "Ignoring malformed cache entry: " + line);
+      continue;
+    }
+    result.entries_[key] = entry;
+  }
+  FLETCHER_LOG(DEBUG, "Loaded " + std::to_string(result.entries_.size()) + " cache entries from " + dir);
+  return result;
+}
+
+void Cache::Save() const {
+  cerata::CreateDir(dir_);
+  std::stringstream str;
+  for (const auto &e : entries_) {
+    str << e.first << " " << e.second.fingerprint << " " << ToHex(e.second.hash) << " " << e.second.path << "\n";
+  }
+  cerata::WriteIfChanged(dir_ + "/" + CACHE_FILE, str.str());
+}
+
+std::deque<cerata::OutputSpec> Cache::Stale(const std::deque<cerata::OutputSpec> &outputs,
+                                            const std::string &subdir) const {
+  std::deque<cerata::OutputSpec> result;
+  for (const auto &o : outputs) {
+    auto fp = o.meta.find(FINGERPRINT);
+    auto entry = entries_.find(subdir + "/" + o.comp->name());
+    if ((fp == o.meta.end()) || (entry == entries_.end()) || (entry->second.fingerprint != fp->second)) {
+      result.push_back(o);
+      continue;
+    }
+    // The inputs did not change, but the file might have been modified or deleted.
+    std::ifstream file(entry->second.path, std::ios::binary);
+    if (!file.is_open()) {
+      result.push_back(o);
+      continue;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    if (cerata::ContentHash(contents.str()) != entry->second.hash) {
+      result.push_back(o);
+      continue;
+    }
+    FLETCHER_LOG(INFO, "Cache: " + entry->second.path + " is up to date.");
+  }
+  return result;
+}
+
+void Cache::Update(const std::deque<cerata::OutputSpec> &outputs, cerata::OutputGenerator *generator) {
+  const auto &manifest = generator->manifest();
+  for (size_t i = 0; (i < outputs.size()) && (i < manifest.size()); i++) {
+    auto fp = outputs[i].meta.find(FINGERPRINT);
+    auto key = generator->subdir() + "/" + outputs[i].comp->name();
+    if (fp == outputs[i].meta.end()) {
+      entries_.erase(key);
+    } else {
+      entries_[key] = {fp->second, manifest[i].path, manifest[i].hash};
+    }
+  }
+}
+
+}  // namespace fletchgen
@@ -0,0 +1,91 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <arrow/api.h>
+#include <cerata/api.h>
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "fletchgen/schema.h"
+#include "fletchgen/options.h"
+
+namespace fletchgen {
+
+/// OutputSpec metadata key holding the fingerprint of the inputs a component was generated from.
+constexpr char FINGERPRINT[] = "fletchgen_fingerprint";
+
+/**
+ * @brief Return a fingerprint of an Arrow schema, covering all fields, types and (Fletcher) metadata.
+ *
+ * Fingerprints also cover the sources fletchgen was built from and the options that change the generated components.
+ */
+std::string Fingerprint(const arrow::Schema &schema, const Options &options = Options());
+
+/// @brief Return a fingerprint of a SchemaSet, covering its name and all its schemas.
+std::string Fingerprint(const SchemaSet &schema_set, const Options &options = Options());
+
+/**
+ * @brief A persistent cache of the files generated by previous runs, keyed by the fingerprint of their inputs.
+ *
+ * An output does not have to be regenerated when the fingerprint of the component it was generated from is equal to
+ * the cached fingerprint, and the file on disk still has the contents that were generated. Fingerprints include a hash
+ * of the fletchgen sources, such that another build of fletchgen invalidates the whole cache.
+ */
+class Cache {
+ public:
+  /// @brief A file generated by a previous run.
+  struct Entry {
+    /// The fingerprint of the component the file was generated from.
+    std::string fingerprint;
+    /// The path of the generated file.
+    std::string path;
+    /// The content hash of the generated file.
+    uint64_t hash = 0;
+  };
+
+  explicit Cache(std::string dir) : dir_(std::move(dir)) {}
+
+  /// @brief Load the cache from a directory. Returns an empty cache if the directory holds no cache yet.
+  static Cache Load(const std::string &dir);
+
+  /// @brief Save the cache to its directory.
+  void Save() const;
+
+  /**
+   * @brief Return the outputs that must be (re)generated by an output generator.
+   * @param outputs   All outputs. Outputs without a fingerprint are always regenerated.
+   * @param subdir    The subdirectory of the output generator.
+   * @return          The outputs of which the inputs or the generated files changed.
+   */
+  std::deque<cerata::OutputSpec> Stale(const std::deque<cerata::OutputSpec> &outputs,
+                                       const std::string &subdir) const;
+
+  /// @brief Record the files an output generator produced for its outputs.
+  void Update(const std::deque<cerata::OutputSpec> &outputs, cerata::OutputGenerator *generator);
+
+  /// @brief Return the cache entries, keyed by subdirectory and component name.
+  const std::map<std::string, Entry> &entries() const { return entries_; }
+
+ private:
+  std::string dir_;
+  std::map<std::string, Entry> entries_;
+};
+
+}  // namespace fletchgen
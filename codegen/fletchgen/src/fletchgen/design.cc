@@ -20,6 +20,8 @@
 #include "fletcher/common.h"
 #include "fletchgen/design.h"
 #include "fletchgen/recordbatch.h"
+#include "fletchgen/cache.h"
+#include "fletchgen/throughput.h"
 
 namespace fletchgen {
 
@@ -54,6 +56,12 @@ fletchgen::Design fletchgen::Design::GenerateFrom(const std::shared_ptr<Options>
 
   ret.schema_set->Sort();
 
+  // Optionally tune the Fletcher metadata of the schemas to reach some bandwidth.
+  if (ret.options->autotune) {
+    FLETCHER_LOG(INFO, "Tuning SchemaSet for throughput.");
+    ret.schema_set = Autotune(*ret.schema_set, ret.options->target_bandwidth, ret.options->recordbatches);
+  }
+
   // Now that we have every Schema, for every Schema, figure out if there is a RecordBatch in the input options.
   // If there is, add a description of the RecordBatch to this design.
   // If there isn't, create a virtual RecordBatch based on the schema.
@@ -84,15 +92,20 @@ fletchgen::Design fletchgen::Design::GenerateFrom(const std::shared_ptr<Options>
 std::deque<OutputSpec> Design::GetOutputSpec() {
   std::deque<OutputSpec> result;
 
+  // The Mantle and Kernel depend on all schemas, the readers only on their own.
+  auto set_fingerprint = Fingerprint(*schema_set, *options);
+
   OutputSpec omantle, okernel;
   // Mantle
   omantle.comp = mantle;
   omantle.meta[cerata::vhdl::metakeys::OVERWRITE_FILE] = "true";
+  omantle.meta[FINGERPRINT] = set_fingerprint;
   result.push_back(omantle);
 
   // Kernel
   okernel.comp = kernel;
   okernel.meta[cerata::vhdl::metakeys::OVERWRITE_FILE] = "false";
+  okernel.meta[FINGERPRINT] = set_fingerprint;
   result.push_back(okernel);
 
   // Readers
@@ -100,6 +113,7 @@ std::deque<OutputSpec> Design::GetOutputSpec() {
     OutputSpec oreader;
     oreader.comp = reader;
     oreader.meta[cerata::vhdl::metakeys::OVERWRITE_FILE] = "true";
+    oreader.meta[FINGERPRINT] = Fingerprint(*reader->fletcher_schema()->arrow_schema(), *options);
     result.push_back(oreader);
   }
 
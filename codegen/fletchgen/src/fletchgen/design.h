@@ -38,10 +38,11 @@ struct Design {
   std::shared_ptr<SchemaSet> schema_set;
   std::vector<fletcher::RecordBatchDescription> batch_desc;
 
-  std::deque<std::shared_ptr<Component>> readers;
+  std::deque<std::shared_ptr<RecordBatch>> readers;
   std::shared_ptr<Kernel> kernel;
   std::shared_ptr<Mantle> mantle;
 
+  /// @brief Return the output specification of all components, including the fingerprints of their inputs.
   std::deque<cerata::OutputSpec> GetOutputSpec();
 };
 
@@ -16,11 +16,15 @@
 #include <fletcher/common.h>
 
 #include <fstream>
+#include <optional>
 
 #include "fletchgen/options.h"
+#include "fletchgen/cache.h"
 #include "fletchgen/design.h"
 #include "fletchgen/utils.h"
+#include "fletchgen/throughput.h"
 #include "fletchgen/hls/vivado.h"
+#include "fletchgen/host/regmap.h"
 #include "fletchgen/srec/recordbatch.h"
 #include "fletchgen/top/sim.h"
 
@@ -48,27 +52,98 @@ int main(int argc, char **argv) {
     FLETCHER_LOG(ERROR, "No schemas detected. Cannot generate design.");
   }
 
+  // Generate throughput report
+  if (options->throughput_report && (design.schema_set != nullptr)) {
+    auto report_path = options->output_dir + "/" + options->kernel_name + "_throughput.txt";
+    FLETCHER_LOG(INFO, "Generating throughput report: " + report_path);
+    auto report = fletchgen::AnalyzeThroughput(*design.schema_set, options->recordbatches).ToString();
+    FLETCHER_LOG(INFO, "Predicted throughput:\n" + report);
+    auto report_file = std::ofstream(report_path);
+    report_file << report;
+  }
+
+  // Determine the location of every RecordBatch buffer in simulation memory.
+  srec_batch_desc = fletchgen::srec::GetSRECLayout(design.batch_desc,
+                                                   fletchgen::srec::SREC_BUFFER_ALIGN,
+                                                   options->srec_write_capacity);
+
   // Generate SREC output
   if (options->MustGenerateSREC()) {
     FLETCHER_LOG(INFO, "Generating SREC output.");
     auto srec_out = std::ofstream(options->srec_out_path);
-    fletchgen::srec::GenerateReadSREC(design.batch_desc, &srec_batch_desc, &srec_out, 64);
+    fletchgen::srec::GenerateReadSREC(design.batch_desc, srec_batch_desc, &srec_out);
+  }
+
+  // Compare the simulation memory dump with the reference RecordBatches
+  int mismatches = 0;
+  if (options->check_dump && (design.schema_set != nullptr)) {
+    FLETCHER_LOG(INFO, "Comparing simulation memory dump " + options->srec_sim_dump + " with "
+        + options->check_reference_path);
+    std::vector<std::shared_ptr<arrow::RecordBatch>> reference;
+    fletcher::ReadRecordBatchesFromFile(options->check_reference_path, &reference);
+    std::vector<std::shared_ptr<arrow::Schema>> schemas;
+    for (const auto &fletcher_schema : design.schema_set->schemas()) {
+      schemas.push_back(fletcher_schema->arrow_schema());
+    }
+    auto dump = std::ifstream(options->srec_sim_dump);
+    if (dump.good()) {
+      mismatches = fletchgen::srec::CompareSRECDump(&dump, schemas, srec_batch_desc, reference);
+    } else {
+      FLETCHER_LOG(ERROR, "Could not open simulation memory dump " + options->srec_sim_dump);
+      mismatches = 1;
+    }
+  }
+
+  // Load the cache of previous runs, if any.
+  std::optional<fletchgen::Cache> cache;
+  if (!options->cache_dir.empty()) {
+    cache = fletchgen::Cache::Load(options->cache_dir);
   }
 
   // Generate DOT output
   if (options->MustGenerateDOT()) {
     FLETCHER_LOG(INFO, "Generating DOT output.");
-    auto dot = cerata::dot::DOTOutputGenerator(options->output_dir, design.GetOutputSpec());
+    auto dot = cerata::dot::DOTOutputGenerator(options->output_dir);
+    auto outputs = cache ? cache->Stale(design.GetOutputSpec(), dot.subdir()) : design.GetOutputSpec();
+    for (const auto &o : outputs) {
+      dot.AddOutput(o);
+    }
     dot.Generate();
+    if (cache) {
+      cache->Update(outputs, &dot);
+    }
   }
 
   // Generate VHDL output
   if (options->MustGenerateVHDL()) {
     FLETCHER_LOG(INFO, "Generating VHDL output.");
-    auto vhdl = cerata::vhdl::VHDLOutputGenerator(options->output_dir,
-                                                  design.GetOutputSpec(),
-                                                  fletchgen::DEFAULT_NOTICE);
+    auto vhdl = cerata::vhdl::VHDLOutputGenerator(options->output_dir, {}, fletchgen::DEFAULT_NOTICE);
+    auto outputs = cache ? cache->Stale(design.GetOutputSpec(), vhdl.subdir()) : design.GetOutputSpec();
+    for (const auto &o : outputs) {
+      vhdl.AddOutput(o);
+    }
     vhdl.Generate();
+    if (cache) {
+      cache->Update(outputs, &vhdl);
+    }
+  }
+
+  // Generate Verilog output
+  if (options->MustGenerateVerilog()) {
+    FLETCHER_LOG(INFO, "Generating Verilog output.");
+    auto verilog = cerata::verilog::VerilogOutputGenerator(options->output_dir);
+    auto outputs = cache ? cache->Stale(design.GetOutputSpec(), verilog.subdir()) : design.GetOutputSpec();
+    for (const auto &o : outputs) {
+      verilog.AddOutput(o);
+    }
+    verilog.Generate();
+    if (cache) {
+      cache->Update(outputs, &verilog);
+    }
+  }
+
+  if (cache) {
+    cache->Save();
   }
 
   // Generate simulation top level
@@ -95,6 +170,16 @@ int main(int argc, char **argv) {
     hls_template_file << fletchgen::hls::GenerateVivadoHLSTemplate(*design.kernel);
   }
 
+  // Generate C++ register map
+  if (options->regmap) {
+    auto regmap_path = options->output_dir + "/cpp/" + options->kernel_name + "_regs.h";
+    FLETCHER_LOG(INFO, "Generating C++ register map: " + regmap_path);
+    cerata::CreateDir(options->output_dir + "/cpp");
+    auto regmap_file = std::ofstream(regmap_path);
+    auto map = fletchgen::host::RegisterMap::Make(design.batch_desc, options->user_regs);
+    regmap_file << fletchgen::host::GenerateRegisterHeader(options->kernel_name, map);
+  }
+
   // Generate AXI top level
   if (options->axi_top) {
     FLETCHER_LOG(WARNING, "Generating AXI top-level not yet implemented.");
@@ -105,5 +190,5 @@ int main(int argc, char **argv) {
   // Shut down logging
   fletcher::StopLogging();
 
-  return 0;
+  return mismatches == 0 ? 0 : 1;
 }
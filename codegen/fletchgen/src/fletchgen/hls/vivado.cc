@@ -14,27 +14,288 @@
 
 #include "fletchgen/hls/vivado.h"
 
+#include <fletcher/common.h>
+
+#include <deque>
 #include <vector>
 #include <memory>
 #include <string>
+#include <sstream>
 
 #include "fletchgen/schema.h"
 #include "fletchgen/kernel.h"
+#include "fletchgen/array.h"
+
+namespace fletchgen::hls {
+
+std::optional<std::string> GetPacketType(const arrow::DataType &type, int epc) {
+  std::string name;
+  switch (type.id()) {
+    case arrow::Type::BOOL: name = "bool";
+      break;
+    case arrow::Type::INT8: name = "int8";
+      break;
+    case arrow::Type::INT16: name = "int16";
+      break;
+    case arrow::Type::INT32: name = "int32";
+      break;
+    case arrow::Type::INT64: name = "int64";
+      break;
+    case arrow::Type::UINT8: name = "uint8";
+      break;
+    case arrow::Type::UINT16: name = "uint16";
+      break;
+    case arrow::Type::UINT32: name = "uint32";
+      break;
+    case arrow::Type::UINT64: name = "uint64";
+      break;
+    case arrow::Type::HALF_FLOAT: name = "float16";
+      break;
+    case arrow::Type::FLOAT: name = "float32";
+      break;
+    case arrow::Type::DOUBLE: name = "float64";
+      break;
+    case arrow::Type::DATE32: name = "date32";
+      break;
+    case arrow::Type::DATE64: name = "date64";
+      break;
+    default: return std::nullopt;
+  }
+  if (epc > 1) {
+    return "f_m" + name + "<" + std::to_string(epc) + ">";
+  }
+  return "f_" + name;
+}
+
+/// @brief Return the packet type of the length stream of a list-like field.
+static std::string LengthType(const arrow::Field &field) {
+  int lepc = GetLEPC(field);
+  std::string type = lepc > 1 ? "f_mspacket<32, " + std::to_string(lepc) + ">" : "f_size";
+  return field.nullable() ? "nullable<" + type + ">" : type;
+}
+
+static void AddStreams(const arrow::Field &field,
+                       const std::string &name,
+                       int epc,
+                       bool per_row,
+                       std::deque<Stream> *out) {
+  const auto &type = *field.type();
+  switch (type.id()) {
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY: {
+      // The EPC relates to the characters or bytes, as there is no child field.
+      out->push_back({name + "_length", LengthType(field), GetLEPC(field), per_row});
+      auto values = type.id() == arrow::Type::STRING ? "_chars" : "_bytes";
+      out->push_back({name + values, *GetPacketType(*arrow::uint8(), epc), epc, false});
+      break;
+    }
+    case arrow::Type::LIST: {
+      // The EPC of the list relates to its values.
+      out->push_back({name + "_length", LengthType(field), GetLEPC(field), per_row});
+      auto child = type.child(0);
+      AddStreams(*child, name + "_" + child->name(), epc, false, out);
+      break;
+    }
+    case arrow::Type::STRUCT: {
+      for (int i = 0; i < type.num_children(); i++) {
+        auto child = type.child(i);
+        AddStreams(*child, name + "_" + child->name(), GetEPC(*child), per_row, out);
+      }
+      break;
+    }
+    default: {
+      auto packet = GetPacketType(type, epc);
+      if (!packet) {
+        FLETCHER_LOG(WARNING, "Vivado HLS template does not support type " + type.ToString() + " of " + name + ".");
+        break;
+      }
+      out->push_back({name, field.nullable() ? "nullable<" + *packet + ">" : *packet, epc, per_row});
+    }
+  }
+}
+
+std::deque<Stream> GetStreams(const arrow::Field &field, const std::string &prefix) {
+  std::deque<Stream> result;
+  AddStreams(field, prefix, GetEPC(field), true, &result);
+  return result;
+}
 
-std::string fletchgen::hls::GenerateVivadoHLSTemplate(const Kernel &kernel) {
+/// @brief Return the width of the buffer addresses in the command stream of a field.
+static std::string CtrlWidth(const arrow::Field &field) {
+  fletcher::FieldMetadata field_meta;
+  std::vector<fletcher::BufferMetadata> buffer_meta;
+  fletcher::FieldAnalyzer fa(&field_meta, &buffer_meta);
+  fa.Analyze(field);
+  return std::to_string(buffer_meta.size()) + " * BUS_ADDR_WIDTH";
+}
+
+/// @brief Return the width of the tags in the command and unlock streams of a field.
+static std::string TagWidth(const arrow::Field &field) {
+  auto tag_width = fletcher::GetMeta(field, "tag_width");
+  return tag_width.empty() ? "1" : tag_width;
+}
+
+/// @brief Generate a list of function arguments, one per line.
+static std::string GenArguments(const std::deque<Argument> &args, size_t indent) {
   std::stringstream str;
+  for (size_t i = 0; i < args.size(); i++) {
+    if (i > 0) {
+      str << ",\n" << std::string(indent, ' ');
+    }
+    // Keep references next to the name.
+    str << args[i].type << (args[i].type.back() == '&' ? "" : " ") << args[i].name;
+  }
+  return str.str();
+}
 
-  std::vector<Argument> args;
+/// @brief Generate a function definition.
+static void GenFunction(std::stringstream *str,
+                        const std::string &doc,
+                        const std::string &name,
+                        const std::deque<Argument> &args,
+                        const std::string &body) {
+  auto signature = "static void " + name + "(";
+  *str << "/// @brief " << doc << "\n";
+  *str << signature << GenArguments(args, signature.size()) << ") {\n";
+  *str << body;
+  *str << "}\n\n";
+}
 
-  auto ports = kernel.GetAll<FieldPort>();
+/// @brief Generate the body of a process that reads a stream until the last packet.
+static std::string GenReadLoop(const Stream &s) {
+  std::stringstream str;
+  str << "  " << s.name << "_loop:\n";
+  str << "  for (bool last = false; !last;) {\n";
+  str << "#pragma HLS PIPELINE II=1\n";
+  str << "    " << s.type << " packet = " << s.name << ".read();\n";
+  str << "    last = packet.last;\n";
+  str << "    // TODO: Process the packet.\n";
+  str << "  }\n";
+  return str.str();
+}
+
+/// @brief Generate the body of a process that writes a stream, with one element per row if the stream carries rows.
+static std::string GenWriteLoop(const Stream &s) {
+  std::stringstream str;
+  std::string end = "last_index";
+  if (!s.per_row) {
+    end = "num_elements";
+    str << "  // TODO: Set the total number of elements of all lists.\n";
+    str << "  ap_uint<32> num_elements = 0;\n";
+  }
+  str << "  " << s.name << "_loop:\n";
+  str << "  for (ap_uint<32> i = " << (s.per_row ? "first_index" : "0") << "; i < " << end << "; i += " << s.epc
+      << ") {\n";
+  str << "#pragma HLS PIPELINE II=1\n";
+  str << "    " << s.type << " packet;\n";
+  str << "    // TODO: Set the packet data.\n";
+  if (s.epc > 1) {
+    str << "    packet.count = (" << end << " - i < " << s.epc << ") ? " << end << " - i : ap_uint<32>(" << s.epc
+        << ");\n";
+  }
+  str << "    packet.last = (i + " << s.epc << " >= " << end << ");\n";
+  str << "    " << s.name << ".write(packet);\n";
+  str << "  }\n";
+  return str.str();
+}
+
+std::string GenerateVivadoHLSTemplate(const Kernel &kernel) {
+  std::stringstream str;
+
+  if (kernel.schema_set_ == nullptr) {
+    FLETCHER_LOG(ERROR, "Kernel " + kernel.name() + " has no schemas. Cannot generate Vivado HLS template.");
+    return str.str();
+  }
 
-  for (const auto &p : ports) {
-    Argument arg;
-    arg.name = p->name();
-    for (const auto &f : p->field_->Flatten()) {
-      std::cout << f->ToString() << std::endl;
+  str << "// Vivado HLS kernel template generated by Fletchgen.\n";
+  str << "//\n";
+  str << "// Every stream is handled by its own process, such that all streams are drained concurrently.\n\n";
+  str << "#include <hls_stream.h>\n";
+  str << "#include <ap_int.h>\n\n";
+  str << "#include \"fletcher/api.h\"\n\n";
+  str << "constexpr unsigned int BUS_ADDR_WIDTH = 64;\n\n";
+
+  std::deque<Argument> top_ranges;
+  std::deque<Argument> top_ctrl;
+  std::deque<Argument> top_streams;
+  std::stringstream calls;
+
+  for (const auto &fs : kernel.schema_set_->schemas()) {
+    bool read = fs->mode() == fletcher::Mode::READ;
+    auto first = fs->name() + "_firstidx";
+    auto last = fs->name() + "_lastidx";
+    top_ranges.push_back({"ap_uint<32>", first});
+    top_ranges.push_back({"ap_uint<32>", last});
+
+    for (const auto &field : fs->arrow_schema()->fields()) {
+      if (fletcher::MustIgnore(*field)) {
+        continue;
+      }
+      auto name = fs->name() + "_" + field->name();
+      auto cmd_type = "f_command<" + CtrlWidth(*field) + ", " + TagWidth(*field) + ">";
+      Argument ctrl = {"ap_uint<" + CtrlWidth(*field) + ">", "ctrl"};
+      Argument cmd = {"hls::stream<" + cmd_type + "> &", "cmd"};
+      Argument unl = {"hls::stream<f_unlock<" + TagWidth(*field) + ">> &", "unl"};
+      Argument first_index = {"ap_uint<32>", "first_index"};
+      Argument last_index = {"ap_uint<32>", "last_index"};
+
+      top_ctrl.push_back({ctrl.type, name + "_ctrl"});
+      top_streams.push_back({cmd.type, name + "_cmd"});
+      top_streams.push_back({unl.type, name + "_unl"});
+
+      // Command and unlock handshakes.
+      GenFunction(&str, "Issue the command of field " + field->name() + " of RecordBatch " + fs->name() + ".",
+                  name + "_command", {first_index, last_index, ctrl, cmd},
+                  "  cmd.write(" + cmd_type + "(first_index, last_index, ctrl));\n");
+      GenFunction(&str, "Wait for the unlock of field " + field->name() + " of RecordBatch " + fs->name() + ".",
+                  name + "_unlock", {unl},
+                  "  unl.read();\n");
+      calls << "  " << name << "_command(" << first << ", " << last << ", " << name << "_ctrl, " << name
+            << "_cmd);\n";
+
+      // Data streams.
+      for (const auto &s : GetStreams(*field, name)) {
+        Argument stream = {"hls::stream<" + s.type + "> &", s.name};
+        top_streams.push_back(stream);
+        if (read) {
+          GenFunction(&str, "Read stream " + s.name + ".", s.name + "_process", {stream}, GenReadLoop(s));
+          calls << "  " << s.name << "_process(" << s.name << ");\n";
+        } else if (s.per_row) {
+          GenFunction(&str, "Write stream " + s.name + ".", s.name + "_process",
+                      {first_index, last_index, stream}, GenWriteLoop(s));
+          calls << "  " << s.name << "_process(" << first << ", " << last << ", " << s.name << ");\n";
+        } else {
+          GenFunction(&str, "Write stream " + s.name + ".", s.name + "_process", {stream}, GenWriteLoop(s));
+          calls << "  " << s.name << "_process(" << s.name << ");\n";
+        }
+      }
+      calls << "  " << name << "_unlock(" << name << "_unl);\n";
     }
   }
 
+  // Top-level function.
+  std::deque<Argument> top_args = top_ranges;
+  top_args.insert(top_args.end(), top_ctrl.begin(), top_ctrl.end());
+  top_args.insert(top_args.end(), top_streams.begin(), top_streams.end());
+
+  str << "/// @brief Kernel " << kernel.name() << ".\n";
+  auto signature = "void " + kernel.name() + "(";
+  str << signature << GenArguments(top_args, signature.size()) << ") {\n";
+  str << "#pragma HLS INTERFACE s_axilite port=return\n";
+  for (const auto &a : top_ranges) {
+    str << "#pragma HLS INTERFACE s_axilite port=" << a.name << "\n";
+  }
+  for (const auto &a : top_ctrl) {
+    str << "#pragma HLS INTERFACE s_axilite port=" << a.name << "\n";
+  }
+  for (const auto &a : top_streams) {
+    str << "#pragma HLS INTERFACE axis port=" << a.name << "\n";
+  }
+  str << "#pragma HLS DATAFLOW\n\n";
+  str << calls.str();
+  str << "}\n";
+
   return str.str();
 }
+
+}  // namespace fletchgen::hls
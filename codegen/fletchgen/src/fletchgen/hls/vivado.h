@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <arrow/api.h>
+
+#include <deque>
+#include <optional>
 #include <string>
 #include <memory>
 
@@ -22,11 +26,40 @@
 
 namespace fletchgen::hls {
 
+/// @brief An argument of a generated HLS function.
 struct Argument {
   std::string type;
   std::string name;
 };
 
-std::string GenerateVivadoHLSTemplate(const Kernel& kernel);
+/// @brief An HLS stream derived from an Arrow field.
+struct Stream {
+  /// Name of the stream.
+  std::string name;
+  /// Packet type of the stream.
+  std::string type;
+  /// Number of elements per packet.
+  int epc = 1;
+  /// Whether the stream carries one element per row, as opposed to the values of lists.
+  bool per_row = true;
+};
+
+/// @brief Return the name of the HLS packet type of an Arrow type with \p epc elements per packet, if any.
+std::optional<std::string> GetPacketType(const arrow::DataType &type, int epc = 1);
+
+/// @brief Return the HLS streams of an Arrow field, with names prefixed by \p prefix.
+std::deque<Stream> GetStreams(const arrow::Field &field, const std::string &prefix);
+
+/**
+ * @brief Generate a Vivado HLS kernel template.
+ *
+ * The top-level function is a DATAFLOW region. Every field has a process that issues its command and a process that
+ * waits for its unlock. Every stream has its own process with a loop pipelined with II=1, such that all streams are
+ * drained concurrently.
+ *
+ * @param kernel  The kernel to generate the template for.
+ * @return        The template source.
+ */
+std::string GenerateVivadoHLSTemplate(const Kernel &kernel);
 
 }  // namespace fletchgen::hls
@@ -0,0 +1,263 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fletchgen/host/regmap.h"
+
+#include <fletcher/fletcher.h>
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace fletchgen::host {
+
+std::string ToIdentifier(const std::string &str) {
+  std::string result;
+  for (char c : str) {
+    if (std::isalnum(static_cast<unsigned char>(c))) {
+      result += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    } else if (!result.empty() && (result.back() != '_')) {
+      result += '_';
+    }
+  }
+  while (!result.empty() && (result.back() == '_')) {
+    result.pop_back();
+  }
+  if (result.empty() || std::isdigit(static_cast<unsigned char>(result.front()))) {
+    result = "R" + result;
+  }
+  return result;
+}
+
+/// @brief Return a name that is not in the set of used names, and add it to the set.
+static std::string UniqueName(const std::string &name, std::unordered_set<std::string> *used) {
+  std::string result = name;
+  for (int i = 1; used->count(result) > 0; i++) {
+    result = name + "_" + std::to_string(i);
+  }
+  used->insert(result);
+  return result;
+}
+
+/// @brief Names and descriptions of the profile counter registers of a field, in register order.
+static constexpr const char *PROFILE_COUNTERS[][2] = {{"BUSY_CYCLES", "busy cycles"},
+                                                      {"REQ_BEATS", "bus request beats"},
+                                                      {"DAT_BEATS", "bus data beats"},
+                                                      {"STALL_CYCLES", "stall cycles"},
+                                                      {"BYTES", "bytes transferred"}};
+static_assert(sizeof(PROFILE_COUNTERS) / sizeof(PROFILE_COUNTERS[0]) == FLETCHER_PROFILE_COUNTERS,
+              "Profile counters must match the runtime.");
+
+uint32_t RegisterMap::num_regs() const {
+  return FLETCHER_REG_SCHEMA + ranges.size() + buffers.size() + bursts.size() + counters.size() + user.size();
+}
+
+RegisterMap RegisterMap::Make(const std::vector<fletcher::RecordBatchDescription> &batches,
+                              const std::vector<std::string> &user_regs) {
+  RegisterMap map;
+  // The default register names are reserved.
+  std::unordered_set<std::string> used = {"CONTROL", "STATUS", "RETURN0", "RETURN1",
+                                          "NUM_RECORDBATCHES", "NUM_BUFFERS", "NUM_REGS"};
+  std::unordered_set<std::string> rb_names;
+
+  for (const auto &rb : batches) {
+    map.num_buffers += rb.buffers.size();
+    map.recordbatches.push_back(UniqueName(ToIdentifier(rb.name), &rb_names));
+  }
+
+  uint32_t offset = FLETCHER_REG_SCHEMA;
+  for (size_t r = 0; r < batches.size(); r++) {
+    const auto &rb_name = map.recordbatches[r];
+    map.ranges.push_back({UniqueName(rb_name + "_FIRSTIDX", &used), offset++, batches[r].name + " first index"});
+    map.ranges.push_back({UniqueName(rb_name + "_LASTIDX", &used), offset++, batches[r].name + " last index"});
+  }
+  for (size_t r = 0; r < batches.size(); r++) {
+    for (const auto &buf : batches[r].buffers) {
+      auto buf_name = map.recordbatches[r] + "_" + ToIdentifier(buf.desc_);
+      auto desc = batches[r].name + " " + buf.desc_;
+      map.buffers.push_back({UniqueName(buf_name + "_LO", &used), offset++, desc + " address (low)"});
+      map.buffers.push_back({UniqueName(buf_name + "_HI", &used), offset++, desc + " address (high)"});
+    }
+  }
+  for (size_t r = 0; r < batches.size(); r++) {
+    for (const auto &field : batches[r].fields) {
+      if (field.burst_reg_) {
+        auto reg_name = map.recordbatches[r] + "_" + ToIdentifier(field.name_) + "_BURST_MAX_LEN";
+        auto desc = batches[r].name + " " + field.name_ + " maximum burst length";
+        map.bursts.push_back({UniqueName(reg_name, &used), offset++, desc});
+      }
+    }
+  }
+  for (size_t r = 0; r < batches.size(); r++) {
+    for (const auto &field : batches[r].fields) {
+      if (field.profile_) {
+        auto reg_name = map.recordbatches[r] + "_" + ToIdentifier(field.name_);
+        auto desc = batches[r].name + " " + field.name_;
+        for (const auto &c : PROFILE_COUNTERS) {
+          map.counters.push_back({UniqueName(reg_name + "_" + c[0], &used), offset++, desc + " " + c[1]});
+        }
+      }
+    }
+  }
+  for (const auto &u : user_regs) {
+    map.user.push_back({UniqueName("USER_" + ToIdentifier(u), &used), offset++, u});
+  }
+  return map;
+}
+
+/// @brief Convert an upper case identifier to camel case, e.g. FOO_BAR to FooBar.
+static std::string ToCamelCase(const std::string &identifier) {
+  std::string result;
+  bool upper = true;
+  for (char c : identifier) {
+    if (c == '_') {
+      upper = true;
+    } else {
+      result += upper ? c : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      upper = false;
+    }
+  }
+  return result;
+}
+
+static void GenConstant(std::stringstream *str, const Register &reg) {
+  *str << "/// " << reg.desc << "\n";
+  *str << "constexpr uint32_t " << reg.name << " = " << reg.offset << ";\n";
+}
+
+std::string GenerateRegisterHeader(const std::string &kernel_name, const RegisterMap &map) {
+  std::stringstream str;
+  auto ns = ToIdentifier(kernel_name);
+  std::transform(ns.begin(), ns.end(), ns.begin(), [](unsigned char c) { return std::tolower(c); });
+  ns += "_mmio";
+
+  str << "// This file was generated by Fletchgen. Modifications will be lost.\n";
+  str << "//\n";
+  str << "// MMIO register map of kernel " << kernel_name << ".\n\n";
+  str << "#pragma once\n\n";
+  str << "#include <array>\n";
+  str << "#include <cstdint>\n";
+  str << "#include <memory>\n";
+  str << "#include <utility>\n\n";
+  str << "#include <fletcher/api.h>\n\n";
+  str << "namespace " << ns << " {\n\n";
+
+  str << "// Default registers\n";
+  str << "constexpr uint32_t CONTROL = FLETCHER_REG_CONTROL;\n";
+  str << "constexpr uint32_t STATUS = FLETCHER_REG_STATUS;\n";
+  str << "constexpr uint32_t RETURN0 = FLETCHER_REG_RETURN0;\n";
+  str << "constexpr uint32_t RETURN1 = FLETCHER_REG_RETURN1;\n\n";
+
+  str << "// RecordBatch ranges\n";
+  for (const auto &r : map.ranges) {
+    GenConstant(&str, r);
+  }
+  str << "\n// Buffer addresses\n";
+  for (const auto &b : map.buffers) {
+    GenConstant(&str, b);
+  }
+  str << "\n// Burst lengths\n";
+  for (const auto &b : map.bursts) {
+    GenConstant(&str, b);
+  }
+  str << "\n// Profile counters (read-only)\n";
+  for (const auto &c : map.counters) {
+    GenConstant(&str, c);
+  }
+  str << "\n// User registers\n";
+  for (const auto &u : map.user) {
+    GenConstant(&str, u);
+  }
+  str << "\n";
+  str << "constexpr uint32_t NUM_RECORDBATCHES = " << map.recordbatches.size() << ";\n";
+  str << "constexpr uint32_t NUM_BUFFERS = " << map.num_buffers << ";\n";
+  str << "constexpr uint32_t NUM_REGS = " << map.num_regs() << ";\n\n";
+
+  // The launcher keeps a copy of all registers following the default registers.
+  str << "/// @brief Programs all writable registers of the " << kernel_name << " kernel with batched writes.\n";
+  str << "class Launcher {\n";
+  str << " public:\n";
+  str << "  explicit Launcher(std::shared_ptr<fletcher::Context> context) : context_(std::move(context)) {}\n\n";
+
+  for (size_t r = 0; r < map.recordbatches.size(); r++) {
+    const auto &first = map.ranges[2 * r];
+    const auto &last = map.ranges[2 * r + 1];
+    str << "  /// @brief Set the range of rows [first, last) of RecordBatch " << map.recordbatches[r] << ".\n";
+    str << "  void Set" << ToCamelCase(map.recordbatches[r]) << "Range(int32_t first, int32_t last) {\n";
+    str << "    regs_[" << first.name << " - FLETCHER_REG_SCHEMA] = static_cast<freg_t>(first);\n";
+    str << "    regs_[" << last.name << " - FLETCHER_REG_SCHEMA] = static_cast<freg_t>(last);\n";
+    str << "  }\n\n";
+  }
+  for (const auto &b : map.bursts) {
+    str << "  /// @brief Set the " << b.desc << " in beats. Zero selects the synthesized maximum.\n";
+    str << "  void Set" << ToCamelCase(b.name) << "(uint32_t beats) {\n";
+    str << "    regs_[" << b.name << " - FLETCHER_REG_SCHEMA] = beats;\n";
+    str << "  }\n\n";
+  }
+  for (const auto &u : map.user) {
+    str << "  /// @brief Set user register " << u.desc << ".\n";
+    str << "  void Set" << ToCamelCase(u.name.substr(5)) << "(uint32_t value) {\n";
+    str << "    regs_[" << u.name << " - FLETCHER_REG_SCHEMA] = value;\n";
+    str << "  }\n\n";
+  }
+
+  str << "  /// @brief Write the ranges, the buffer addresses of the context, the burst lengths and the user registers "
+         "to the device.\n";
+  str << "  fletcher::Status Write() {\n";
+  str << "    if (context_->num_buffers() != NUM_BUFFERS) {\n";
+  str << "      return fletcher::Status::ERROR(\"Context buffers do not match the register map of "
+      << kernel_name << ".\");\n";
+  str << "    }\n";
+  str << "    for (uint32_t i = 0; i < NUM_BUFFERS; i++) {\n";
+  str << "      auto address = context_->device_buffer(i).device_address;\n";
+  str << "      regs_[" << map.ranges.size() << " + 2 * i] = static_cast<freg_t>(address & 0xFFFFFFFF);\n";
+  str << "      regs_[" << map.ranges.size() << " + 2 * i + 1] = static_cast<freg_t>(address >> 32);\n";
+  str << "    }\n";
+  if (map.counters.empty()) {
+    str << "    return context_->platform()->WriteMMIORange(FLETCHER_REG_SCHEMA, regs_.size(), regs_.data());\n";
+  } else {
+    // Skip the read-only profile counters, writing them would reset the counts of the previous run.
+    const auto &counters = map.counters.front();
+    str << "    auto status = context_->platform()->WriteMMIORange(FLETCHER_REG_SCHEMA, " << counters.name
+        << " - FLETCHER_REG_SCHEMA, regs_.data());\n";
+    if (map.user.empty()) {
+      str << "    return status;\n";
+    } else {
+      const auto &user = map.user.front();
+      str << "    if (!status.ok()) return status;\n";
+      str << "    return context_->platform()->WriteMMIORange(" << user.name << ", NUM_REGS - " << user.name
+          << ", &regs_[" << user.name << " - FLETCHER_REG_SCHEMA]);\n";
+    }
+  }
+  str << "  }\n\n";
+
+  str << "  /// @brief Write all registers and start the kernel.\n";
+  str << "  fletcher::Status Launch() {\n";
+  str << "    auto status = Write();\n";
+  str << "    if (!status.ok()) return status;\n";
+  str << "    return context_->platform()->WriteMMIO(CONTROL, 1u << FLETCHER_REG_CONTROL_START);\n";
+  str << "  }\n\n";
+
+  str << " private:\n";
+  str << "  std::shared_ptr<fletcher::Context> context_;\n";
+  str << "  std::array<freg_t, NUM_REGS - FLETCHER_REG_SCHEMA> regs_{};\n";
+  str << "};\n\n";
+  str << "}  // namespace " << ns << "\n";
+  return str.str();
+}
+
+}  // namespace fletchgen::host
@@ -0,0 +1,87 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <fletcher/common.h>
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace fletchgen::host {
+
+/// @brief A single 32-bit MMIO register.
+struct Register {
+  /// Name of the register, used as C++ identifier.
+  std::string name;
+  /// Register index.
+  uint32_t offset;
+  /// Human-readable description.
+  std::string desc;
+};
+
+/**
+ * @brief The MMIO register map of a Mantle.
+ *
+ * The layout follows the runtime: the default registers are followed by the first and last index of every
+ * RecordBatch, the low and high address of every buffer of every RecordBatch, the maximum burst length of every field
+ * with a burst register, the read-only profile counters of every profiled field, and finally the user registers.
+ */
+struct RegisterMap {
+  /// First and last index registers of every RecordBatch, in order.
+  std::deque<Register> ranges;
+  /// Low and high address registers of every buffer, in order.
+  std::deque<Register> buffers;
+  /// Maximum burst length registers of every field with a burst register, in order.
+  std::deque<Register> bursts;
+  /// Profile counter registers of every profiled field, in order.
+  std::deque<Register> counters;
+  /// User registers.
+  std::deque<Register> user;
+  /// Names of the RecordBatches, in order, used as C++ identifiers.
+  std::vector<std::string> recordbatches;
+  /// Total number of buffers.
+  size_t num_buffers = 0;
+
+  /// @brief Return the total number of registers, including the default registers.
+  uint32_t num_regs() const;
+
+  /**
+   * @brief Create the register map of a design.
+   * @param batches   The RecordBatch descriptions of the design, in the order of the Mantle.
+   * @param user_regs Names of the user registers.
+   * @return          The register map.
+   */
+  static RegisterMap Make(const std::vector<fletcher::RecordBatchDescription> &batches,
+                          const std::vector<std::string> &user_regs = {});
+};
+
+/// @brief Convert a string to an upper case C++ identifier.
+std::string ToIdentifier(const std::string &str);
+
+/**
+ * @brief Generate a C++ header with the register map and a typed launcher for a kernel.
+ *
+ * The launcher programs all RecordBatch ranges, buffer addresses, burst lengths and user registers of a
+ * fletcher::Context with a single batched MMIO write.
+ *
+ * @param kernel_name The name of the kernel.
+ * @param map         The register map.
+ * @return            The header source.
+ */
+std::string GenerateRegisterHeader(const std::string &kernel_name, const RegisterMap &map);
+
+}  // namespace fletchgen::host
@@ -17,6 +17,7 @@
 #include <cerata/api.h>
 #include <fletcher/common.h>
 
+#include <algorithm>
 #include <unordered_map>
 #include <memory>
 #include <deque>
@@ -32,7 +33,12 @@
 namespace fletchgen {
 
 static std::string ArbiterMasterName(BusSpec spec) {
-  return std::string(spec.function == BusFunction::READ ? "rd" : "wr") + "_mst";
+  auto name = std::string(spec.function == BusFunction::READ ? "rd" : "wr") + "_mst";
+  // Keep the name of the master of the first memory channel the same as when there was only one.
+  if (spec.channel > 0) {
+    name += "_ch" + std::to_string(spec.channel);
+  }
+  return name;
 }
 
 Mantle::Mantle(std::string name, std::shared_ptr<SchemaSet> schema_set)
@@ -60,6 +66,7 @@ Mantle::Mantle(std::string name, std::shared_ptr<SchemaSet> schema_set)
 
   // Create and add the kernel.
   kernel_ = Kernel::Make(schema_set_->name(), cerata::ToRawPointers(recordbatch_components()));
+  kernel_->schema_set_ = schema_set_;
   kernel_inst_ = AddInstanceOf(kernel_.get());
   kernel_inst_->port("kcd") <<= kcr;
   kernel_inst_->port("mmio") <<= regs;
@@ -75,9 +82,9 @@ Mantle::Mantle(std::string name, std::shared_ptr<SchemaSet> schema_set)
         } else {
           Connect(fp, kernel_inst_->port(fp->name()));
         }
-      } else if (fp->function_ == FieldPort::Function::COMMAND) {
+      } else if ((fp->function_ == FieldPort::Function::COMMAND) || (fp->function_ == FieldPort::Function::BURST)) {
         Connect(fp, kernel_inst_->port(fp->name()));
-      } else if (fp->function_ == FieldPort::Function::UNLOCK) {
+      } else if ((fp->function_ == FieldPort::Function::UNLOCK) || (fp->function_ == FieldPort::Function::PROFILE)) {
         Connect(kernel_inst_->port(fp->name()), fp);
       }
     }
@@ -90,16 +97,16 @@ Mantle::Mantle(std::string name, std::shared_ptr<SchemaSet> schema_set)
   for (const auto &r : recordbatch_instances_) {
     auto r_bus_ports = r->GetAll<BusPort>();
     for (const auto &b : r_bus_ports) {
-      bus_specs.push_back(b->spec_);
+      // Leave only unique bus specs.
+      if (std::find(bus_specs.begin(), bus_specs.end(), b->spec_) == bus_specs.end()) {
+        bus_specs.push_back(b->spec_);
+      }
       bus_ports.push_back(b);
     }
   }
 
-  // Leave only unique bus specs.
-  auto last = std::unique(bus_specs.begin(), bus_specs.end());
-  bus_specs.erase(last, bus_specs.end());
-
-  // Generate a BusArbiterVec for every unique bus specification.
+  // Generate a BusArbiterVec for every unique bus specification. Buses on different memory channels have a different
+  // specification, so every channel gets its own arbiter and master port.
   for (const auto &spec : bus_specs) {
     FLETCHER_LOG(DEBUG, "Adding bus arbiter for: " + spec.ToString());
     auto arbiter_instance = BusArbiterInstance(spec);
@@ -115,14 +122,14 @@ Mantle::Mantle(std::string name, std::shared_ptr<SchemaSet> schema_set)
     // Create the bus port on the mantle level.
     auto master = BusPort::Make(ArbiterMasterName(spec), Port::Dir::OUT, spec);
     AddObject(master);
-    // TODO(johanpel): actually support multiple bus specs
     // Connect the arbiter master port to the mantle master port.
     master <<= arbiter->port("mst");
     // Connect the bus clock domain.
     arbiter->port("bcd") <<= bcr;
   }
 
-  // Connect bus ports to the arbiters.
+  // Connect bus ports to the arbiters. Remember their weights in the order of the arbiter slave ports.
+  std::unordered_map<BusSpec, std::deque<int>> weights;
   for (const auto &bp : bus_ports) {
     // Get the arbiter port.
     auto arbiter = arbiters_.at(bp->spec_);
@@ -131,6 +138,28 @@ Mantle::Mantle(std::string name, std::shared_ptr<SchemaSet> schema_set)
     auto mapper = TypeMapper::MakeImplicit(bp->type(), arbiter_port_array->type());
     bp->type()->AddMapper(mapper);
     Connect(arbiter_port_array->Append(), bp);
+    weights[bp->spec_].push_back(bp->weight_);
+  }
+
+  // Arbiters of which the ports are not weighted equally use weighted round-robin arbitration.
+  for (const auto &w : weights) {
+    const auto &port_weights = w.second;
+    if (std::all_of(port_weights.begin(), port_weights.end(), [&](int x) { return x == port_weights.front(); })) {
+      continue;
+    }
+    std::string weight_list;
+    int total = 0;
+    for (const auto &x : port_weights) {
+      weight_list += (weight_list.empty() ? "" : ",") + std::to_string(x);
+      total += x;
+    }
+    FLETCHER_LOG(DEBUG, "Weighted arbitration for: " + w.first.ToString() + " weights: " + weight_list);
+    auto arbiter = arbiters_.at(w.first);
+    arbiter->par("ARB_METHOD") <<= cerata::strl("WEIGHTED");
+    arbiter->par("SLV_WEIGHTS") <<= cerata::strl(weight_list);
+    // The arbiters keep the outstanding requests of all slave ports in a single FIFO, so there is no depth per port.
+    // Size it such that a full round of requests, in which every port issues as many requests as its weight, fits.
+    arbiter->par("MAX_OUTSTANDING") <<= intl(std::max(DEFAULT_ARBITER_MAX_OUTSTANDING, total));
   }
 }
 
@@ -42,18 +42,37 @@ int Options::Parse(Options *options, int argc, char **argv) {
                  "SREC simulation output file.");
   app.add_option("-t,--srec_dump", options->srec_sim_dump,
                  "File to dump memory contents to in SREC format after simulation.");
+  app.add_option("--srec_write_capacity", options->srec_write_capacity,
+                 "Number of bytes to reserve in simulation memory for every buffer of RecordBatches that the kernel "
+                 "writes. (Default: 1 MiB)");
+
+  // Subcommand to check simulation results:
+  auto check = app.add_subcommand("check",
+                                  "Compare the RecordBatches that the kernel wrote into the simulation memory dump "
+                                  "(--srec_dump) with reference RecordBatches. Requires the same schemas and "
+                                  "RecordBatches as used to generate the simulation.");
+  check->add_option("reference", options->check_reference_path,
+                    "Flatbuffer file with the reference Arrow RecordBatches.")
+      ->required()
+      ->check(CLI::ExistingFile);
+  check->fallthrough();
 
   // Output options:
   app.add_option("-o,--output_path", options->output_dir,
                  "Path to the output directory to place the generated files. (Default: . )")
       ->check(CLI::ExistingDirectory);
 
+  app.add_option("-c,--cache_dir", options->cache_dir,
+                 "Directory to cache fingerprints of the inputs of generated files in. Files of which the inputs did "
+                 "not change since the previous run with the same cache directory are not regenerated.");
+
   app.add_option("-l,--language", options->languages,
                  "Select the output languages for your design. Each type of output will be stored in a "
                  "seperate subfolder (e.g. <output folder>/vhdl/...). \n"
                  "                                        Available languages:\n"
-                 "                                          vhdl: Export as VHDL files (default).\n"
-                 "                                          dot : Export as DOT graphs.");
+                 "                                          vhdl   : Export as VHDL files (default).\n"
+                 "                                          dot    : Export as DOT graphs.\n"
+                 "                                          verilog: Export as Verilog files, e.g. for Verilator.");
 
   app.add_flag("-f,--force", options->overwrite,
                "Force overwriting source code files if they exists already. If this flag is *not* used and the source "
@@ -66,6 +85,20 @@ int Options::Parse(Options *options, int argc, char **argv) {
                "Generate simulation top-level template (VHDL only).");
   app.add_flag("--vivado_hls", options->vivado_hls,
                "Generate a Vivado HLS kernel template.");
+  app.add_flag("--regmap", options->regmap,
+               "Generate a C++ header with the MMIO register map and a typed launcher for the kernel.");
+  app.add_option("--user_regs", options->user_regs,
+                 "Names of the user registers of the kernel, in order, for --regmap.");
+
+  // Throughput options:
+  app.add_flag("--throughput", options->throughput_report,
+               "Generate a report of the predicted bus throughput of every field. Supply RecordBatches with -r to "
+               "take the average length of list and string fields into account.");
+  app.add_flag("--autotune", options->autotune,
+               "Tune the elements-per-cycle of fields and the maximum burst length of the buses to reach the target "
+               "bandwidth according to the throughput model.");
+  app.add_option("--target_bandwidth", options->target_bandwidth,
+                 "Target bandwidth in bytes per cycle for --autotune. (Default: 0, saturate the buses)");
 
   // Other options:
   // TODO(johanpel): implement the quiet and verbose options
@@ -78,6 +111,8 @@ int Options::Parse(Options *options, int argc, char **argv) {
 
   CLI11_PARSE(app, argc, argv)
 
+  options->check_dump = app.got_subcommand(check);
+
   // Load input files
   options->LoadRecordBatches();
   options->LoadSchemas();
@@ -113,6 +148,10 @@ bool Options::MustGenerateDOT() const {
   return HasLanguage(languages, "dot") && Options::MustGenerateDesign();
 }
 
+bool Options::MustGenerateVerilog() const {
+  return HasLanguage(languages, "verilog") && Options::MustGenerateDesign();
+}
+
 bool Options::MustGenerateDesign() const {
   return !schemas.empty() || !recordbatches.empty();
 }
@@ -36,12 +36,22 @@ struct Options {
   /// Output directory
   std::string output_dir = ".";
 
+  /// Cache directory for incremental generation. Caching is disabled if empty.
+  std::string cache_dir;
+
   /// Output languages
   std::vector<std::string> languages = {"vhdl", "dot"};
 
   /// SREC output path
   std::string srec_out_path = "\"\"";
   std::string srec_sim_dump = "\"\"";
+  /// Bytes reserved in simulation memory for every buffer of a RecordBatch written by the kernel
+  int64_t srec_write_capacity = 1 << 20;
+
+  /// Compare the RecordBatches in the simulation memory dump with reference RecordBatches
+  bool check_dump = false;
+  /// Path to the reference RecordBatches
+  std::string check_reference_path;
 
   /// Name of the Kernel
   std::string kernel_name = "Kernel";
@@ -53,6 +63,18 @@ struct Options {
   /// Vivado HLS template
   bool vivado_hls = false;
 
+  /// C++ register map header and launcher
+  bool regmap = false;
+  /// Names of the user registers following the buffer address registers
+  std::vector<std::string> user_regs;
+
+  /// Throughput report
+  bool throughput_report = false;
+  /// Tune EPC and burst parameters to reach the target bandwidth
+  bool autotune = false;
+  /// Target bandwidth in bytes per cycle for autotuning. Tune until the buses are saturated if zero.
+  double target_bandwidth = 0.0;
+
   bool quiet = false;
   bool verbose = false;
 
@@ -75,6 +97,8 @@ struct Options {
   bool MustGenerateVHDL() const;
   /// @brief Return true if the design must be outputted as DOT.
   bool MustGenerateDOT() const;
+  /// @brief Return true if the design must be outputted as Verilog.
+  bool MustGenerateVerilog() const;
 
   /// @brief Load all specified RecordBatches
   void LoadRecordBatches();
@@ -15,6 +15,7 @@
 #include "fletchgen/recordbatch.h"
 
 #include <cerata/api.h>
+#include <algorithm>
 #include <memory>
 #include <deque>
 
@@ -29,6 +30,7 @@ using cerata::Component;
 using cerata::Port;
 using cerata::Literal;
 using cerata::intl;
+using cerata::booll;
 
 RecordBatch::RecordBatch(const std::shared_ptr<FletcherSchema> &fletcher_schema)
     : Component(fletcher_schema->name()), fletcher_schema_(fletcher_schema) {
@@ -79,6 +81,32 @@ void RecordBatch::AddArrays(const FletcherSchema &fletcher_schema) {
       auto cfg_node = array_inst->GetNode(Node::NodeID::PARAMETER, "CFG");
       cfg_node <<= cerata::strl(GenerateConfigString(*field));  // Set the configuration string for this field
 
+      // Override the burst lengths if the field or the schema specifies them.
+      auto burst_max_len = GetBurstMaxLen(*fletcher_schema.arrow_schema(), *field);
+      if (burst_max_len != DEFAULT_BURST_MAX_LEN) {
+        array_inst->par("BUS_BURST_MAX_LEN") <<= intl(burst_max_len);
+      }
+      auto burst_step_len = GetBurstStepLen(*fletcher_schema.arrow_schema(), *field);
+      if (burst_step_len != DEFAULT_BURST_STEP_LEN) {
+        array_inst->par("BUS_BURST_STEP_LEN") <<= intl(burst_step_len);
+      }
+
+      // Drive the burst length limit of the ArrayReader from the top-level, if the field has a burst register.
+      if (fletcher::HasBurstRegister(*fletcher_schema.arrow_schema(), *field)) {
+        auto burst_port = FieldPort::MakeBurstPort(fletcher_schema, field);
+        AddObject(burst_port);
+        array_inst->par("BURST_LIMIT_ENABLE") <<= booll(true);
+        array_inst->port("burst_max_len") <<= burst_port;
+      }
+
+      // Expose the profile counters of the ArrayReader/Writer, if the field is profiled.
+      if (fletcher::HasProfileCounters(*fletcher_schema.arrow_schema(), *field)) {
+        auto profile_port = FieldPort::MakeProfilePort(fletcher_schema, field);
+        AddObject(profile_port);
+        array_inst->par("PROFILE_ENABLE") <<= booll(true);
+        profile_port <<= array_inst->port("prof");
+      }
+
       // Drive the clocks and resets
       Connect(array_inst->port("kcd"), port("kcd"));
       Connect(array_inst->port("bcd"), port("bcd"));
@@ -112,6 +140,9 @@ void RecordBatch::AddArrays(const FletcherSchema &fletcher_schema) {
       // Give the new bus port a unique name
       // TODO(johanpel): move the bus renaming to the Mantle level
       bus->SetName(fletcher_schema.name() + "_" + field->name() + "_" + bus->name());
+      // Select the memory channel the Mantle arbitrates this bus onto.
+      bus->spec_.channel = fletcher::GetBusChannel(*fletcher_schema.arrow_schema(), *field);
+      bus->weight_ = std::max(1, fletcher::GetBusWeight(*fletcher_schema.arrow_schema(), *field));
       AddObject(bus);  // Add them to the RecordBatch
       bus_ports_.push_back(bus);  // Remember the port
       bus <<= array_inst->port("bus");  // Connect them to the ArrayReader/Writer
@@ -120,12 +151,9 @@ void RecordBatch::AddArrays(const FletcherSchema &fletcher_schema) {
 }
 
 std::shared_ptr<FieldPort> RecordBatch::GetArrowPort(const arrow::Field &field) const {
-  for (const auto &n : objects_) {
-    auto ap = std::dynamic_pointer_cast<FieldPort>(n);
-    if (ap != nullptr) {
-      if ((ap->function_ == FieldPort::ARROW) && (ap->field_->Equals(field))) {
-        return ap;
-      }
+  for (const auto &ap : GetAll<FieldPort>()) {
+    if ((ap->function_ == FieldPort::ARROW) && (ap->field_->Equals(field))) {
+      return std::dynamic_pointer_cast<FieldPort>(ap->shared_from_this());
     }
   }
   throw std::runtime_error("Field " + field.name() + " did not generate an ArrowPort for Core " + name() + ".");
@@ -134,12 +162,9 @@ std::shared_ptr<FieldPort> RecordBatch::GetArrowPort(const arrow::Field &field)
 std::deque<std::shared_ptr<FieldPort>>
 RecordBatch::GetFieldPorts(const std::optional<FieldPort::Function> &function) const {
   std::deque<std::shared_ptr<FieldPort>> result;
-  for (const auto &n : objects_) {
-    auto ap = std::dynamic_pointer_cast<FieldPort>(n);
-    if (ap != nullptr) {
-      if ((function && (ap->function_ == *function)) || !function) {
-        result.push_back(ap);
-      }
+  for (const auto &ap : GetAll<FieldPort>()) {
+    if ((function && (ap->function_ == *function)) || !function) {
+      result.push_back(std::dynamic_pointer_cast<FieldPort>(ap->shared_from_this()));
     }
   }
   return result;
@@ -183,6 +208,25 @@ std::shared_ptr<FieldPort> FieldPort::MakeUnlockPort(const FletcherSchema &fs,
                                      Dir::OUT);
 }
 
+std::shared_ptr<FieldPort> FieldPort::MakeBurstPort(const FletcherSchema &fs,
+                                                    const std::shared_ptr<arrow::Field> &field) {
+  BusSpec spec{};
+  return std::make_shared<FieldPort>(fs.name() + "_" + field->name() + "_burst_max_len",
+                                     BURST,
+                                     field,
+                                     burst_max_len(intl(spec.len_width)),
+                                     Dir::IN);
+}
+
+std::shared_ptr<FieldPort> FieldPort::MakeProfilePort(const FletcherSchema &fs,
+                                                      const std::shared_ptr<arrow::Field> &field) {
+  return std::make_shared<FieldPort>(fs.name() + "_" + field->name() + "_prof",
+                                     PROFILE,
+                                     field,
+                                     profile_counters(),
+                                     Dir::OUT);
+}
+
 std::shared_ptr<Node> FieldPort::data_width() {
   std::shared_ptr<Node> width = intl(0);
   // Flatten the type
@@ -38,10 +38,12 @@ using fletcher::Mode;
 /**
  * @brief A port derived from an Arrow field
  *
- * We currently derive three ports from Arrow fields;
+ * We currently derive five ports from Arrow fields;
  *  - a data port for reading/writing from/to Arrow Arrays.
  *  - a command port to issue a command to an ArrayReader/Writer .
  *  - an unlock port to know a command sent to an ArrayReader/Writer was completed.
+ *  - optionally, a port to set the maximum burst length of an ArrayReader at run time.
+ *  - optionally, a port with the profile counters of an ArrayReader/Writer.
  *
  * This structure just helps us remember what function the port has and from what field it was derived.
  * If a FlatType of the type of this port was marked with "array_data" in the Type metadata, it signifies that this
@@ -52,7 +54,9 @@ struct FieldPort : public Port {
   enum Function {
     ARROW,
     COMMAND,
-    UNLOCK
+    UNLOCK,
+    BURST,
+    PROFILE
   } function_;
 
   std::shared_ptr<arrow::Field> field_;
@@ -72,6 +76,10 @@ struct FieldPort : public Port {
                                                     const std::shared_ptr<arrow::Field> &field);
   static std::shared_ptr<FieldPort> MakeUnlockPort(const FletcherSchema &fs,
                                                    const std::shared_ptr<arrow::Field> &field);
+  static std::shared_ptr<FieldPort> MakeBurstPort(const FletcherSchema &fs,
+                                                  const std::shared_ptr<arrow::Field> &field);
+  static std::shared_ptr<FieldPort> MakeProfilePort(const FletcherSchema &fs,
+                                                    const std::shared_ptr<arrow::Field> &field);
 
   std::shared_ptr<Object> Copy() const override;
 
@@ -18,23 +18,30 @@
 #include <cerata/api.h>
 #include <fletcher/common.h>
 
+#include <algorithm>
 #include <deque>
+#include <iterator>
 #include <memory>
 #include <ostream>
+#include <string>
 
 #include "fletchgen/options.h"
 #include "fletchgen/srec/srec.h"
 
 namespace fletchgen::srec {
 
+/// Maximum number of bytes of every buffer to print in the debug log.
+constexpr int64_t DEBUG_HEXVIEW_BYTES = 256;
+
 static inline size_t PaddedLength(size_t size, size_t alignment) {
   return ((size + alignment - 1) / alignment) * alignment;
 }
 
-void GenerateReadSREC(const std::vector<fletcher::RecordBatchDescription> &meta_in,
-                      std::vector<fletcher::RecordBatchDescription> *meta_out,
-                      std::ofstream *out,
-                      int64_t buffer_align) {
+std::vector<fletcher::RecordBatchDescription> GetSRECLayout(
+    const std::vector<fletcher::RecordBatchDescription> &meta_in,
+    int64_t buffer_align,
+    int64_t write_capacity) {
+  std::vector<fletcher::RecordBatchDescription> layout;
   // We need to align each buffer into the SREC stream.
   // We start at offset 0.
   uint64_t offset = 0;
@@ -43,54 +50,271 @@ void GenerateReadSREC(const std::vector<fletcher::RecordBatchDescription> &meta_
     // We can only copy data from physically existing recordbatches into the SREC
     if (!desc_in.is_virtual) {
       desc_out.buffers.clear();
-      FLETCHER_LOG(DEBUG, "RecordBatch " + desc_in.name + " buffers: \n" + desc_in.ToString());
       for (const auto &buf : desc_in.buffers) {
         // May the force be with us
         auto srec_buf_address = reinterpret_cast<uint8_t *>(offset);
         // Determine the place of the buffer in the SREC output
-        desc_out.buffers.emplace_back(srec_buf_address, buf.size_, buf.desc_, buf.level_);
-
-        // Print some debug info
-        auto hv = fletcher::HexView(offset);
-        hv.AddData(buf.raw_buffer_, buf.size_);
-        FLETCHER_LOG(DEBUG, buf.desc_ + "\n" + hv.ToString());
-
+        desc_out.buffers.emplace_back(srec_buf_address, buf.size_, buf.desc_, buf.level_, buf.implicit_);
+        desc_out.buffers.back().channel_ = buf.channel_;
         // Calculate the padded length and calculate the next offset.
-        auto padded_size = PaddedLength(buf.size_, buffer_align);
-        offset = offset + padded_size;
+        offset = offset + PaddedLength(buf.size_, buffer_align);
+      }
+    }
+    layout.push_back(desc_out);
+  }
+  // Reserve space for the buffers of virtual RecordBatches behind the physical ones, so the kernel can write them.
+  for (auto &desc : layout) {
+    if (desc.is_virtual) {
+      for (auto &buf : desc.buffers) {
+        buf.raw_buffer_ = reinterpret_cast<uint8_t *>(offset);
+        buf.size_ = write_capacity;
+        offset = offset + PaddedLength(write_capacity, buffer_align);
       }
     }
-    meta_out->push_back(desc_out);
   }
-  // We have now determined the location of every buffer in the SREC file and we know the total size of the resulting
-  // file in bytes. We must now create the actual SREC file. Calloc some space to serialize the Arrow buffers into.
-  auto srec_buffer = static_cast<uint8_t *>(calloc(1, offset));
+  return layout;
+}
 
-  // Copy over every buffer.
+void GenerateReadSREC(const std::vector<fletcher::RecordBatchDescription> &meta_in,
+                      const std::vector<fletcher::RecordBatchDescription> &layout,
+                      std::ostream *out,
+                      int64_t buffer_align,
+                      size_t num_threads) {
+  if (!out->good()) {
+    FLETCHER_LOG(ERROR, "Output stream unavailable. SREC was not written.");
+    return;
+  }
+  // Stream every buffer and its padding into the SREC file, starting at 0, without copying the buffers into an
+  // intermediate image first.
+  Writer writer(out, num_threads);
+  writer.Header();
   for (size_t r = 0; r < meta_in.size(); r++) {
     if (!meta_in[r].is_virtual) {
+      FLETCHER_LOG(DEBUG, "RecordBatch " + meta_in[r].name + " buffers: \n" + meta_in[r].ToString());
       for (size_t b = 0; b < meta_in[r].buffers.size(); b++) {
-        auto srec_off = reinterpret_cast<size_t>(meta_out->at(r).buffers[b].raw_buffer_);
-        auto dest = srec_buffer + srec_off;
+        auto srec_off = reinterpret_cast<size_t>(layout[r].buffers[b].raw_buffer_);
         auto src = meta_in[r].buffers[b].raw_buffer_;
         auto size = meta_in[r].buffers[b].size_;
-        // skip empty buffers (typically implicit validity buffers)
+        auto padded_size = PaddedLength(size, buffer_align);
+
+        // Print some debug info, limited to the start of the buffer.
         if (src != nullptr) {
-          memcpy(dest, src, size);
+          auto hv = fletcher::HexView(srec_off);
+          hv.AddData(src, std::min(size, DEBUG_HEXVIEW_BYTES));
+          FLETCHER_LOG(DEBUG, meta_in[r].buffers[b].desc_ + "\n" + hv.ToString());
         }
+
+        // Empty buffers (typically implicit validity buffers) are written as zeros.
+        writer.Write(srec_off, src, size);
+        writer.Write(srec_off + size, nullptr, padded_size - size);
       }
     }
   }
+  writer.Flush();
+}
 
-  // Create the SREC file, start at 0
-  srec::File sr(0, srec_buffer, offset);
-  if (out->good()) {
-    sr.write(out);
-  } else {
-    FLETCHER_LOG(ERROR, "Output stream unavailable. SREC was not written.");
+MemoryImage::MemoryImage(std::istream *input) {
+  std::map<uint64_t, std::string> segments;
+  std::string segment;
+  uint64_t segment_address = 0;
+  Reader reader(input);
+  while (reader.Next()) {
+    if ((reader.type() != Record::DATA16) && (reader.type() != Record::DATA24) && (reader.type() != Record::DATA32)) {
+      continue;
+    }
+    // Start a new segment if this record does not directly follow the current one.
+    if (!segment.empty() && (reader.address() != segment_address + segment.size())) {
+      AddSegment(&segments, segment_address, std::move(segment));
+      segment.clear();
+    }
+    if (segment.empty()) {
+      segment_address = reader.address();
+    }
+    segment.append(reinterpret_cast<const char *>(reader.data()), reader.size());
+  }
+  if (!segment.empty()) {
+    AddSegment(&segments, segment_address, std::move(segment));
   }
+  // Hand the segments over to Arrow buffers, without copying.
+  for (auto &s : segments) {
+    segments_[s.first] = arrow::Buffer::FromString(std::move(s.second));
+  }
+}
 
-  free(srec_buffer);
+void MemoryImage::AddSegment(std::map<uint64_t, std::string> *segments, uint64_t address, std::string data) {
+  // Merge any segments that overlap or touch the new segment into it. Data of the new segment takes precedence.
+  uint64_t begin = address;
+  uint64_t end = address + data.size();
+  auto next = segments->upper_bound(end);
+  while (next != segments->begin()) {
+    auto prev = std::prev(next);
+    uint64_t prev_end = prev->first + prev->second.size();
+    if (prev_end < begin) {
+      break;
+    }
+    uint64_t merged_begin = std::min(begin, prev->first);
+    uint64_t merged_end = std::max(end, prev_end);
+    std::string merged(merged_end - merged_begin, '\0');
+    merged.replace(prev->first - merged_begin, prev->second.size(), prev->second);
+    merged.replace(begin - merged_begin, data.size(), data);
+    data = std::move(merged);
+    begin = merged_begin;
+    end = merged_end;
+    next = segments->erase(prev);
+  }
+  (*segments)[begin] = std::move(data);
+}
+
+std::shared_ptr<arrow::Buffer> MemoryImage::Get(uint64_t address, int64_t size) const {
+  auto end = address + static_cast<uint64_t>(size);
+  // Slice the buffer out of its segment if it lies within a single segment.
+  auto next = segments_.upper_bound(address);
+  if (next != segments_.begin()) {
+    auto seg = std::prev(next);
+    if (seg->first + seg->second->size() >= end) {
+      return arrow::SliceBuffer(seg->second, address - seg->first, size);
+    }
+  }
+  // Otherwise, copy whatever is in the image, leaving bytes that are not in the image zero.
+  FLETCHER_LOG(DEBUG, "Buffer at " + std::to_string(address) + " is not contiguous in the SREC image. Copying.");
+  std::string data(size, '\0');
+  for (auto seg = next == segments_.begin() ? next : std::prev(next); seg != segments_.end(); seg++) {
+    uint64_t seg_end = seg->first + seg->second->size();
+    if (seg->first >= end) {
+      break;
+    }
+    uint64_t from = std::max(address, seg->first);
+    uint64_t to = std::min(end, seg_end);
+    if (from < to) {
+      memcpy(&data[from - address], seg->second->data() + (from - seg->first), to - from);
+    }
+  }
+  return arrow::Buffer::FromString(std::move(data));
+}
+
+namespace {
+
+/// @brief Reconstructs Arrow arrays from a memory image, taking buffers in the order of a fletcher::FieldAnalyzer.
+class ArrayReader {
+ public:
+  ArrayReader(const MemoryImage &image, const std::vector<uint64_t> &buf_offsets)
+      : image_(image), buf_offsets_(buf_offsets) {}
+
+  /// @brief Read the array of a top-level field.
+  std::shared_ptr<arrow::ArrayData> ReadField(const arrow::Field &field, int64_t length) {
+    std::shared_ptr<arrow::Buffer> validity;
+    if (field.nullable()) {
+      validity = Next((length + 7) / 8);
+    }
+    return ReadType(field.type(), length, validity);
+  }
+
+  /// @brief Return the number of buffers that were read.
+  size_t num_buffers() const { return next_; }
+
+ private:
+  /// @brief Read an array of some type. Nested arrays are assumed not to have a validity bitmap.
+  std::shared_ptr<arrow::ArrayData> ReadType(const std::shared_ptr<arrow::DataType> &type,
+                                             int64_t length,
+                                             const std::shared_ptr<arrow::Buffer> &validity) {
+    int64_t null_count = validity == nullptr ? 0 : arrow::kUnknownNullCount;
+    switch (type->id()) {
+      case arrow::Type::STRING:
+      case arrow::Type::BINARY: {
+        auto offsets = Next((length + 1) * sizeof(int32_t));
+        auto last = LastOffset(*offsets, length);
+        if (last < 0) return nullptr;
+        auto values = Next(last);
+        return arrow::ArrayData::Make(type, length, {validity, offsets, values}, null_count);
+      }
+      case arrow::Type::LIST: {
+        auto offsets = Next((length + 1) * sizeof(int32_t));
+        auto last = LastOffset(*offsets, length);
+        if (last < 0) return nullptr;
+        auto values = ReadType(type->child(0)->type(), last, nullptr);
+        if (values == nullptr) return nullptr;
+        return arrow::ArrayData::Make(type, length, {validity, offsets}, {values}, null_count);
+      }
+      case arrow::Type::STRUCT: {
+        std::vector<std::shared_ptr<arrow::ArrayData>> children;
+        for (int i = 0; i < type->num_children(); i++) {
+          auto child = ReadType(type->child(i)->type(), length, nullptr);
+          if (child == nullptr) return nullptr;
+          children.push_back(child);
+        }
+        return arrow::ArrayData::Make(type, length, {validity}, children, null_count);
+      }
+      default: {
+        auto fixed_width = std::dynamic_pointer_cast<arrow::FixedWidthType>(type);
+        if ((fixed_width == nullptr) || (type->id() == arrow::Type::BOOL)) {
+          FLETCHER_LOG(ERROR, "Cannot read arrays of type " + type->ToString() + " from SREC.");
+          return nullptr;
+        }
+        auto values = Next((fixed_width->bit_width() * length + 7) / 8);
+        return arrow::ArrayData::Make(type, length, {validity, values}, null_count);
+      }
+    }
+  }
+
+  /// @brief Return the next buffer of the RecordBatch with some size.
+  std::shared_ptr<arrow::Buffer> Next(int64_t size) {
+    if (next_ >= buf_offsets_.size()) {
+      // Keep going so that the caller can report the total number of buffers required.
+      next_++;
+      return arrow::Buffer::FromString(std::string(size, '\0'));
+    }
+    return image_.Get(buf_offsets_[next_++], size);
+  }
+
+  /**
+   * @brief Return the last offset in an offsets buffer of an array of some length, or -1 if the offsets are invalid.
+   *
+   * The offsets must be non-negative and monotonic, and may not exceed the part of the image starting at the next
+   * buffer, which holds the values they point into.
+   */
+  int64_t LastOffset(const arrow::Buffer &offsets, int64_t length) const {
+    auto data = reinterpret_cast<const int32_t *>(offsets.data());
+    int64_t max = 0;
+    if ((next_ < buf_offsets_.size()) && (buf_offsets_[next_] < image_.end())) {
+      max = static_cast<int64_t>(image_.end() - buf_offsets_[next_]);
+    }
+    for (int64_t i = 0; i <= length; i++) {
+      if ((data[i] < 0) || (data[i] > max) || ((i > 0) && (data[i] < data[i - 1]))) {
+        FLETCHER_LOG(ERROR, "Offsets buffer " + std::to_string(next_ - 1) + " holds invalid offset "
+            + std::to_string(data[i]) + " at index " + std::to_string(i) + ".");
+        return -1;
+      }
+    }
+    return data[length];
+  }
+
+  const MemoryImage &image_;
+  const std::vector<uint64_t> &buf_offsets_;
+  size_t next_ = 0;
+};
+
+}  // namespace
+
+std::shared_ptr<arrow::RecordBatch> ReadRecordBatchFromImage(const MemoryImage &image,
+                                                             const std::shared_ptr<arrow::Schema> &schema,
+                                                             int64_t num_rows,
+                                                             const std::vector<uint64_t> &buf_offsets) {
+  ArrayReader reader(image, buf_offsets);
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int i = 0; i < schema->num_fields(); i++) {
+    auto data = reader.ReadField(*schema->field(i), num_rows);
+    if (data == nullptr) {
+      return nullptr;
+    }
+    columns.push_back(arrow::MakeArray(data));
+  }
+  if (reader.num_buffers() != buf_offsets.size()) {
+    FLETCHER_LOG(ERROR, "Schema " + fletcher::GetMeta(*schema, "fletcher_name") + " requires "
+        + std::to_string(reader.num_buffers()) + " buffers, but " + std::to_string(buf_offsets.size())
+        + " buffer offsets were supplied.");
+    return nullptr;
+  }
+  return arrow::RecordBatch::Make(schema, num_rows, columns);
 }
 
 std::deque<std::shared_ptr<arrow::RecordBatch>>
@@ -99,9 +323,77 @@ ReadRecordBatchesFromSREC(std::istream *input,
                           const std::vector<uint64_t> &num_rows,
                           const std::vector<uint64_t> &buf_offsets) {
   std::deque<std::shared_ptr<arrow::RecordBatch>> ret;
-  // TODO(johanpel): implement this
-  FLETCHER_LOG(ERROR, "SREC to RecordBatch not yet implemented.");
+  MemoryImage image(input);
+  // The buffer offsets of all RecordBatches are flattened, so count how many buffers every schema requires.
+  size_t first = 0;
+  for (size_t i = 0; i < schemas.size(); i++) {
+    fletcher::RecordBatchDescription desc;
+    fletcher::SchemaAnalyzer(&desc).Analyze(*schemas[i]);
+    size_t last = std::min(buf_offsets.size(), first + desc.buffers.size());
+    std::vector<uint64_t> offsets(buf_offsets.begin() + first, buf_offsets.begin() + last);
+    auto rb = ReadRecordBatchFromImage(image, schemas[i], num_rows[i], offsets);
+    if (rb == nullptr) {
+      FLETCHER_LOG(ERROR, "Could not read RecordBatch " + std::to_string(i) + " from SREC.");
+      return {};
+    }
+    ret.push_back(rb);
+    first = last;
+  }
   return ret;
 }
 
+int CompareSRECDump(std::istream *input,
+                    const std::vector<std::shared_ptr<arrow::Schema>> &schemas,
+                    const std::vector<fletcher::RecordBatchDescription> &layout,
+                    const std::vector<std::shared_ptr<arrow::RecordBatch>> &reference) {
+  MemoryImage image(input);
+  int mismatches = 0;
+  for (size_t i = 0; i < schemas.size(); i++) {
+    if (fletcher::GetMode(*schemas[i]) != fletcher::Mode::WRITE) {
+      continue;
+    }
+    auto name = fletcher::GetMeta(*schemas[i], "fletcher_name");
+    // Find the reference RecordBatch with the same name.
+    std::shared_ptr<arrow::RecordBatch> expected;
+    for (const auto &rb : reference) {
+      if (fletcher::GetMeta(*rb->schema(), "fletcher_name") == name) {
+        expected = rb;
+        break;
+      }
+    }
+    if (expected == nullptr) {
+      FLETCHER_LOG(WARNING, "No reference RecordBatch for " + name + ". Skipping comparison.");
+      continue;
+    }
+    // Reconstruct the RecordBatch with as many rows as the reference.
+    std::vector<uint64_t> offsets;
+    for (const auto &buf : layout[i].buffers) {
+      offsets.push_back(reinterpret_cast<uint64_t>(buf.raw_buffer_));
+    }
+    auto actual = ReadRecordBatchFromImage(image, schemas[i], expected->num_rows(), offsets);
+    if (actual == nullptr) {
+      mismatches++;
+      continue;
+    }
+    bool equal = actual->num_columns() == expected->num_columns();
+    if (!equal) {
+      FLETCHER_LOG(ERROR, "RecordBatch " + name + " has a different number of columns than its reference.");
+    }
+    for (int c = 0; equal && (c < actual->num_columns()); c++) {
+      if (!actual->column(c)->Equals(expected->column(c))) {
+        FLETCHER_LOG(ERROR, "RecordBatch " + name + " column " + schemas[i]->field(c)->name()
+            + " differs from reference.\nExpected:\n" + expected->column(c)->ToString()
+            + "\nActual:\n" + actual->column(c)->ToString());
+        equal = false;
+      }
+    }
+    if (equal) {
+      FLETCHER_LOG(INFO, "RecordBatch " + name + " matches reference.");
+    } else {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
 }  // namespace fletchgen::srec
@@ -21,24 +21,48 @@
 
 #include <vector>
 #include <deque>
+#include <map>
 #include <memory>
+#include <string>
 
 #include "fletchgen/options.h"
 
 namespace fletchgen::srec {
 
+/// Alignment in bytes of every RecordBatch buffer in simulation memory.
+constexpr int64_t SREC_BUFFER_ALIGN = 64;
+/// Default number of bytes reserved in simulation memory for every buffer of a RecordBatch written by the kernel.
+constexpr int64_t SREC_WRITE_CAPACITY = 1 << 20;
+
 /**
- * @brief Generate and save an SREC file from a bunch of RecordBatches and Schemas.
- * @param schemas       The Schemas.
- * @param recordbatches The RecordBatches.
- * @param meta_out      Metadata output about saved RecordBatches.
+ * @brief Determine the location of every RecordBatch buffer in simulation memory.
+ *
+ * The buffers of physical RecordBatches are placed consecutively, starting at 0. Behind those, a region of
+ * write_capacity bytes is reserved for every buffer of virtual RecordBatches, such that the kernel can write them.
+ *
+ * @param meta_in         The RecordBatch descriptions.
+ * @param buffer_align    Alignment in bytes for every RecordBatch buffer.
+ * @param write_capacity  Number of bytes to reserve for every buffer of a virtual RecordBatch.
+ * @return                Copies of the RecordBatch descriptions, where the buffer addresses are offsets into memory.
+ */
+std::vector<fletcher::RecordBatchDescription> GetSRECLayout(
+    const std::vector<fletcher::RecordBatchDescription> &meta_in,
+    int64_t buffer_align = SREC_BUFFER_ALIGN,
+    int64_t write_capacity = SREC_WRITE_CAPACITY);
+
+/**
+ * @brief Generate and save an SREC file from a bunch of RecordBatches.
+ * @param meta_in       The RecordBatch descriptions.
+ * @param layout        The layout of the RecordBatches in memory, as obtained from GetSRECLayout.
  * @param out           Output stream to write the SREC file to.
  * @param buffer_align  Alignment in bytes for every RecordBatch buffer.
+ * @param num_threads   Number of threads to encode large buffers with. Zero uses all hardware threads.
 */
 void GenerateReadSREC(const std::vector<fletcher::RecordBatchDescription> &meta_in,
-                      std::vector<fletcher::RecordBatchDescription> *meta_out,
-                      std::ofstream *out,
-                      int64_t buffer_align);
+                      const std::vector<fletcher::RecordBatchDescription> &layout,
+                      std::ostream *out,
+                      int64_t buffer_align = SREC_BUFFER_ALIGN,
+                      size_t num_threads = 0);
 
 /**
  * Write SREC formatted RecordBatches to an output stream.
@@ -50,9 +74,79 @@ std::vector<uint64_t> WriteRecordBatchesToSREC(std::ostream *output,
                                                const std::deque<std::shared_ptr<arrow::RecordBatch>> &recordbatches);
 
 /**
- * @brief Read an SREC formatted input stream and turn it into a RecordBatch
+ * @brief A sparse memory image, read from an SREC file.
+ *
+ * Data records at contiguous addresses are stored in a single segment. Buffers that lie within a single segment are
+ * obtained without copying.
+ */
+class MemoryImage {
+ public:
+  /// @brief Construct a new MemoryImage from the data records in an SREC formatted input stream.
+  explicit MemoryImage(std::istream *input);
+
+  /**
+   * @brief Obtain the contents of a region of memory.
+   *
+   * The buffer is a slice of a segment if the region lies within a single segment. Otherwise, the contents are copied,
+   * and bytes that are not in the image are zero.
+   *
+   * @param address The address of the region.
+   * @param size    The size of the region in bytes.
+   * @return        A buffer with the contents of the region.
+   */
+  std::shared_ptr<arrow::Buffer> Get(uint64_t address, int64_t size) const;
+
+  /// @brief Return the number of contiguous segments in the image.
+  size_t num_segments() const { return segments_.size(); }
+
+  /// @brief Return the address just past the last byte in the image.
+  uint64_t end() const {
+    return segments_.empty() ? 0 : segments_.rbegin()->first + segments_.rbegin()->second->size();
+  }
+
+ private:
+  /// @brief Add a segment to a map of segments, merging it with any segments it overlaps or touches.
+  static void AddSegment(std::map<uint64_t, std::string> *segments, uint64_t address, std::string data);
+
+  std::map<uint64_t, std::shared_ptr<arrow::Buffer>> segments_;
+};
+
+/**
+ * @brief Reconstruct a RecordBatch from a memory image, without copying the buffers where possible.
  *
- * Buffer offsets should follow
+ * The buffers are expected in the order of a fletcher::SchemaAnalyzer. Only top-level fields can have a validity
+ * bitmap. The sizes of variable-length buffers are obtained from the last element of their offsets buffer. Offsets
+ * that are negative, decreasing, or point beyond the end of the image make the RecordBatch impossible to reconstruct.
+ *
+ * @param image         The memory image.
+ * @param schema        The Arrow Schema of the RecordBatch.
+ * @param num_rows      The number of rows of the RecordBatch.
+ * @param buf_offsets   The addresses of the buffers of the RecordBatch in the image.
+ * @return              The RecordBatch, or nullptr if it could not be reconstructed.
+ */
+std::shared_ptr<arrow::RecordBatch> ReadRecordBatchFromImage(const MemoryImage &image,
+                                                             const std::shared_ptr<arrow::Schema> &schema,
+                                                             int64_t num_rows,
+                                                             const std::vector<uint64_t> &buf_offsets);
+
+/**
+ * @brief Compare the RecordBatches written by the kernel in a simulation memory dump with reference RecordBatches.
+ * @param input     The SREC formatted input stream with the memory dump.
+ * @param schemas   The Arrow Schemas of all RecordBatches of the design. Only write-mode schemas are compared.
+ * @param layout    The layout of all RecordBatches in memory, as obtained from GetSRECLayout.
+ * @param reference The reference RecordBatches, matched by their "fletcher_name" schema metadata.
+ * @return          The number of RecordBatches that differ from their reference.
+ */
+int CompareSRECDump(std::istream *input,
+                    const std::vector<std::shared_ptr<arrow::Schema>> &schemas,
+                    const std::vector<fletcher::RecordBatchDescription> &layout,
+                    const std::vector<std::shared_ptr<arrow::RecordBatch>> &reference);
+
+/**
+ * @brief Read an SREC formatted input stream and turn it into RecordBatches
+ *
+ * Buffer offsets should follow the order of the buffers of every schema as obtained from a fletcher::SchemaAnalyzer,
+ * for every schema in order.
  *
  * @param input         The input stream to read from.
  * @param schemas       A deque of Arrow Schemas.
@@ -66,4 +160,17 @@ ReadRecordBatchesFromSREC(std::istream *input,
                           const std::vector<uint64_t> &num_rows,
                           const std::vector<uint64_t> &buf_offsets);
 
+/**
+ * @brief Compare the RecordBatches written by the kernel in a simulation memory dump with reference RecordBatches.
+ * @param input     The SREC formatted input stream with the memory dump.
+ * @param schemas   The Arrow Schemas of all RecordBatches of the design. Only write-mode schemas are compared.
+ * @param layout    The layout of all RecordBatches in memory, as obtained from GetSRECLayout.
+ * @param reference The reference RecordBatches, matched by their "fletcher_name" schema metadata.
+ * @return          The number of RecordBatches that differ from their reference.
+ */
+int CompareSRECDump(std::istream *input,
+                    const std::vector<std::shared_ptr<arrow::Schema>> &schemas,
+                    const std::vector<fletcher::RecordBatchDescription> &layout,
+                    const std::vector<std::shared_ptr<arrow::RecordBatch>> &reference);
+
 }  // namespace fletchgen::srec
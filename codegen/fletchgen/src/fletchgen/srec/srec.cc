@@ -19,6 +19,7 @@
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
+#include <thread>
 
 #include "fletchgen/srec/srec.h"
 
@@ -53,17 +54,21 @@ uint8_t Record::byte_count() {
   return address_width() + size_ + 1;
 }
 
-int Record::address_width() {
-  switch (type_) {
-    case DATA24: return 3;
-    case COUNT24: return 3;
-    case TERM24: return 3;
-    case DATA32: return 4;
-    case TERM32: return 4;
+int AddressWidth(Record::Type type) {
+  switch (type) {
+    case Record::DATA24: return 3;
+    case Record::COUNT24: return 3;
+    case Record::TERM24: return 3;
+    case Record::DATA32: return 4;
+    case Record::TERM32: return 4;
     default:return 2;
   }
 }
 
+int Record::address_width() const {
+  return AddressWidth(type_);
+}
+
 uint8_t Record::checksum() {
   uint32_t sum = 0;
   // Byte count
@@ -84,80 +89,136 @@ uint8_t Record::checksum() {
   return ret;
 }
 
-std::string Record::ToString(bool line_feed) {
-  // String stream to build output
-  std::stringstream output;
-  // Record type
-  output << 'S' << std::to_string(type_);
-  // Byte count
-  PutHex(output, byte_count());
-  // Address
-  PutHex(output, address_, 2 * address_width());
-  // Data
-  for (unsigned int i = 0; i < size_; i++) {
-    PutHex(output, data_[i]);
-  }
-  // Checksum
-  PutHex(output, checksum());
-  // Line feed
-  if (line_feed) {
-    output << std::endl;
+namespace {
+
+/// @brief Lookup tables for hexadecimal encoding and decoding.
+struct HexTable {
+  char chars[256][2] = {};
+  int8_t values[256] = {};
+
+  constexpr HexTable() {
+    const char digits[] = "0123456789ABCDEF";
+    for (int i = 0; i < 256; i++) {
+      chars[i][0] = digits[i >> 4];
+      chars[i][1] = digits[i & 0xF];
+      values[i] = -1;
+    }
+    for (int i = 0; i < 10; i++) {
+      values['0' + i] = static_cast<int8_t>(i);
+    }
+    for (int i = 0; i < 6; i++) {
+      values['A' + i] = static_cast<int8_t>(10 + i);
+      values['a' + i] = static_cast<int8_t>(10 + i);
+    }
   }
-  return output.str();
+};
+
+constexpr HexTable hex_table;
+
+inline char *PutByte(char *dest, uint8_t byte) {
+  dest[0] = hex_table.chars[byte][0];
+  dest[1] = hex_table.chars[byte][1];
+  return dest + 2;
 }
 
-std::optional<Record> Record::FromString(const std::string &line) {
-  // TODO(johanpel): make this function not break on big endian systems
-  size_t offset = 0;
-  Record ret(RESERVED, 0, nullptr, 0);
+/// @brief Decode two hexadecimal characters. Returns a negative value if they are invalid.
+inline int GetByte(const char *src) {
+  int hi = hex_table.values[static_cast<uint8_t>(src[0])];
+  int lo = hex_table.values[static_cast<uint8_t>(src[1])];
+  return (hi < 0) || (lo < 0) ? -1 : (hi << 4) | lo;
+}
 
-  // Check if line starts with S (1 character)
-  if (line.substr(offset, 1) != "S") {
-    return std::nullopt;
-  }
-  offset++;
+/// Maximum number of characters of an S3 data record of Record::MAX_DATA_BYTES, including line feed.
+constexpr size_t MAX_DATA_LINE = 4 + 2 * (4 + Record::MAX_DATA_BYTES + 1) + 1;
 
-  // Get type (1 character)
-  uint64_t t = std::stoul(line.substr(offset, 1), nullptr, 16);
-  if (t > 9) {
-    return std::nullopt;
-  }
-  ret.type_ = static_cast<Type>(t);
-  offset++;
+/// Zeros to encode when no data is supplied.
+const uint8_t zeros[Record::MAX_RECORD_BYTES] = {};
 
-  // Get size (2 characters, 1 byte), subtract address width and checksum
-  ret.size_ = std::stoul(line.substr(offset, 2), nullptr, 16) - ret.address_width() - 1;
-  if (ret.size_ > MAX_DATA_BYTES) {
-    return std::nullopt;
-  }
-  offset += 2;
+}  // namespace
 
-  // Obtain the address (addr. width * (2 chars or 1 byte))
-  uint32_t addr = 0;
-  for (int i = ret.address_width() - 1; i >= 0; i--) {
-    uint8_t byte = std::stoul(line.substr(offset, 2), nullptr, 16);
-    addr |= byte << (8u * i);
-    offset += 2;
+size_t EncodeRecord(Record::Type type, uint32_t address, const uint8_t *data, size_t size, char *dest) {
+  if (data == nullptr) {
+    data = zeros;
+  }
+  int address_width = AddressWidth(type);
+  auto byte_count = static_cast<uint8_t>(address_width + size + 1);
+  uint32_t sum = byte_count;
+  char *pos = dest;
+  *pos++ = 'S';
+  *pos++ = static_cast<char>('0' + type);
+  pos = PutByte(pos, byte_count);
+  for (int i = address_width - 1; i >= 0; i--) {
+    auto byte = static_cast<uint8_t>(address >> (8u * i));
+    sum += byte;
+    pos = PutByte(pos, byte);
+  }
+  for (size_t i = 0; i < size; i++) {
+    sum += data[i];
+    pos = PutByte(pos, data[i]);
   }
-  ret.address_ = addr;
+  // One's complement of the least significant byte of the sum.
+  pos = PutByte(pos, static_cast<uint8_t>(~sum & 0xFFu));
+  return pos - dest;
+}
 
-  // Reserve a data buffer
-  ret.data_ = static_cast<uint8_t *>(calloc(ret.size_, sizeof(uint8_t)));
+bool DecodeRecord(const char *line,
+                  size_t length,
+                  Record::Type *type,
+                  uint32_t *address,
+                  uint8_t *data,
+                  size_t *size) {
+  // Type, byte count and at least the checksum.
+  if ((length < 6) || (line[0] != 'S') || (line[1] < '0') || (line[1] > '9')) {
+    return false;
+  }
+  *type = static_cast<Record::Type>(line[1] - '0');
+  int byte_count = GetByte(line + 2);
+  int address_width = AddressWidth(*type);
+  if ((byte_count < address_width + 1) || (length < 4 + 2 * static_cast<size_t>(byte_count))) {
+    return false;
+  }
+  uint32_t sum = byte_count;
+  const char *pos = line + 4;
+  *address = 0;
+  for (int i = 0; i < address_width; i++, pos += 2) {
+    int byte = GetByte(pos);
+    if (byte < 0) return false;
+    *address = (*address << 8u) | static_cast<uint32_t>(byte);
+    sum += byte;
+  }
+  *size = byte_count - address_width - 1;
+  // Records with a short address can hold a few more bytes than the data output is able to.
+  if (*size > Record::MAX_RECORD_BYTES) {
+    return false;
+  }
+  for (size_t i = 0; i < *size; i++, pos += 2) {
+    int byte = GetByte(pos);
+    if (byte < 0) return false;
+    data[i] = static_cast<uint8_t>(byte);
+    sum += byte;
+  }
+  int checksum = GetByte(pos);
+  return (checksum >= 0) && (static_cast<uint8_t>(~sum & 0xFFu) == checksum);
+}
 
-  // Obtain the data (2 chars or 1 byte)
-  for (size_t i = 0; i < ret.size_; i++) {
-    auto byte = static_cast<uint8_t>(std::stoul(line.substr(offset, 2), nullptr, 16));
-    ret.data_[i] = byte;
-    offset += 2;
+std::string Record::ToString(bool line_feed) {
+  char line[MAX_DATA_LINE];
+  auto length = EncodeRecord(type_, address_, data_, size_, line);
+  if (line_feed) {
+    line[length++] = '\n';
   }
+  return std::string(line, length);
+}
 
-  // Validate checksum
-  uint8_t sum = std::stoul(line.substr(offset, 2), nullptr, 16);
-  if (ret.checksum() != sum) {
+std::optional<Record> Record::FromString(const std::string &line) {
+  Type type;
+  uint32_t address;
+  uint8_t data[MAX_RECORD_BYTES];
+  size_t size;
+  if (!DecodeRecord(line.data(), line.size(), &type, &address, data, &size) || (size > MAX_DATA_BYTES)) {
     return std::nullopt;
   }
-
-  return ret;
+  return Record(type, address, data, size);
 }
 
 File::File(uint32_t start_address, const uint8_t *data, size_t size, const std::string &header_str) {
@@ -193,13 +254,12 @@ void File::write(std::ostream *output) {
 }
 
 File::File(std::istream *input) {
-  for (std::string line; std::getline(*input, line);) {
-    auto record = Record::FromString(line);
-    if (record) {
-      records.push_back(*record);
-    } else {
+  Reader reader(input);
+  while (reader.Next()) {
+    if (reader.size() > Record::MAX_DATA_BYTES) {
       throw std::runtime_error("Could not parse SREC file.");
     }
+    records.emplace_back(reader.type(), reader.address(), reader.data(), reader.size());
   }
 }
 
@@ -229,4 +289,150 @@ void File::ToBuffer(uint8_t **buf, size_t *size) {
   }
 }
 
+Writer::Writer(std::ostream *output, size_t num_threads, size_t buffer_size)
+    : output_(output),
+      num_threads_(num_threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : num_threads),
+      buffer_(std::max(buffer_size, MAX_DATA_LINE)) {}
+
+Writer::~Writer() {
+  Flush();
+}
+
+void Writer::Header(const std::string &header_str, uint16_t address) {
+  FlushPartial();
+  auto line = Record::Header(header_str, address).ToString(true);
+  Append(line.data(), line.size());
+  num_records_++;
+}
+
+void Writer::Write(uint32_t address, const uint8_t *data, size_t size) {
+  size_t pos = 0;
+  // Complete the partial record if this data directly follows it.
+  if (partial_size_ > 0) {
+    if (address != partial_address_ + partial_size_) {
+      FlushPartial();
+    } else {
+      pos = std::min(size, Record::MAX_DATA_BYTES - partial_size_);
+      if (data != nullptr) {
+        memcpy(partial_ + partial_size_, data, pos);
+      } else {
+        memset(partial_ + partial_size_, 0, pos);
+      }
+      partial_size_ += pos;
+      if (partial_size_ == Record::MAX_DATA_BYTES) {
+        FlushPartial();
+      }
+    }
+  }
+  // Encode the full records straight from the source.
+  size_t num_full = (size - pos) / Record::MAX_DATA_BYTES;
+  WriteRecords(address + pos, data != nullptr ? data + pos : nullptr, num_full);
+  pos += num_full * Record::MAX_DATA_BYTES;
+  // Keep the remainder, it may be completed by the next write.
+  if (pos < size) {
+    partial_address_ = static_cast<uint32_t>(address + pos);
+    partial_size_ = size - pos;
+    if (data != nullptr) {
+      memcpy(partial_, data + pos, partial_size_);
+    } else {
+      memset(partial_, 0, partial_size_);
+    }
+  }
+}
+
+void Writer::WriteRecords(uint32_t address, const uint8_t *data, size_t num_records) {
+  constexpr size_t rec_bytes = Record::MAX_DATA_BYTES;
+  auto rec_data = [&](size_t r) { return data != nullptr ? data + r * rec_bytes : nullptr; };
+  auto rec_address = [&](size_t r) { return static_cast<uint32_t>(address + r * rec_bytes); };
+
+  size_t records_per_thread = THREAD_BLOCK_SIZE / rec_bytes;
+  if ((num_threads_ > 1) && (num_records > records_per_thread)) {
+    // Encode blocks of records in parallel. Every thread encodes one block at a time, bounding the memory use.
+    std::vector<std::vector<char>> blocks(num_threads_, std::vector<char>(records_per_thread * MAX_DATA_LINE));
+    std::vector<size_t> lengths(num_threads_);
+    for (size_t first = 0; first < num_records; first += num_threads_ * records_per_thread) {
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < num_threads_; t++) {
+        size_t begin = std::min(num_records, first + t * records_per_thread);
+        size_t end = std::min(num_records, begin + records_per_thread);
+        threads.emplace_back([&, t, begin, end]() {
+          char *pos = blocks[t].data();
+          for (size_t r = begin; r < end; r++) {
+            pos += EncodeRecord(Record::DATA32, rec_address(r), rec_data(r), rec_bytes, pos);
+            *pos++ = '\n';
+          }
+          lengths[t] = pos - blocks[t].data();
+        });
+      }
+      for (size_t t = 0; t < num_threads_; t++) {
+        threads[t].join();
+        Append(blocks[t].data(), lengths[t]);
+      }
+    }
+  } else {
+    for (size_t r = 0; r < num_records; r++) {
+      if (buffer_pos_ + MAX_DATA_LINE > buffer_.size()) {
+        FlushBuffer();
+      }
+      char *pos = buffer_.data() + buffer_pos_;
+      pos += EncodeRecord(Record::DATA32, rec_address(r), rec_data(r), rec_bytes, pos);
+      *pos++ = '\n';
+      buffer_pos_ = pos - buffer_.data();
+    }
+  }
+  num_records_ += num_records;
+}
+
+void Writer::FlushPartial() {
+  if (partial_size_ > 0) {
+    char line[MAX_DATA_LINE];
+    auto length = EncodeRecord(Record::DATA32, partial_address_, partial_, partial_size_, line);
+    line[length++] = '\n';
+    Append(line, length);
+    partial_size_ = 0;
+    num_records_++;
+  }
+}
+
+void Writer::Append(const char *str, size_t size) {
+  if (buffer_pos_ + size > buffer_.size()) {
+    FlushBuffer();
+  }
+  if (size > buffer_.size()) {
+    output_->write(str, size);
+  } else {
+    memcpy(buffer_.data() + buffer_pos_, str, size);
+    buffer_pos_ += size;
+  }
+}
+
+void Writer::FlushBuffer() {
+  output_->write(buffer_.data(), buffer_pos_);
+  buffer_pos_ = 0;
+}
+
+void Writer::Flush() {
+  FlushPartial();
+  FlushBuffer();
+  output_->flush();
+}
+
+bool Reader::Next() {
+  while (std::getline(*input_, line_)) {
+    // Tolerate carriage returns and empty lines.
+    auto length = line_.size();
+    if ((length > 0) && (line_[length - 1] == '\r')) {
+      length--;
+    }
+    if (length == 0) {
+      continue;
+    }
+    if (!DecodeRecord(line_.data(), length, &type_, &address_, data_, &size_)) {
+      throw std::runtime_error("Could not parse SREC record: " + line_);
+    }
+    return true;
+  }
+  return false;
+}
+
 }  // namespace fletchgen::srec
@@ -17,7 +17,9 @@
 #include <cstdint>
 #include <stdexcept>
 #include <cstring>
+#include <iomanip>
 #include <ostream>
+#include <sstream>
 #include <vector>
 #include <memory>
 #include <iostream>
@@ -33,6 +35,8 @@ class Record {
  public:
   /// Maximum number of data bytes per Record.
   static constexpr size_t MAX_DATA_BYTES = 32;
+  /// Maximum number of data bytes that fit in a record of every SREC type, as limited by the byte count field.
+  static constexpr size_t MAX_RECORD_BYTES = 250;
 
   /**
    * @brief The SREC Record type.
@@ -115,13 +119,44 @@ class Record {
   uint8_t *data_ = nullptr;
 
   /// @brief Return the number of bytes of the address field.
-  int address_width();
+  int address_width() const;
   /// @brief Return the byte count of this Record.
   uint8_t byte_count();
   /// @brief Return the checksum of this Record.
   uint8_t checksum();
 };
 
+/// @brief Return the number of bytes of the address field of a record type.
+int AddressWidth(Record::Type type);
+
+/**
+ * @brief Encode an SREC record, without line feed.
+ * @param type    The record type.
+ * @param address The record address.
+ * @param data    The record data. If nullptr, the data is all zeros.
+ * @param size    The size of the data in bytes, at most Record::MAX_RECORD_BYTES.
+ * @param dest    The destination. Must be able to hold 4 + 2 * (address width + size + 1) characters.
+ * @return        The number of characters written.
+ */
+size_t EncodeRecord(Record::Type type, uint32_t address, const uint8_t *data, size_t size, char *dest);
+
+/**
+ * @brief Decode an SREC record.
+ * @param line    The record characters, without line feed.
+ * @param length  The number of characters.
+ * @param type    The record type output.
+ * @param address The record address output.
+ * @param data    The record data output. Must be able to hold Record::MAX_RECORD_BYTES bytes.
+ * @param size    The size of the record data output.
+ * @return        True if the record is valid and holds at most Record::MAX_RECORD_BYTES data bytes, false otherwise.
+ */
+bool DecodeRecord(const char *line,
+                  size_t length,
+                  Record::Type *type,
+                  uint32_t *address,
+                  uint8_t *data,
+                  size_t *size);
+
 inline void PutHex(std::stringstream &stream, uint32_t val, int characters = 2) {
   stream << std::uppercase << std::hex << std::setfill('0') << std::setw(characters) << val;
 }
@@ -165,4 +200,97 @@ struct File {
   void ToBuffer(uint8_t **buffer, size_t *size);
 };
 
+/**
+ * @brief Streaming SREC writer.
+ *
+ * Writes S3 data records straight from the source data into a large output buffer, without constructing Records.
+ * Consecutive writes to contiguous addresses are coalesced into full records, such that the output is equal to that of
+ * a File constructed from one contiguous buffer. Large writes can be encoded by multiple threads.
+ */
+class Writer {
+ public:
+  /// Default size of the output buffer in bytes.
+  static constexpr size_t DEFAULT_BUFFER_SIZE = 1u << 20u;
+  /// Number of data bytes that a single thread encodes at a time.
+  static constexpr size_t THREAD_BLOCK_SIZE = 1u << 20u;
+
+  /**
+   * @brief Construct a new streaming SREC Writer.
+   * @param output      The output stream to write to.
+   * @param num_threads The number of threads to encode large writes with. Zero uses all hardware threads.
+   * @param buffer_size The size of the output buffer in bytes.
+   */
+  explicit Writer(std::ostream *output, size_t num_threads = 1, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+  /// @brief Flush and destroy the Writer.
+  ~Writer();
+
+  /// @brief Write a header record.
+  void Header(const std::string &header_str = "HDR", uint16_t address = 0);
+
+  /**
+   * @brief Write data records.
+   * @param address The address of the data.
+   * @param data    The data. If nullptr, zeros are written.
+   * @param size    The size of the data in bytes.
+   */
+  void Write(uint32_t address, const uint8_t *data, size_t size);
+
+  /// @brief Write any partial record and the output buffer to the output stream.
+  void Flush();
+
+  /// @brief Return the number of records written so far.
+  size_t num_records() const { return num_records_; }
+
+ private:
+  /// @brief Encode full data records.
+  void WriteRecords(uint32_t address, const uint8_t *data, size_t num_records);
+  /// @brief Write the partial record to the output buffer.
+  void FlushPartial();
+  /// @brief Append characters to the output buffer.
+  void Append(const char *str, size_t size);
+  /// @brief Write the output buffer to the output stream.
+  void FlushBuffer();
+
+  std::ostream *output_;
+  size_t num_threads_;
+  std::vector<char> buffer_;
+  size_t buffer_pos_ = 0;
+  uint8_t partial_[Record::MAX_DATA_BYTES] = {};
+  size_t partial_size_ = 0;
+  uint32_t partial_address_ = 0;
+  size_t num_records_ = 0;
+};
+
+/**
+ * @brief Streaming SREC reader.
+ *
+ * Parses one record at a time into storage that is reused for every record.
+ */
+class Reader {
+ public:
+  /// @brief Construct a new streaming SREC Reader.
+  explicit Reader(std::istream *input) : input_(input) {}
+
+  /**
+   * @brief Parse the next record. Empty lines are skipped.
+   * @return True if a record was parsed, false at the end of the input.
+   * @throws std::runtime_error if the record is invalid.
+   */
+  bool Next();
+
+  inline Record::Type type() const { return type_; }
+  inline uint32_t address() const { return address_; }
+  inline const uint8_t *data() const { return data_; }
+  inline size_t size() const { return size_; }
+
+ private:
+  std::istream *input_;
+  std::string line_;
+  Record::Type type_ = Record::RESERVED;
+  uint32_t address_ = 0;
+  uint8_t data_[Record::MAX_RECORD_BYTES] = {};
+  size_t size_ = 0;
+};
+
 }  // namespace fletchgen::srec
@@ -0,0 +1,451 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fletchgen/throughput.h"
+
+#include <arrow/api.h>
+#include <fletcher/common.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "fletchgen/array.h"
+
+namespace fletchgen {
+
+/// Upper bound on the number of tuning steps.
+static constexpr int MAX_AUTOTUNE_STEPS = 1024;
+
+static constexpr double UNLIMITED = std::numeric_limits<double>::infinity();
+
+/// @brief A buffer an Array(Reader/Writer) transfers over the bus for a field.
+struct Buffer {
+  /// Number of bytes of a single row.
+  double bytes_per_row;
+  /// Number of rows per cycle the Array(Reader/Writer) can handle for this buffer.
+  double max_rows_per_cycle;
+  /// Whether this buffer holds list offsets.
+  bool offsets;
+};
+
+static std::shared_ptr<arrow::RecordBatch> GetSample(const std::vector<std::shared_ptr<arrow::RecordBatch>> &samples,
+                                                     const std::string &name) {
+  for (const auto &b : samples) {
+    if (fletcher::GetMeta(*b->schema(), "fletcher_name") == name) {
+      return b;
+    }
+  }
+  return nullptr;
+}
+
+/// @brief Return the average number of elements of the lists in a sample array, or some default.
+static double AverageLength(const arrow::Array *sample, double default_to) {
+  if ((sample == nullptr) || (sample->length() == 0)) {
+    return default_to;
+  }
+  int64_t elements = 0;
+  if (auto list = dynamic_cast<const arrow::ListArray *>(sample)) {
+    elements = list->value_offset(list->length()) - list->value_offset(0);
+  } else if (auto binary = dynamic_cast<const arrow::BinaryArray *>(sample)) {
+    elements = binary->value_offset(binary->length()) - binary->value_offset(0);
+  } else {
+    return default_to;
+  }
+  return static_cast<double>(elements) / sample->length();
+}
+
+/**
+ * @brief Determine the buffers an Array(Reader/Writer) transfers for a field.
+ * @param field             The field.
+ * @param sample            Optional sample data of the field.
+ * @param elements_per_row  The average number of elements of this field per row of the RecordBatch.
+ * @param epc               The elements-per-cycle of the top-level field.
+ * @param lepc              The lengths-per-cycle of the top-level field.
+ * @param model             The model parameters.
+ * @param buffers           The buffers are appended to this.
+ */
+static void AnalyzeBuffers(const arrow::Field &field,
+                           const arrow::Array *sample,
+                           double elements_per_row,
+                           int epc,
+                           int lepc,
+                           const ThroughputModel &model,
+                           std::deque<Buffer> *buffers) {
+  const auto &type = *field.type();
+  // Validity bitmap
+  if (field.nullable()) {
+    buffers->push_back({elements_per_row / 8.0, UNLIMITED, false});
+  }
+  switch (type.id()) {
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY: {
+      double length = AverageLength(sample, model.default_list_length);
+      buffers->push_back({elements_per_row * 4.0, lepc / elements_per_row, true});
+      buffers->push_back({elements_per_row * length, epc / (elements_per_row * length), false});
+      break;
+    }
+    case arrow::Type::LIST: {
+      double length = AverageLength(sample, model.default_list_length);
+      buffers->push_back({elements_per_row * 4.0, lepc / elements_per_row, true});
+      auto list = dynamic_cast<const arrow::ListArray *>(sample);
+      AnalyzeBuffers(*type.child(0),
+                     list != nullptr ? list->values().get() : nullptr,
+                     elements_per_row * length,
+                     epc,
+                     lepc,
+                     model,
+                     buffers);
+      break;
+    }
+    case arrow::Type::STRUCT: {
+      auto str = dynamic_cast<const arrow::StructArray *>(sample);
+      for (int c = 0; c < type.num_children(); c++) {
+        AnalyzeBuffers(*type.child(c),
+                       str != nullptr ? str->field(c).get() : nullptr,
+                       elements_per_row,
+                       epc,
+                       lepc,
+                       model,
+                       buffers);
+      }
+      break;
+    }
+    default: {
+      auto fixed = dynamic_cast<const arrow::FixedWidthType *>(&type);
+      if (fixed == nullptr) {
+        FLETCHER_LOG(WARNING, "Throughput of field " + field.name() + " of type " + type.ToString()
+            + " cannot be modeled.");
+        break;
+      }
+      buffers->push_back({elements_per_row * fixed->bit_width() / 8.0, epc / elements_per_row, false});
+      break;
+    }
+  }
+}
+
+/// @brief Return the width in bits of the elements the EPC of a field applies to, or 0 if it is not tunable.
+static int ElementWidth(const arrow::DataType &type) {
+  switch (type.id()) {
+    case arrow::Type::STRING:
+    case arrow::Type::BINARY:return 8;
+    case arrow::Type::LIST:return ElementWidth(*type.child(0)->type());
+    case arrow::Type::STRUCT:return 0;
+    default: {
+      auto fixed = dynamic_cast<const arrow::FixedWidthType *>(&type);
+      return fixed != nullptr ? fixed->bit_width() : 0;
+    }
+  }
+}
+
+static double BurstEfficiency(const std::deque<Buffer> &buffers,
+                              int64_t rows,
+                              const FieldThroughput &f,
+                              double beat_bytes,
+                              const ThroughputModel &model) {
+  if (rows == 0) {
+    // Assume large buffers; every burst is of maximum length.
+    return f.burst_max_len / (f.burst_max_len + model.burst_overhead);
+  }
+  // Bursts of a buffer are aligned to burst steps, so a partial step is transferred at the end of the buffer.
+  double step_bytes = f.burst_step_len * beat_bytes;
+  double useful_beats = 0.0;
+  double cycles = 0.0;
+  for (const auto &b : buffers) {
+    double bytes = b.bytes_per_row * rows;
+    double beats = std::ceil(bytes / step_bytes) * f.burst_step_len;
+    useful_beats += bytes / beat_bytes;
+    cycles += beats + std::ceil(beats / f.burst_max_len) * model.burst_overhead;
+  }
+  return cycles > 0.0 ? useful_beats / cycles : 1.0;
+}
+
+/// @brief Share the cycles of an arbiter between its fields according to their weights.
+static void Arbitrate(ArbiterThroughput *arbiter, std::deque<FieldThroughput> *fields) {
+  double beat_bytes = arbiter->spec.data_width / 8.0;
+  std::deque<size_t> unsatisfied;
+  std::vector<double> demand(fields->size(), 0.0);
+  std::vector<double> granted(fields->size(), 0.0);
+  for (auto i : arbiter->fields) {
+    const auto &f = (*fields)[i];
+    demand[i] = f.demand / beat_bytes / f.burst_efficiency;
+    unsatisfied.push_back(i);
+  }
+  // Every field that demands less than its weighted share of the remaining cycles gets what it demands, the others
+  // share the rest in proportion to their weights.
+  double remaining = 1.0;
+  while (!unsatisfied.empty()) {
+    double total_weight = 0.0;
+    for (auto i : unsatisfied) {
+      total_weight += (*fields)[i].weight;
+    }
+    double fair = remaining / total_weight;
+    std::deque<size_t> next;
+    for (auto i : unsatisfied) {
+      if (demand[i] <= fair * (*fields)[i].weight) {
+        granted[i] = demand[i];
+        remaining -= demand[i];
+      } else {
+        next.push_back(i);
+      }
+    }
+    if (next.size() == unsatisfied.size()) {
+      for (auto i : next) {
+        granted[i] = fair * (*fields)[i].weight;
+      }
+      remaining = 0.0;
+      break;
+    }
+    unsatisfied = next;
+  }
+  arbiter->utilization = 1.0 - remaining;
+  for (auto i : arbiter->fields) {
+    auto &f = (*fields)[i];
+    f.share = granted[i];
+    f.bus_limited = granted[i] < demand[i] * (1.0 - 1e-9);
+    f.rows_per_cycle = demand[i] > 0.0 ? f.epc_rows_per_cycle * granted[i] / demand[i] : f.epc_rows_per_cycle;
+  }
+}
+
+ThroughputReport AnalyzeThroughput(const SchemaSet &schema_set,
+                                   const std::vector<std::shared_ptr<arrow::RecordBatch>> &samples,
+                                   const ThroughputModel &model) {
+  ThroughputReport report;
+  for (const auto &fs : schema_set.schemas()) {
+    const auto &schema = *fs->arrow_schema();
+    auto sample = GetSample(samples, fs->name());
+    if ((sample != nullptr) && (sample->num_columns() != schema.num_fields())) {
+      FLETCHER_LOG(WARNING, "Sample RecordBatch does not match schema " + fs->name() + ". Ignoring sample.");
+      sample = nullptr;
+    }
+
+    for (int i = 0; i < schema.num_fields(); i++) {
+      const auto &field = *schema.field(i);
+      if (fletcher::MustIgnore(field)) {
+        continue;
+      }
+      // Every Array(Reader/Writer) uses the default bus specification, see Array() in array.cc, on the memory channel
+      // of its field. The Mantle generates an arbiter for every unique bus specification.
+      BusSpec spec;
+      spec.function = fs->mode() == Mode::READ ? BusFunction::READ : BusFunction::WRITE;
+      spec.channel = fletcher::GetBusChannel(schema, field);
+      auto arbiter = std::find_if(report.arbiters.begin(), report.arbiters.end(),
+                                  [&spec](const ArbiterThroughput &a) { return a.spec == spec; });
+      if (arbiter == report.arbiters.end()) {
+        report.arbiters.push_back(ArbiterThroughput{spec, {}, 0.0});
+        arbiter = report.arbiters.end() - 1;
+      }
+
+      FieldThroughput f;
+      f.schema = fs->name();
+      f.field = field.name();
+      f.epc = GetEPC(field);
+      f.lepc = GetLEPC(field);
+      f.burst_max_len = GetBurstMaxLen(schema, field);
+      f.burst_step_len = GetBurstStepLen(schema, field);
+      f.weight = std::max(1, fletcher::GetBusWeight(schema, field));
+
+      std::deque<Buffer> buffers;
+      AnalyzeBuffers(field, sample != nullptr ? sample->column(i).get() : nullptr, 1.0, f.epc, f.lepc, model, &buffers);
+      if (buffers.empty()) {
+        continue;
+      }
+      f.epc_rows_per_cycle = UNLIMITED;
+      for (const auto &b : buffers) {
+        f.bytes_per_row += b.bytes_per_row;
+        if (b.max_rows_per_cycle < f.epc_rows_per_cycle) {
+          f.epc_rows_per_cycle = b.max_rows_per_cycle;
+          f.lepc_limited = b.offsets;
+        }
+      }
+      f.demand = f.epc_rows_per_cycle * f.bytes_per_row;
+      f.burst_efficiency = BurstEfficiency(buffers,
+                                           sample != nullptr ? sample->num_rows() : 0,
+                                           f,
+                                           spec.data_width / 8.0,
+                                           model);
+      arbiter->fields.push_back(report.fields.size());
+      report.fields.push_back(f);
+    }
+  }
+
+  for (auto &a : report.arbiters) {
+    Arbitrate(&a, &report.fields);
+  }
+
+  for (size_t i = 0; i < report.fields.size(); i++) {
+    if (!report.bottleneck || (report.fields[i].rows_per_cycle < report.fields[*report.bottleneck].rows_per_cycle)) {
+      report.bottleneck = i;
+    }
+  }
+  return report;
+}
+
+double ThroughputReport::bandwidth() const {
+  double result = 0.0;
+  for (const auto &f : fields) {
+    result += f.bandwidth();
+  }
+  return result;
+}
+
+std::string ThroughputReport::ToString() const {
+  std::stringstream str;
+  str << std::fixed << std::setprecision(3);
+  for (const auto &a : arbiters) {
+    str << "Arbiter " << a.spec.ToString() << "\n";
+    str << "  Capacity: " << a.spec.data_width / 8 << " B/cycle, utilization: " << 100.0 * a.utilization << " %\n";
+    str << "  " << std::left << std::setw(32) << "Field"
+        << std::right << std::setw(5) << "EPC" << std::setw(6) << "LEPC" << std::setw(7) << "Burst"
+        << std::setw(5) << "Wgt"
+        << std::setw(10) << "B/row" << std::setw(12) << "Demand" << std::setw(10) << "Eff."
+        << std::setw(10) << "Share" << std::setw(12) << "Rows/cycle" << std::setw(12) << "B/cycle" << "  Limit\n";
+    for (auto i : a.fields) {
+      const auto &f = fields[i];
+      str << "  " << std::left << std::setw(32) << (f.schema + "." + f.field)
+          << std::right << std::setw(5) << f.epc << std::setw(6) << f.lepc
+          << std::setw(7) << (std::to_string(f.burst_max_len) + "/" + std::to_string(f.burst_step_len))
+          << std::setw(5) << f.weight
+          << std::setw(10) << f.bytes_per_row << std::setw(12) << f.demand << std::setw(10) << f.burst_efficiency
+          << std::setw(10) << f.share << std::setw(12) << f.rows_per_cycle << std::setw(12) << f.bandwidth()
+          << "  " << (f.bus_limited ? "bus" : (f.lepc_limited ? "lepc" : "epc")) << "\n";
+    }
+  }
+  str << "Total: " << bandwidth() << " B/cycle\n";
+  if (bottleneck) {
+    const auto &f = fields[*bottleneck];
+    str << "Bottleneck: " << f.schema << "." << f.field << " (" << f.rows_per_cycle << " rows/cycle, limited by "
+        << (f.bus_limited ? "bus" : (f.lepc_limited ? "lepc" : "epc")) << ")\n";
+  }
+  return str.str();
+}
+
+/// @brief Return a copy of metadata with some key set to some value.
+static std::shared_ptr<arrow::KeyValueMetadata> SetMeta(const std::shared_ptr<const arrow::KeyValueMetadata> &meta,
+                                                        const std::string &key,
+                                                        const std::string &value) {
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  if (meta != nullptr) {
+    for (int64_t i = 0; i < meta->size(); i++) {
+      if (meta->key(i) != key) {
+        keys.push_back(meta->key(i));
+        values.push_back(meta->value(i));
+      }
+    }
+  }
+  keys.push_back(key);
+  values.push_back(value);
+  return std::make_shared<arrow::KeyValueMetadata>(keys, values);
+}
+
+std::shared_ptr<SchemaSet> Autotune(const SchemaSet &schema_set,
+                                    double target,
+                                    const std::vector<std::shared_ptr<arrow::RecordBatch>> &samples,
+                                    const ThroughputModel &model) {
+  std::vector<std::shared_ptr<arrow::Schema>> schemas;
+  for (const auto &fs : schema_set.schemas()) {
+    schemas.push_back(fs->arrow_schema());
+  }
+  auto schema_index = [&schemas](const std::string &name) {
+    for (size_t i = 0; i < schemas.size(); i++) {
+      if (fletcher::GetMeta(*schemas[i], "fletcher_name") == name) {
+        return i;
+      }
+    }
+    return schemas.size();
+  };
+  auto make_set = [&]() {
+    auto result = SchemaSet::Make(schema_set.name());
+    for (const auto &s : schemas) {
+      result->AppendSchema(s);
+    }
+    result->Sort();
+    return result;
+  };
+
+  // Fields of which no parameter can be raised any further.
+  std::set<std::string> frozen;
+  auto result = make_set();
+  for (int step = 0; step < MAX_AUTOTUNE_STEPS; step++) {
+    auto report = AnalyzeThroughput(*result, samples, model);
+    if ((target > 0.0) && (report.bandwidth() >= target)) {
+      break;
+    }
+
+    // Find the slowest field that can still be tuned.
+    std::optional<size_t> slowest;
+    for (size_t i = 0; i < report.fields.size(); i++) {
+      const auto &f = report.fields[i];
+      if ((frozen.count(f.schema + "." + f.field) == 0)
+          && (!slowest || (f.rows_per_cycle < report.fields[*slowest].rows_per_cycle))) {
+        slowest = i;
+      }
+    }
+    if (!slowest) {
+      break;
+    }
+    const auto &f = report.fields[*slowest];
+    auto s = schema_index(f.schema);
+    auto &schema = schemas[s];
+    auto field_index = schema->GetFieldIndex(f.field);
+    auto field = schema->field(field_index);
+
+    if (f.bus_limited) {
+      // Longer bursts waste fewer cycles. Only raise the burst length of this field, such that fields on other
+      // arbiters and fields that are not limited by the bus keep theirs.
+      const auto &arbiter = *std::find_if(report.arbiters.begin(), report.arbiters.end(),
+                                          [&](const ArbiterThroughput &a) {
+                                            return std::find(a.fields.begin(), a.fields.end(), *slowest)
+                                                != a.fields.end();
+                                          });
+      if (2 * static_cast<size_t>(f.burst_max_len) > arbiter.spec.max_burst) {
+        frozen.insert(f.schema + "." + f.field);
+        continue;
+      }
+      field = field->AddMetadata(SetMeta(field->metadata(), "fletcher_burst_max_len",
+                                         std::to_string(2 * f.burst_max_len)));
+      FLETCHER_LOG(INFO, "Autotune: maximum burst length of " + f.schema + "." + f.field + " set to "
+          + std::to_string(2 * f.burst_max_len));
+    } else if (f.lepc_limited) {
+      if (2 * f.lepc > model.max_epc) {
+        frozen.insert(f.schema + "." + f.field);
+        continue;
+      }
+      field = field->AddMetadata(SetMeta(field->metadata(), "fletcher_lepc", std::to_string(2 * f.lepc)));
+      FLETCHER_LOG(INFO, "Autotune: LEPC of " + f.schema + "." + f.field + " set to " + std::to_string(2 * f.lepc));
+    } else {
+      auto width = ElementWidth(*field->type());
+      if ((width == 0) || (2 * f.epc > model.max_epc)
+          || (static_cast<size_t>(2 * f.epc * width) > BusSpec().data_width)) {
+        frozen.insert(f.schema + "." + f.field);
+        continue;
+      }
+      field = field->AddMetadata(SetMeta(field->metadata(), "fletcher_epc", std::to_string(2 * f.epc)));
+      FLETCHER_LOG(INFO, "Autotune: EPC of " + f.schema + "." + f.field + " set to " + std::to_string(2 * f.epc));
+    }
+    auto fields = schema->fields();
+    fields[field_index] = field;
+    schema = std::make_shared<arrow::Schema>(fields, schema->metadata());
+    result = make_set();
+  }
+  return result;
+}
+
+}  // namespace fletchgen
@@ -0,0 +1,133 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <arrow/api.h>
+#include <fletcher/common.h>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fletchgen/bus.h"
+#include "fletchgen/schema.h"
+
+namespace fletchgen {
+
+/// @brief Parameters of the throughput model.
+struct ThroughputModel {
+  /// Bus cycles lost for every burst, e.g. due to arbitration and request handshaking.
+  double burst_overhead = 1.0;
+  /// Average number of elements of list and string fields, used when no sample RecordBatch is available.
+  double default_list_length = 16.0;
+  /// Maximum elements-per-cycle and lengths-per-cycle the autotuner may select.
+  int max_epc = 64;
+};
+
+/// @brief Predicted throughput of the Array(Reader/Writer) of a single field.
+struct FieldThroughput {
+  std::string schema;
+  std::string field;
+  /// Elements per cycle.
+  int epc = 1;
+  /// Lengths per cycle.
+  int lepc = 1;
+  /// Maximum burst length in beats.
+  int burst_max_len = 0;
+  /// Burst step length in beats.
+  int burst_step_len = 0;
+  /// Arbitration weight of the bus of this field.
+  int weight = 1;
+  /// Number of bytes of all buffers of a single row.
+  double bytes_per_row = 0.0;
+  /// Number of rows per cycle the kernel side of the Array(Reader/Writer) can handle, limited by (L)EPC.
+  double epc_rows_per_cycle = 0.0;
+  /// True if epc_rows_per_cycle is limited by the lengths-per-cycle rather than the elements-per-cycle.
+  bool lepc_limited = false;
+  /// Bus demand in bytes per cycle at epc_rows_per_cycle.
+  double demand = 0.0;
+  /// Fraction of the bus cycles used by bursts of this field that transfer useful data.
+  double burst_efficiency = 1.0;
+  /// Fraction of the bus cycles of the arbiter granted to this field.
+  double share = 0.0;
+  /// Predicted number of rows per cycle after arbitration.
+  double rows_per_cycle = 0.0;
+  /// True if the field is limited by its share of the bus rather than its (L)EPC.
+  bool bus_limited = false;
+
+  /// @brief Return the predicted number of useful bytes per cycle.
+  double bandwidth() const { return rows_per_cycle * bytes_per_row; }
+};
+
+/// @brief Predicted utilization of a bus arbiter, i.e. a BusReadArbiterVec or BusWriteArbiterVec.
+struct ArbiterThroughput {
+  BusSpec spec;
+  /// Indices of the fields of this arbiter in the report.
+  std::deque<size_t> fields;
+  /// Fraction of the bus cycles that are used.
+  double utilization = 0.0;
+};
+
+/// @brief Predicted throughput of all fields of a SchemaSet.
+struct ThroughputReport {
+  std::deque<FieldThroughput> fields;
+  std::deque<ArbiterThroughput> arbiters;
+  /// Index of the field with the lowest number of rows per cycle, if any.
+  std::optional<size_t> bottleneck;
+
+  /// @brief Return the total predicted number of useful bytes per cycle.
+  double bandwidth() const;
+  /// @brief Return a human-readable report.
+  std::string ToString() const;
+};
+
+/**
+ * @brief Predict the bus throughput of every field of a SchemaSet, before synthesis.
+ *
+ * For every field, the bytes per row and the number of rows per cycle allowed by its (L)EPC are derived from its type.
+ * Every arbiter provides one beat per bus cycle, which it shares between the fields connected to it in proportion to
+ * their bus arbitration weights (weighted round-robin). Every burst loses some cycles, and with sample data, partially
+ * used burst steps at the end of buffers are taken into account. The model assumes the kernel and bus clock domains run
+ * at the same frequency.
+ *
+ * @param schema_set  The SchemaSet to analyze.
+ * @param samples     Optional sample RecordBatches, used to determine the average length of list and string fields.
+ * @param model       The model parameters.
+ * @return            The report.
+ */
+ThroughputReport AnalyzeThroughput(const SchemaSet &schema_set,
+                                   const std::vector<std::shared_ptr<arrow::RecordBatch>> &samples = {},
+                                   const ThroughputModel &model = ThroughputModel());
+
+/**
+ * @brief Tune the (L)EPC and burst lengths of a SchemaSet to reach a target bandwidth.
+ *
+ * Repeatedly raises the EPC or LEPC of the bottleneck field, or its maximum burst length if it is limited by the bus,
+ * until the predicted bandwidth reaches the target or no parameter can be raised any further.
+ *
+ * @param schema_set  The SchemaSet to tune.
+ * @param target      The target bandwidth in bytes per cycle. Zero or less tunes until the buses are saturated.
+ * @param samples     Optional sample RecordBatches.
+ * @param model       The model parameters.
+ * @return            A new SchemaSet with the tuned parameters in the Fletcher metadata of its schemas and fields.
+ */
+std::shared_ptr<SchemaSet> Autotune(const SchemaSet &schema_set,
+                                    double target,
+                                    const std::vector<std::shared_ptr<arrow::RecordBatch>> &samples = {},
+                                    const ThroughputModel &model = ThroughputModel());
+
+}  // namespace fletchgen
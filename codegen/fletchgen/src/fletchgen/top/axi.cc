@@ -43,13 +43,12 @@ std::string GenerateAXITop(const std::shared_ptr<Mantle> &mantle, const std::vec
   t.Replace("MMIO_ADDR_WIDTH", 32);
   t.Replace("MMIO_DATA_WIDTH", 32);
 
-  // Do not change this order, TODO: fix this in replacement code
   t.Replace("FLETCHER_WRAPPER_NAME", mantle->name());
   t.Replace("FLETCHER_WRAPPER_INST_NAME", mantle->name() + "_inst");
 
   for (auto &o : outputs) {
     o->flush();
-    *o << t.ToString();
+    t.Render(o);
   }
 
   return t.ToString();
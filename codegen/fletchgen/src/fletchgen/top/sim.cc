@@ -57,6 +57,14 @@ std::string GenerateSimTop(const Mantle &mantle,
   auto read_schemas = mantle.schema_set()->read_schemas();
   auto write_schemas = mantle.schema_set()->write_schemas();
 
+  // The simulation top-level only models the memory of the first channel.
+  for (const auto &b : mantle.GetAll<BusPort>()) {
+    if (b->spec_.channel > 0) {
+      FLETCHER_LOG(WARNING, "Simulation top-level does not support multiple memory channels. Port " + b->name()
+          + " is left unconnected.");
+    }
+  }
+
   // Total number of RecordBatches
   size_t num_rbs = read_schemas.size() + write_schemas.size();
 
@@ -71,7 +79,6 @@ std::string GenerateSimTop(const Mantle &mantle,
   t.Replace("BUS_BURST_STEP_LEN", 1);
   t.Replace("BUS_BURST_MAX_LEN", 64);
 
-  // Do not change this order, TODO: fix this in replacement code
   t.Replace("FLETCHER_WRAPPER_NAME", mantle.name());
   t.Replace("FLETCHER_WRAPPER_INST_NAME", mantle.name() + "_inst");
 
@@ -79,8 +86,8 @@ std::string GenerateSimTop(const Mantle &mantle,
   t.Replace("WRITE_SREC_PATH", write_srec_path);
 
   // Generate all the buffer and recordbatch metadata
-  std::stringstream buffer_meta;
-  std::stringstream rb_meta;
+  t.Replace("SREC_BUFFER_ADDRESSES", "");
+  t.Replace("SREC_FIRSTLAST_INDICES", "");
 
   FLETCHER_LOG(DEBUG, "SIM: Generating MMIO writes for " << num_rbs << " RecordBatches.");
 
@@ -94,17 +101,15 @@ std::string GenerateSimTop(const Mantle &mantle,
       auto addr_lo = (uint32_t) (addr & 0xFFFFFFFF);
       auto addr_hi = (uint32_t) (addr >> 32u);
       uint32_t buffer_idx = 2 * (buffer_offset) + (ndefault + 2 * num_rbs);
-      buffer_meta << GenMMIOWrite(buffer_idx, addr_lo, rb.name + " " + rb.buffers[i].desc_);
-      buffer_meta << GenMMIOWrite(buffer_idx + 1, addr_hi);
+      t.Append("SREC_BUFFER_ADDRESSES", GenMMIOWrite(buffer_idx, addr_lo, rb.name + " " + rb.buffers[i].desc_));
+      t.Append("SREC_BUFFER_ADDRESSES", GenMMIOWrite(buffer_idx + 1, addr_hi));
       buffer_offset++;
     }
     uint32_t rb_idx = 2 * (rb_offset) + ndefault;
-    rb_meta << GenMMIOWrite(rb_idx, 0, rb.name + " first index");
-    rb_meta << GenMMIOWrite(rb_idx + 1, rb.rows, rb.name + " last index");
+    t.Append("SREC_FIRSTLAST_INDICES", GenMMIOWrite(rb_idx, 0, rb.name + " first index"));
+    t.Append("SREC_FIRSTLAST_INDICES", GenMMIOWrite(rb_idx + 1, rb.rows, rb.name + " last index"));
     rb_offset++;
   }
-  t.Replace("SREC_BUFFER_ADDRESSES", buffer_meta.str());
-  t.Replace("SREC_FIRSTLAST_INDICES", rb_meta.str());
 
   // Read/write specific memory models
   if (mantle.schema_set()->RequiresReading()) {
@@ -217,7 +222,7 @@ std::string GenerateSimTop(const Mantle &mantle,
 
   for (auto &o : outputs) {
     o->flush();
-    *o << t.ToString();
+    t.Render(o);
   }
 
   return t.ToString();
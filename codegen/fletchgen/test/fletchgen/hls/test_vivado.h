@@ -0,0 +1,69 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <arrow/api.h>
+#include <cerata/api.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "fletcher/test_schemas.h"
+
+#include "fletchgen/mantle.h"
+#include "fletchgen/hls/vivado.h"
+
+namespace fletchgen::hls {
+
+TEST(VivadoHLS, Streams) {
+  ASSERT_EQ(*GetPacketType(*arrow::int8()), "f_int8");
+  ASSERT_EQ(*GetPacketType(*arrow::float32(), 8), "f_mfloat32<8>");
+  ASSERT_FALSE(GetPacketType(*arrow::utf8()));
+
+  // A string field has a length stream and a character stream with the EPC of the field.
+  auto string_field = fletcher::GetStringReadSchemaWithEPC(4)->field(0);
+  auto streams = GetStreams(*string_field, "StringRead_Name");
+  ASSERT_EQ(streams.size(), 2);
+  ASSERT_EQ(streams[0].name, "StringRead_Name_length");
+  ASSERT_EQ(streams[0].type, "f_size");
+  ASSERT_TRUE(streams[0].per_row);
+  ASSERT_EQ(streams[1].name, "StringRead_Name_chars");
+  ASSERT_EQ(streams[1].type, "f_muint8<4>");
+  ASSERT_FALSE(streams[1].per_row);
+
+  // Struct children are flattened.
+  auto struct_field = fletcher::GetStructSchema()->field(0);
+  ASSERT_GT(GetStreams(*struct_field, "s").size(), 1);
+}
+
+TEST(VivadoHLS, Template) {
+  cerata::default_component_pool()->Clear();
+  auto set = SchemaSet::Make("Kernel");
+  set->AppendSchema(fletcher::GetStringReadSchemaWithEPC(4));
+  set->AppendSchema(fletcher::GetPrimWriteSchema());
+  auto mantle = Mantle::Make(set);
+  auto code = GenerateVivadoHLSTemplate(*mantle->kernel());
+  std::cout << code << std::endl;
+  ASSERT_NE(code.find("void Kernel("), std::string::npos);
+  ASSERT_NE(code.find("#pragma HLS DATAFLOW"), std::string::npos);
+  ASSERT_NE(code.find("#pragma HLS PIPELINE II=1"), std::string::npos);
+  ASSERT_NE(code.find("hls::stream<f_muint8<4>> &StringRead_Name_chars"), std::string::npos);
+  ASSERT_NE(code.find("StringRead_Name_unl"), std::string::npos);
+  ASSERT_NE(code.find("PrimWrite_number.write(packet);"), std::string::npos);
+}
+
+}  // namespace fletchgen::hls
@@ -16,6 +16,8 @@
 
 #include <deque>
 #include <memory>
+#include <sstream>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -85,6 +87,185 @@ TEST(SREC, File) {
   free(result);
 }
 
+TEST(SREC, Writer) {
+  std::vector<uint8_t> data(100);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  // Contiguous writes must result in the same records as a single contiguous buffer.
+  std::stringstream expected;
+  File(0, data.data(), data.size()).write(&expected);
+  std::stringstream streamed;
+  {
+    Writer writer(&streamed);
+    writer.Header();
+    writer.Write(0, data.data(), 10);
+    writer.Write(10, data.data() + 10, 40);
+    writer.Write(50, data.data() + 50, 50);
+    ASSERT_EQ(writer.num_records(), 1 + 3);
+  }
+  ASSERT_EQ(streamed.str(), expected.str());
+
+  // Encoding with multiple threads must not change the output.
+  std::vector<uint8_t> large(3 * Writer::THREAD_BLOCK_SIZE + 17);
+  for (size_t i = 0; i < large.size(); i++) {
+    large[i] = static_cast<uint8_t>(i ^ (i >> 8u));
+  }
+  std::stringstream single;
+  std::stringstream parallel;
+  {
+    Writer single_writer(&single, 1);
+    single_writer.Write(3, large.data(), large.size());
+    single_writer.Write(3 + large.size(), nullptr, 15);
+    Writer parallel_writer(&parallel, 4, 4096);
+    parallel_writer.Write(3, large.data(), large.size());
+    parallel_writer.Write(3 + large.size(), nullptr, 15);
+  }
+  ASSERT_EQ(single.str(), parallel.str());
+}
+
+TEST(SREC, Reader) {
+  std::stringstream input("S00600004844521B\n"
+                          "S1130000285F245F2212226A000424290008237C2A\r\n"
+                          "\n"
+                          "S107003000144ED492\n");
+  Reader reader(&input);
+  ASSERT_TRUE(reader.Next());
+  ASSERT_EQ(reader.type(), Record::HEADER);
+  ASSERT_EQ(reader.size(), 3);
+  ASSERT_EQ(memcmp(reader.data(), "HDR", 3), 0);
+  ASSERT_TRUE(reader.Next());
+  ASSERT_EQ(reader.type(), Record::DATA16);
+  ASSERT_EQ(reader.address(), 0x00);
+  ASSERT_EQ(reader.size(), 16);
+  ASSERT_EQ(reader.data()[15], 0x7C);
+  ASSERT_TRUE(reader.Next());
+  ASSERT_EQ(reader.address(), 0x30);
+  ASSERT_EQ(reader.size(), 4);
+  ASSERT_FALSE(reader.Next());
+
+  // Invalid checksum.
+  std::stringstream invalid("S107003000144ED493\n");
+  Reader invalid_reader(&invalid);
+  ASSERT_THROW(invalid_reader.Next(), std::runtime_error);
+
+  // S1 record with a valid checksum, but more data bytes than a record of every type can hold.
+  auto oversized = "S1FF" + std::string(2 * (0xFF), '0');
+  ASSERT_FALSE(Record::FromString(oversized));
+  std::stringstream oversized_input(oversized + "\n");
+  Reader oversized_reader(&oversized_input);
+  ASSERT_THROW(oversized_reader.Next(), std::runtime_error);
+}
+
+TEST(SREC, MemoryImage) {
+  std::vector<uint8_t> data(200);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  std::stringstream srec;
+  {
+    Writer writer(&srec);
+    writer.Header();
+    writer.Write(0, data.data(), 100);
+    writer.Write(1000, data.data() + 100, 50);
+    // Overlaps the end of the previous segment.
+    writer.Write(1040, data.data() + 150, 50);
+  }
+  MemoryImage image(&srec);
+  ASSERT_EQ(image.num_segments(), 2);
+  // Regions within a segment are slices of the same buffer.
+  auto a = image.Get(10, 20);
+  auto b = image.Get(40, 20);
+  ASSERT_EQ(a->data() + 30, b->data());
+  ASSERT_EQ(memcmp(a->data(), data.data() + 10, 20), 0);
+  // The most recent data takes precedence.
+  auto c = image.Get(1030, 20);
+  ASSERT_EQ(memcmp(c->data(), data.data() + 130, 10), 0);
+  ASSERT_EQ(memcmp(c->data() + 10, data.data() + 150, 10), 0);
+  // Regions outside the image are zero.
+  auto d = image.Get(90, 20);
+  ASSERT_EQ(memcmp(d->data(), data.data() + 90, 10), 0);
+  ASSERT_EQ(d->data()[10], 0);
+}
+
+TEST(SREC, ReadRecordBatches) {
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches = {fletcher::GetStringRB(),
+                                                               fletcher::GetListUint8RB(),
+                                                               fletcher::GetStructRB()};
+  std::vector<fletcher::RecordBatchDescription> meta;
+  for (const auto &rb : batches) {
+    fletcher::RecordBatchDescription desc;
+    fletcher::RecordBatchAnalyzer(&desc).Analyze(*rb);
+    meta.push_back(desc);
+  }
+  auto layout = GetSRECLayout(meta);
+  std::stringstream srec;
+  GenerateReadSREC(meta, layout, &srec);
+
+  std::deque<std::shared_ptr<arrow::Schema>> schemas;
+  std::vector<uint64_t> num_rows;
+  std::vector<uint64_t> buf_offsets;
+  for (size_t i = 0; i < batches.size(); i++) {
+    schemas.push_back(batches[i]->schema());
+    num_rows.push_back(batches[i]->num_rows());
+    for (const auto &buf : layout[i].buffers) {
+      buf_offsets.push_back(reinterpret_cast<uint64_t>(buf.raw_buffer_));
+    }
+  }
+  auto result = ReadRecordBatchesFromSREC(&srec, schemas, num_rows, buf_offsets);
+  ASSERT_EQ(result.size(), batches.size());
+  for (size_t i = 0; i < batches.size(); i++) {
+    // Builders may name the children of nested types differently than the schema does, so compare with the schema type.
+    auto expected = batches[i]->column(0)->data()->Copy();
+    expected->type = schemas[i]->field(0)->type();
+    ASSERT_TRUE(result[i]->column(0)->Equals(arrow::MakeArray(expected)));
+  }
+}
+
+TEST(SREC, CompareDump) {
+  auto expected = fletcher::GetStringRB();
+  auto read_schema = fletcher::GetStringReadSchema();
+  auto write_schema = fletcher::GetStringWriteSchema();
+  std::vector<fletcher::RecordBatchDescription> meta(2);
+  fletcher::RecordBatchAnalyzer(&meta[0]).Analyze(*expected);
+  fletcher::SchemaAnalyzer(&meta[1]).Analyze(*write_schema);
+
+  // The buffers of the write-mode RecordBatch are placed behind those of the read-mode RecordBatch.
+  auto layout = GetSRECLayout(meta, 64, 4096);
+  // 27 offsets padded to 128 bytes, 133 characters padded to 192 bytes.
+  ASSERT_EQ(reinterpret_cast<uint64_t>(layout[1].buffers[0].raw_buffer_), 128 + 192);
+  ASSERT_EQ(reinterpret_cast<uint64_t>(layout[1].buffers[1].raw_buffer_), 128 + 192 + 4096);
+
+  // Emulate a kernel that copies the strings from the read-mode to the write-mode RecordBatch.
+  auto values = meta[0].buffers[1];
+  std::vector<uint8_t> corrupted(values.raw_buffer_, values.raw_buffer_ + values.size_);
+  corrupted[0] = 'B';
+  auto offsets = meta[0].buffers[0];
+  auto dump = [&](const uint8_t *values_data, const uint8_t *offsets_data) {
+    std::stringstream out;
+    Writer writer(&out);
+    writer.Write(reinterpret_cast<uint64_t>(layout[1].buffers[0].raw_buffer_), offsets_data, offsets.size_);
+    writer.Write(reinterpret_cast<uint64_t>(layout[1].buffers[1].raw_buffer_), values_data, values.size_);
+    writer.Flush();
+    return out.str();
+  };
+  auto reference = arrow::RecordBatch::Make(write_schema, expected->num_rows(), {expected->column(0)});
+  std::stringstream good(dump(values.raw_buffer_, offsets.raw_buffer_));
+  ASSERT_EQ(CompareSRECDump(&good, {read_schema, write_schema}, layout, {reference}), 0);
+  std::stringstream bad(dump(corrupted.data(), offsets.raw_buffer_));
+  ASSERT_EQ(CompareSRECDump(&bad, {read_schema, write_schema}, layout, {reference}), 1);
+
+  // Offsets that point beyond the image or decrease are reported as a mismatch.
+  std::vector<int32_t> bad_offsets(reinterpret_cast<const int32_t *>(offsets.raw_buffer_),
+                                   reinterpret_cast<const int32_t *>(offsets.raw_buffer_ + offsets.size_));
+  bad_offsets.back() = 0x7FFFFFFF;
+  std::stringstream beyond(dump(values.raw_buffer_, reinterpret_cast<const uint8_t *>(bad_offsets.data())));
+  ASSERT_EQ(CompareSRECDump(&beyond, {read_schema, write_schema}, layout, {reference}), 1);
+  bad_offsets.back() = 0;
+  std::stringstream decreasing(dump(values.raw_buffer_, reinterpret_cast<const uint8_t *>(bad_offsets.data())));
+  ASSERT_EQ(CompareSRECDump(&decreasing, {read_schema, write_schema}, layout, {reference}), 1);
+}
+
 TEST(SREC, RecordBatchRoundTrip) {
   // Get a recordbatch with some integers
   auto rb = fletcher::GetStringRB();
@@ -19,7 +19,12 @@
 #include "fletchgen/test_kernel.h"
 #include "fletchgen/test_mantle.h"
 #include "fletchgen/test_recordbatch.h"
+#include "fletchgen/test_scaling.h"
+#include "fletchgen/test_cache.h"
+#include "fletchgen/test_throughput.h"
+#include "fletchgen/test_regmap.h"
 #include "fletchgen/srec/test_srec.h"
+#include "fletchgen/hls/test_vivado.h"
 
 void Log(int level, const std::string &msg, char const *source_fun, char const *source_file, int line_num) {
   std::cout << source_file << ":" << line_num << ":" << source_fun << ": " << msg << std::endl;
@@ -0,0 +1,84 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <arrow/api.h>
+#include <cerata/api.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fletcher/test_schemas.h"
+
+#include "fletchgen/cache.h"
+#include "fletchgen/design.h"
+
+namespace fletchgen {
+
+TEST(Cache, Fingerprint) {
+  auto prim = Fingerprint(*fletcher::GetPrimReadSchema());
+  ASSERT_EQ(prim, Fingerprint(*fletcher::GetPrimReadSchema()));
+  ASSERT_NE(prim, Fingerprint(*fletcher::GetPrimWriteSchema()));
+  // Fletcher metadata of fields is part of the fingerprint.
+  ASSERT_NE(Fingerprint(*fletcher::GetStringReadSchemaWithEPC(1)),
+            Fingerprint(*fletcher::GetStringReadSchemaWithEPC(4)));
+  // So are the options that change the generated components.
+  Options options;
+  options.kernel_name = "Other";
+  ASSERT_NE(prim, Fingerprint(*fletcher::GetPrimReadSchema(), options));
+}
+
+TEST(Cache, Incremental) {
+  const std::string dir = "Cache_Incremental";
+  std::remove((dir + "/fletchgen.cache").c_str());
+
+  auto options = std::make_shared<Options>();
+  options->schemas = {fletcher::GetPrimReadSchema(), fletcher::GetStringReadSchemaWithEPC(1)};
+  cerata::default_component_pool()->Clear();
+  auto design = Design::GenerateFrom(options);
+  auto outputs = design.GetOutputSpec();
+
+  // Nothing is cached yet.
+  auto cache = Cache::Load(dir);
+  ASSERT_EQ(cache.Stale(outputs, "dot").size(), outputs.size());
+  cerata::dot::DOTOutputGenerator dot(".", outputs);
+  dot.Generate();
+  cache.Update(outputs, &dot);
+  cache.Save();
+
+  // Running again with the same inputs regenerates nothing.
+  auto reloaded = Cache::Load(dir);
+  ASSERT_EQ(reloaded.entries().size(), outputs.size());
+  ASSERT_TRUE(reloaded.Stale(outputs, "dot").empty());
+
+  // Changing a schema affects its RecordBatch, the Mantle and the Kernel, but not the other RecordBatches.
+  options->schemas[1] = fletcher::GetStringReadSchemaWithEPC(4);
+  cerata::default_component_pool()->Clear();
+  auto changed_design = Design::GenerateFrom(options);
+  auto stale = reloaded.Stale(changed_design.GetOutputSpec(), "dot");
+  ASSERT_EQ(stale.size(), 3);
+  for (const auto &o : stale) {
+    ASSERT_NE(o.comp->name(), "PrimRead");
+  }
+
+  // Files that were removed are regenerated.
+  std::remove(reloaded.entries().at("dot/PrimRead").path.c_str());
+  ASSERT_EQ(reloaded.Stale(outputs, "dot").size(), 1);
+}
+
+}  // namespace fletchgen
@@ -42,5 +42,70 @@ TEST(Mantle, StringRead) {
   TestReadMantle(fletcher::GetStringReadSchema());
 }
 
+TEST(Mantle, MemoryChannels) {
+  cerata::default_component_pool()->Clear();
+  // Field b is on channel 1, the other fields on channel 0.
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               fletcher::AppendMetaBusChannel(*arrow::field("b", arrow::uint64(), false), 1),
+                               arrow::field("c", arrow::uint64(), false)});
+  auto set = SchemaSet::Make("test");
+  set->AppendSchema(fletcher::AppendMetaRequired(*schema, "Channels", Mode::READ));
+  auto mantle = Mantle::Make(set);
+  // Every channel gets its own arbiter and master port.
+  ASSERT_EQ(mantle->GetAll<BusPort>().size(), 2);
+  ASSERT_EQ(mantle->port("rd_mst")->sources().size(), 1);
+  ASSERT_EQ(mantle->port("rd_mst_ch1")->sources().size(), 1);
+  // A RecordBatchReader, the Kernel and two arbiters.
+  ASSERT_EQ(mantle->children().size(), 4);
+  auto design = cerata::vhdl::Design(mantle);
+  auto code = design.Generate().ToString();
+  VHDL_DUMP_TEST(code);
+}
+
+TEST(Mantle, BusWeights) {
+  cerata::default_component_pool()->Clear();
+  // Field c gets four times the bus share of the other fields.
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               arrow::field("b", arrow::uint64(), false),
+                               fletcher::AppendMetaBusWeight(*arrow::field("c", arrow::uint64(), false), 4)});
+  auto set = SchemaSet::Make("test");
+  set->AppendSchema(fletcher::AppendMetaRequired(*schema, "Weights", Mode::READ));
+  auto mantle = Mantle::Make(set);
+  auto design = cerata::vhdl::Design(mantle);
+  auto code = design.Generate().ToString();
+  VHDL_DUMP_TEST(code);
+  ASSERT_NE(code.find("ARB_METHOD      => \"WEIGHTED\""), std::string::npos);
+  ASSERT_NE(code.find("SLV_WEIGHTS     => \"1,1,4\""), std::string::npos);
+  ASSERT_NE(code.find("MAX_OUTSTANDING => 6"), std::string::npos);
+}
+
+TEST(Mantle, BurstRegisters) {
+  cerata::default_component_pool()->Clear();
+  // Field b gets a run-time maximum burst length.
+  auto meta = arrow::key_value_metadata({"fletcher_burst_reg"}, {"true"});
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               arrow::field("b", arrow::uint64(), false, meta)});
+  auto set = SchemaSet::Make("test");
+  set->AppendSchema(fletcher::AppendMetaRequired(*schema, "Bursts", Mode::READ));
+  auto mantle = Mantle::Make(set);
+  auto design = cerata::vhdl::Design(mantle);
+  auto code = design.Generate().ToString();
+  VHDL_DUMP_TEST(code);
+  // The kernel drives the maximum burst length of field b only.
+  ASSERT_NE(code.find("Bursts_b_burst_max_len"), std::string::npos);
+  ASSERT_EQ(code.find("Bursts_a_burst_max_len"), std::string::npos);
+}
+
+TEST(Mantle, Verilog) {
+  cerata::default_component_pool()->Clear();
+  auto set = SchemaSet::Make("test");
+  set->AppendSchema(fletcher::GetStringReadSchema());
+  auto mantle = Mantle::Make(set);
+  auto code = cerata::verilog::Design(mantle).Generate().ToString();
+  std::cout << code << std::endl;
+  ASSERT_EQ(code.find("module " + mantle->name() + " #("), 0);
+  ASSERT_NE(code.find("endmodule"), std::string::npos);
+}
+
 
 }
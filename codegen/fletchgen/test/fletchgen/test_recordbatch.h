@@ -49,4 +49,31 @@ TEST(RecordBatch, StringRead) {
   TestRecordBatchReader(fletcher::GetStringReadSchema());
 }
 
+TEST(RecordBatch, BurstRegister) {
+  cerata::default_component_pool()->Clear();
+  auto meta = arrow::key_value_metadata({"fletcher_burst_reg"}, {"true"});
+  auto schema = arrow::schema({arrow::field("b", arrow::uint64(), false, meta)});
+  auto fs = FletcherSchema::Make(fletcher::AppendMetaRequired(*schema, "Bursts", fletcher::Mode::READ));
+  auto rbr = RecordBatch::Make(fs);
+  auto code = cerata::vhdl::Design(rbr).Generate().ToString();
+  VHDL_DUMP_TEST(code);
+  ASSERT_NE(code.find("BURST_LIMIT_ENABLE"), std::string::npos);
+  ASSERT_NE(code.find("burst_max_len"), std::string::npos);
+}
+
+TEST(RecordBatch, ProfileCounters) {
+  cerata::default_component_pool()->Clear();
+  auto meta = arrow::key_value_metadata({"fletcher_profile"}, {"true"});
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               arrow::field("b", arrow::uint64(), false, meta)});
+  auto fs = FletcherSchema::Make(fletcher::AppendMetaRequired(*schema, "Prof", fletcher::Mode::WRITE));
+  auto rbw = RecordBatch::Make(fs);
+  auto code = cerata::vhdl::Design(rbw).Generate().ToString();
+  VHDL_DUMP_TEST(code);
+  // Only the ArrayWriter of field b is profiled.
+  ASSERT_NE(code.find("PROFILE_ENABLE"), std::string::npos);
+  ASSERT_NE(code.find("Prof_b_prof_stall_cycles"), std::string::npos);
+  ASSERT_EQ(code.find("Prof_a_prof"), std::string::npos);
+}
+
 }
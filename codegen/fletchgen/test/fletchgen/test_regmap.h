@@ -0,0 +1,125 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <fletcher/fletcher.h>
+#include <fletcher/common.h>
+
+#include <string>
+#include <vector>
+
+#include "fletcher/test_schemas.h"
+
+#include "fletchgen/host/regmap.h"
+
+namespace fletchgen::host {
+
+static std::vector<fletcher::RecordBatchDescription> GetDescriptions() {
+  std::vector<fletcher::RecordBatchDescription> result;
+  for (const auto &schema : {fletcher::GetPrimReadSchema(), fletcher::GetStringReadSchema()}) {
+    fletcher::RecordBatchDescription rbd;
+    fletcher::SchemaAnalyzer sa(&rbd);
+    sa.Analyze(*schema);
+    result.push_back(rbd);
+  }
+  return result;
+}
+
+TEST(RegisterMap, Offsets) {
+  auto map = RegisterMap::Make(GetDescriptions(), {"result addr", "result addr"});
+  ASSERT_EQ(map.recordbatches.size(), 2);
+  ASSERT_EQ(map.num_buffers, 3);
+
+  // Ranges follow the default registers.
+  ASSERT_EQ(map.ranges[0].name, "PRIMREAD_FIRSTIDX");
+  ASSERT_EQ(map.ranges[0].offset, FLETCHER_REG_SCHEMA);
+  ASSERT_EQ(map.ranges[3].name, "STRINGREAD_LASTIDX");
+  ASSERT_EQ(map.ranges[3].offset, FLETCHER_REG_SCHEMA + 3);
+
+  // Buffer addresses follow the ranges.
+  ASSERT_EQ(map.buffers.size(), 6);
+  ASSERT_EQ(map.buffers[0].offset, FLETCHER_REG_SCHEMA + 4);
+  ASSERT_EQ(map.buffers[2].name.rfind("STRINGREAD_NAME", 0), 0);
+  ASSERT_EQ(map.buffers[5].offset, FLETCHER_REG_SCHEMA + 9);
+
+  // User registers come last and have unique names.
+  ASSERT_EQ(map.user[0].name, "USER_RESULT_ADDR");
+  ASSERT_EQ(map.user[1].name, "USER_RESULT_ADDR_1");
+  ASSERT_EQ(map.user[1].offset, FLETCHER_REG_SCHEMA + 11);
+  ASSERT_EQ(map.num_regs(), FLETCHER_REG_SCHEMA + 12);
+}
+
+TEST(RegisterMap, Header) {
+  auto map = RegisterMap::Make(GetDescriptions(), {"threshold"});
+  auto header = GenerateRegisterHeader("Kernel", map);
+  ASSERT_NE(header.find("namespace kernel_mmio {"), std::string::npos);
+  ASSERT_NE(header.find("constexpr uint32_t PRIMREAD_FIRSTIDX = 4;"), std::string::npos);
+  ASSERT_NE(header.find("constexpr uint32_t USER_THRESHOLD = 14;"), std::string::npos);
+  ASSERT_NE(header.find("constexpr uint32_t NUM_REGS = 15;"), std::string::npos);
+  ASSERT_NE(header.find("void SetStringreadRange(int32_t first, int32_t last)"), std::string::npos);
+  ASSERT_NE(header.find("void SetThreshold(uint32_t value)"), std::string::npos);
+  ASSERT_NE(header.find("WriteMMIORange(FLETCHER_REG_SCHEMA"), std::string::npos);
+}
+
+TEST(RegisterMap, BurstRegisters) {
+  // Field b gets a run-time maximum burst length register.
+  auto meta = arrow::key_value_metadata({"fletcher_burst_reg"}, {"true"});
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               arrow::field("b", arrow::uint64(), false, meta)});
+  fletcher::RecordBatchDescription rbd;
+  fletcher::SchemaAnalyzer sa(&rbd);
+  sa.Analyze(*fletcher::AppendMetaRequired(*schema, "Bursts", fletcher::Mode::READ));
+
+  auto map = RegisterMap::Make({rbd}, {"threshold"});
+  ASSERT_EQ(map.bursts.size(), 1);
+  ASSERT_EQ(map.bursts[0].name, "BURSTS_B_BURST_MAX_LEN");
+  // Burst registers follow the buffer addresses, user registers follow the burst registers.
+  ASSERT_EQ(map.bursts[0].offset, FLETCHER_REG_SCHEMA + 6);
+  ASSERT_EQ(map.user[0].offset, FLETCHER_REG_SCHEMA + 7);
+  ASSERT_EQ(map.num_regs(), FLETCHER_REG_SCHEMA + 8);
+
+  auto header = GenerateRegisterHeader("Kernel", map);
+  ASSERT_NE(header.find("void SetBurstsBBurstMaxLen(uint32_t beats)"), std::string::npos);
+}
+
+TEST(RegisterMap, ProfileCounters) {
+  // Field b is profiled and has a burst register.
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               arrow::field("b", arrow::uint64(), false,
+                                            arrow::key_value_metadata({"fletcher_burst_reg", "fletcher_profile"},
+                                                                      {"true", "true"}))});
+  fletcher::RecordBatchDescription rbd;
+  fletcher::SchemaAnalyzer sa(&rbd);
+  sa.Analyze(*fletcher::AppendMetaRequired(*schema, "Prof", fletcher::Mode::READ));
+
+  auto map = RegisterMap::Make({rbd}, {"threshold"});
+  ASSERT_EQ(map.counters.size(), FLETCHER_PROFILE_COUNTERS);
+  // Counters follow the burst registers, user registers follow the counters.
+  ASSERT_EQ(map.counters[0].name, "PROF_B_BUSY_CYCLES");
+  ASSERT_EQ(map.counters[0].offset, FLETCHER_REG_SCHEMA + 7);
+  ASSERT_EQ(map.counters[4].name, "PROF_B_BYTES");
+  ASSERT_EQ(map.user[0].offset, FLETCHER_REG_SCHEMA + 12);
+  ASSERT_EQ(map.num_regs(), FLETCHER_REG_SCHEMA + 13);
+
+  auto header = GenerateRegisterHeader("Kernel", map);
+  ASSERT_NE(header.find("constexpr uint32_t PROF_B_STALL_CYCLES = 14;"), std::string::npos);
+  // The launcher does not write the read-only counters.
+  ASSERT_NE(header.find("WriteMMIORange(FLETCHER_REG_SCHEMA, PROF_B_BUSY_CYCLES - FLETCHER_REG_SCHEMA"),
+            std::string::npos);
+  ASSERT_NE(header.find("WriteMMIORange(USER_THRESHOLD, NUM_REGS - USER_THRESHOLD"), std::string::npos);
+}
+
+}  // namespace fletchgen::host
@@ -0,0 +1,72 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <arrow/api.h>
+#include <cerata/api.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "fletcher/test_schemas.h"
+
+#include "fletchgen/mantle.h"
+
+namespace fletchgen {
+
+/// @brief Generate the Mantle for a schema, report the time it took, and return the Mantle.
+static std::shared_ptr<Mantle> GenerateMantle(const std::shared_ptr<arrow::Schema> &schema, const std::string &what) {
+  auto start = std::chrono::steady_clock::now();
+  cerata::default_component_pool()->Clear();
+  auto set = SchemaSet::Make("test");
+  set->AppendSchema(schema);
+  auto mantle = Mantle::Make(set);
+  auto code = cerata::vhdl::Design(mantle).Generate().ToString();
+  EXPECT_FALSE(code.empty());
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  std::cerr << "Mantle for " << what << ": " << time.count() << " s" << std::endl;
+  return mantle;
+}
+
+TEST(Scaling, WideSchema) {
+  // Schemas of real-world tables can have hundreds of columns.
+  for (size_t width : {8, 128, 800}) {
+    auto mantle = GenerateMantle(fletcher::GetWideSchema(width), std::to_string(width) + " fields");
+    ASSERT_EQ(mantle->recordbatch_components().size(), 1);
+    auto rb = mantle->recordbatch_components()[0];
+    // Every field gets its own ArrayReader, bus port and Arrow port, that must all be found by name.
+    ASSERT_EQ(rb->reader_instances().size(), width);
+    ASSERT_EQ(rb->bus_ports().size(), width);
+    ASSERT_EQ(rb->GetFieldPorts(FieldPort::Function::ARROW).size(), width);
+    auto last = rb->fletcher_schema()->arrow_schema()->field(static_cast<int>(width - 1));
+    ASSERT_EQ(rb->GetArrowPort(*last)->field_, last);
+    // The RecordBatch, the Kernel and a single arbiter.
+    ASSERT_EQ(mantle->children().size(), 3);
+  }
+}
+
+TEST(Scaling, DeepSchema) {
+  for (int depth : {2, 8, 32}) {
+    auto mantle = GenerateMantle(fletcher::GetDeepSchema(depth), "struct depth " + std::to_string(depth));
+    auto rb = mantle->recordbatch_components()[0];
+    // A single ArrayReader reads all nested primitives.
+    ASSERT_EQ(rb->reader_instances().size(), 1);
+    ASSERT_EQ(rb->GetFieldPorts(FieldPort::Function::ARROW).size(), 1);
+  }
+}
+
+}  // namespace fletchgen
@@ -0,0 +1,116 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <arrow/api.h>
+
+#include <memory>
+
+#include "fletcher/test_schemas.h"
+#include "fletcher/test_recordbatches.h"
+
+#include "fletchgen/schema.h"
+#include "fletchgen/throughput.h"
+
+namespace fletchgen {
+
+static std::shared_ptr<SchemaSet> GetSchemaSet(const std::shared_ptr<arrow::Schema> &schema) {
+  auto result = SchemaSet::Make("Throughput");
+  result->AppendSchema(schema);
+  return result;
+}
+
+TEST(Throughput, EPC) {
+  auto report1 = AnalyzeThroughput(*GetSchemaSet(fletcher::GetStringReadSchemaWithEPC(1)));
+  auto report4 = AnalyzeThroughput(*GetSchemaSet(fletcher::GetStringReadSchemaWithEPC(4)));
+  ASSERT_EQ(report1.fields.size(), 1);
+  ASSERT_EQ(report1.arbiters.size(), 1);
+  ASSERT_TRUE(report1.bottleneck);
+  ASSERT_EQ(report4.fields[0].epc, 4);
+  ASSERT_GT(report4.fields[0].rows_per_cycle, report1.fields[0].rows_per_cycle);
+  ASSERT_GT(report4.bandwidth(), report1.bandwidth());
+}
+
+TEST(Throughput, Sample) {
+  // The names in the sample are shorter than the default list length.
+  auto schema_set = GetSchemaSet(fletcher::GetStringReadSchemaWithEPC(1));
+  auto without = AnalyzeThroughput(*schema_set);
+  auto with = AnalyzeThroughput(*schema_set, {fletcher::GetStringRB()});
+  ASSERT_LT(with.fields[0].bytes_per_row, without.fields[0].bytes_per_row);
+  ASSERT_GT(with.fields[0].rows_per_cycle, without.fields[0].rows_per_cycle);
+}
+
+TEST(Throughput, BusWeight) {
+  // Two fields that both demand the whole bus, of which field b has three times the weight of field a.
+  auto epc = arrow::key_value_metadata({"fletcher_epc"}, {"8"});
+  auto weighted_epc = arrow::key_value_metadata({"fletcher_epc", "fletcher_bus_weight"}, {"8", "3"});
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false, epc),
+                               arrow::field("b", arrow::uint64(), false, weighted_epc)});
+  auto report = AnalyzeThroughput(*GetSchemaSet(fletcher::AppendMetaRequired(*schema, "Weights", Mode::READ)));
+  ASSERT_EQ(report.fields.size(), 2);
+  ASSERT_EQ(report.fields[1].weight, 3);
+  ASSERT_TRUE(report.fields[0].bus_limited);
+  ASSERT_TRUE(report.fields[1].bus_limited);
+  ASSERT_DOUBLE_EQ(3 * report.fields[0].share, report.fields[1].share);
+}
+
+TEST(Throughput, Autotune) {
+  auto schema_set = GetSchemaSet(fletcher::GetPrimReadSchema());
+  auto before = AnalyzeThroughput(*schema_set);
+  auto tuned = Autotune(*schema_set, 0.0);
+  auto after = AnalyzeThroughput(*tuned);
+  ASSERT_EQ(tuned->schemas().size(), schema_set->schemas().size());
+  ASSERT_GT(after.bandwidth(), before.bandwidth());
+  // A reachable target stops the tuning early.
+  auto target = 2 * before.bandwidth();
+  auto partially_tuned = AnalyzeThroughput(*Autotune(*schema_set, target));
+  ASSERT_GE(partially_tuned.bandwidth(), target);
+  ASSERT_LE(partially_tuned.bandwidth(), after.bandwidth());
+}
+
+TEST(Throughput, BurstLength) {
+  // Field metadata overrides schema metadata, invalid values are ignored.
+  auto burst = arrow::key_value_metadata({"fletcher_burst_max_len"}, {"64"});
+  auto invalid = arrow::key_value_metadata({"fletcher_burst_max_len", "fletcher_burst_step_len"}, {"sixteen", "-4"});
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false, burst),
+                               arrow::field("b", arrow::uint64(), false, invalid),
+                               arrow::field("c", arrow::uint64(), false)});
+  schema = fletcher::AppendMetaRequired(*schema, "Bursts", Mode::READ);
+  auto meta = schema->metadata()->Copy();
+  meta->Append("fletcher_burst_max_len", "32");
+  auto report = AnalyzeThroughput(*GetSchemaSet(schema->AddMetadata(meta)));
+  ASSERT_EQ(report.fields[0].burst_max_len, 64);
+  ASSERT_EQ(report.fields[1].burst_max_len, DEFAULT_BURST_MAX_LEN);
+  ASSERT_EQ(report.fields[1].burst_step_len, DEFAULT_BURST_STEP_LEN);
+  ASSERT_EQ(report.fields[2].burst_max_len, 32);
+}
+
+TEST(Throughput, AutotuneBurstPerField) {
+  // Field a saturates the bus of channel 0, field b on channel 1 cannot be tuned.
+  auto epc = arrow::key_value_metadata({"fletcher_epc"}, {"8"});
+  auto b_type = arrow::struct_({arrow::field("x", arrow::uint8(), false), arrow::field("y", arrow::uint8(), false)});
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false, epc),
+                               fletcher::AppendMetaBusChannel(*arrow::field("b", b_type, false), 1)});
+  auto schema_set = GetSchemaSet(fletcher::AppendMetaRequired(*schema, "Bursts", Mode::READ));
+  auto tuned = Autotune(*schema_set, 0.0);
+  auto report = AnalyzeThroughput(*tuned);
+  // Only the burst length of the field that is limited by the bus is raised.
+  ASSERT_GT(report.fields[0].burst_max_len, DEFAULT_BURST_MAX_LEN);
+  ASSERT_EQ(report.fields[1].burst_max_len, DEFAULT_BURST_MAX_LEN);
+  ASSERT_TRUE(fletcher::GetMeta(*tuned->schemas()[0]->arrow_schema(), "fletcher_burst_max_len").empty());
+}
+
+}  // namespace fletchgen
@@ -48,6 +48,14 @@ typedef union {
 /// Device nullptr
 #define D_NULLPTR (da_t) 0x0
 
+/// Platform capabilities, as reported by the run-time through a bitmask.
+/// The MMIO register file is mapped into the host address space (platformGetMmioBase is available).
+#define FLETCHER_PLATFORM_CAP_MMIO_MAPPED (1u << 0)
+/// Device memory allocations can be placed in the region of a memory channel (platformSetDeviceRegion is available).
+#define FLETCHER_PLATFORM_CAP_DEVICE_REGIONS (1u << 1)
+/// Device memory allocations can be mapped with huge pages (platformSetDeviceHugePages is available).
+#define FLETCHER_PLATFORM_CAP_HUGE_PAGES (1u << 2)
+
 /// Hardware default registers
 #define FLETCHER_REG_CONTROL        0
 #define FLETCHER_REG_STATUS         1
@@ -57,6 +65,10 @@ typedef union {
 /// Offset for schema derived registers
 #define FLETCHER_REG_SCHEMA         4
 
+/// Number of profile counter registers of every profiled field: busy cycles, bus request beats, bus data beats, stall
+/// cycles and bytes transferred.
+#define FLETCHER_PROFILE_COUNTERS   5
+
 #define FLETCHER_REG_CONTROL_START  0x0u
 #define FLETCHER_REG_CONTROL_STOP   0x1u
 #define FLETCHER_REG_CONTROL_RESET  0x2u
@@ -90,11 +102,14 @@ typedef union {
 #define FLETCHER_REG_BUFFER_OFFSET  26
 
 
+/// Device memory region of memory channel 0. Memory channel N uses region FLETCHER_REG_MM_DEFAULT_REGION + N.
 #define FLETCHER_REG_MM_DEFAULT_REGION 1
 
 #define FLETCHER_REG_MM_CMD_ALLOC   (1|(1<<1))
 #define FLETCHER_REG_MM_CMD_FREE    (1|(1<<2))
 #define FLETCHER_REG_MM_CMD_REALLOC (1|(1<<3))
+/// Hint for FLETCHER_REG_MM_CMD_ALLOC to map the allocation with huge pages where possible.
+#define FLETCHER_REG_MM_CMD_HUGE    (1<<4)
 #define FLETCHER_REG_MM_STATUS_DONE (1<<0)
 #define FLETCHER_REG_MM_STATUS_OK   (1<<1)
 #define FLETCHER_REG_MM_HDA_STATUS_ACK 0
@@ -33,7 +33,7 @@ arrow::Status RecordBatchAnalyzer::VisitArray(const arrow::Array &arr) {
   if (field->nullable()) {
     if (arr.null_count() > 0) {
       out_->buffers.emplace_back(arr.null_bitmap()->data(),
-                                 arr.null_bitmap()->size(),
+                                 CoveredSize(*arr.null_bitmap(), (arr.offset() + arr.length() + 7) / 8),
                                  buf_name + " (null bitmap)",
                                  level);
     } else {
@@ -54,25 +54,40 @@ bool RecordBatchAnalyzer::Analyze(const arrow::RecordBatch &batch) {
     field = batch.schema()->field(i);
     buf_name = field->name();
     out_->fields.emplace_back(arr->type(), arr->length(), arr->null_count());
+    out_->fields.back().name_ = field->name();
+    out_->fields.back().burst_reg_ = HasBurstRegister(*batch.schema(), *field);
+    out_->fields.back().profile_ = HasProfileCounters(*batch.schema(), *field);
+    // All buffers of a field are accessed over the same bus channel.
+    auto channel = GetBusChannel(*batch.schema(), *field);
+    auto first_buffer = out_->buffers.size();
     if (!VisitArray(*arr).ok()) {
       return false;
     }
+    for (auto b = first_buffer; b < out_->buffers.size(); b++) {
+      out_->buffers[b].channel_ = channel;
+    }
   }
   return true;
 }
 
 arrow::Status RecordBatchAnalyzer::VisitBinary(const arrow::BinaryArray &array) {
+  // A sliced array only covers the first part of its buffers.
+  auto num_offsets = array.offset() + array.length() + 1;
   out_->buffers.emplace_back(array.value_offsets()->data(),
-                             array.value_offsets()->size(),
+                             CoveredSize(*array.value_offsets(), num_offsets * sizeof(int32_t)),
                              buf_name + " (offsets)",
                              level);
-  out_->buffers.emplace_back(array.value_data()->data(), array.value_data()->size(), buf_name + " (values)", level);
+  out_->buffers.emplace_back(array.value_data()->data(),
+                             CoveredSize(*array.value_data(), array.value_offset(array.length())),
+                             buf_name + " (values)",
+                             level);
   return arrow::Status::OK();
 }
 
 arrow::Status RecordBatchAnalyzer::Visit(const arrow::ListArray &array) {
+  auto num_offsets = array.offset() + array.length() + 1;
   out_->buffers.emplace_back(array.value_offsets()->data(),
-                             array.value_offsets()->size(),
+                             CoveredSize(*array.value_offsets(), num_offsets * sizeof(int32_t)),
                              buf_name + " (offsets)",
                              level);
   // Advance to the next nesting level.
@@ -82,7 +97,10 @@ arrow::Status RecordBatchAnalyzer::Visit(const arrow::ListArray &array) {
     return arrow::Status::TypeError("List type does not have exactly one child.");
   }
   field = field->type()->child(0);
-  // Visit the nested values array
+  // Visit the nested values array, up to the last value of the last list if only the covered part is described.
+  if (covered_only_) {
+    return VisitArray(*array.values()->Slice(0, array.value_offset(array.length())));
+  }
   return VisitArray(*array.values());
 }
 
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <string>
@@ -32,17 +33,31 @@ namespace fletcher {
  */
 class RecordBatchAnalyzer : public arrow::ArrayVisitor {
  public:
-  explicit RecordBatchAnalyzer(RecordBatchDescription *out) : out_(out) {}
+  /**
+   * @brief Construct a RecordBatchAnalyzer.
+   * @param out           The description to fill in.
+   * @param covered_only  Describe only the part of every buffer that the (sliced) arrays cover, instead of the whole
+   *                      buffer.
+   */
+  explicit RecordBatchAnalyzer(RecordBatchDescription *out, bool covered_only = false)
+      : out_(out), covered_only_(covered_only) {}
   ~RecordBatchAnalyzer() override = default;
   bool Analyze(const arrow::RecordBatch &batch);
 
  protected:
   arrow::Status VisitArray(const arrow::Array &arr);
 
+  /// @brief Return the size to describe for a buffer of which an array covers the first \p covered bytes.
+  int64_t CoveredSize(const arrow::Buffer &buf, int64_t covered) const {
+    return covered_only_ ? std::min(buf.size(), covered) : buf.size();
+  }
+
   template<typename ArrayType>
   arrow::Status VisitFixedWidth(const ArrayType &array) {
     std::shared_ptr<arrow::Buffer> buf = array.values();
-    out_->buffers.emplace_back(buf->data(), buf->size(), buf_name + " (values)", level);
+    auto bit_width = static_cast<const arrow::FixedWidthType &>(*array.type()).bit_width();
+    auto size = CoveredSize(*buf, (bit_width * (array.offset() + array.length()) + 7) / 8);
+    out_->buffers.emplace_back(buf->data(), size, buf_name + " (values)", level);
     return arrow::Status::OK();
   }
 
@@ -84,6 +99,7 @@ class RecordBatchAnalyzer : public arrow::ArrayVisitor {
   std::string buf_name;
   int level = 0;
   RecordBatchDescription *out_{};
+  bool covered_only_ = false;
   std::shared_ptr<arrow::Field> field;
 };
 
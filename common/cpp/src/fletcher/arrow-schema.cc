@@ -37,6 +37,12 @@ bool SchemaAnalyzer::Analyze(const arrow::Schema& schema) {
     std::vector<BufferMetadata> buffers_meta;
     FieldAnalyzer fa(&field_meta, &buffers_meta, schema.field(i)->name());
     fa.Analyze(*schema.field(i));
+    for (auto &b : buffers_meta) {
+      b.channel_ = GetBusChannel(schema, *schema.field(i));
+    }
+    field_meta.name_ = schema.field(i)->name();
+    field_meta.burst_reg_ = HasBurstRegister(schema, *schema.field(i));
+    field_meta.profile_ = HasProfileCounters(schema, *schema.field(i));
     // Push back the result.
     out_->fields.push_back(field_meta);
     out_->buffers.insert(out_->buffers.end(), buffers_meta.begin(), buffers_meta.end());
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdlib>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <iostream>
@@ -69,6 +71,59 @@ bool MustIgnore(const arrow::Field &field) {
   return ret;
 }
 
+/// @brief Obtain integer bus metadata of a field or its schema. Invalid values are logged and result in the default.
+static int GetBusMeta(const arrow::Schema &schema,
+                      const arrow::Field &field,
+                      const std::string &key,
+                      int default_to,
+                      int min) {
+  auto value = GetMeta(field, key);
+  if (value.empty()) {
+    value = GetMeta(schema, key);
+  }
+  if (value.empty()) {
+    return default_to;
+  }
+  char *end = nullptr;
+  auto result = std::strtol(value.c_str(), &end, 10);
+  if ((*end != '\0') || (result < min) || (result > std::numeric_limits<int>::max())) {
+    FLETCHER_LOG(ERROR, "Field " + field.name() + " has invalid metadata " + key + "=\"" + value
+        + "\". Using default value " + std::to_string(default_to) + ".");
+    return default_to;
+  }
+  return static_cast<int>(result);
+}
+
+int GetBusChannel(const arrow::Schema &schema, const arrow::Field &field) {
+  return GetBusMeta(schema, field, "fletcher_bus_channel", 0, 0);
+}
+
+int GetBusWeight(const arrow::Schema &schema, const arrow::Field &field) {
+  return GetBusMeta(schema, field, "fletcher_bus_weight", 1, 1);
+}
+
+bool HasBurstRegister(const arrow::Schema &schema, const arrow::Field &field) {
+  if ((GetMode(schema) != Mode::READ) || MustIgnore(field)) {
+    return false;
+  }
+  auto reg = GetMeta(field, "fletcher_burst_reg");
+  if (reg.empty()) {
+    reg = GetMeta(schema, "fletcher_burst_reg");
+  }
+  return reg == "true";
+}
+
+bool HasProfileCounters(const arrow::Schema &schema, const arrow::Field &field) {
+  if (MustIgnore(field)) {
+    return false;
+  }
+  auto profile = GetMeta(field, "fletcher_profile");
+  if (profile.empty()) {
+    profile = GetMeta(schema, "fletcher_profile");
+  }
+  return profile == "true";
+}
+
 int GetIntMeta(const arrow::Field &field, const std::string& key, int default_to) {
   int ret = default_to;
   auto strepc = GetMeta(field, key);
@@ -97,6 +152,18 @@ std::shared_ptr<arrow::Field> AppendMetaEPC(const arrow::Field &field, int epc)
   return field.AddMetadata(meta);
 }
 
+std::shared_ptr<arrow::Field> AppendMetaBusChannel(const arrow::Field &field, int channel) {
+  auto meta = std::make_shared<arrow::KeyValueMetadata>(std::vector<std::string>({"fletcher_bus_channel"}),
+                                                        std::vector<std::string>({std::to_string(channel)}));
+  return field.AddMetadata(meta);
+}
+
+std::shared_ptr<arrow::Field> AppendMetaBusWeight(const arrow::Field &field, int weight) {
+  auto meta = std::make_shared<arrow::KeyValueMetadata>(std::vector<std::string>({"fletcher_bus_weight"}),
+                                                        std::vector<std::string>({std::to_string(weight)}));
+  return field.AddMetadata(meta);
+}
+
 std::shared_ptr<arrow::Field> AppendMetaIgnore(const arrow::Field &field) {
   const static std::vector<std::string> ignore_key = {"fletcher_ignore"};
   const static std::vector<std::string> ignore_value = {"true"};
@@ -33,6 +33,12 @@ struct FieldMetadata {
   std::shared_ptr<arrow::DataType> type_{};
   int64_t length_ = 0;
   int64_t null_count_ = 0;
+  /// Name of the field.
+  std::string name_;
+  /// Whether the maximum burst length of the field is set at run time through an MMIO register.
+  bool burst_reg_ = false;
+  /// Whether the hardware counts the activity of the field in profile counters.
+  bool profile_ = false;
   FieldMetadata() = default;
   FieldMetadata(std::shared_ptr<arrow::DataType> type, int64_t length, int64_t null_count)
       : type_(std::move(type)), length_(length), null_count_(null_count) {}
@@ -43,6 +49,8 @@ struct BufferMetadata {
   int64_t size_;
   std::string desc_;
   int level_ = 0;
+  /// The bus channel over which the device accesses this buffer.
+  int channel_ = 0;
 
   /// Implicit means the buffer might exists physically but is not required logically (e.g. an empty validity bitmap for
   /// non-nullable fields).
@@ -91,6 +99,55 @@ int GetIntMeta(const arrow::Field &field, const std::string &key, int default_to
  */
 bool MustIgnore(const arrow::Field &field);
 
+/**
+ * @brief Obtain the bus channel over which a field is transferred to or from memory.
+ *
+ * The "fletcher_bus_channel" metadata of the field takes precedence over that of the schema. Negative or malformed
+ * channels are logged as an error and result in the default channel.
+ *
+ * @param schema  The schema the field belongs to.
+ * @param field   A top-level field of the schema.
+ * @return        The bus channel of the field. Default = 0.
+ */
+int GetBusChannel(const arrow::Schema &schema, const arrow::Field &field);
+
+/**
+ * @brief Obtain the arbitration weight of the bus over which a field is transferred to or from memory.
+ *
+ * Bus masters with a larger weight get a proportionally larger share of the memory channel when the channel is
+ * congested. The "fletcher_bus_weight" metadata of the field takes precedence over that of the schema. Weights
+ * smaller than one or malformed weights are logged as an error and result in the default weight.
+ *
+ * @param schema  The schema the field belongs to.
+ * @param field   A top-level field of the schema.
+ * @return        The bus arbitration weight of the field. Default = 1.
+ */
+int GetBusWeight(const arrow::Schema &schema, const arrow::Field &field);
+
+/**
+ * @brief Check if the maximum burst length of a field is set at run time through an MMIO register.
+ *
+ * The register is enabled by setting the "fletcher_burst_reg" metadata to "true". The metadata of the field takes
+ * precedence over that of the schema. Only fields of read schemas that are not ignored can have a register.
+ *
+ * @param schema  The schema the field belongs to.
+ * @param field   A top-level field of the schema.
+ * @return        True if the field has a burst length register, false otherwise.
+ */
+bool HasBurstRegister(const arrow::Schema &schema, const arrow::Field &field);
+
+/**
+ * @brief Check if the hardware of a field counts its activity in profile counters.
+ *
+ * The counters are enabled by setting the "fletcher_profile" metadata to "true". The metadata of the field takes
+ * precedence over that of the schema. Fields that are ignored have no counters.
+ *
+ * @param schema  The schema the field belongs to.
+ * @param field   A top-level field of the schema.
+ * @return        True if the field has profile counters, false otherwise.
+ */
+bool HasProfileCounters(const arrow::Schema &schema, const arrow::Field &field);
+
 /**
  * @brief Append the minimum required metadata for Fletcher to a schema. Returns a copy of the schema.
  * @param schema        The Schema to append to.
@@ -121,6 +178,22 @@ std::shared_ptr<arrow::Field> AppendMetaEPC(const arrow::Field &field, int epc);
  */
 std::shared_ptr<arrow::Field> AppendMetaIgnore(const arrow::Field &field);
 
+/**
+ * @brief Append bus channel metadata to a field. Returns a copy of the field.
+ * @param field   The field to append to.
+ * @param channel The bus channel.
+ * @return        A copy of the field with metadata appended.
+ */
+std::shared_ptr<arrow::Field> AppendMetaBusChannel(const arrow::Field &field, int channel);
+
+/**
+ * @brief Append bus arbitration weight metadata to a field. Returns a copy of the field.
+ * @param field   The field to append to.
+ * @param weight  The bus arbitration weight.
+ * @return        A copy of the field with metadata appended.
+ */
+std::shared_ptr<arrow::Field> AppendMetaBusWeight(const arrow::Field &field, int weight);
+
 /**
  * Write a schema to a Flatbuffer file
  * @param file_name   File to write to.
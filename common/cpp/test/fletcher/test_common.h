@@ -43,3 +43,27 @@ TEST(Common, RecordBatchFileRoundTrip) {
   ASSERT_TRUE(rb_out->schema()->Equals(*rbs_in[0]->schema(), true));
   ASSERT_TRUE(rb_out->Equals(*rbs_in[0]));
 }
+
+TEST(Common, BusMeta) {
+  auto meta = arrow::key_value_metadata({"fletcher_bus_channel", "fletcher_bus_weight"}, {"2", "4"});
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               arrow::field("b", arrow::uint64(), false, meta)},
+                              arrow::key_value_metadata({"fletcher_bus_channel"}, {"1"}));
+  // Field metadata takes precedence over schema metadata.
+  ASSERT_EQ(fletcher::GetBusChannel(*schema, *schema->field(0)), 1);
+  ASSERT_EQ(fletcher::GetBusWeight(*schema, *schema->field(0)), 1);
+  ASSERT_EQ(fletcher::GetBusChannel(*schema, *schema->field(1)), 2);
+  ASSERT_EQ(fletcher::GetBusWeight(*schema, *schema->field(1)), 4);
+
+  // Invalid values result in the defaults.
+  auto invalid = arrow::schema({arrow::field("c", arrow::uint64(), false,
+                                             arrow::key_value_metadata({"fletcher_bus_channel", "fletcher_bus_weight"},
+                                                                       {"-1", "0"})),
+                                arrow::field("d", arrow::uint64(), false,
+                                             arrow::key_value_metadata({"fletcher_bus_channel", "fletcher_bus_weight"},
+                                                                       {"one", "99999999999"}))});
+  for (const auto &f : invalid->fields()) {
+    ASSERT_EQ(fletcher::GetBusChannel(*invalid, *f), 0);
+    ASSERT_EQ(fletcher::GetBusWeight(*invalid, *f), 1);
+  }
+}
@@ -18,6 +18,7 @@
 
 #include <arrow/api.h>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace fletcher {
@@ -56,6 +57,12 @@ inline std::shared_ptr<arrow::Schema> GetStringReadSchema() {
   return AppendMetaRequired(*schema, "StringRead", Mode::READ);
 }
 
+inline std::shared_ptr<arrow::Schema> GetStringReadSchemaWithEPC(int epc) {
+  auto name_field = AppendMetaEPC(*arrow::field("Name", arrow::utf8(), false), epc);
+  auto schema = std::make_shared<arrow::Schema>(std::vector<std::shared_ptr<arrow::Field>>({name_field}));
+  return AppendMetaRequired(*schema, "StringRead", Mode::READ);
+}
+
 inline std::shared_ptr<arrow::Schema> GetStringWriteSchema() {
   auto string_field = arrow::field("String", arrow::utf8(), false);
   AppendMetaEPC(*string_field, 64);
@@ -143,4 +150,28 @@ inline std::shared_ptr<arrow::Schema> GetSodaBeerSchema(const std::string& name=
   return fletcher_schema;
 }
 
+/// @brief Return a schema with many primitive fields, cycling through a few types.
+inline std::shared_ptr<arrow::Schema> GetWideSchema(int num_fields, Mode mode = Mode::READ) {
+  std::vector<std::shared_ptr<arrow::DataType>> types = {arrow::uint8(), arrow::int32(), arrow::float64(),
+                                                         arrow::utf8()};
+  std::vector<std::shared_ptr<arrow::Field>> schema_fields;
+  for (int i = 0; i < num_fields; i++) {
+    schema_fields.push_back(arrow::field("f" + std::to_string(i), types[i % types.size()], false));
+  }
+  auto schema = std::make_shared<arrow::Schema>(schema_fields);
+  return AppendMetaRequired(*schema, "Wide" + std::to_string(num_fields), mode);
+}
+
+/// @brief Return a schema with a single field of structs nested \p depth levels deep, each holding a primitive.
+inline std::shared_ptr<arrow::Schema> GetDeepSchema(int depth, Mode mode = Mode::READ) {
+  std::shared_ptr<arrow::DataType> type = arrow::uint32();
+  for (int i = depth - 1; i >= 0; i--) {
+    type = arrow::struct_({arrow::field("p" + std::to_string(i), arrow::uint16(), false),
+                           arrow::field("s" + std::to_string(i), type, false)});
+  }
+  std::vector<std::shared_ptr<arrow::Field>> schema_fields = {arrow::field("deep", type, false)};
+  auto schema = std::make_shared<arrow::Schema>(schema_fields);
+  return AppendMetaRequired(*schema, "Deep" + std::to_string(depth), mode);
+}
+
 }  // namespace fletcher
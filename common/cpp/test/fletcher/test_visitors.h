@@ -98,6 +98,29 @@ TEST(RecordBatchAnalyzer, VisitStruct) {
   ASSERT_EQ(rbd.buffers[1].size_, 4 * sizeof(uint32_t));
 }
 
+TEST(RecordBatchAnalyzer, VisitSlice) {
+  // By default, a slice is described by its whole buffers.
+  fletcher::RecordBatchDescription full;
+  fletcher::RecordBatchAnalyzer(&full).Analyze(*fletcher::GetIntRB()->Slice(0, 2));
+  ASSERT_EQ(full.buffers[0].size_, fletcher::GetIntRB()->column(0)->data()->buffers[1]->size());
+
+  // Otherwise, a slice only covers the first part of the buffers.
+  fletcher::RecordBatchDescription prim;
+  fletcher::RecordBatchAnalyzer(&prim, true).Analyze(*fletcher::GetIntRB()->Slice(0, 2));
+  ASSERT_EQ(prim.rows, 2);
+  ASSERT_EQ(prim.buffers[0].size_, 2);
+
+  fletcher::RecordBatchDescription str;
+  fletcher::RecordBatchAnalyzer(&str, true).Analyze(*fletcher::GetStringRB()->Slice(0, 2));
+  ASSERT_EQ(str.buffers[0].size_, 3 * sizeof(int32_t));
+  ASSERT_EQ(str.buffers[1].size_, 8);  // "AliceBob"
+
+  fletcher::RecordBatchDescription list;
+  fletcher::RecordBatchAnalyzer(&list, true).Analyze(*fletcher::GetListUint8RB()->Slice(0, 2));
+  ASSERT_EQ(list.buffers[0].size_, 3 * sizeof(int32_t));
+  ASSERT_EQ(list.buffers[1].size_, 11);
+}
+
 // TypeVisitor tests
 TEST(SchemaAnalyzer, VisitPrimitive) {
   auto schema = fletcher::GetPrimReadSchema();
@@ -55,7 +55,7 @@ entity axi_top is
     TAG_WIDTH                   : natural := 1;
     NUM_ARROW_BUFFERS           : natural := 0;
     NUM_USER_REGS               : natural := 0;
-    NUM_REGS                    : natural := 26 + 12 * 4 + 1
+    NUM_REGS                    : natural := 26 + 12 * 4 + 1 + 1 + 4 * 4
   );
 
   port (
@@ -138,7 +138,8 @@ entity axi_top is
     htr_resp_ready              : in  std_logic := '1';
     htr_resp_virt               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     htr_resp_phys               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-    htr_resp_mask               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0)
+    htr_resp_mask               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    htr_resp_fault              : out std_logic
   );
 end axi_top;
 
@@ -215,7 +216,8 @@ architecture Behavorial of axi_top is
       htr_resp_ready                             : in  std_logic := '1';
       htr_resp_virt                              : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
       htr_resp_phys                              : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-      htr_resp_mask                              : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0)
+      htr_resp_mask                              : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+      htr_resp_fault                             : out std_logic
     );
   end component;
 
@@ -317,7 +319,8 @@ begin
       htr_resp_ready            => htr_resp_ready,
       htr_resp_virt             => htr_resp_virt,
       htr_resp_phys             => htr_resp_phys,
-      htr_resp_mask             => htr_resp_mask
+      htr_resp_mask             => htr_resp_mask,
+      htr_resp_fault            => htr_resp_fault
     );
 
   -----------------------------------------------------------------------------
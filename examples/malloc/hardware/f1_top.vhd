@@ -53,7 +53,7 @@ entity f1_top is
     TAG_WIDTH                   : natural := 1;
     NUM_ARROW_BUFFERS           : natural := 0;
     NUM_USER_REGS               : natural := 0;
-    NUM_REGS                    : natural := 26 + 12 * 4 + 1 + 1
+    NUM_REGS                    : natural := 26 + 12 * 4 + 1 + 1 + 4 * 4
   );
   port (
     kcd_clk                     : in  std_logic;
@@ -325,7 +325,8 @@ architecture Behavorial of f1_top is
       htr_resp_ready              : in  std_logic := '1';
       htr_resp_virt               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
       htr_resp_phys               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-      htr_resp_mask               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0)
+      htr_resp_mask               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+      htr_resp_fault              : out std_logic
     );
   end component;
 
@@ -341,7 +342,8 @@ architecture Behavorial of f1_top is
   signal tr_a_virt               : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
   signal tr_a_phys               : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
   signal tr_a_mask               : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-  signal tr_a_data               : std_logic_vector(BUS_ADDR_WIDTH*3-1 downto 0);
+  signal tr_a_fault              : std_logic;
+  signal tr_a_data               : std_logic_vector(BUS_ADDR_WIDTH*3 downto 0);
 
   -- Translate request channel (read)
   signal tr_rq_valid             : std_logic;
@@ -353,7 +355,8 @@ architecture Behavorial of f1_top is
   signal tr_ra_virt              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
   signal tr_ra_phys              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
   signal tr_ra_mask              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-  signal tr_ra_data              : std_logic_vector(BUS_ADDR_WIDTH*3-1 downto 0);
+  signal tr_ra_fault             : std_logic;
+  signal tr_ra_data              : std_logic_vector(BUS_ADDR_WIDTH*3 downto 0);
 
   -- Translate request channel (write)
   signal tr_wq_valid             : std_logic;
@@ -365,7 +368,8 @@ architecture Behavorial of f1_top is
   signal tr_wa_virt              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
   signal tr_wa_phys              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
   signal tr_wa_mask              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-  signal tr_wa_data              : std_logic_vector(BUS_ADDR_WIDTH*3-1 downto 0);
+  signal tr_wa_fault             : std_logic;
+  signal tr_wa_data              : std_logic_vector(BUS_ADDR_WIDTH*3 downto 0);
 
   signal s_axi_aruser            : std_logic_vector(s_axi_arid'length + s_axi_arsize'length - 1 downto 0);
   signal ml_axi_aruser           : std_logic_vector(s_axi_arid'length + s_axi_arsize'length - 1 downto 0);
@@ -491,7 +495,8 @@ begin
     htr_resp_ready              => tr_a_ready,
     htr_resp_virt               => tr_a_virt,
     htr_resp_phys               => tr_a_phys,
-    htr_resp_mask               => tr_a_mask
+    htr_resp_mask               => tr_a_mask,
+    htr_resp_fault              => tr_a_fault
   );
 
   -----------------------------------------------------------------------------
@@ -555,7 +560,8 @@ begin
     resp_ready                  => tr_ra_ready,
     resp_virt                   => tr_ra_virt,
     resp_phys                   => tr_ra_phys,
-    resp_mask                   => tr_ra_mask
+    resp_mask                   => tr_ra_mask,
+    resp_fault                  => tr_ra_fault
   );
   s_axi_aruser  <= s_axi_arid & s_axi_arsize;
   ml_axi_arsize <= ml_axi_aruser(s_axi_arsize'high downto 0);
@@ -598,7 +604,8 @@ begin
     resp_ready                  => tr_wa_ready,
     resp_virt                   => tr_wa_virt,
     resp_phys                   => tr_wa_phys,
-    resp_mask                   => tr_wa_mask
+    resp_mask                   => tr_wa_mask,
+    resp_fault                  => tr_wa_fault
   );
   s_axi_awuser  <= s_axi_awid & s_axi_awsize;
   ml_axi_awsize <= ml_axi_awuser(s_axi_awsize'high downto 0);
@@ -609,7 +616,7 @@ begin
   generic map (
     BUS_ADDR_WIDTH              => BUS_ADDR_WIDTH,
     BUS_LEN_WIDTH               => 1,
-    BUS_DATA_WIDTH              => BUS_ADDR_WIDTH * 3,
+    BUS_DATA_WIDTH              => BUS_ADDR_WIDTH * 3 + 1,
     NUM_SLAVE_PORTS             => 2,
     ARB_METHOD                  => "ROUND-ROBIN",
     MAX_OUTSTANDING             => 2,
@@ -647,14 +654,16 @@ begin
     bs01_rdat_data              => tr_wa_data
   );
 
-  tr_a_data <= tr_a_virt & tr_a_phys & tr_a_mask;
+  tr_a_data <= tr_a_fault & tr_a_virt & tr_a_phys & tr_a_mask;
 
   tr_ra_virt <= EXTRACT(tr_ra_data, BUS_ADDR_WIDTH*2, BUS_ADDR_WIDTH);
   tr_ra_phys <= EXTRACT(tr_ra_data, BUS_ADDR_WIDTH*1, BUS_ADDR_WIDTH);
   tr_ra_mask <= EXTRACT(tr_ra_data, BUS_ADDR_WIDTH*0, BUS_ADDR_WIDTH);
+  tr_ra_fault <= tr_ra_data(BUS_ADDR_WIDTH*3);
 
   tr_wa_virt <= EXTRACT(tr_wa_data, BUS_ADDR_WIDTH*2, BUS_ADDR_WIDTH);
   tr_wa_phys <= EXTRACT(tr_wa_data, BUS_ADDR_WIDTH*1, BUS_ADDR_WIDTH);
   tr_wa_mask <= EXTRACT(tr_wa_data, BUS_ADDR_WIDTH*0, BUS_ADDR_WIDTH);
+  tr_wa_fault <= tr_wa_data(BUS_ADDR_WIDTH*3);
 
 end architecture;
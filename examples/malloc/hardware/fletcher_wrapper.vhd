@@ -94,7 +94,8 @@ entity fletcher_wrapper is
     htr_resp_ready                             : in  std_logic := '1';
     htr_resp_virt                              : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     htr_resp_phys                              : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-    htr_resp_mask                              : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0)
+    htr_resp_mask                              : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    htr_resp_fault                             : out std_logic
   );
 end fletcher_wrapper;
 
@@ -127,6 +128,12 @@ architecture Implementation of fletcher_wrapper is
   constant MM_REG_OFFSET_BENCH_WR      : natural := MM_REG_OFFSET_BENCH_WS + MM_BENCH_REGS;
   constant MM_REG_CMD_DELAY            : natural := MM_REG_OFFSET_BENCH_WR + MM_BENCH_REGS;
   constant MM_REG_DEBUG                : natural := MM_REG_CMD_DELAY + 1;
+  -- Translator statistics: hits, misses, prefetches and walk cycles.
+  constant MM_TLB_REGS                 : natural := 4;
+  constant MM_REG_OFFSET_TLB_RS        : natural := MM_REG_DEBUG + 1;
+  constant MM_REG_OFFSET_TLB_RR        : natural := MM_REG_OFFSET_TLB_RS + MM_TLB_REGS;
+  constant MM_REG_OFFSET_TLB_WS        : natural := MM_REG_OFFSET_TLB_RR + MM_TLB_REGS;
+  constant MM_REG_OFFSET_TLB_WR        : natural := MM_REG_OFFSET_TLB_WS + MM_TLB_REGS;
 
   type bus_req_t is record
     valid             : std_logic;
@@ -139,10 +146,11 @@ architecture Implementation of fletcher_wrapper is
     req               : bus_req_t;
     resp_valid        : std_logic;
     resp_ready        : std_logic;
-    resp_data         : std_logic_vector(BUS_ADDR_WIDTH*3-1 downto 0);
+    resp_data         : std_logic_vector(BUS_ADDR_WIDTH*3 downto 0);
     resp_virt         : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     resp_phys         : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     resp_mask         : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    resp_fault        : std_logic;
   end record translate_t;
 
   type bus_r_t is record
@@ -175,6 +183,7 @@ architecture Implementation of fletcher_wrapper is
   signal cmd_free     : std_logic;
   signal cmd_alloc    : std_logic;
   signal cmd_realloc  : std_logic;
+  signal cmd_huge     : std_logic;
   signal cmd_valid    : std_logic;
   signal cmd_ready    : std_logic;
   signal resp_addr    : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
@@ -187,7 +196,7 @@ architecture Implementation of fletcher_wrapper is
 
   signal translate    : translate_t;
 
-  signal htr_resp_data : std_logic_vector(BUS_ADDR_WIDTH*3-1 downto 0);
+  signal htr_resp_data : std_logic_vector(BUS_ADDR_WIDTH*3 downto 0);
 
   signal dir_r        : bus_r_t;
   signal dir_w        : bus_w_t;
@@ -258,6 +267,10 @@ begin
       reg_cycles_per_word         => regs_in (
           (MM_REG_OFFSET_BENCH_RS+9)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_RS+8)*REG_WIDTH),
 
+      -- Sequential address increment in bytes, set 0 to use the burst size
+      reg_stride                  => regs_in (
+          (MM_REG_OFFSET_BENCH_RS+12)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_RS+11)*REG_WIDTH),
+
       -- Result registers
       reg_cycles                  => regs_out (
           (MM_REG_OFFSET_BENCH_RS+10)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_RS+9)*REG_WIDTH),
@@ -273,7 +286,10 @@ begin
     PT_ENTRIES_LOG2             => PT_ENTRIES_LOG2,
     PAGE_SIZE_LOG2              => PAGE_SIZE_LOG2,
     MAX_OUTSTANDING             => 1,
-    CACHE_SIZE                  => 1,
+    CACHE_SIZE                  => 4,
+    PREFETCH                    => true,
+    -- Prefetch the next page in the last 1/16th of a page.
+    PREFETCH_LOG2               => PAGE_SIZE_LOG2 - 4,
     SLV_SLICES                  => 2,
     MST_SLICES                  => 2
   )
@@ -301,8 +317,20 @@ begin
     resp_ready                  => tr_bench_rs.resp_ready,
     resp_virt                   => tr_bench_rs.resp_virt,
     resp_phys                   => tr_bench_rs.resp_phys,
-    resp_mask                   => tr_bench_rs.resp_mask
+    resp_mask                   => tr_bench_rs.resp_mask,
+    resp_fault                  => tr_bench_rs.resp_fault,
+
+    -- Statistics
+    cnt_hits                    => regs_out (
+        (MM_REG_OFFSET_TLB_RS+1)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_RS+0)*REG_WIDTH),
+    cnt_misses                  => regs_out (
+        (MM_REG_OFFSET_TLB_RS+2)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_RS+1)*REG_WIDTH),
+    cnt_prefetches              => regs_out (
+        (MM_REG_OFFSET_TLB_RS+3)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_RS+2)*REG_WIDTH),
+    cnt_walk_cycles             => regs_out (
+        (MM_REG_OFFSET_TLB_RS+4)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_RS+3)*REG_WIDTH)
   );
+  regs_out_en(MM_REG_OFFSET_TLB_RS + MM_TLB_REGS - 1 downto MM_REG_OFFSET_TLB_RS) <= (others => '1');
 
   regs_out_en(MM_REG_OFFSET_BENCH_RR + MM_BENCH_REGS - 1 downto MM_REG_OFFSET_BENCH_RR) <= "011000000010";
   bench_rr_inst : BusReadBenchmarker
@@ -358,6 +386,10 @@ begin
       reg_cycles_per_word         => regs_in (
           (MM_REG_OFFSET_BENCH_RR+9)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_RR+8)*REG_WIDTH),
 
+      -- Sequential address increment in bytes, set 0 to use the burst size
+      reg_stride                  => regs_in (
+          (MM_REG_OFFSET_BENCH_RR+12)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_RR+11)*REG_WIDTH),
+
       -- Result registers
       reg_cycles                  => regs_out (
           (MM_REG_OFFSET_BENCH_RR+10)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_RR+9)*REG_WIDTH),
@@ -401,8 +433,20 @@ begin
     resp_ready                  => tr_bench_rr.resp_ready,
     resp_virt                   => tr_bench_rr.resp_virt,
     resp_phys                   => tr_bench_rr.resp_phys,
-    resp_mask                   => tr_bench_rr.resp_mask
+    resp_mask                   => tr_bench_rr.resp_mask,
+    resp_fault                  => tr_bench_rr.resp_fault,
+
+    -- Statistics
+    cnt_hits                    => regs_out (
+        (MM_REG_OFFSET_TLB_RR+1)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_RR+0)*REG_WIDTH),
+    cnt_misses                  => regs_out (
+        (MM_REG_OFFSET_TLB_RR+2)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_RR+1)*REG_WIDTH),
+    cnt_prefetches              => regs_out (
+        (MM_REG_OFFSET_TLB_RR+3)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_RR+2)*REG_WIDTH),
+    cnt_walk_cycles             => regs_out (
+        (MM_REG_OFFSET_TLB_RR+4)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_RR+3)*REG_WIDTH)
   );
+  regs_out_en(MM_REG_OFFSET_TLB_RR + MM_TLB_REGS - 1 downto MM_REG_OFFSET_TLB_RR) <= (others => '1');
 
   regs_out_en(MM_REG_OFFSET_BENCH_WS + MM_BENCH_REGS - 1 downto MM_REG_OFFSET_BENCH_WS) <= "011000000010";
   bench_ws_inst : BusWriteBenchmarker
@@ -458,6 +502,10 @@ begin
       reg_cycles_per_word         => regs_in (
           (MM_REG_OFFSET_BENCH_WS+9)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_WS+8)*REG_WIDTH),
 
+      -- Sequential address increment in bytes, set 0 to use the burst size
+      reg_stride                  => regs_in (
+          (MM_REG_OFFSET_BENCH_WS+12)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_WS+11)*REG_WIDTH),
+
       -- Result registers
       reg_cycles                  => regs_out (
           (MM_REG_OFFSET_BENCH_WS+10)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_WS+9)*REG_WIDTH),
@@ -473,7 +521,10 @@ begin
     PT_ENTRIES_LOG2             => PT_ENTRIES_LOG2,
     PAGE_SIZE_LOG2              => PAGE_SIZE_LOG2,
     MAX_OUTSTANDING             => 1,
-    CACHE_SIZE                  => 1,
+    CACHE_SIZE                  => 4,
+    PREFETCH                    => true,
+    -- Prefetch the next page in the last 1/16th of a page.
+    PREFETCH_LOG2               => PAGE_SIZE_LOG2 - 4,
     SLV_SLICES                  => 2,
     MST_SLICES                  => 2
   )
@@ -501,8 +552,20 @@ begin
     resp_ready                  => tr_bench_ws.resp_ready,
     resp_virt                   => tr_bench_ws.resp_virt,
     resp_phys                   => tr_bench_ws.resp_phys,
-    resp_mask                   => tr_bench_ws.resp_mask
+    resp_mask                   => tr_bench_ws.resp_mask,
+    resp_fault                  => tr_bench_ws.resp_fault,
+
+    -- Statistics
+    cnt_hits                    => regs_out (
+        (MM_REG_OFFSET_TLB_WS+1)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_WS+0)*REG_WIDTH),
+    cnt_misses                  => regs_out (
+        (MM_REG_OFFSET_TLB_WS+2)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_WS+1)*REG_WIDTH),
+    cnt_prefetches              => regs_out (
+        (MM_REG_OFFSET_TLB_WS+3)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_WS+2)*REG_WIDTH),
+    cnt_walk_cycles             => regs_out (
+        (MM_REG_OFFSET_TLB_WS+4)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_WS+3)*REG_WIDTH)
   );
+  regs_out_en(MM_REG_OFFSET_TLB_WS + MM_TLB_REGS - 1 downto MM_REG_OFFSET_TLB_WS) <= (others => '1');
 
   regs_out_en(MM_REG_OFFSET_BENCH_WR + MM_BENCH_REGS - 1 downto MM_REG_OFFSET_BENCH_WR) <= "011000000010";
   bench_wr_inst : BusWriteBenchmarker
@@ -558,6 +621,10 @@ begin
       reg_cycles_per_word         => regs_in (
           (MM_REG_OFFSET_BENCH_WR+9)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_WR+8)*REG_WIDTH),
 
+      -- Sequential address increment in bytes, set 0 to use the burst size
+      reg_stride                  => regs_in (
+          (MM_REG_OFFSET_BENCH_WR+12)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_WR+11)*REG_WIDTH),
+
       -- Result registers
       reg_cycles                  => regs_out (
           (MM_REG_OFFSET_BENCH_WR+10)*REG_WIDTH-1 downto (MM_REG_OFFSET_BENCH_WR+9)*REG_WIDTH),
@@ -601,8 +668,20 @@ begin
     resp_ready                  => tr_bench_wr.resp_ready,
     resp_virt                   => tr_bench_wr.resp_virt,
     resp_phys                   => tr_bench_wr.resp_phys,
-    resp_mask                   => tr_bench_wr.resp_mask
+    resp_mask                   => tr_bench_wr.resp_mask,
+    resp_fault                  => tr_bench_wr.resp_fault,
+
+    -- Statistics
+    cnt_hits                    => regs_out (
+        (MM_REG_OFFSET_TLB_WR+1)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_WR+0)*REG_WIDTH),
+    cnt_misses                  => regs_out (
+        (MM_REG_OFFSET_TLB_WR+2)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_WR+1)*REG_WIDTH),
+    cnt_prefetches              => regs_out (
+        (MM_REG_OFFSET_TLB_WR+3)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_WR+2)*REG_WIDTH),
+    cnt_walk_cycles             => regs_out (
+        (MM_REG_OFFSET_TLB_WR+4)*REG_WIDTH-1 downto (MM_REG_OFFSET_TLB_WR+3)*REG_WIDTH)
   );
+  regs_out_en(MM_REG_OFFSET_TLB_WR + MM_TLB_REGS - 1 downto MM_REG_OFFSET_TLB_WR) <= (others => '1');
 
   mm_dir_inst : MMDirector
     generic map (
@@ -631,6 +710,7 @@ begin
       cmd_free                    => cmd_free,
       cmd_alloc                   => cmd_alloc,
       cmd_realloc                 => cmd_realloc,
+      cmd_huge                    => cmd_huge,
       cmd_valid                   => cmd_valid,
       cmd_ready                   => cmd_ready,
 
@@ -646,6 +726,7 @@ begin
       mmu_resp_valid              => tr_mmu.resp_valid,
       mmu_resp_ready              => tr_mmu.resp_ready,
       mmu_resp_addr               => tr_mmu.resp_phys,
+      mmu_resp_fault              => tr_mmu.resp_fault,
 
       bus_wreq_valid              => dir_w.phys.valid,
       bus_wreq_ready              => dir_w.phys.ready,
@@ -701,6 +782,7 @@ begin
       cmd_free                    => cmd_free,
       cmd_alloc                   => cmd_alloc,
       cmd_realloc                 => cmd_realloc,
+      cmd_huge                    => cmd_huge,
       cmd_valid                   => cmd_valid,
       cmd_ready                   => cmd_ready,
 
@@ -758,6 +840,7 @@ begin
       resp_virt                   => translate.resp_virt,
       resp_phys                   => translate.resp_phys,
       resp_mask                   => translate.resp_mask,
+      resp_fault                  => translate.resp_fault,
 
       dir_req_valid               => tr_mmu.req.valid,
       dir_req_ready               => tr_mmu.req.ready,
@@ -765,14 +848,15 @@ begin
 
       dir_resp_valid              => tr_mmu.resp_valid,
       dir_resp_ready              => tr_mmu.resp_ready,
-      dir_resp_addr               => tr_mmu.resp_phys
+      dir_resp_addr               => tr_mmu.resp_phys,
+      dir_resp_fault              => tr_mmu.resp_fault
     );
 
   tr_req_arb_inst : BusReadArbiter
   generic map (
     BUS_ADDR_WIDTH              => BUS_ADDR_WIDTH,
     BUS_LEN_WIDTH               => 1,
-    BUS_DATA_WIDTH              => BUS_ADDR_WIDTH * 3,
+    BUS_DATA_WIDTH              => BUS_ADDR_WIDTH * 3 + 1,
     NUM_SLAVE_PORTS             => 5,
     ARB_METHOD                  => "ROUND-ROBIN",
     MAX_OUTSTANDING             => 1,
@@ -834,27 +918,32 @@ begin
     bs04_rdat_data              => tr_bench_wr.resp_data
   );
 
-  translate.resp_data   <= translate.resp_virt & translate.resp_phys & translate.resp_mask;
+  translate.resp_data   <= translate.resp_fault & translate.resp_virt & translate.resp_phys & translate.resp_mask;
 
   htr_resp_virt         <= EXTRACT(htr_resp_data, BUS_ADDR_WIDTH*2, BUS_ADDR_WIDTH);
   htr_resp_phys         <= EXTRACT(htr_resp_data, BUS_ADDR_WIDTH*1, BUS_ADDR_WIDTH);
   htr_resp_mask         <= EXTRACT(htr_resp_data, BUS_ADDR_WIDTH*0, BUS_ADDR_WIDTH);
+  htr_resp_fault        <= htr_resp_data(BUS_ADDR_WIDTH*3);
 
   tr_bench_rs.resp_virt <= EXTRACT(tr_bench_rs.resp_data, BUS_ADDR_WIDTH*2, BUS_ADDR_WIDTH);
   tr_bench_rs.resp_phys <= EXTRACT(tr_bench_rs.resp_data, BUS_ADDR_WIDTH*1, BUS_ADDR_WIDTH);
   tr_bench_rs.resp_mask <= EXTRACT(tr_bench_rs.resp_data, BUS_ADDR_WIDTH*0, BUS_ADDR_WIDTH);
+  tr_bench_rs.resp_fault <= tr_bench_rs.resp_data(BUS_ADDR_WIDTH*3);
 
   tr_bench_rr.resp_virt <= EXTRACT(tr_bench_rr.resp_data, BUS_ADDR_WIDTH*2, BUS_ADDR_WIDTH);
   tr_bench_rr.resp_phys <= EXTRACT(tr_bench_rr.resp_data, BUS_ADDR_WIDTH*1, BUS_ADDR_WIDTH);
   tr_bench_rr.resp_mask <= EXTRACT(tr_bench_rr.resp_data, BUS_ADDR_WIDTH*0, BUS_ADDR_WIDTH);
+  tr_bench_rr.resp_fault <= tr_bench_rr.resp_data(BUS_ADDR_WIDTH*3);
 
   tr_bench_ws.resp_virt <= EXTRACT(tr_bench_ws.resp_data, BUS_ADDR_WIDTH*2, BUS_ADDR_WIDTH);
   tr_bench_ws.resp_phys <= EXTRACT(tr_bench_ws.resp_data, BUS_ADDR_WIDTH*1, BUS_ADDR_WIDTH);
   tr_bench_ws.resp_mask <= EXTRACT(tr_bench_ws.resp_data, BUS_ADDR_WIDTH*0, BUS_ADDR_WIDTH);
+  tr_bench_ws.resp_fault <= tr_bench_ws.resp_data(BUS_ADDR_WIDTH*3);
 
   tr_bench_wr.resp_virt <= EXTRACT(tr_bench_wr.resp_data, BUS_ADDR_WIDTH*2, BUS_ADDR_WIDTH);
   tr_bench_wr.resp_phys <= EXTRACT(tr_bench_wr.resp_data, BUS_ADDR_WIDTH*1, BUS_ADDR_WIDTH);
   tr_bench_wr.resp_mask <= EXTRACT(tr_bench_wr.resp_data, BUS_ADDR_WIDTH*0, BUS_ADDR_WIDTH);
+  tr_bench_wr.resp_fault <= tr_bench_wr.resp_data(BUS_ADDR_WIDTH*3);
 
 
   bus_read_arb_inst : BusReadArbiter
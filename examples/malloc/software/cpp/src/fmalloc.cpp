@@ -45,6 +45,20 @@
 #define FLETCHER_ALIGNMENT 4096
 #define BUS_DATA_BYTES 64
 #define PERIOD 0.000000004
+// MMIO registers of the hardware, must match fletcher_wrapper.vhd
+#define MM_BENCH_REGS 12
+#define MM_REG_OFFSET_BENCH_RS 26
+#define MM_REG_OFFSET_BENCH_RR (MM_REG_OFFSET_BENCH_RS + MM_BENCH_REGS)
+#define MM_REG_OFFSET_BENCH_WS (MM_REG_OFFSET_BENCH_RR + MM_BENCH_REGS)
+#define MM_REG_OFFSET_BENCH_WR (MM_REG_OFFSET_BENCH_WS + MM_BENCH_REGS)
+#define MM_REG_CMD_DELAY (MM_REG_OFFSET_BENCH_WR + MM_BENCH_REGS)
+#define MM_REG_DEBUG (MM_REG_CMD_DELAY + 1)
+// Statistics counters of the address translators
+#define MM_TLB_REGS 4
+#define MM_REG_OFFSET_TLB_RS (MM_REG_DEBUG + 1)
+#define MM_REG_OFFSET_TLB_RR (MM_REG_OFFSET_TLB_RS + MM_TLB_REGS)
+#define MM_REG_OFFSET_TLB_WS (MM_REG_OFFSET_TLB_RR + MM_TLB_REGS)
+#define MM_REG_OFFSET_TLB_WR (MM_REG_OFFSET_TLB_WS + MM_TLB_REGS)
 
 using fletcher::Timer;
 
@@ -56,69 +70,53 @@ uint32_t calc_sum(const std::vector<uint32_t> &values) {
   return static_cast<uint32_t>(accumulate(values.begin(), values.end(), 0.0));
 }
 
-uint64_t get_addr_mask(uint64_t buffer_size, int burst_len) {
-  uint64_t addr_mask = ~ 0L;
-  for (int i=0; i<64; i++) {
-    if ( ((buffer_size-1) >> i) == 0 ) {
-      addr_mask >>= (64-i);
-      break;
-    }
+/**
+ * Run the hardware benchmarker at \p reg_offset over a range of burst sizes and print the throughput.
+ * The benchmarker reports whether it generates sequential or random addresses.
+ * The statistics of its address translator at \p tlb_offset are printed afterwards.
+ */
+void device_bench(std::shared_ptr<fletcher::Platform> platform, const std::string &name,
+    int reg_offset, int tlb_offset, da_t base_addr, uint64_t region_size, uint64_t test_size) {
+  fletcher::BusBenchmarker::Options opts;
+  opts.clock_hz = 1.0 / PERIOD;
+  opts.bus_data_bytes = BUS_DATA_BYTES;
+  opts.poll_interval_usec = 2000;
+  opts.timeout = 60.0;
+  std::shared_ptr<fletcher::BusBenchmarker> bench;
+  // The benchmarkers of this design have a stride register, but cannot limit outstanding requests.
+  auto regs = fletcher::BusBenchmarkerRegisters::Contiguous(reg_offset, 12);
+  fletcher::BusBenchmarker::Make(&bench, platform, name, regs, opts).ewf("Could not create benchmarker.");
+
+  fletcher::BusBenchmarkSweep sweep;
+  sweep.patterns = {fletcher::BusPattern::SEQUENTIAL, fletcher::BusPattern::RANDOM};
+  sweep.burst_lengths = {64, 32, 16, 8, 4, 2, 1};
+  sweep.latency = false;
+  sweep.bytes = test_size;
+  sweep.base_addr = base_addr;
+  sweep.region_size = region_size;
+
+  fletcher::TranslatorCounters tlb_start, tlb_end;
+  fletcher::TranslatorCounters::Read(platform.get(), tlb_offset, &tlb_start);
+
+  std::cerr << "running device benchmarker " << name << "...";
+  std::vector<fletcher::BusBenchmarkResult> results;
+  auto status = bench->Sweep(sweep, &results);
+  if (!status.ok()) {
+    std::cerr << "ERROR: " << status.message << std::endl << std::flush;
+  } else {
+    std::cerr << "finished" << std::endl << std::flush;
   }
-  for (int i=0; i<64; i++) {
-    if ( ((burst_len*BUS_DATA_BYTES-1) >> i) == 0) {
-      addr_mask &= (~ 0L) << i;
-      break;
-    }
+  for (const auto &r : results) {
+    std::cout << r.cycles << " cycles for " << r.config.num_bursts << " bursts of length "
+        << r.config.burst_length << " (" << (r.bytes/1024) << " KiB)" << std::endl;
+    std::cout << "D_R: " << static_cast<int>(r.bandwidth()/1000/1000) << " MB/s" << std::endl << std::flush;
   }
-  return addr_mask;
-}
 
-void device_bench(std::shared_ptr<fletcher::Platform> platform, 
-    int reg_offset, uint32_t burst_len, uint32_t bursts,
-    da_t base_addr, uint64_t addr_mask) {
-  std::cerr << "running device benchmarker...";
-  uint32_t control = 0;
-  uint32_t status;
-  uint32_t base_addr_lo = (uint32_t) base_addr;
-  uint32_t base_addr_hi = (uint32_t) (base_addr >> 32);
-  uint32_t addr_mask_lo = (uint32_t) addr_mask;
-  uint32_t addr_mask_hi = (uint32_t) (addr_mask >> 32);
-  uint32_t cycles_per_word = 0;
-  uint32_t cycles;
-  platform->WriteMMIO(reg_offset+2, burst_len);
-  platform->WriteMMIO(reg_offset+3, bursts);
-  platform->WriteMMIO(reg_offset+4, base_addr_lo);
-  platform->WriteMMIO(reg_offset+5, base_addr_hi);
-  platform->WriteMMIO(reg_offset+6, addr_mask_lo);
-  platform->WriteMMIO(reg_offset+7, addr_mask_hi);
-  platform->WriteMMIO(reg_offset+8, cycles_per_word);
-  // Reset
-  control = 4;
-  platform->WriteMMIO(reg_offset+0, control);
-  // Start
-  control = 1;
-  platform->WriteMMIO(reg_offset+0, control);
-  // Deassert start
-  control = 0;
-  platform->WriteMMIO(reg_offset+0, control);
-  // Wait until done
-  do {
-    usleep(2000);
-    platform->ReadMMIO(reg_offset+1, &status);
-  } while (status == 2);
-  if (status != 4) {
-    std::cerr << "ERROR" << std::endl;
-    std::cerr << std::flush;
-  } else {
-    std::cerr << "finished" << std::endl;
-    std::cerr << std::flush;
-    platform->ReadMMIO(reg_offset+9, &cycles);
-    uint64_t num_bytes =  BUS_DATA_BYTES * burst_len * bursts;
-    int throughput = (num_bytes/(cycles*PERIOD))/1000/1000;
-    std::cout << cycles << " cycles for " << bursts << " bursts of length "
-        << burst_len << " (" << (num_bytes/1024) << " KiB)" << std::endl;
-    std::cout << "D_R: " << throughput << " MB/s" << std::endl << std::flush;
-  }
+  fletcher::TranslatorCounters::Read(platform.get(), tlb_offset, &tlb_end);
+  auto tlb = tlb_end.Since(tlb_start);
+  std::cout << "TLB " << name << ": " << tlb.hits << " hits, " << tlb.misses << " misses ("
+      << std::setprecision(4) << tlb.hit_rate() * 100 << "% hit rate), " << tlb.prefetches << " prefetches, "
+      << tlb.walk_cycles << " cycles waiting for page table walks" << std::endl << std::flush;
 }
 
 /**
@@ -299,106 +297,17 @@ int main(int argc, char ** argv) {
     if (benchmark_buffer >= 0) {
 
       da_t dev_raw = 1024L*1024L*1024L; // 1 GiB offset into device memory
-      int test_size = 1024*1024*512; // 512 MiB
-
-      int bench_reg_offset = 26+2*12;
-
-//      std::cerr << "Performing latency measurement" << std::endl;
-
-      uint32_t burst_len = 1;
-      uint32_t bursts = 1;
-      uint64_t addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-//      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-//      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      std::cerr << "Performing sequential reads with decrementing burst sizes." << std::endl;
-
-      burst_len = 1;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 2;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 4;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 8;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 16;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 32;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 64;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      std::cerr << "Performing random reads with decrementing burst sizes." << std::endl;
-      bench_reg_offset = 26 + 12;
-
-      burst_len = 64;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 32;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 16;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 8;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 4;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 2;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
-
-      burst_len = 1;
-      bursts = test_size/BUS_DATA_BYTES/burst_len;
-      addr_mask = get_addr_mask(malloc_sizes.at(benchmark_buffer), burst_len);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, dev_raw, addr_mask);
-      device_bench(platform, bench_reg_offset, burst_len, bursts, maddr.at(benchmark_buffer), addr_mask);
+      uint64_t test_size = 1024*1024*512; // 512 MiB
+
+      // The sequential write and the random read benchmarker.
+      device_bench(platform, "WS", MM_REG_OFFSET_BENCH_WS, MM_REG_OFFSET_TLB_WS,
+                   dev_raw, malloc_sizes.at(benchmark_buffer), test_size);
+      device_bench(platform, "WS", MM_REG_OFFSET_BENCH_WS, MM_REG_OFFSET_TLB_WS,
+                   maddr.at(benchmark_buffer), malloc_sizes.at(benchmark_buffer), test_size);
+      device_bench(platform, "RR", MM_REG_OFFSET_BENCH_RR, MM_REG_OFFSET_TLB_RR,
+                   dev_raw, malloc_sizes.at(benchmark_buffer), test_size);
+      device_bench(platform, "RR", MM_REG_OFFSET_BENCH_RR, MM_REG_OFFSET_TLB_RR,
+                   maddr.at(benchmark_buffer), malloc_sizes.at(benchmark_buffer), test_size);
     }
   }
 
@@ -424,7 +333,7 @@ int main(int argc, char ** argv) {
         status = EXIT_FAILURE;
         break;
       }
-      platform->ReadMMIO(26+12*4, &cycles);
+      platform->ReadMMIO(MM_REG_CMD_DELAY, &cycles);
       if (bench_alloc) {
         std::cout << "Alloc of " << alloc_size << " bytes took " << cycles << " cycles." << std::endl << std::flush;
       }
@@ -433,12 +342,12 @@ int main(int argc, char ** argv) {
         if (!platform->DeviceFree(alloc_addr).ok()) {
           std::cerr << "ERROR while freeing " << alloc_size << " bytes." << std::endl << std::flush;
           uint32_t regval = 0;
-          platform->ReadMMIO(26+12*4+1, &regval);
+          platform->ReadMMIO(MM_REG_DEBUG, &regval);
           std::cerr << "State: " << regval << std::endl;
           status = EXIT_FAILURE;
           break;
         }
-        platform->ReadMMIO(26+12*4, &cycles);
+        platform->ReadMMIO(MM_REG_CMD_DELAY, &cycles);
         std::cout << "Free of " << alloc_size << " bytes took " << cycles << " cycles." << std::endl << std::flush;
       }
 
@@ -467,7 +376,7 @@ int main(int argc, char ** argv) {
       std::cerr << "ERROR while allocating " << alloc_size << " bytes." << std::endl << std::flush;
       status = EXIT_FAILURE;
     }
-    platform->ReadMMIO(26+12*4, &cycles);
+    platform->ReadMMIO(MM_REG_CMD_DELAY, &cycles);
     std::cout << "-Alloc of " << alloc_size << " bytes took " << cycles << " cycles." << std::endl << std::flush;
 
     alloc_size = 1024*1024;
@@ -516,7 +425,7 @@ int main(int argc, char ** argv) {
         status = EXIT_FAILURE;
         break;
       }
-      platform->ReadMMIO(26+12*4, &cycles);
+      platform->ReadMMIO(MM_REG_CMD_DELAY, &cycles);
       std::cout << "Realloc to " << alloc_size << " bytes took " << cycles << " cycles." << std::endl << std::flush;
 
       std::cerr << "Device malloc at " << std::setw(12) << std::hex << alloc_addr << std::dec << "." << std::endl << std::flush;
@@ -538,7 +447,7 @@ int main(int argc, char ** argv) {
       std::cerr << "ERROR while freeing " << alloc_size << " bytes." << std::endl;
       status = EXIT_FAILURE;
     }
-    platform->ReadMMIO(26+12*4, &cycles);
+    platform->ReadMMIO(MM_REG_CMD_DELAY, &cycles);
     std::cout << "-Free of " << alloc_size << " bytes took " << cycles << " cycles." << std::endl << std::flush;
   }
 
@@ -0,0 +1,162 @@
+-- Copyright 2018 Delft University of Technology
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing, software
+-- distributed under the License is distributed on an "AS IS" BASIS,
+-- WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+-- See the License for the specific language governing permissions and
+-- limitations under the License.
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+-- This unit observes the handshakes of an ArrayReader or ArrayWriter and
+-- counts:
+--  - busy cycles: bus clock cycles in which at least one command was accepted
+--    that has not been unlocked yet,
+--  - request beats: the sum of the burst lengths of all bus requests,
+--  - data beats: the number of bus data transfers,
+--  - stall cycles: kernel clock cycles in which at least one of the user
+--    streams is valid while it is not ready,
+--  - bytes: the number of bytes transferred over the bus.
+--
+-- The counters are reset with their clock domain and wrap around when they
+-- overflow. The counters of the bus clock domain are not synchronized to the
+-- kernel clock domain; they should only be read when the array is idle, or
+-- when both clock domains are driven by the same clock.
+
+entity ArrayProfiler is
+  generic (
+
+    -- Bus burst length width.
+    BUS_LEN_WIDTH               : natural := 8;
+
+    -- Bus data width.
+    BUS_DATA_WIDTH              : natural := 32;
+
+    -- Number of user streams.
+    NUM_STREAMS                 : natural := 1;
+
+    -- Width of the counters.
+    COUNT_WIDTH                 : natural := 32
+
+  );
+  port (
+
+    -- Rising-edge sensitive clock and active-high synchronous reset for the
+    -- bus and control logic side.
+    bcd_clk                     : in  std_logic;
+    bcd_reset                   : in  std_logic;
+
+    -- Rising-edge sensitive clock and active-high synchronous reset for the
+    -- accelerator side.
+    kcd_clk                     : in  std_logic;
+    kcd_reset                   : in  std_logic;
+
+    -- Command and unlock stream handshakes (bus clock domain).
+    cmd_valid                   : in  std_logic;
+    cmd_ready                   : in  std_logic;
+    unl_valid                   : in  std_logic;
+    unl_ready                   : in  std_logic;
+
+    -- Bus request and data handshakes (bus clock domain).
+    req_valid                   : in  std_logic;
+    req_ready                   : in  std_logic;
+    req_len                     : in  std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+    dat_valid                   : in  std_logic;
+    dat_ready                   : in  std_logic;
+
+    -- User stream handshakes (kernel clock domain).
+    str_valid                   : in  std_logic_vector(NUM_STREAMS-1 downto 0);
+    str_ready                   : in  std_logic_vector(NUM_STREAMS-1 downto 0);
+
+    -- Counters (busy cycles, request beats, data beats and bytes in the bus
+    -- clock domain, stall cycles in the kernel clock domain).
+    busy_cycles                 : out std_logic_vector(COUNT_WIDTH-1 downto 0);
+    req_beats                   : out std_logic_vector(COUNT_WIDTH-1 downto 0);
+    dat_beats                   : out std_logic_vector(COUNT_WIDTH-1 downto 0);
+    stall_cycles                : out std_logic_vector(COUNT_WIDTH-1 downto 0);
+    bytes                       : out std_logic_vector(COUNT_WIDTH-1 downto 0)
+
+  );
+end ArrayProfiler;
+
+architecture rtl of ArrayProfiler is
+
+  -- Number of bytes in a bus data transfer.
+  constant BEAT_BYTES           : natural := BUS_DATA_WIDTH / 8;
+
+  -- Number of commands that were accepted but not unlocked yet.
+  signal outstanding            : unsigned(7 downto 0);
+
+  signal busy_count             : unsigned(COUNT_WIDTH-1 downto 0);
+  signal req_count              : unsigned(COUNT_WIDTH-1 downto 0);
+  signal dat_count              : unsigned(COUNT_WIDTH-1 downto 0);
+  signal stall_count            : unsigned(COUNT_WIDTH-1 downto 0);
+  signal byte_count             : unsigned(COUNT_WIDTH-1 downto 0);
+
+begin
+
+  bcd_proc: process (bcd_clk) is
+    variable cmd_handshake      : boolean;
+    variable unl_handshake      : boolean;
+  begin
+    if rising_edge(bcd_clk) then
+      cmd_handshake := cmd_valid = '1' and cmd_ready = '1';
+      unl_handshake := unl_valid = '1' and unl_ready = '1';
+
+      if outstanding /= 0 then
+        busy_count <= busy_count + 1;
+      end if;
+
+      if cmd_handshake and not unl_handshake then
+        outstanding <= outstanding + 1;
+      elsif unl_handshake and not cmd_handshake and outstanding /= 0 then
+        outstanding <= outstanding - 1;
+      end if;
+
+      if req_valid = '1' and req_ready = '1' then
+        req_count <= req_count + resize(unsigned(req_len), COUNT_WIDTH);
+      end if;
+
+      if dat_valid = '1' and dat_ready = '1' then
+        dat_count <= dat_count + 1;
+        byte_count <= byte_count + BEAT_BYTES;
+      end if;
+
+      if bcd_reset = '1' then
+        outstanding <= (others => '0');
+        busy_count <= (others => '0');
+        req_count <= (others => '0');
+        dat_count <= (others => '0');
+        byte_count <= (others => '0');
+      end if;
+    end if;
+  end process;
+
+  kcd_proc: process (kcd_clk) is
+  begin
+    if rising_edge(kcd_clk) then
+      if unsigned(str_valid and not str_ready) /= 0 then
+        stall_count <= stall_count + 1;
+      end if;
+
+      if kcd_reset = '1' then
+        stall_count <= (others => '0');
+      end if;
+    end if;
+  end process;
+
+  busy_cycles                   <= std_logic_vector(busy_count);
+  req_beats                     <= std_logic_vector(req_count);
+  dat_beats                     <= std_logic_vector(dat_count);
+  stall_cycles                  <= std_logic_vector(stall_count);
+  bytes                         <= std_logic_vector(byte_count);
+
+end rtl;
@@ -21,6 +21,7 @@ use work.Stream_pkg.all;
 use work.ArrayConfig_pkg.all;
 use work.ArrayConfigParse_pkg.all;
 use work.Array_pkg.all;
+use work.Interconnect_pkg.all;
 
 entity ArrayReader is
   generic (
@@ -72,7 +73,15 @@ entity ArrayReader is
     CMD_TAG_ENABLE              : boolean := false;
 
     -- Command stream tag width. Must be at least 1 to avoid null vectors.
-    CMD_TAG_WIDTH               : natural := 1
+    CMD_TAG_WIDTH               : natural := 1;
+
+    -- Enables or disables the run-time burst length limit. When enabled, bus
+    -- requests are split into bursts of at most burst_max_len beats.
+    BURST_LIMIT_ENABLE          : boolean := false;
+
+    -- Enables or disables the profile counters. When disabled, the counters
+    -- are tied to zero.
+    PROFILE_ENABLE              : boolean := false
 
   );
   port (
@@ -112,6 +121,12 @@ entity ArrayReader is
     unl_ready                   : in  std_logic := '1';
     unl_tag                     : out std_logic_vector(CMD_TAG_WIDTH-1 downto 0);
 
+    -- Maximum number of beats in a burst (bus clock domain), if
+    -- BURST_LIMIT_ENABLE is set. Zero or values larger than BUS_BURST_MAX_LEN
+    -- select BUS_BURST_MAX_LEN. Changes only apply to bus requests that are
+    -- generated afterwards.
+    burst_max_len               : in  std_logic_vector(BUS_LEN_WIDTH-1 downto 0) := (others => '0');
+
     ---------------------------------------------------------------------------
     -- Bus access ports
     ---------------------------------------------------------------------------
@@ -135,12 +150,41 @@ entity ArrayReader is
     out_ready                   : in  std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
     out_last                    : out std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
     out_dvalid                  : out std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
-    out_data                    : out std_logic_vector(arcfg_userWidth(CFG, INDEX_WIDTH)-1 downto 0)
+    out_data                    : out std_logic_vector(arcfg_userWidth(CFG, INDEX_WIDTH)-1 downto 0);
+
+    ---------------------------------------------------------------------------
+    -- Profile counters
+    ---------------------------------------------------------------------------
+    -- Busy cycles, bus request beats, bus data beats and bytes read (bus clock
+    -- domain), and cycles in which a user stream is valid while the kernel is
+    -- not ready (kernel clock domain), if PROFILE_ENABLE is set. See
+    -- ArrayProfiler.vhd.
+    prof_busy_cycles            : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+    prof_req_beats              : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+    prof_dat_beats              : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+    prof_stall_cycles           : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+    prof_bytes                  : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0)
 
   );
 end ArrayReader;
 
 architecture Behavioral of ArrayReader is
+
+  -- Bus port of the arbiter.
+  signal arb_rreq_valid         : std_logic;
+  signal arb_rreq_ready         : std_logic;
+  signal arb_rreq_addr          : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal arb_rreq_len           : std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+  signal arb_rdat_valid         : std_logic;
+  signal arb_rdat_ready         : std_logic;
+  signal arb_rdat_data          : std_logic_vector(BUS_DATA_WIDTH-1 downto 0);
+  signal arb_rdat_last          : std_logic;
+
+  -- Copies of the outputs that are observed by the profiler.
+  signal int_cmd_ready          : std_logic;
+  signal int_unl_valid          : std_logic;
+  signal int_out_valid          : std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
+
 begin
 
   -- Wrap an arbiter and register slices around the requested array reader.
@@ -165,30 +209,124 @@ begin
       kcd_reset                 => kcd_reset,
 
       cmd_valid                 => cmd_valid,
-      cmd_ready                 => cmd_ready,
+      cmd_ready                 => int_cmd_ready,
       cmd_firstIdx              => cmd_firstIdx,
       cmd_lastIdx               => cmd_lastIdx,
       cmd_ctrl                  => cmd_ctrl,
       cmd_tag                   => cmd_tag,
 
-      unlock_valid              => unl_valid,
+      unlock_valid              => int_unl_valid,
       unlock_ready              => unl_ready,
       unlock_tag                => unl_tag,
 
-      bus_rreq_valid(0)         => bus_rreq_valid,
-      bus_rreq_ready(0)         => bus_rreq_ready,
-      bus_rreq_addr             => bus_rreq_addr,
-      bus_rreq_len              => bus_rreq_len,
-      bus_rdat_valid(0)         => bus_rdat_valid,
-      bus_rdat_ready(0)         => bus_rdat_ready,
-      bus_rdat_data             => bus_rdat_data,
-      bus_rdat_last(0)          => bus_rdat_last,
+      bus_rreq_valid(0)         => arb_rreq_valid,
+      bus_rreq_ready(0)         => arb_rreq_ready,
+      bus_rreq_addr             => arb_rreq_addr,
+      bus_rreq_len              => arb_rreq_len,
+      bus_rdat_valid(0)         => arb_rdat_valid,
+      bus_rdat_ready(0)         => arb_rdat_ready,
+      bus_rdat_data             => arb_rdat_data,
+      bus_rdat_last(0)          => arb_rdat_last,
 
-      out_valid                 => out_valid,
+      out_valid                 => int_out_valid,
       out_ready                 => out_ready,
       out_last                  => out_last,
       out_dvalid                => out_dvalid,
       out_data                  => out_data
     );
 
+  cmd_ready                     <= int_cmd_ready;
+  unl_valid                     <= int_unl_valid;
+  out_valid                     <= int_out_valid;
+
+  -- Split the bursts of the arbiter if the burst length limit is enabled.
+  limit_gen: if BURST_LIMIT_ENABLE generate
+    limiter_inst: BusReadBurstLimiter
+      generic map (
+        BUS_ADDR_WIDTH          => BUS_ADDR_WIDTH,
+        BUS_LEN_WIDTH           => BUS_LEN_WIDTH,
+        BUS_DATA_WIDTH          => BUS_DATA_WIDTH,
+        BUS_BURST_MAX_LEN       => BUS_BURST_MAX_LEN
+      )
+      port map (
+        clk                     => bcd_clk,
+        reset                   => bcd_reset,
+
+        max_len                 => burst_max_len,
+
+        slv_rreq_valid          => arb_rreq_valid,
+        slv_rreq_ready          => arb_rreq_ready,
+        slv_rreq_addr           => arb_rreq_addr,
+        slv_rreq_len            => arb_rreq_len,
+        slv_rdat_valid          => arb_rdat_valid,
+        slv_rdat_ready          => arb_rdat_ready,
+        slv_rdat_data           => arb_rdat_data,
+        slv_rdat_last           => arb_rdat_last,
+
+        mst_rreq_valid          => bus_rreq_valid,
+        mst_rreq_ready          => bus_rreq_ready,
+        mst_rreq_addr           => bus_rreq_addr,
+        mst_rreq_len            => bus_rreq_len,
+        mst_rdat_valid          => bus_rdat_valid,
+        mst_rdat_ready          => bus_rdat_ready,
+        mst_rdat_data           => bus_rdat_data,
+        mst_rdat_last           => bus_rdat_last
+      );
+  end generate;
+
+  no_limit_gen: if not BURST_LIMIT_ENABLE generate
+    bus_rreq_valid              <= arb_rreq_valid;
+    arb_rreq_ready              <= bus_rreq_ready;
+    bus_rreq_addr               <= arb_rreq_addr;
+    bus_rreq_len                <= arb_rreq_len;
+    arb_rdat_valid              <= bus_rdat_valid;
+    bus_rdat_ready              <= arb_rdat_ready;
+    arb_rdat_data               <= bus_rdat_data;
+    arb_rdat_last               <= bus_rdat_last;
+  end generate;
+
+  profile_gen: if PROFILE_ENABLE generate
+    profiler_inst: ArrayProfiler
+      generic map (
+        BUS_LEN_WIDTH           => BUS_LEN_WIDTH,
+        BUS_DATA_WIDTH          => BUS_DATA_WIDTH,
+        NUM_STREAMS             => arcfg_userCount(CFG),
+        COUNT_WIDTH             => ARRAY_PROFILE_COUNT_WIDTH
+      )
+      port map (
+        bcd_clk                 => bcd_clk,
+        bcd_reset               => bcd_reset,
+        kcd_clk                 => kcd_clk,
+        kcd_reset               => kcd_reset,
+
+        cmd_valid               => cmd_valid,
+        cmd_ready               => int_cmd_ready,
+        unl_valid               => int_unl_valid,
+        unl_ready               => unl_ready,
+
+        req_valid               => arb_rreq_valid,
+        req_ready               => arb_rreq_ready,
+        req_len                 => arb_rreq_len,
+        dat_valid               => arb_rdat_valid,
+        dat_ready               => arb_rdat_ready,
+
+        str_valid               => int_out_valid,
+        str_ready               => out_ready,
+
+        busy_cycles             => prof_busy_cycles,
+        req_beats               => prof_req_beats,
+        dat_beats               => prof_dat_beats,
+        stall_cycles            => prof_stall_cycles,
+        bytes                   => prof_bytes
+      );
+  end generate;
+
+  no_profile_gen: if not PROFILE_ENABLE generate
+    prof_busy_cycles            <= (others => '0');
+    prof_req_beats              <= (others => '0');
+    prof_dat_beats              <= (others => '0');
+    prof_stall_cycles           <= (others => '0');
+    prof_bytes                  <= (others => '0');
+  end generate;
+
 end Behavioral;
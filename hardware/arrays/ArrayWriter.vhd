@@ -76,7 +76,11 @@ entity ArrayWriter is
     CMD_TAG_ENABLE              : boolean := false;
 
     -- Command stream tag width. Must be at least 1 to avoid null vectors.
-    CMD_TAG_WIDTH               : natural := 1
+    CMD_TAG_WIDTH               : natural := 1;
+
+    -- Enables or disables the profile counters. When disabled, the counters
+    -- are tied to zero.
+    PROFILE_ENABLE              : boolean := false
 
   );
   port (
@@ -140,12 +144,34 @@ entity ArrayWriter is
     in_ready                    : out std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
     in_last                     : in  std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
     in_dvalid                   : in  std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
-    in_data                     : in  std_logic_vector(arcfg_userWidth(CFG, INDEX_WIDTH)-1 downto 0)
+    in_data                     : in  std_logic_vector(arcfg_userWidth(CFG, INDEX_WIDTH)-1 downto 0);
+
+    ---------------------------------------------------------------------------
+    -- Profile counters
+    ---------------------------------------------------------------------------
+    -- Busy cycles, bus request beats, bus data beats and bytes written (bus
+    -- clock domain), and cycles in which a user stream is valid while the
+    -- ArrayWriter is not ready (accelerator clock domain), if PROFILE_ENABLE
+    -- is set. See ArrayProfiler.vhd.
+    prof_busy_cycles            : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+    prof_req_beats              : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+    prof_dat_beats              : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+    prof_stall_cycles           : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+    prof_bytes                  : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0)
 
   );
 end ArrayWriter;
 
 architecture Behavioral of ArrayWriter is
+
+  -- Copies of the outputs that are observed by the profiler.
+  signal int_cmd_ready          : std_logic;
+  signal int_unl_valid          : std_logic;
+  signal int_bus_wreq_valid     : std_logic;
+  signal int_bus_wreq_len       : std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+  signal int_bus_wdat_valid     : std_logic;
+  signal int_in_ready           : std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
+
 begin
 
   -- pragma translate off
@@ -180,31 +206,82 @@ begin
       kcd_reset                 => kcd_reset,
   
       cmd_valid                 => cmd_valid,
-      cmd_ready                 => cmd_ready,
+      cmd_ready                 => int_cmd_ready,
       cmd_firstIdx              => cmd_firstIdx,
       cmd_lastIdx               => cmd_lastIdx,
       cmd_ctrl                  => cmd_ctrl,
       cmd_tag                   => cmd_tag,
       
-      unlock_valid              => unl_valid,
+      unlock_valid              => int_unl_valid,
       unlock_ready              => unl_ready,
       unlock_tag                => unl_tag,
       
-      bus_wreq_valid(0)         => bus_wreq_valid,
+      bus_wreq_valid(0)         => int_bus_wreq_valid,
       bus_wreq_ready(0)         => bus_wreq_ready,
       bus_wreq_addr             => bus_wreq_addr,
-      bus_wreq_len              => bus_wreq_len,
-      bus_wdat_valid(0)         => bus_wdat_valid,
+      bus_wreq_len              => int_bus_wreq_len,
+      bus_wdat_valid(0)         => int_bus_wdat_valid,
       bus_wdat_ready(0)         => bus_wdat_ready,
       bus_wdat_strobe           => bus_wdat_strobe,
       bus_wdat_data             => bus_wdat_data,
       bus_wdat_last(0)          => bus_wdat_last,
       
       in_valid                  => in_valid,
-      in_ready                  => in_ready,
+      in_ready                  => int_in_ready,
       in_last                   => in_last,
       in_dvalid                 => in_dvalid,
       in_data                   => in_data
     );
 
+  cmd_ready                     <= int_cmd_ready;
+  unl_valid                     <= int_unl_valid;
+  bus_wreq_valid                <= int_bus_wreq_valid;
+  bus_wreq_len                  <= int_bus_wreq_len;
+  bus_wdat_valid                <= int_bus_wdat_valid;
+  in_ready                      <= int_in_ready;
+
+  profile_gen: if PROFILE_ENABLE generate
+    profiler_inst: ArrayProfiler
+      generic map (
+        BUS_LEN_WIDTH           => BUS_LEN_WIDTH,
+        BUS_DATA_WIDTH          => BUS_DATA_WIDTH,
+        NUM_STREAMS             => arcfg_userCount(CFG),
+        COUNT_WIDTH             => ARRAY_PROFILE_COUNT_WIDTH
+      )
+      port map (
+        bcd_clk                 => bcd_clk,
+        bcd_reset               => bcd_reset,
+        kcd_clk                 => kcd_clk,
+        kcd_reset               => kcd_reset,
+
+        cmd_valid               => cmd_valid,
+        cmd_ready               => int_cmd_ready,
+        unl_valid               => int_unl_valid,
+        unl_ready               => unl_ready,
+
+        req_valid               => int_bus_wreq_valid,
+        req_ready               => bus_wreq_ready,
+        req_len                 => int_bus_wreq_len,
+        dat_valid               => int_bus_wdat_valid,
+        dat_ready               => bus_wdat_ready,
+
+        str_valid               => in_valid,
+        str_ready               => int_in_ready,
+
+        busy_cycles             => prof_busy_cycles,
+        req_beats               => prof_req_beats,
+        dat_beats               => prof_dat_beats,
+        stall_cycles            => prof_stall_cycles,
+        bytes                   => prof_bytes
+      );
+  end generate;
+
+  no_profile_gen: if not PROFILE_ENABLE generate
+    prof_busy_cycles            <= (others => '0');
+    prof_req_beats              <= (others => '0');
+    prof_dat_beats              <= (others => '0');
+    prof_stall_cycles           <= (others => '0');
+    prof_bytes                  <= (others => '0');
+  end generate;
+
 end Behavioral;
@@ -21,6 +21,9 @@ use work.ArrayConfig_pkg.all;
 use work.ArrayConfigParse_pkg.all;
 
 package Array_pkg is
+  -- Width of the profile counters of ArrayReaders and ArrayWriters.
+  constant ARRAY_PROFILE_COUNT_WIDTH : natural := 32;
+
   -----------------------------------------------------------------------------
   -- ArrayWriter
   -----------------------------------------------------------------------------
@@ -35,7 +38,8 @@ package Array_pkg is
       INDEX_WIDTH               : natural;
       CFG                       : string;
       CMD_TAG_ENABLE            : boolean := false;
-      CMD_TAG_WIDTH             : natural := 1
+      CMD_TAG_WIDTH             : natural := 1;
+      PROFILE_ENABLE            : boolean := false
     );
     port (
       bcd_clk                   : in  std_logic;
@@ -64,7 +68,12 @@ package Array_pkg is
       in_ready                  : out std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
       in_last                   : in  std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
       in_dvalid                 : in  std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
-      in_data                   : in  std_logic_vector(arcfg_userWidth(CFG, INDEX_WIDTH)-1 downto 0)
+      in_data                   : in  std_logic_vector(arcfg_userWidth(CFG, INDEX_WIDTH)-1 downto 0);
+      prof_busy_cycles          : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+      prof_req_beats            : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+      prof_dat_beats            : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+      prof_stall_cycles         : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+      prof_bytes                : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0)
     );
   end component;
 
@@ -237,7 +246,9 @@ package Array_pkg is
       INDEX_WIDTH               : natural;
       CFG                       : string;
       CMD_TAG_ENABLE            : boolean := false;
-      CMD_TAG_WIDTH             : natural := 1
+      CMD_TAG_WIDTH             : natural := 1;
+      BURST_LIMIT_ENABLE        : boolean := false;
+      PROFILE_ENABLE            : boolean := false
     );
     port (
       bcd_clk                   : in  std_logic;
@@ -253,6 +264,7 @@ package Array_pkg is
       unl_valid                 : out std_logic;
       unl_ready                 : in  std_logic := '1';
       unl_tag                   : out std_logic_vector(CMD_TAG_WIDTH-1 downto 0) := (others => '0');
+      burst_max_len             : in  std_logic_vector(BUS_LEN_WIDTH-1 downto 0) := (others => '0');
       bus_rreq_valid            : out std_logic;
       bus_rreq_ready            : in  std_logic;
       bus_rreq_addr             : out std_logic_vector;
@@ -265,7 +277,12 @@ package Array_pkg is
       out_ready                 : in  std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
       out_last                  : out std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
       out_dvalid                : out std_logic_vector(arcfg_userCount(CFG)-1 downto 0);
-      out_data                  : out std_logic_vector(arcfg_userWidth(CFG, INDEX_WIDTH)-1 downto 0)
+      out_data                  : out std_logic_vector(arcfg_userWidth(CFG, INDEX_WIDTH)-1 downto 0);
+      prof_busy_cycles          : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+      prof_req_beats            : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+      prof_dat_beats            : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+      prof_stall_cycles         : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0);
+      prof_bytes                : out std_logic_vector(ARRAY_PROFILE_COUNT_WIDTH-1 downto 0)
     );
   end component;
 
@@ -592,4 +609,38 @@ package Array_pkg is
     );
   end component;
 
+  -----------------------------------------------------------------------------
+  -- Profiling
+  -----------------------------------------------------------------------------
+  component ArrayProfiler is
+    generic (
+      BUS_LEN_WIDTH             : natural := 8;
+      BUS_DATA_WIDTH            : natural := 32;
+      NUM_STREAMS               : natural := 1;
+      COUNT_WIDTH               : natural := 32
+    );
+    port (
+      bcd_clk                   : in  std_logic;
+      bcd_reset                 : in  std_logic;
+      kcd_clk                   : in  std_logic;
+      kcd_reset                 : in  std_logic;
+      cmd_valid                 : in  std_logic;
+      cmd_ready                 : in  std_logic;
+      unl_valid                 : in  std_logic;
+      unl_ready                 : in  std_logic;
+      req_valid                 : in  std_logic;
+      req_ready                 : in  std_logic;
+      req_len                   : in  std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+      dat_valid                 : in  std_logic;
+      dat_ready                 : in  std_logic;
+      str_valid                 : in  std_logic_vector(NUM_STREAMS-1 downto 0);
+      str_ready                 : in  std_logic_vector(NUM_STREAMS-1 downto 0);
+      busy_cycles               : out std_logic_vector(COUNT_WIDTH-1 downto 0);
+      req_beats                 : out std_logic_vector(COUNT_WIDTH-1 downto 0);
+      dat_beats                 : out std_logic_vector(COUNT_WIDTH-1 downto 0);
+      stall_cycles              : out std_logic_vector(COUNT_WIDTH-1 downto 0);
+      bytes                     : out std_logic_vector(COUNT_WIDTH-1 downto 0)
+    );
+  end component;
+
 end Array_pkg;
@@ -0,0 +1,186 @@
+-- Copyright 2018 Delft University of Technology
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing, software
+-- distributed under the License is distributed on an "AS IS" BASIS,
+-- WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+-- See the License for the specific language governing permissions and
+-- limitations under the License.
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+library work;
+use work.UtilStr_pkg.all;
+use work.Array_pkg.all;
+
+-- Test bench of the ArrayProfiler. Drives a fixed sequence of handshakes and
+-- checks the resulting counters.
+
+entity ArrayProfiler_tb is
+  generic (
+    BUS_LEN_WIDTH               : natural := 8;
+    BUS_DATA_WIDTH              : natural := 64;
+    NUM_STREAMS                 : natural := 2
+  );
+end ArrayProfiler_tb;
+
+architecture Behavioral of ArrayProfiler_tb is
+
+  constant COUNT_WIDTH          : natural := 32;
+
+  signal clk                    : std_logic;
+  signal reset                  : std_logic;
+
+  signal cmd_valid              : std_logic := '0';
+  signal cmd_ready              : std_logic := '0';
+  signal unl_valid              : std_logic := '0';
+  signal unl_ready              : std_logic := '0';
+  signal req_valid              : std_logic := '0';
+  signal req_ready              : std_logic := '0';
+  signal req_len                : std_logic_vector(BUS_LEN_WIDTH-1 downto 0) := (others => '0');
+  signal dat_valid              : std_logic := '0';
+  signal dat_ready              : std_logic := '0';
+  signal str_valid              : std_logic_vector(NUM_STREAMS-1 downto 0) := (others => '0');
+  signal str_ready              : std_logic_vector(NUM_STREAMS-1 downto 0) := (others => '0');
+
+  signal busy_cycles            : std_logic_vector(COUNT_WIDTH-1 downto 0);
+  signal req_beats              : std_logic_vector(COUNT_WIDTH-1 downto 0);
+  signal dat_beats              : std_logic_vector(COUNT_WIDTH-1 downto 0);
+  signal stall_cycles           : std_logic_vector(COUNT_WIDTH-1 downto 0);
+  signal bytes                  : std_logic_vector(COUNT_WIDTH-1 downto 0);
+
+  signal simulation_done        : boolean := false;
+
+  procedure check(name : string; actual : std_logic_vector; expected : natural) is
+  begin
+    assert unsigned(actual) = expected
+      report name & " is " & slvToUDec(actual) & ", expected "
+        & integer'image(expected) & "." severity failure;
+  end procedure;
+
+begin
+
+  clk_proc: process is
+  begin
+    loop
+      clk <= '1';
+      wait for 5 ns;
+      clk <= '0';
+      wait for 5 ns;
+      exit when simulation_done;
+    end loop;
+    wait;
+  end process;
+
+  stim_proc: process is
+    procedure cycle is
+    begin
+      wait until rising_edge(clk);
+    end procedure;
+  begin
+    reset <= '1';
+    cycle;
+    cycle;
+    reset <= '0';
+
+    -- Accept a command. The profiler is busy from the next cycle on.
+    cmd_valid <= '1';
+    cmd_ready <= '1';
+    cycle;
+    cmd_valid <= '0';
+    cmd_ready <= '0';
+
+    -- A request of 4 beats that is only accepted in the second cycle.
+    req_valid <= '1';
+    req_len <= std_logic_vector(to_unsigned(4, BUS_LEN_WIDTH));
+    cycle;
+    req_ready <= '1';
+    cycle;
+    req_valid <= '0';
+    req_ready <= '0';
+
+    -- 4 data beats, with a cycle in which the slave is not ready.
+    dat_valid <= '1';
+    dat_ready <= '1';
+    cycle;
+    cycle;
+    dat_ready <= '0';
+    cycle;
+    dat_ready <= '1';
+    cycle;
+    cycle;
+    dat_valid <= '0';
+    dat_ready <= '0';
+
+    -- 3 stall cycles: a valid stream that is not ready, also when the other
+    -- stream does handshake.
+    str_valid <= "01";
+    cycle;
+    str_valid <= "11";
+    str_ready <= "10";
+    cycle;
+    str_ready <= "00";
+    cycle;
+    str_ready <= "11";
+    cycle;
+    str_valid <= "00";
+    str_ready <= "00";
+
+    -- Unlock the command. The last busy cycle is the cycle of the handshake.
+    unl_valid <= '1';
+    unl_ready <= '1';
+    cycle;
+    unl_valid <= '0';
+    unl_ready <= '0';
+    cycle;
+    cycle;
+
+    check("Busy cycles", busy_cycles, 12);
+    check("Request beats", req_beats, 4);
+    check("Data beats", dat_beats, 4);
+    check("Stall cycles", stall_cycles, 3);
+    check("Bytes", bytes, 4 * BUS_DATA_WIDTH / 8);
+
+    println("ArrayProfiler_tb finished.");
+    simulation_done <= true;
+    wait;
+  end process;
+
+  uut: ArrayProfiler
+    generic map (
+      BUS_LEN_WIDTH             => BUS_LEN_WIDTH,
+      BUS_DATA_WIDTH            => BUS_DATA_WIDTH,
+      NUM_STREAMS               => NUM_STREAMS,
+      COUNT_WIDTH               => COUNT_WIDTH
+    )
+    port map (
+      bcd_clk                   => clk,
+      bcd_reset                 => reset,
+      kcd_clk                   => clk,
+      kcd_reset                 => reset,
+      cmd_valid                 => cmd_valid,
+      cmd_ready                 => cmd_ready,
+      unl_valid                 => unl_valid,
+      unl_ready                 => unl_ready,
+      req_valid                 => req_valid,
+      req_ready                 => req_ready,
+      req_len                   => req_len,
+      dat_valid                 => dat_valid,
+      dat_ready                 => dat_ready,
+      str_valid                 => str_valid,
+      str_ready                 => str_ready,
+      busy_cycles               => busy_cycles,
+      req_beats                 => req_beats,
+      dat_beats                 => dat_beats,
+      stall_cycles              => stall_cycles,
+      bytes                     => bytes
+    );
+
+end Behavioral;
@@ -0,0 +1,126 @@
+-- Copyright 2018 Delft University of Technology
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing, software
+-- distributed under the License is distributed on an "AS IS" BASIS,
+-- WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+-- See the License for the specific language governing permissions and
+-- limitations under the License.
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+library work;
+use work.Interconnect_pkg.all;
+use work.UtilInt_pkg.all;
+
+-- This unit turns the round-robin arbitration of bus requests into weighted
+-- round-robin arbitration, by masking the request streams in front of the
+-- arbiter.
+--
+-- Every slave port receives a number of credits equal to its weight at the
+-- start of a round. Every request accepted from a port consumes one credit,
+-- and ports without credits are masked. A new round starts when none of the
+-- requesting ports has credits left. Ports that do not request anything do
+-- not hold up the other ports. A port is only masked right after one of its
+-- requests was accepted, so the stream handshake rules are never violated.
+
+entity BusArbiterWeights is
+  generic (
+
+    -- Number of bus masters to arbitrate between.
+    NUM_SLAVE_PORTS             : natural := 2;
+
+    -- Comma-separated list of arbitration weights of the slave ports, e.g.
+    -- "1,1,4". Ports without a weight get a weight of 1.
+    SLV_WEIGHTS                 : string := ""
+
+  );
+  port (
+
+    -- Rising-edge sensitive clock and active-high synchronous reset.
+    bcd_clk                     : in  std_logic;
+    bcd_reset                   : in  std_logic;
+
+    -- Request stream handshakes of the slave ports.
+    in_valid                    : in  std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+    in_ready                    : out std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+
+    -- Masked request stream handshakes towards the arbiter.
+    out_valid                   : out std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+    out_ready                   : in  std_logic_vector(NUM_SLAVE_PORTS-1 downto 0)
+
+  );
+end BusArbiterWeights;
+
+architecture Behavioral of BusArbiterWeights is
+
+  -- Number of credits per port at the start of a round.
+  constant WEIGHTS              : nat_array(0 to NUM_SLAVE_PORTS-1) := parse_weights(SLV_WEIGHTS, NUM_SLAVE_PORTS);
+
+  -- Credits left in the current round.
+  signal credits                : nat_array(0 to NUM_SLAVE_PORTS-1);
+
+  -- Ports that have credits left.
+  signal eligible               : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+
+begin
+
+  eligible_proc: process (credits) is
+  begin
+    for i in 0 to NUM_SLAVE_PORTS-1 loop
+      if credits(i) > 0 then
+        eligible(i) <= '1';
+      else
+        eligible(i) <= '0';
+      end if;
+    end loop;
+  end process;
+
+  out_valid <= in_valid and eligible;
+  in_ready  <= out_ready and eligible;
+
+  reg_proc: process (bcd_clk) is
+    variable c                  : nat_array(0 to NUM_SLAVE_PORTS-1);
+    variable requesting         : boolean;
+    variable blocked            : boolean;
+  begin
+    if rising_edge(bcd_clk) then
+      c := credits;
+      requesting := false;
+      blocked := true;
+
+      for i in 0 to NUM_SLAVE_PORTS-1 loop
+        if in_valid(i) = '1' then
+          requesting := true;
+          if eligible(i) = '1' then
+            blocked := false;
+          end if;
+        end if;
+
+        -- Consume a credit for every accepted request.
+        if in_valid(i) = '1' and out_ready(i) = '1' and eligible(i) = '1' then
+          c(i) := c(i) - 1;
+        end if;
+      end loop;
+
+      -- Start a new round when all requesting ports are out of credits.
+      if requesting and blocked then
+        c := WEIGHTS;
+      end if;
+
+      credits <= c;
+
+      if bcd_reset = '1' then
+        credits <= WEIGHTS;
+      end if;
+    end if;
+  end process;
+
+end Behavioral;
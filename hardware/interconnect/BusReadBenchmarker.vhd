@@ -71,6 +71,12 @@ entity BusReadBenchmarker is
     -- Number of cycles to absorb a word, set 0 to always accept immediately
     reg_cycles_per_word         : in  std_logic_vector(31 downto 0);
 
+    -- Sequential address increment in bytes, set 0 to use the burst size
+    reg_stride                  : in  std_logic_vector(31 downto 0) := (others => '0');
+
+    -- Maximum number of outstanding bursts, set 0 for no limit
+    reg_max_outstanding         : in  std_logic_vector(31 downto 0) := (others => '0');
+
     -- Result registers
     reg_cycles                  : out std_logic_vector(31 downto 0);
     reg_checksum                : out std_logic_vector(31 downto 0)
@@ -87,6 +93,8 @@ architecture Behavioral of BusReadBenchmarker is
   constant STATUS_BUSY          : natural := 1;
   constant STATUS_DONE          : natural := 2;
   constant STATUS_ERROR         : natural := 3;
+  -- Set if the unit generates random addresses
+  constant STATUS_RANDOM        : natural := 4;
   
   constant ADDR_SHIFT           : natural := log2ceil(BUS_MAX_BURST_LENGTH * BUS_DATA_WIDTH / 8);
 
@@ -102,6 +110,8 @@ architecture Behavioral of BusReadBenchmarker is
     addr_mask                   : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     max_bursts                  : unsigned(31 downto 0);
     burst_length                : unsigned(31 downto 0);
+    stride                      : unsigned(31 downto 0);
+    max_outstanding             : unsigned(31 downto 0);
     -- Current request address
     addr                        : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     -- Accept rate modifier
@@ -161,6 +171,8 @@ begin
     reg_addr_mask_lo,
     reg_addr_mask_hi,
     reg_cycles_per_word,
+    reg_stride,
+    reg_max_outstanding,
     prng_valid,
     prng_data
   ) is
@@ -175,6 +187,9 @@ begin
     bus_rreq_len   <= slv(r.burst_length(BUS_LEN_WIDTH-1 downto 0));
     prng_ready     <= '0';
     reg_status     <= (others => '0');
+    if PATTERN = "RANDOM" then
+      reg_status(STATUS_RANDOM) <= '1';
+    end if;
     bus_rreq_addr  <= (others => 'U');
     reg_cycles     <= (others => 'U');
     
@@ -194,6 +209,13 @@ begin
           v.num_requests  := unsigned(reg_max_bursts);
           v.num_responses := unsigned(reg_max_bursts);
           v.burst_length  := unsigned(reg_burst_length);
+          v.max_outstanding := unsigned(reg_max_outstanding);
+          -- Without a stride, bursts are requested back to back
+          if unsigned(reg_stride) = 0 then
+            v.stride      := shift_left(unsigned(reg_burst_length), log2ceil(BUS_DATA_WIDTH/8));
+          else
+            v.stride      := unsigned(reg_stride);
+          end if;
           v.base_addr     := reg_base_addr_hi & reg_base_addr_lo;
           v.addr_mask     := reg_addr_mask_hi & reg_addr_mask_lo;
           v.addr          := reg_base_addr_hi & reg_base_addr_lo;
@@ -213,7 +235,10 @@ begin
         -- Count all cycles spent on all requests
         v.cycles := r.cycles + 1;
 
-        if r.num_requests /= 0 then
+        -- Bursts that were requested but not completed are outstanding
+        if r.num_requests /= 0
+          and (r.max_outstanding = 0 or r.num_responses - r.num_requests < r.max_outstanding)
+        then
           -- Generate a valid read request
           bus_rreq_valid <= '1';
           
@@ -235,7 +260,7 @@ begin
             if PATTERN = "RANDOM" then
               prng_ready <= '1';            
             else
-              v.addr := slv(u(r.addr) + shift_left(r.burst_length, log2ceil(BUS_DATA_WIDTH/8)));
+              v.addr := slv(u(r.addr) + r.stride);
             end if;
           end if;
         end if;
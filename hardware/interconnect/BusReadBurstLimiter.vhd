@@ -0,0 +1,223 @@
+-- Copyright 2018 Delft University of Technology
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing, software
+-- distributed under the License is distributed on an "AS IS" BASIS,
+-- WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+-- See the License for the specific language governing permissions and
+-- limitations under the License.
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+library work;
+use work.Stream_pkg.all;
+use work.Interconnect_pkg.all;
+use work.UtilInt_pkg.all;
+
+-- This unit splits the read bursts of a master into bursts of at most max_len
+-- beats, such that the maximum burst length of a master can be lowered at run
+-- time. The burst length is latched for every incoming request, so max_len
+-- may change at any time, but only affects requests accepted afterwards. When
+-- max_len is zero or larger than BUS_BURST_MAX_LEN, requests are passed
+-- through unmodified.
+--
+-- The responses to the resulting bursts are merged again, such that the
+-- master only sees the last signal of the last burst of every request. This
+-- requires the slave to return responses in order.
+
+entity BusReadBurstLimiter is
+  generic (
+
+    -- Bus address width.
+    BUS_ADDR_WIDTH              : natural := 32;
+
+    -- Bus burst length width.
+    BUS_LEN_WIDTH               : natural := 8;
+
+    -- Bus data width.
+    BUS_DATA_WIDTH              : natural := 32;
+
+    -- Maximum number of beats in a burst of the master. Must be representable
+    -- in BUS_LEN_WIDTH bits.
+    BUS_BURST_MAX_LEN           : natural := 16;
+
+    -- Maximum number of bursts on the master port that have not completed
+    -- yet. Requests are blocked when this number is reached.
+    MAX_OUTSTANDING             : natural := 16
+
+  );
+  port (
+
+    -- Rising-edge sensitive clock and active-high synchronous reset.
+    clk                         : in  std_logic;
+    reset                       : in  std_logic;
+
+    -- Maximum number of beats of bursts on the master port. Zero selects
+    -- BUS_BURST_MAX_LEN.
+    max_len                     : in  std_logic_vector(BUS_LEN_WIDTH-1 downto 0) := (others => '0');
+
+    -- Slave port.
+    slv_rreq_valid              : in  std_logic;
+    slv_rreq_ready              : out std_logic;
+    slv_rreq_addr               : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    slv_rreq_len                : in  std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+    slv_rdat_valid              : out std_logic;
+    slv_rdat_ready              : in  std_logic;
+    slv_rdat_data               : out std_logic_vector(BUS_DATA_WIDTH-1 downto 0);
+    slv_rdat_last               : out std_logic;
+
+    -- Master port.
+    mst_rreq_valid              : out std_logic;
+    mst_rreq_ready              : in  std_logic;
+    mst_rreq_addr               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    mst_rreq_len                : out std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+    mst_rdat_valid              : in  std_logic;
+    mst_rdat_ready              : out std_logic;
+    mst_rdat_data               : in  std_logic_vector(BUS_DATA_WIDTH-1 downto 0);
+    mst_rdat_last               : in  std_logic
+
+  );
+end BusReadBurstLimiter;
+
+architecture rtl of BusReadBurstLimiter is
+
+  -- Number of bits to shift a number of beats to obtain a number of bytes.
+  constant BEAT_SHIFT           : natural := log2ceil(BUS_DATA_WIDTH / 8);
+
+  constant MAX_LEN              : unsigned(BUS_LEN_WIDTH-1 downto 0) := to_unsigned(BUS_BURST_MAX_LEN, BUS_LEN_WIDTH);
+
+  type regs_record is record
+    -- Whether a request is being split.
+    busy                        : std_logic;
+    -- Address of the next burst.
+    addr                        : unsigned(BUS_ADDR_WIDTH-1 downto 0);
+    -- Number of beats of the request that have not been requested yet.
+    remain                      : unsigned(BUS_LEN_WIDTH-1 downto 0);
+    -- Burst length limit of the request.
+    limit                       : unsigned(BUS_LEN_WIDTH-1 downto 0);
+  end record;
+
+  signal r                      : regs_record;
+  signal d                      : regs_record;
+
+  -- Whether the current burst is the last burst of the request.
+  signal last_burst             : std_logic;
+
+  -- Handshake of the current burst with both the master port and the queue.
+  signal burst_valid            : std_logic;
+  signal burst_ready            : std_logic;
+
+  -- Queue of flags that mark the last burst of every request.
+  signal queue_in_valid         : std_logic;
+  signal queue_in_ready         : std_logic;
+  signal queue_in_data          : std_logic_vector(0 downto 0);
+  signal queue_out_valid        : std_logic;
+  signal queue_out_ready        : std_logic;
+  signal queue_out_data         : std_logic_vector(0 downto 0);
+
+begin
+
+  last_burst                    <= '1' when r.remain <= r.limit else '0';
+
+  mst_rreq_addr                 <= std_logic_vector(r.addr);
+  mst_rreq_len                  <= std_logic_vector(r.remain) when last_burst = '1' else std_logic_vector(r.limit);
+
+  -- A new request may be accepted when the last burst of the current request
+  -- is handed off.
+  slv_rreq_ready                <= not r.busy or (burst_ready and last_burst);
+
+  burst_valid                   <= r.busy;
+
+  seq_proc: process (clk) is
+  begin
+    if rising_edge(clk) then
+      r                         <= d;
+      if reset = '1' then
+        r.busy                  <= '0';
+      end if;
+    end if;
+  end process;
+
+  comb_proc: process (
+    r, last_burst, burst_ready,
+    max_len, slv_rreq_valid, slv_rreq_addr, slv_rreq_len
+  ) is
+    variable v                  : regs_record;
+  begin
+    v                           := r;
+
+    if r.busy = '1' and burst_ready = '1' then
+      v.addr                    := r.addr + shift_left(resize(r.limit, BUS_ADDR_WIDTH), BEAT_SHIFT);
+      v.remain                  := r.remain - r.limit;
+      if last_burst = '1' then
+        v.busy                  := '0';
+      end if;
+    end if;
+
+    if slv_rreq_valid = '1' and v.busy = '0' then
+      v.busy                    := '1';
+      v.addr                    := unsigned(slv_rreq_addr);
+      v.remain                  := unsigned(slv_rreq_len);
+      if unsigned(max_len) = 0 or unsigned(max_len) > MAX_LEN then
+        v.limit                 := MAX_LEN;
+      else
+        v.limit                 := unsigned(max_len);
+      end if;
+    end if;
+
+    d                           <= v;
+  end process;
+
+  -- Hand off every burst to the master port and the queue simultaneously.
+  sync_inst: StreamSync
+    generic map (
+      NUM_INPUTS                => 1,
+      NUM_OUTPUTS               => 2
+    )
+    port map (
+      clk                       => clk,
+      reset                     => reset,
+      in_valid(0)               => burst_valid,
+      in_ready(0)               => burst_ready,
+      out_valid(0)              => mst_rreq_valid,
+      out_valid(1)              => queue_in_valid,
+      out_ready(0)              => mst_rreq_ready,
+      out_ready(1)              => queue_in_ready
+    );
+
+  queue_in_data(0)              <= last_burst;
+
+  queue_inst: StreamBuffer
+    generic map (
+      MIN_DEPTH                 => MAX_OUTSTANDING,
+      DATA_WIDTH                => 1
+    )
+    port map (
+      clk                       => clk,
+      reset                     => reset,
+      in_valid                  => queue_in_valid,
+      in_ready                  => queue_in_ready,
+      in_data                   => queue_in_data,
+      out_valid                 => queue_out_valid,
+      out_ready                 => queue_out_ready,
+      out_data                  => queue_out_data
+    );
+
+  -- Only pass on responses once the flag of their burst is known, and only
+  -- pass on the last signal of the last burst of a request.
+  slv_rdat_valid                <= mst_rdat_valid and queue_out_valid;
+  mst_rdat_ready                <= slv_rdat_ready and queue_out_valid;
+  slv_rdat_data                 <= mst_rdat_data;
+  slv_rdat_last                 <= mst_rdat_last and queue_out_data(0);
+
+  -- Pop the flag at the end of every burst.
+  queue_out_ready               <= mst_rdat_valid and slv_rdat_ready and mst_rdat_last;
+
+end rtl;
@@ -43,10 +43,16 @@ entity BusWriteArbiterVec is
     -- Number of slaves ports to arbitrate between.
     NUM_SLAVE_PORTS             : natural := 2;
 
-    -- Arbitration method. Must be "ROUND-ROBIN" or "FIXED". If fixed,
-    -- lower-indexed masters take precedence.
+    -- Arbitration method. Must be "ROUND-ROBIN", "WEIGHTED" or "FIXED". If
+    -- fixed, lower-indexed masters take precedence. If weighted, the masters
+    -- are arbitrated in weighted round-robin fashion, according to SLV_WEIGHTS.
     ARB_METHOD                  : string := "ROUND-ROBIN";
 
+    -- Comma-separated list of arbitration weights of the slave ports, e.g.
+    -- "1,1,4", used when ARB_METHOD is "WEIGHTED". Ports without a weight get
+    -- a weight of 1.
+    SLV_WEIGHTS                 : string := "";
+
     -- Maximum number of requests forwarded before the data. This is rounded
     -- upward to whatever is convenient internally.
     MAX_DATA_LAG                : natural := 2;
@@ -195,6 +201,10 @@ architecture Behavioral of BusWriteArbiterVec is
   signal bms_resp_ready         : std_logic;
   signal bms_resp_ok            : bus_resp_type;
 
+  -- Request stream handshakes before the arbitration weights are applied.
+  signal arb_req_valid          : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+  signal arb_req_ready          : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+
   -- Serialized arbiter input signals.
   signal arb_in_valid           : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
   signal arb_in_ready           : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
@@ -411,25 +421,49 @@ begin
   bss2arb_proc: process (bss_wreq_valid, bss_wreq_addr, bss_wreq_len) is
   begin
     for i in 0 to NUM_SLAVE_PORTS-1 loop
-      arb_in_valid(i) <= bss_wreq_valid(i);
+      arb_req_valid(i) <= bss_wreq_valid(i);
       arb_in_data(i*BQI(BQI'high)+BQI(2)-1 downto i*BQI(BQI'high)+BQI(1)) <= bss_wreq_addr(i);
       arb_in_data(i*BQI(BQI'high)+BQI(1)-1 downto i*BQI(BQI'high)+BQI(0)) <= bss_wreq_len(i);
     end loop;
   end process;
-  arb2bss_proc: process (arb_in_ready) is
+  arb2bss_proc: process (arb_req_ready) is
   begin
     for i in 0 to NUM_SLAVE_PORTS-1 loop
-      bss_wreq_ready(i) <= arb_in_ready(i);
+      bss_wreq_ready(i) <= arb_req_ready(i);
     end loop;
   end process;
 
+  -- Apply the arbitration weights, if weighted arbitration is used.
+  weights_gen: if ARB_METHOD = "WEIGHTED" generate
+    weights_inst: BusArbiterWeights
+      generic map (
+        NUM_SLAVE_PORTS                 => NUM_SLAVE_PORTS,
+        SLV_WEIGHTS                     => SLV_WEIGHTS
+      )
+      port map (
+        bcd_clk                         => bcd_clk,
+        bcd_reset                       => bcd_reset,
+
+        in_valid                        => arb_req_valid,
+        in_ready                        => arb_req_ready,
+
+        out_valid                       => arb_in_valid,
+        out_ready                       => arb_in_ready
+      );
+  end generate;
+
+  no_weights_gen: if ARB_METHOD /= "WEIGHTED" generate
+    arb_in_valid                        <= arb_req_valid;
+    arb_req_ready                       <= arb_in_ready;
+  end generate;
+
   -- Instantiate the stream arbiter.
   arb_inst: StreamArb
     generic map (
       NUM_INPUTS                        => NUM_SLAVE_PORTS,
       INDEX_WIDTH                       => INDEX_WIDTH,
       DATA_WIDTH                        => BQI(BQI'high),
-      ARB_METHOD                        => ARB_METHOD
+      ARB_METHOD                        => stream_arb_method(ARB_METHOD)
     )
     port map (
       clk                               => bcd_clk,
@@ -43,6 +43,7 @@ package Interconnect_pkg is
       BUS_DATA_WIDTH            : natural := 32;
       NUM_SLAVE_PORTS           : natural := 2;
       ARB_METHOD                : string  := "ROUND-ROBIN";
+      SLV_WEIGHTS               : string  := "";
       MAX_OUTSTANDING           : natural := 2;
       RAM_CONFIG                : string  := "";
       SLV_REQ_SLICES            : boolean := true;
@@ -82,6 +83,7 @@ package Interconnect_pkg is
       BUS_STROBE_WIDTH          : natural := 32/8;
       NUM_SLAVE_PORTS           : natural := 2;
       ARB_METHOD                : string  := "ROUND-ROBIN";
+      SLV_WEIGHTS               : string  := "";
       MAX_DATA_LAG              : natural := 2;
       MAX_OUTSTANDING           : natural := 2;
       RAM_CONFIG                : string  := "";
@@ -124,6 +126,21 @@ package Interconnect_pkg is
     );
   end component;
 
+  component BusArbiterWeights is
+    generic (
+      NUM_SLAVE_PORTS           : natural := 2;
+      SLV_WEIGHTS               : string  := ""
+    );
+    port (
+      bcd_clk                   : in  std_logic;
+      bcd_reset                 : in  std_logic;
+      in_valid                  : in  std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+      in_ready                  : out std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+      out_valid                 : out std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+      out_ready                 : in  std_logic_vector(NUM_SLAVE_PORTS-1 downto 0)
+    );
+  end component;
+
   component BusReadBuffer is
     generic (
       BUS_ADDR_WIDTH            : natural;
@@ -160,6 +177,40 @@ package Interconnect_pkg is
     );
   end component;
 
+  component BusReadBurstLimiter is
+    generic (
+      BUS_ADDR_WIDTH            : natural := 32;
+      BUS_LEN_WIDTH             : natural := 8;
+      BUS_DATA_WIDTH            : natural := 32;
+      BUS_BURST_MAX_LEN         : natural := 16;
+      MAX_OUTSTANDING           : natural := 16
+    );
+    port (
+      clk                       : in  std_logic;
+      reset                     : in  std_logic;
+
+      max_len                   : in  std_logic_vector(BUS_LEN_WIDTH-1 downto 0) := (others => '0');
+
+      slv_rreq_valid            : in  std_logic;
+      slv_rreq_ready            : out std_logic;
+      slv_rreq_addr             : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+      slv_rreq_len              : in  std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+      slv_rdat_valid            : out std_logic;
+      slv_rdat_ready            : in  std_logic;
+      slv_rdat_data             : out std_logic_vector(BUS_DATA_WIDTH-1 downto 0);
+      slv_rdat_last             : out std_logic;
+
+      mst_rreq_valid            : out std_logic;
+      mst_rreq_ready            : in  std_logic;
+      mst_rreq_addr             : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+      mst_rreq_len              : out std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+      mst_rdat_valid            : in  std_logic;
+      mst_rdat_ready            : out std_logic;
+      mst_rdat_data             : in  std_logic_vector(BUS_DATA_WIDTH-1 downto 0);
+      mst_rdat_last             : in  std_logic
+    );
+  end component;
+
   component BusWriteBuffer is
     generic (
       BUS_ADDR_WIDTH            : natural;
@@ -236,6 +287,8 @@ package Interconnect_pkg is
       reg_addr_mask_lo            : in  std_logic_vector(31 downto 0);
       reg_addr_mask_hi            : in  std_logic_vector(31 downto 0);
       reg_cycles_per_word         : in  std_logic_vector(31 downto 0);
+      reg_stride                  : in  std_logic_vector(31 downto 0) := (others => '0');
+      reg_max_outstanding         : in  std_logic_vector(31 downto 0) := (others => '0');
       reg_cycles                  : out std_logic_vector(31 downto 0);
       reg_checksum                : out std_logic_vector(31 downto 0)
     );
@@ -286,6 +339,12 @@ package Interconnect_pkg is
       -- Number of cycles to absorb a word, set 0 to always accept immediately
       reg_cycles_per_word         : in  std_logic_vector(31 downto 0);
 
+      -- Sequential address increment in bytes, set 0 to use the burst size
+      reg_stride                  : in  std_logic_vector(31 downto 0) := (others => '0');
+
+      -- Maximum number of outstanding bursts, set 0 for no limit
+      reg_max_outstanding         : in  std_logic_vector(31 downto 0) := (others => '0');
+
       -- Result registers
       reg_cycles                  : out std_logic_vector(31 downto 0);
       reg_checksum                : out std_logic_vector(31 downto 0)
@@ -714,6 +773,18 @@ package Interconnect_pkg is
     );
   end component;
    
+  -----------------------------------------------------------------------------
+  -- Arbitration helper functions
+  -----------------------------------------------------------------------------
+  -- Parses a comma-separated list of arbitration weights, e.g. "1,1,4". Ports
+  -- without a weight in the list, or with a weight of zero, get a weight of 1.
+  function parse_weights(weights : string; num_ports : natural) return nat_array;
+
+  -- Returns the method of the StreamArb that a bus arbiter with arbitration
+  -- method arb_method is built on. The "WEIGHTED" method uses a round-robin
+  -- arbiter of which the inputs are masked by a BusArbiterWeights unit.
+  function stream_arb_method(arb_method : string) return string;
+
   -----------------------------------------------------------------------------
   -- Component declarations for simulation-only helper units
   -----------------------------------------------------------------------------
@@ -853,3 +924,37 @@ package Interconnect_pkg is
   -- pragma translate_on
   
 end Interconnect_pkg;
+
+package body Interconnect_pkg is
+
+  function parse_weights(weights : string; num_ports : natural) return nat_array is
+    variable result : nat_array(0 to num_ports-1) := (others => 1);
+    variable port_i : natural := 0;
+    variable value  : natural := 0;
+  begin
+    for i in weights'range loop
+      if weights(i) >= '0' and weights(i) <= '9' then
+        value := value * 10 + character'pos(weights(i)) - character'pos('0');
+      elsif weights(i) = ',' then
+        if port_i < num_ports then
+          result(port_i) := imax(1, value);
+        end if;
+        port_i := port_i + 1;
+        value := 0;
+      end if;
+    end loop;
+    if port_i < num_ports then
+      result(port_i) := imax(1, value);
+    end if;
+    return result;
+  end function;
+
+  function stream_arb_method(arb_method : string) return string is
+  begin
+    if arb_method = "WEIGHTED" then
+      return "ROUND-ROBIN";
+    end if;
+    return arb_method;
+  end function;
+
+end Interconnect_pkg;
@@ -0,0 +1,201 @@
+-- Copyright 2018 Delft University of Technology
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing, software
+-- distributed under the License is distributed on an "AS IS" BASIS,
+-- WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+-- See the License for the specific language governing permissions and
+-- limitations under the License.
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+library work;
+use work.UtilStr_pkg.all;
+use work.Interconnect_pkg.all;
+
+-- Bus benchmark of a BusReadArbiterVec. Every slave port is driven by a master
+-- that requests bursts as fast as possible, such that the bus is saturated.
+-- After a number of cycles, the bandwidth obtained by every port is reported.
+
+entity BusReadArbiterWeights_tb is
+  generic (
+    BUS_ADDR_WIDTH              : natural := 64;
+    BUS_DATA_WIDTH              : natural := 512;
+    BUS_LEN_WIDTH               : natural := 9;
+    BURST_LENGTH                : natural := 8;
+    NUM_SLAVE_PORTS             : natural := 3;
+    ARB_METHOD                  : string := "WEIGHTED";
+    SLV_WEIGHTS                 : string := "1,1,4";
+    CYCLES                      : natural := 10000
+  );
+end BusReadArbiterWeights_tb;
+
+architecture Behavioral of BusReadArbiterWeights_tb is
+
+  type count_array is array (natural range <>) of natural;
+
+  signal bus_clk                : std_logic;
+  signal bus_reset              : std_logic;
+
+  signal mst_rreq_valid         : std_logic;
+  signal mst_rreq_ready         : std_logic;
+  signal mst_rreq_addr          : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal mst_rreq_len           : std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+  signal mst_rdat_valid         : std_logic;
+  signal mst_rdat_ready         : std_logic;
+  signal mst_rdat_data          : std_logic_vector(BUS_DATA_WIDTH-1 downto 0);
+  signal mst_rdat_last          : std_logic;
+
+  signal bsv_rreq_valid         : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+  signal bsv_rreq_ready         : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+  signal bsv_rreq_addr          : std_logic_vector(NUM_SLAVE_PORTS*BUS_ADDR_WIDTH-1 downto 0);
+  signal bsv_rreq_len           : std_logic_vector(NUM_SLAVE_PORTS*BUS_LEN_WIDTH-1 downto 0);
+  signal bsv_rdat_valid         : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+  signal bsv_rdat_ready         : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+  signal bsv_rdat_data          : std_logic_vector(NUM_SLAVE_PORTS*BUS_DATA_WIDTH-1 downto 0);
+  signal bsv_rdat_last          : std_logic_vector(NUM_SLAVE_PORTS-1 downto 0);
+
+  signal simulation_done        : boolean := false;
+
+begin
+
+  clk_proc: process is
+  begin
+    loop
+      bus_clk <= '1';
+      wait for 5 ns;
+      bus_clk <= '0';
+      wait for 5 ns;
+      exit when simulation_done;
+    end loop;
+    wait;
+  end process;
+
+  reset_proc: process is
+  begin
+    bus_reset <= '1';
+    wait for 50 ns;
+    wait until rising_edge(bus_clk);
+    bus_reset <= '0';
+    wait;
+  end process;
+
+  -- Greedy masters, that request bursts of consecutive addresses and accept
+  -- all data immediately.
+  master_gen: for i in 0 to NUM_SLAVE_PORTS-1 generate
+  begin
+    req_proc: process (bus_clk) is
+      variable addr : unsigned(BUS_ADDR_WIDTH-1 downto 0) := shift_left(to_unsigned(i, BUS_ADDR_WIDTH), 32);
+    begin
+      if rising_edge(bus_clk) then
+        if bus_reset = '1' then
+          bsv_rreq_valid(i) <= '0';
+        else
+          if bsv_rreq_valid(i) = '1' and bsv_rreq_ready(i) = '1' then
+            addr := addr + BURST_LENGTH * (BUS_DATA_WIDTH/8);
+          end if;
+          bsv_rreq_valid(i) <= '1';
+        end if;
+        bsv_rreq_addr((i+1)*BUS_ADDR_WIDTH-1 downto i*BUS_ADDR_WIDTH) <= std_logic_vector(addr);
+      end if;
+    end process;
+
+    bsv_rreq_len((i+1)*BUS_LEN_WIDTH-1 downto i*BUS_LEN_WIDTH) <=
+      std_logic_vector(to_unsigned(BURST_LENGTH, BUS_LEN_WIDTH));
+    bsv_rdat_ready(i) <= '1';
+  end generate;
+
+  -- Count the beats transferred to every port during the measurement.
+  measure_proc: process is
+    variable beats              : count_array(0 to NUM_SLAVE_PORTS-1) := (others => 0);
+    variable total              : natural := 0;
+  begin
+    wait until bus_reset = '0';
+    -- Let the arbiter reach its steady state first.
+    for c in 1 to 100 loop
+      wait until rising_edge(bus_clk);
+    end loop;
+
+    for c in 1 to CYCLES loop
+      wait until rising_edge(bus_clk);
+      for i in 0 to NUM_SLAVE_PORTS-1 loop
+        if bsv_rdat_valid(i) = '1' and bsv_rdat_ready(i) = '1' then
+          beats(i) := beats(i) + 1;
+          total := total + 1;
+        end if;
+      end loop;
+    end loop;
+
+    println("Arbitration method      : " & ARB_METHOD & " (" & SLV_WEIGHTS & ")");
+    println("Cycles                  : " & integer'image(CYCLES));
+    println("Utilization (%)         : " & integer'image((100 * total) / CYCLES));
+    for i in 0 to NUM_SLAVE_PORTS-1 loop
+      println("Port " & integer'image(i) & " (bits/cycle)     : " & integer'image((beats(i) * BUS_DATA_WIDTH) / CYCLES)
+        & ", share (%): " & integer'image((100 * beats(i)) / total));
+    end loop;
+
+    simulation_done <= true;
+    wait;
+  end process;
+
+  uut: BusReadArbiterVec
+    generic map (
+      BUS_ADDR_WIDTH            => BUS_ADDR_WIDTH,
+      BUS_LEN_WIDTH             => BUS_LEN_WIDTH,
+      BUS_DATA_WIDTH            => BUS_DATA_WIDTH,
+      NUM_SLAVE_PORTS           => NUM_SLAVE_PORTS,
+      ARB_METHOD                => ARB_METHOD,
+      SLV_WEIGHTS               => SLV_WEIGHTS,
+      MAX_OUTSTANDING           => 8
+    )
+    port map (
+      bcd_clk                   => bus_clk,
+      bcd_reset                 => bus_reset,
+      mst_rreq_valid            => mst_rreq_valid,
+      mst_rreq_ready            => mst_rreq_ready,
+      mst_rreq_addr             => mst_rreq_addr,
+      mst_rreq_len              => mst_rreq_len,
+      mst_rdat_valid            => mst_rdat_valid,
+      mst_rdat_ready            => mst_rdat_ready,
+      mst_rdat_data             => mst_rdat_data,
+      mst_rdat_last             => mst_rdat_last,
+      bsv_rreq_valid            => bsv_rreq_valid,
+      bsv_rreq_ready            => bsv_rreq_ready,
+      bsv_rreq_addr             => bsv_rreq_addr,
+      bsv_rreq_len              => bsv_rreq_len,
+      bsv_rdat_valid            => bsv_rdat_valid,
+      bsv_rdat_ready            => bsv_rdat_ready,
+      bsv_rdat_data             => bsv_rdat_data,
+      bsv_rdat_last             => bsv_rdat_last
+    );
+
+  slave_inst: BusReadSlaveMock
+    generic map (
+      BUS_ADDR_WIDTH            => BUS_ADDR_WIDTH,
+      BUS_LEN_WIDTH             => BUS_LEN_WIDTH,
+      BUS_DATA_WIDTH            => BUS_DATA_WIDTH,
+      SEED                      => 1337,
+      RANDOM_REQUEST_TIMING     => false,
+      RANDOM_RESPONSE_TIMING    => false
+    )
+    port map (
+      clk                       => bus_clk,
+      reset                     => bus_reset,
+      rreq_valid                => mst_rreq_valid,
+      rreq_ready                => mst_rreq_ready,
+      rreq_addr                 => mst_rreq_addr,
+      rreq_len                  => mst_rreq_len,
+      rdat_valid                => mst_rdat_valid,
+      rdat_ready                => mst_rdat_ready,
+      rdat_data                 => mst_rdat_data,
+      rdat_last                 => mst_rdat_last
+    );
+
+end Behavioral;
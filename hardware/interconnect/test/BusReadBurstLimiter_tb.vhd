@@ -0,0 +1,232 @@
+-- Copyright 2018 Delft University of Technology
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing, software
+-- distributed under the License is distributed on an "AS IS" BASIS,
+-- WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+-- See the License for the specific language governing permissions and
+-- limitations under the License.
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+library work;
+use work.UtilStr_pkg.all;
+use work.Interconnect_pkg.all;
+
+-- Test bench of the BusReadBurstLimiter. A random master issues requests
+-- through the limiter while the burst length limit changes. The master checks
+-- the data, and this test bench checks the burst lengths on the master port
+-- and the position of the last signal on the slave port.
+
+entity BusReadBurstLimiter_tb is
+  generic (
+    BUS_ADDR_WIDTH              : natural := 32;
+    BUS_LEN_WIDTH               : natural := 8;
+    BUS_DATA_WIDTH              : natural := 32;
+    BUS_BURST_MAX_LEN           : natural := 8;
+    CYCLES_PER_LIMIT            : natural := 1000
+  );
+end BusReadBurstLimiter_tb;
+
+architecture Behavioral of BusReadBurstLimiter_tb is
+
+  type len_array is array (natural range <>) of natural;
+
+  -- Burst length limits to apply, in order.
+  constant LIMITS               : len_array := (0, 1, 3, 4, 8, 20, 2);
+
+  signal bus_clk                : std_logic;
+  signal bus_reset              : std_logic;
+
+  signal max_len                : std_logic_vector(BUS_LEN_WIDTH-1 downto 0) := (others => '0');
+
+  signal slv_rreq_valid         : std_logic;
+  signal slv_rreq_ready         : std_logic;
+  signal slv_rreq_addr          : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal slv_rreq_len           : std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+  signal slv_rdat_valid         : std_logic;
+  signal slv_rdat_ready         : std_logic;
+  signal slv_rdat_data          : std_logic_vector(BUS_DATA_WIDTH-1 downto 0);
+  signal slv_rdat_last          : std_logic;
+
+  signal mst_rreq_valid         : std_logic;
+  signal mst_rreq_ready         : std_logic;
+  signal mst_rreq_addr          : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal mst_rreq_len           : std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+  signal mst_rdat_valid         : std_logic;
+  signal mst_rdat_ready         : std_logic;
+  signal mst_rdat_data          : std_logic_vector(BUS_DATA_WIDTH-1 downto 0);
+  signal mst_rdat_last          : std_logic;
+
+  signal simulation_done        : boolean := false;
+
+begin
+
+  clk_proc: process is
+  begin
+    loop
+      bus_clk <= '1';
+      wait for 5 ns;
+      bus_clk <= '0';
+      wait for 5 ns;
+      exit when simulation_done;
+    end loop;
+    wait;
+  end process;
+
+  reset_proc: process is
+  begin
+    bus_reset <= '1';
+    wait for 50 ns;
+    wait until rising_edge(bus_clk);
+    bus_reset <= '0';
+    wait;
+  end process;
+
+  -- Change the burst length limit every CYCLES_PER_LIMIT cycles.
+  limit_proc: process is
+  begin
+    wait until bus_reset = '0';
+    for l in LIMITS'range loop
+      max_len <= std_logic_vector(to_unsigned(LIMITS(l), BUS_LEN_WIDTH));
+      for c in 1 to CYCLES_PER_LIMIT loop
+        wait until rising_edge(bus_clk);
+      end loop;
+    end loop;
+    println("BusReadBurstLimiter_tb finished.");
+    simulation_done <= true;
+    wait;
+  end process;
+
+  -- Check the burst lengths on the master port, and check that the last
+  -- signal on the slave port marks the last beat of every request.
+  check_proc: process (bus_clk) is
+    variable lens               : len_array(0 to 255);
+    variable head               : natural := 0;
+    variable tail               : natural := 0;
+    variable beats              : natural := 0;
+    variable limit              : natural := BUS_BURST_MAX_LEN;
+  begin
+    if rising_edge(bus_clk) then
+      if bus_reset = '1' then
+        head := 0;
+        tail := 0;
+        beats := 0;
+      else
+        -- Bursts on the master port belong to the request that was accepted
+        -- last, unless a new request is accepted in the same cycle.
+        if mst_rreq_valid = '1' and mst_rreq_ready = '1' then
+          assert unsigned(mst_rreq_len) > 0
+            report "Empty burst on master port." severity failure;
+          assert to_integer(unsigned(mst_rreq_len)) <= limit
+            report "Burst of " & slvToUDec(mst_rreq_len) & " beats exceeds the limit of "
+              & integer'image(limit) & " beats." severity failure;
+        end if;
+
+        if slv_rreq_valid = '1' and slv_rreq_ready = '1' then
+          lens(head) := to_integer(unsigned(slv_rreq_len));
+          head := (head + 1) mod lens'length;
+          -- The limit of a request is sampled when it is accepted.
+          limit := to_integer(unsigned(max_len));
+          if limit = 0 or limit > BUS_BURST_MAX_LEN then
+            limit := BUS_BURST_MAX_LEN;
+          end if;
+        end if;
+
+        if slv_rdat_valid = '1' and slv_rdat_ready = '1' then
+          assert head /= tail
+            report "Response without request." severity failure;
+          beats := beats + 1;
+          if beats = lens(tail) then
+            assert slv_rdat_last = '1'
+              report "Last signal missing at the end of a request." severity failure;
+            beats := 0;
+            tail := (tail + 1) mod lens'length;
+          else
+            assert slv_rdat_last = '0'
+              report "Last signal asserted before the end of a request." severity failure;
+          end if;
+        end if;
+      end if;
+    end if;
+  end process;
+
+  master_inst: BusReadMasterMock
+    generic map (
+      BUS_ADDR_WIDTH            => BUS_ADDR_WIDTH,
+      BUS_LEN_WIDTH             => BUS_LEN_WIDTH,
+      BUS_DATA_WIDTH            => BUS_DATA_WIDTH,
+      SEED                      => 1
+    )
+    port map (
+      clk                       => bus_clk,
+      reset                     => bus_reset,
+      rreq_valid                => slv_rreq_valid,
+      rreq_ready                => slv_rreq_ready,
+      rreq_addr                 => slv_rreq_addr,
+      rreq_len                  => slv_rreq_len,
+      rdat_valid                => slv_rdat_valid,
+      rdat_ready                => slv_rdat_ready,
+      rdat_data                 => slv_rdat_data,
+      rdat_last                 => slv_rdat_last
+    );
+
+  uut: BusReadBurstLimiter
+    generic map (
+      BUS_ADDR_WIDTH            => BUS_ADDR_WIDTH,
+      BUS_LEN_WIDTH             => BUS_LEN_WIDTH,
+      BUS_DATA_WIDTH            => BUS_DATA_WIDTH,
+      BUS_BURST_MAX_LEN         => BUS_BURST_MAX_LEN
+    )
+    port map (
+      clk                       => bus_clk,
+      reset                     => bus_reset,
+      max_len                   => max_len,
+      slv_rreq_valid            => slv_rreq_valid,
+      slv_rreq_ready            => slv_rreq_ready,
+      slv_rreq_addr             => slv_rreq_addr,
+      slv_rreq_len              => slv_rreq_len,
+      slv_rdat_valid            => slv_rdat_valid,
+      slv_rdat_ready            => slv_rdat_ready,
+      slv_rdat_data             => slv_rdat_data,
+      slv_rdat_last             => slv_rdat_last,
+      mst_rreq_valid            => mst_rreq_valid,
+      mst_rreq_ready            => mst_rreq_ready,
+      mst_rreq_addr             => mst_rreq_addr,
+      mst_rreq_len              => mst_rreq_len,
+      mst_rdat_valid            => mst_rdat_valid,
+      mst_rdat_ready            => mst_rdat_ready,
+      mst_rdat_data             => mst_rdat_data,
+      mst_rdat_last             => mst_rdat_last
+    );
+
+  slave_inst: BusReadSlaveMock
+    generic map (
+      BUS_ADDR_WIDTH            => BUS_ADDR_WIDTH,
+      BUS_LEN_WIDTH             => BUS_LEN_WIDTH,
+      BUS_DATA_WIDTH            => BUS_DATA_WIDTH,
+      SEED                      => 1337,
+      RANDOM_REQUEST_TIMING     => true,
+      RANDOM_RESPONSE_TIMING    => true
+    )
+    port map (
+      clk                       => bus_clk,
+      reset                     => bus_reset,
+      rreq_valid                => mst_rreq_valid,
+      rreq_ready                => mst_rreq_ready,
+      rreq_addr                 => mst_rreq_addr,
+      rreq_len                  => mst_rreq_len,
+      rdat_valid                => mst_rdat_valid,
+      rdat_ready                => mst_rdat_ready,
+      rdat_data                 => mst_rdat_data,
+      rdat_last                 => mst_rdat_last
+    );
+
+end Behavioral;
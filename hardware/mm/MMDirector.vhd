@@ -71,6 +71,8 @@ entity MMDirector is
     cmd_free                    : in  std_logic;
     cmd_alloc                   : in  std_logic;
     cmd_realloc                 : in  std_logic;
+    -- Map the allocation with level 1 blocks where possible.
+    cmd_huge                    : in  std_logic := '0';
     cmd_valid                   : in  std_logic;
     cmd_ready                   : out std_logic;
 
@@ -86,6 +88,8 @@ entity MMDirector is
     mmu_resp_valid              : out std_logic;
     mmu_resp_ready              : in  std_logic := '1';
     mmu_resp_addr               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    -- The address is not mapped, mmu_resp_addr is invalid.
+    mmu_resp_fault              : out std_logic;
 
     ---------------------------------------------------------------------------
     -- Bus write channels
@@ -139,6 +143,7 @@ architecture Behavioral of MMDirector is
   constant PTE_MAPPED           : natural := 0;
   constant PTE_PRESENT          : natural := 1;
   constant PTE_BOUNDARY         : natural := 2;
+  constant PTE_BLOCK            : natural := 3;
 
   constant FRAME_IDX_WIDTH      : natural := MEM_MAP_SIZE_LOG2 + MEM_REGIONS - PAGE_SIZE_LOG2;
 
@@ -434,7 +439,7 @@ architecture Behavioral of MMDirector is
   type state_mmu_type is (
       RESET_ST, IDLE, FAIL,
       MMU_GET_L1_ADDR, MMU_GET_L1_DAT,
-      MMU_GET_L2_ADDR, MMU_GET_L2_DAT, MMU_RESP,
+      MMU_GET_L2_ADDR, MMU_GET_L2_DAT, MMU_RESP, MMU_FAULT,
       MMU_SET_L2_ADDR, MMU_SET_L2_DAT );
 
   type state_type is (
@@ -442,9 +447,11 @@ architecture Behavioral of MMDirector is
       RESERVE_PT, RESERVE_PT_CHECK, PT0_INIT,
 
       VMALLOC, VMALLOC_CHECK_PT0, VMALLOC_CHECK_PT0_DATA,
-      VMALLOC_RESERVE_FRAME, VMALLOC_FINISH,
+      VMALLOC_RESERVE_FRAME, VMALLOC_TAIL, VMALLOC_TAIL_FINISH, VMALLOC_FINISH,
 
-      VREALLOC, VREALLOC_MOVE, VREALLOC_FREE, VREALLOC_RESPONSE,
+      VREALLOC, VREALLOC_CHECK_ADDR, VREALLOC_CHECK_DAT,
+      VREALLOC_REJECT, VREALLOC_REJECT_RESPONSE,
+      VREALLOC_MOVE, VREALLOC_FREE, VREALLOC_RESPONSE,
 
       VFREE, VFREE_FINISH,
 
@@ -457,8 +464,13 @@ architecture Behavioral of MMDirector is
       SET_PTE_RANGE_FRAME, SET_PTE_RANGE_L2_REQ_PT,
       SET_PTE_RANGE_L2_DEALLOC_FRAME_C, SET_PTE_RANGE_L2_DEALLOC_FRAME_R,
       SET_PTE_RANGE_L2_UPDATE_ADDR, SET_PTE_RANGE_L2_UPDATE_DAT,
+      SET_PTE_RANGE_BLOCK_FREE, SET_PTE_RANGE_BLOCK_FREE_CHECK,
+      SET_PTE_RANGE_BLOCK_CLEAR_ADDR, SET_PTE_RANGE_BLOCK_CLEAR_DAT,
       SET_PTE_RANGE_FINISH,
 
+      SET_BLOCK_RANGE, SET_BLOCK_RANGE_CHECK,
+      SET_BLOCK_RANGE_ADDR, SET_BLOCK_RANGE_DAT,
+
       PT_DEL, PT_DEL_MARK_BM_ADDR, PT_DEL_MARK_BM_DATA,
       PT_DEL_ROLODEX, PT_DEL_FRAME, PT_DEL_FRAME_CHECK,
 
@@ -502,6 +514,8 @@ architecture Behavioral of MMDirector is
     addr_pt                     : unsigned(BUS_ADDR_WIDTH-1 downto 0);
     size                        : unsigned(BUS_ADDR_WIDTH-1 downto 0);
     pages                       : unsigned(VM_SIZE_L0_LOG2 - PAGE_SIZE_LOG2 - 1 downto 0);
+    blocks                      : unsigned(VM_SIZE_L0_LOG2 - VM_SIZE_L1_LOG2 - 1 downto 0);
+    block_last                  : std_logic;
     region                      : unsigned(log2ceil(MEM_REGIONS+1)-1 downto 0);
     pt_arg                      : pt_arg_type;
     pt_empty                    : std_logic;
@@ -558,6 +572,10 @@ begin
     report "Too few bits available for segment ID in PTE"
     severity failure;
 
+  assert MEM_MAP_BASE(VM_SIZE_L1_LOG2-1 downto 0) = 0
+    report "MEM_MAP_BASE is not aligned to the block size, blocks will not be aligned"
+    severity warning;
+
 -- TODO: assert that L1 PT address refers to first possible PT in that frame.
 
   process (clk) begin
@@ -574,7 +592,7 @@ begin
   end process;
 
   process (r,
-           cmd_region, cmd_addr, cmd_free, cmd_alloc, cmd_realloc, cmd_valid, cmd_size,
+           cmd_region, cmd_addr, cmd_free, cmd_alloc, cmd_realloc, cmd_huge, cmd_valid, cmd_size,
            resp_ready,
            pt_reader_cmd_ready, pt_reader,
            dir_frames_cmd_ready,
@@ -905,6 +923,37 @@ begin
         v.region             := unsigned(cmd_region);
         v.pt_arg             := PT_ARG_DEFAULT;
         v.pt_arg.alloc_first := '1'; -- Take first page mapping from frame allocator
+        v.blocks             := (others => '0');
+        if cmd_huge = '1' and
+          EXTRACT(unsigned(cmd_size), VM_SIZE_L1_LOG2, v.blocks'length) /= 0
+        then
+          -- Map the part of the allocation that covers whole L1 entries with blocks,
+          -- and the remainder with pages.
+          v.state_stack(0)   := SET_BLOCK_RANGE;
+          v.state_stack(1)   := VMALLOC_TAIL;
+          v.blocks           := EXTRACT(unsigned(cmd_size), VM_SIZE_L1_LOG2, v.blocks'length);
+          v.pages            := PAGE_COUNT(resize(unsigned(cmd_size(VM_SIZE_L1_LOG2-1 downto 0)), BUS_ADDR_WIDTH));
+          v.addr             := v.addr_vm;
+        end if;
+
+    when VMALLOC_TAIL =>
+      -- `addr' points to the end of the blocks mapped so far.
+      if v.pages = 0 then
+        v.state_stack(0)     := VMALLOC_FINISH;
+      else
+        -- Map the remainder with pages, starting at the next L1 entry.
+        v.addr_vm_src        := v.addr_vm;
+        v.addr_vm            := v.addr;
+        v.state_stack(0)     := VMALLOC_TAIL_FINISH;
+        v.state_stack        := push_state(v.state_stack, SET_PTE_RANGE);
+        v.pt_arg             := PT_ARG_DEFAULT;
+        v.pt_arg.alloc_first := '1';
+      end if;
+
+    when VMALLOC_TAIL_FINISH =>
+      -- Restore the start address of the allocation.
+      v.addr_vm              := v.addr_vm_src;
+      v.state_stack(0)       := VMALLOC_FINISH;
 
     when VMALLOC_FINISH =>
       resp_success <= '1';
@@ -925,8 +974,44 @@ begin
       -- Make sure we see all those writes.
       -- TODO This could wait indefinitely.
       if mmu_bus_wreq.dirty = '0' then
-        v.state_stack(0) := VREALLOC_MOVE;
-        v.state_stack    := push_state(v.state_stack, FIND_GAP);
+        v.state_stack(0) := VREALLOC_CHECK_ADDR;
+      end if;
+
+    when VREALLOC_CHECK_ADDR =>
+      -- Get the L1 PTE of the source.
+      my_bus_rreq.addr  <= slv(ADDR_BUS_ALIGN(VA_TO_PTE(PT_ADDR, PAGE_BASE(unsigned(cmd_addr)), 1)));
+      my_bus_rreq.len   <= slv(to_unsigned(1, my_bus_rreq.len'length));
+      my_bus_rreq.valid <= '1';
+      if my_bus_rreq.ready = '1' then
+        v.state_stack(0) := VREALLOC_CHECK_DAT;
+      end if;
+
+    when VREALLOC_CHECK_DAT =>
+      -- Moving mappings that use blocks is not supported.
+      my_bus_rdat.ready <= '1';
+      if my_bus_rdat.valid = '1' then
+        if my_bus_rdat.data(
+             BYTE_SIZE * int(ADDR_BUS_OFFSET(VA_TO_PTE(PT_ADDR, PAGE_BASE(unsigned(cmd_addr)), 1)))
+             + PTE_BLOCK
+           ) = '1'
+        then
+          v.state_stack(0) := VREALLOC_REJECT;
+        else
+          v.state_stack(0) := VREALLOC_MOVE;
+          v.state_stack    := push_state(v.state_stack, FIND_GAP);
+        end if;
+      end if;
+
+    when VREALLOC_REJECT =>
+      cmd_ready        <= '1';
+      v.state_stack(0) := VREALLOC_REJECT_RESPONSE;
+
+    when VREALLOC_REJECT_RESPONSE =>
+      resp_success <= '0';
+      resp_addr    <= (others => '0');
+      resp_valid   <= '1';
+      if resp_ready = '1' then
+        v.state_stack := pop_state(v.state_stack);
       end if;
 
     when VREALLOC_MOVE =>
@@ -1148,6 +1233,23 @@ begin
           -- Indicate the L1 entry does not need updating.
           v.pt_empty         := '0';
         end if;
+
+        if v.pt_arg.unmap = '1' and
+          my_bus_rdat.data(
+             BYTE_SIZE * int(ADDR_BUS_OFFSET(VA_TO_PTE(PT_ADDR, v.addr, 1)))
+             + PTE_BLOCK
+           ) = '1'
+        then
+          -- The L1 entry maps a block, `addr_pt' holds its base address.
+          v.block_last       := my_bus_rdat.data(
+             BYTE_SIZE * int(ADDR_BUS_OFFSET(VA_TO_PTE(PT_ADDR, v.addr, 1)))
+             + PTE_BOUNDARY);
+          if v.pt_arg.dealloc = '1' then
+            v.state_stack(0) := SET_PTE_RANGE_BLOCK_FREE;
+          else
+            v.state_stack(0) := SET_PTE_RANGE_BLOCK_CLEAR_ADDR;
+          end if;
+        end if;
       end if;
 
     when SET_PTE_RANGE_L1_UPDATE_ADDR =>
@@ -1524,6 +1626,51 @@ begin
         v.in_mapping := r.in_mapping;
       end if;
 
+    when SET_PTE_RANGE_BLOCK_FREE =>
+      -- Return the frames of a block to the frame allocator.
+      dir_frames_cmd_valid   <= '1';
+      dir_frames_cmd_action  <= MM_FRAMES_FREE_BLOCK;
+      dir_frames_cmd_addr    <= slv(v.addr_pt);
+      if dir_frames_cmd_ready = '1' then
+        v.state_stack(0) := SET_PTE_RANGE_BLOCK_FREE_CHECK;
+      end if;
+
+    when SET_PTE_RANGE_BLOCK_FREE_CHECK =>
+      dir_frames_resp_ready  <= '1';
+      if dir_frames_resp_valid = '1' then
+        v.state_stack(0) := SET_PTE_RANGE_BLOCK_CLEAR_ADDR;
+      end if;
+
+    when SET_PTE_RANGE_BLOCK_CLEAR_ADDR =>
+      -- Clear the L1 entry of the block.
+      my_bus_wreq.valid <= '1';
+      my_bus_wreq.addr  <= slv(ADDR_BUS_ALIGN(VA_TO_PTE(PT_ADDR, v.addr, 1)));
+      my_bus_wreq.len   <= slv(to_unsigned(1, my_bus_wreq.len'length));
+      if my_bus_wreq.ready = '1' then
+        v.state_stack(0) := SET_PTE_RANGE_BLOCK_CLEAR_DAT;
+      end if;
+
+    when SET_PTE_RANGE_BLOCK_CLEAR_DAT =>
+      my_bus_wdat.valid  <= '1';
+      my_bus_wdat.last   <= '1';
+      my_bus_wdat.data   <= (others => '0');
+      -- Use strobe to write the correct entry
+      my_bus_wdat.strobe <= slv(OVERLAY(
+          not to_unsigned(0, PTE_SIZE),
+          to_unsigned(0, my_bus_wdat.strobe'length),
+          int(ADDR_BUS_OFFSET(VA_TO_PTE(PT_ADDR, v.addr, 1)))));
+      if my_bus_wdat.ready = '1' then
+        if v.block_last = '1' then
+          -- Done unmapping.
+          v.state_stack(0) := SET_PTE_RANGE_FINISH;
+        else
+          -- The mapping continues in the next L1 entry.
+          v.addr           := v.addr + shift_left(to_unsigned(1, v.addr'length), VM_SIZE_L1_LOG2);
+          v.addr_vm        := v.addr;
+          v.state_stack(0) := SET_PTE_RANGE_L1_ADDR;
+        end if;
+      end if;
+
     when SET_PTE_RANGE_FINISH =>
       -- Sink all the PT reader data.
       pt_reader.ready        <= '1';
@@ -1534,6 +1681,79 @@ begin
       end if;
 
 
+    -- === START OF SET_BLOCK_RANGE ROUTINE ===
+    -- Map a range of virtual addresses with blocks, by writing L1 entries.
+    -- `addr'    contains the L1 aligned address to start mapping at.
+    --           It points to the end of the mapped range on return.
+    -- `region'  region to allocate the blocks in.
+    -- `blocks'  must be initialized to the number of blocks to map.
+    -- `pages'   number of pages mapped after the blocks.
+    -- When no free block is found, the blocks that remain are added to `pages'.
+
+    when SET_BLOCK_RANGE =>
+      -- Allocate an aligned block of frames.
+      dir_frames_cmd_valid   <= '1';
+      dir_frames_cmd_action  <= MM_FRAMES_FIND_BLOCK;
+      dir_frames_cmd_region  <= slv(resize(v.region - 1, dir_frames_cmd_region'length));
+      if dir_frames_cmd_ready = '1' then
+        v.state_stack(0) := SET_BLOCK_RANGE_CHECK;
+      end if;
+
+    when SET_BLOCK_RANGE_CHECK =>
+      dir_frames_resp_ready  <= '1';
+      if dir_frames_resp_valid = '1' then
+        if dir_frames_resp_success = '1' then
+          -- Use `addr_pt' to hold the block base address.
+          v.addr_pt        := u(dir_frames_resp_addr);
+          v.state_stack(0) := SET_BLOCK_RANGE_ADDR;
+        else
+          -- Out of blocks, map the rest with pages.
+          v.pages          := v.pages + shift_left(resize(v.blocks, v.pages'length), PT_ENTRIES_LOG2);
+          v.blocks         := (others => '0');
+          v.state_stack    := pop_state(v.state_stack);
+        end if;
+      end if;
+
+    when SET_BLOCK_RANGE_ADDR =>
+      my_bus_wreq.valid <= '1';
+      my_bus_wreq.addr  <= slv(ADDR_BUS_ALIGN(VA_TO_PTE(PT_ADDR, v.addr, 1)));
+      my_bus_wreq.len   <= slv(to_unsigned(1, my_bus_wreq.len'length));
+      if my_bus_wreq.ready = '1' then
+        v.state_stack(0) := SET_BLOCK_RANGE_DAT;
+      end if;
+
+    when SET_BLOCK_RANGE_DAT =>
+      my_bus_wdat.valid  <= '1';
+      my_bus_wdat.last   <= '1';
+      -- Duplicate the entry over the data bus
+      for i in 0 to BUS_DATA_BYTES/PTE_SIZE-1 loop
+        my_bus_wdat.data(PTE_WIDTH * (i+1) - 1 downto PTE_WIDTH * i) <= slv(v.addr_pt);
+        my_bus_wdat.data(PTE_WIDTH * i + PTE_MAPPED)  <= '1';
+        my_bus_wdat.data(PTE_WIDTH * i + PTE_PRESENT) <= '1';
+        my_bus_wdat.data(PTE_WIDTH * i + PTE_BLOCK)   <= '1';
+        if v.blocks = 1 and v.pages = 0 then
+          my_bus_wdat.data(PTE_WIDTH * i + PTE_BOUNDARY) <= '1';
+        else
+          my_bus_wdat.data(PTE_WIDTH * i + PTE_BOUNDARY) <= '0';
+        end if;
+        my_bus_wdat.data(PTE_WIDTH * i + PTE_SEGMENT + v.region'length - 1 downto PTE_WIDTH * i + PTE_SEGMENT) <= slv(v.region);
+      end loop;
+      -- Use strobe to write the correct entry
+      my_bus_wdat.strobe <= slv(OVERLAY(
+          not to_unsigned(0, PTE_SIZE),
+          to_unsigned(0, my_bus_wdat.strobe'length),
+          int(ADDR_BUS_OFFSET(VA_TO_PTE(PT_ADDR, v.addr, 1)))));
+      if my_bus_wdat.ready = '1' then
+        v.addr           := v.addr + shift_left(to_unsigned(1, v.addr'length), VM_SIZE_L1_LOG2);
+        v.blocks         := v.blocks - 1;
+        if v.blocks = 0 then
+          v.state_stack  := pop_state(v.state_stack);
+        else
+          v.state_stack(0) := SET_BLOCK_RANGE;
+        end if;
+      end if;
+
+
     -- === START OF FRAME_INIT ROUTINE ===
     -- Clear the usage bitmap of the frame at `addr' and add it to the rolodex.
     -- `addr' is not preserved, but will continue to point into the same frame.
@@ -1870,6 +2090,7 @@ begin
 
     mmu_resp_valid           <= '0';
     mmu_resp_addr            <= (others => 'U');
+    mmu_resp_fault           <= '0';
 
     case v.state is
 
@@ -1905,7 +2126,7 @@ begin
            ) /= '1'
         then
           -- Given address isn't mapped.
-          v.state            := FAIL;
+          v.state            := MMU_FAULT;
         else
           -- Get address of L2 page table from the read data.
           v.addr_pt          := alignDown(
@@ -1938,7 +2159,7 @@ begin
         then
           -- Given address isn't mapped.
           mmu_bus_rdat.ready  <= '1';
-          v.state            := FAIL;
+          v.state            := MMU_FAULT;
 
         elsif mmu_bus_rdat.data(
              PTE_SIZE * int(ADDR_BUS_OFFSET(VA_TO_PTE(v.addr_pt, v.addr_vm, 2)))
@@ -1989,6 +2210,15 @@ begin
         end if;
       end if;
 
+    when MMU_FAULT =>
+      -- Report that the address isn't mapped, e.g. for a prefetch beyond the
+      -- end of an allocation.
+      mmu_resp_valid         <= '1';
+      mmu_resp_fault         <= '1';
+      if mmu_resp_ready = '1' then
+        v.state              := IDLE;
+      end if;
+
     when MMU_RESP =>
       -- Respond with the frame address as soon as possible.
       mmu_resp_valid         <= mmu_frames_resp_valid;
@@ -2118,6 +2348,7 @@ begin
       MEM_SIZES                   => MEM_SIZES,
       MEM_MAP_BASE                => MEM_MAP_BASE,
       MEM_MAP_SIZE_LOG2           => MEM_MAP_SIZE_LOG2,
+      BLOCK_FRAMES_LOG2           => PT_ENTRIES_LOG2,
       BUS_ADDR_WIDTH              => BUS_ADDR_WIDTH
     )
     port map (
@@ -29,6 +29,8 @@ entity MMFrames is
     MEM_SIZES                   : nat_array;
     MEM_MAP_BASE                : unsigned(ADDR_WIDTH_LIMIT-1 downto 0);
     MEM_MAP_SIZE_LOG2           : natural;
+    -- Number of frames in a block, as found by MM_FRAMES_FIND_BLOCK.
+    BLOCK_FRAMES_LOG2           : natural := 0;
     BUS_ADDR_WIDTH              : natural
   );
   port (
@@ -139,6 +141,21 @@ architecture Behavioral of MMFrames is
     return frame;
   end REGION_TO_FRAME;
 
+  -- Frame indices of blocks are wide enough to hold the end of the last block.
+  constant BLOCK_IDX_WIDTH      : natural := imax(TOTAL_FRAMES_LOG2, BLOCK_FRAMES_LOG2) + 1;
+
+  -- Return the index of the first frame after a region.
+  function REGION_END (region : natural)
+                    return unsigned is
+    variable frame : unsigned(BLOCK_IDX_WIDTH-1 downto 0);
+  begin
+    frame := (others => '0');
+    for i in 0 to region loop
+      frame := frame + MEM_SIZES(i);
+    end loop;
+    return frame;
+  end REGION_END;
+
   signal r_addr                 : std_logic_vector(TOTAL_FRAMES_LOG2-1 downto 0);
   signal w_addr                 : std_logic_vector(TOTAL_FRAMES_LOG2-1 downto 0);
   signal r_data                 : std_logic_vector(0 downto 0);
@@ -146,11 +163,17 @@ architecture Behavioral of MMFrames is
   signal w_en                   : std_logic;
   signal region, region_next    : unsigned(log2ceil(MEM_REGIONS)-1 downto 0);
   signal frame, frame_next      : unsigned(TOTAL_FRAMES_LOG2-1 downto 0);
+  -- First frame of the block that is being checked or applied.
+  signal block_start, block_start_next : unsigned(BLOCK_IDX_WIDTH-1 downto 0);
+  -- Value to write to all frames of the block.
+  signal block_used, block_used_next   : std_logic;
   type rover_t is array (0 to MEM_REGIONS-1) of unsigned(TOTAL_FRAMES_LOG2-1 downto 0);
   signal roving_ptr, roving_ptr_next : rover_t;
 
   type state_type is (IDLE, CLEAR, ALLOC_CHECK, ALLOC_APPLY,
-                      FREE, FIND, FIND_LOOP, FIND_DONE, SUCCESS, FAIL);
+                      FREE, FIND, FIND_LOOP, FIND_DONE,
+                      FIND_BLOCK, FIND_BLOCK_READ, FIND_BLOCK_CHECK,
+                      BLOCK_APPLY, SUCCESS, FAIL);
   signal state, state_next      : state_type;
 begin
 
@@ -160,6 +183,8 @@ begin
         state  <= IDLE;
         region <= (others => '0');
         frame  <= (others => '0');
+        block_start <= (others => '0');
+        block_used  <= '0';
         for I in 0 to MEM_REGIONS-1 loop
           roving_ptr(I) <= REGION_TO_FRAME(I);
         end loop;
@@ -167,15 +192,19 @@ begin
         state  <= state_next;
         region <= region_next;
         frame  <= frame_next;
+        block_start <= block_start_next;
+        block_used  <= block_used_next;
         roving_ptr <= roving_ptr_next;
       end if;
     end if;
   end process;
 
-  process (state, region, frame, roving_ptr, r_data,
+  process (state, region, frame, block_start, block_used, roving_ptr, r_data,
            cmd_addr, cmd_region, cmd_valid, cmd_action, resp_ready) begin
     state_next   <= state;
     frame_next   <= frame;
+    block_start_next <= block_start;
+    block_used_next  <= block_used;
     region_next  <= region;
     roving_ptr_next <= roving_ptr;
     resp_addr    <= (others => '0');
@@ -194,24 +223,35 @@ begin
 
       if cmd_valid = '1' then
         case cmd_action is
-        when "01" => -- MM_FRAMES_ALLOC
+        when "001" => -- MM_FRAMES_ALLOC
           state_next  <= ALLOC_CHECK;
           region_next <= to_unsigned(PAGE_TO_REGION(cmd_addr), region'length);
           frame_next  <= PAGE_TO_FRAME(cmd_addr);
 
-        when "00" => -- MM_FRAMES_FREE
+        when "000" => -- MM_FRAMES_FREE
           state_next  <= FREE;
           frame_next  <= PAGE_TO_FRAME(cmd_addr);
 
-        when "11" => -- MM_FRAMES_CLEAR
+        when "011" => -- MM_FRAMES_CLEAR
           state_next  <= CLEAR;
           frame_next  <= (others => '0');
 
-        when "10" => -- MM_FRAMES_FIND
+        when "010" => -- MM_FRAMES_FIND
           state_next  <= FIND;
           region_next <= unsigned(cmd_region);
           frame_next  <= roving_ptr(to_integer(unsigned(cmd_region)));
 
+        when "100" => -- MM_FRAMES_FIND_BLOCK
+          state_next  <= FIND_BLOCK;
+          region_next <= unsigned(cmd_region);
+          block_start_next <= resize(REGION_TO_FRAME(to_integer(unsigned(cmd_region))), block_start'length);
+
+        when "101" => -- MM_FRAMES_FREE_BLOCK
+          state_next  <= BLOCK_APPLY;
+          frame_next  <= PAGE_TO_FRAME(cmd_addr);
+          block_start_next <= resize(PAGE_TO_FRAME(cmd_addr), block_start'length);
+          block_used_next  <= '0';
+
         when others =>
         end case;
       end if;
@@ -270,6 +310,49 @@ begin
       w_data     <= "1";
       w_en       <= '1';
 
+    -- Blocks are aligned to their size, relative to the start of the region.
+    -- The frames of a candidate block are checked one by one. When a frame
+    -- is in use, the search continues at the next block.
+    when FIND_BLOCK =>
+      if block_start + 2**BLOCK_FRAMES_LOG2 > REGION_END(to_integer(region)) then
+        -- No more blocks in this region.
+        state_next <= FAIL;
+      else
+        state_next <= FIND_BLOCK_READ;
+        frame_next <= block_start(frame'range);
+      end if;
+
+    when FIND_BLOCK_READ =>
+      -- Wait for the frame to be read.
+      state_next <= FIND_BLOCK_CHECK;
+
+    when FIND_BLOCK_CHECK =>
+      if r_data /= "0" then
+        -- Frame in use, try the next block.
+        state_next       <= FIND_BLOCK;
+        block_start_next <= block_start + 2**BLOCK_FRAMES_LOG2;
+      elsif frame = block_start + 2**BLOCK_FRAMES_LOG2 - 1 then
+        -- All frames of the block are free, reserve them.
+        state_next <= BLOCK_APPLY;
+        frame_next <= block_start(frame'range);
+        block_used_next <= '1';
+      else
+        state_next <= FIND_BLOCK_READ;
+        frame_next <= frame + 1;
+      end if;
+
+    when BLOCK_APPLY =>
+      -- Mark all frames of the block as used when finding, or as free when
+      -- freeing a block.
+      w_data     <= (0 => block_used);
+      w_en       <= '1';
+      frame_next <= frame + 1;
+      if frame = block_start + 2**BLOCK_FRAMES_LOG2 - 1 then
+        -- Respond with the first frame of the block.
+        state_next <= SUCCESS;
+        frame_next <= block_start(frame'range);
+      end if;
+
     when SUCCESS =>
       resp_valid   <= '1';
       resp_addr    <= FRAME_TO_PAGE(frame);
@@ -26,7 +26,7 @@ entity MMHostInterface is
     -- 1 cmd_region
     -- 2 cmd_addr
     -- 2 cmd_size
-    -- 1 cmd_free/alloc/realloc/valid
+    -- 1 cmd_free/alloc/realloc/huge/valid
     --  6 cmd
     -- 2 resp_addr
     -- 1 resp_success/valid
@@ -45,6 +45,8 @@ entity MMHostInterface is
     cmd_free                    : out std_logic;
     cmd_alloc                   : out std_logic;
     cmd_realloc                 : out std_logic;
+    -- Hint to map the allocation with level 1 blocks where possible.
+    cmd_huge                    : out std_logic;
     cmd_valid                   : out std_logic;
     cmd_ready                   : in  std_logic;
 
@@ -64,6 +66,7 @@ architecture Behavioral of MMHostInterface is
 
   -- Command stream serialization indices.
   constant CSI : nat_array := cumulative((
+    6 => 1,
     5 => 1,
     4 => 1,
     3 => 1,
@@ -84,6 +87,7 @@ architecture Behavioral of MMHostInterface is
   signal int_cmd_free                : std_logic;
   signal int_cmd_alloc               : std_logic;
   signal int_cmd_realloc             : std_logic;
+  signal int_cmd_huge                : std_logic;
   signal int_cmd_valid               : std_logic;
   signal int_cmd_ready               : std_logic;
   signal int_cmd_all                 : std_logic_vector(CSI(CSI'high)-1 downto 0);
@@ -104,6 +108,7 @@ begin
   int_cmd_alloc   <= regs_in(5*REG_WIDTH + 1);
   int_cmd_free    <= regs_in(5*REG_WIDTH + 2);
   int_cmd_realloc <= regs_in(5*REG_WIDTH + 3);
+  int_cmd_huge    <= regs_in(5*REG_WIDTH + 4);
 
 
   process (regs_in, int_cmd_ready, int_resp_addr, int_resp_success, int_resp_valid)
@@ -124,6 +129,7 @@ begin
   end process;
 
 
+  int_cmd_all(                CSI(6)) <= int_cmd_huge;
   int_cmd_all(                CSI(5)) <= int_cmd_realloc;
   int_cmd_all(                CSI(4)) <= int_cmd_free;
   int_cmd_all(                CSI(3)) <= int_cmd_alloc;
@@ -148,6 +154,7 @@ begin
       out_data                    => cmd_all
     );
 
+  cmd_huge    <= cmd_all(                CSI(6));
   cmd_realloc <= cmd_all(                CSI(5));
   cmd_free    <= cmd_all(                CSI(4));
   cmd_alloc   <= cmd_all(                CSI(3));
@@ -27,6 +27,11 @@ entity MMTranslator is
     VM_BASE                     : unsigned(ADDR_WIDTH_LIMIT-1 downto 0) := (others => '0');
     PT_ENTRIES_LOG2             : natural := 64/2; -- Default to 64-bit VM address space.
     PAGE_SIZE_LOG2              : natural := 0;
+    -- Request the translation of the next page when a request hits in the
+    -- last 2**PREFETCH_LOG2 bytes of a cached page. Requires CACHE_SIZE > 1
+    -- and PREFETCH_LOG2 < PAGE_SIZE_LOG2. Prefetches of pages that turn out
+    -- not to be mapped are dropped.
+    PREFETCH                    : boolean := false;
     PREFETCH_LOG2               : natural := 22;
     BUS_ADDR_WIDTH              : natural := 64;
     BUS_LEN_WIDTH               : natural := 8;
@@ -62,7 +67,24 @@ entity MMTranslator is
     resp_ready                  : out std_logic;
     resp_virt                   : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     resp_phys                   : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-    resp_mask                   : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0)
+    resp_mask                   : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    -- The address is not mapped, the response holds no translation.
+    resp_fault                  : in  std_logic := '0';
+
+    -- High after a request to an address that is not mapped. That request
+    -- and all later requests are dropped until reset.
+    fault                       : out std_logic;
+
+    -- Statistics, cleared on reset or when cnt_clear is high.
+    cnt_clear                   : in  std_logic := '0';
+    -- Number of translated requests found in the cache.
+    cnt_hits                    : out std_logic_vector(31 downto 0);
+    -- Number of translated requests that required a page table walk.
+    cnt_misses                  : out std_logic_vector(31 downto 0);
+    -- Number of prefetched translations.
+    cnt_prefetches              : out std_logic_vector(31 downto 0);
+    -- Number of cycles a request waited for its translation.
+    cnt_walk_cycles             : out std_logic_vector(31 downto 0)
   );
 end MMTranslator;
 
@@ -83,7 +105,32 @@ architecture Behavioral of MMTranslator is
   signal cache  : cache_type;
   signal dcache : cache_type;
 
+  -- Pending prefetch, and the last page that was prefetched.
+  type prefetch_type is record
+    valid      : std_logic;
+    addr       : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    last_valid : std_logic;
+    last       : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  end record;
+
+  signal pf     : prefetch_type;
+  signal dpf    : prefetch_type;
+
+  type stats_type is record
+    hits        : unsigned(31 downto 0);
+    misses      : unsigned(31 downto 0);
+    prefetches  : unsigned(31 downto 0);
+    walk_cycles : unsigned(31 downto 0);
+  end record;
+
+  signal stats  : stats_type;
+  signal dstats : stats_type;
+
+  signal faulted  : std_logic;
+  signal dfaulted : std_logic;
+
   constant ABI : nat_array := cumulative((
+    4 => 1,
     3 => 1,
     2 => USER_WIDTH,
     1 => BUS_LEN_WIDTH,
@@ -95,6 +142,8 @@ architecture Behavioral of MMTranslator is
     len    : std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
     user   : std_logic_vector(USER_WIDTH-1 downto 0);
     virt   : std_logic;
+    -- Set for prefetches, which only update the cache.
+    pref   : std_logic;
   end record;
 
   type request_type is record
@@ -112,6 +161,7 @@ architecture Behavioral of MMTranslator is
     t(ABI(2)-1 downto ABI(1)) := x.d.len;
     t(ABI(3)-1 downto ABI(2)) := x.d.user;
     t(ABI(3))                 := x.d.virt;
+    t(ABI(4))                 := x.d.pref;
     return t;
   end REQUEST_SER;
 
@@ -123,6 +173,7 @@ architecture Behavioral of MMTranslator is
     t.len  := x.concat(ABI(2)-1 downto ABI(1));
     t.user := x.concat(ABI(3)-1 downto ABI(2));
     t.virt := x.concat(ABI(3));
+    t.pref := x.concat(ABI(4));
     return t;
   end REQUEST_DESER;
 
@@ -137,26 +188,51 @@ architecture Behavioral of MMTranslator is
 
 begin
 
+  assert not PREFETCH or PREFETCH_LOG2 < PAGE_SIZE_LOG2
+    report "prefetch distance must be smaller than the page size"
+    severity failure;
+
   clk_proc : process(clk) is
   begin
     if rising_edge(clk) then
       cache <= dcache;
+      pf    <= dpf;
+      stats <= dstats;
+      faulted <= dfaulted;
       if reset = '1' then
         for cidx in 0 to CACHE_SIZE-1 loop
           cache(cidx).valid <= '0';
         end loop;
+        pf.valid      <= '0';
+        pf.last_valid <= '0';
+        faulted       <= '0';
+      end if;
+      if reset = '1' or cnt_clear = '1' then
+        stats.hits        <= (others => '0');
+        stats.misses      <= (others => '0');
+        stats.prefetches  <= (others => '0');
+        stats.walk_cycles <= (others => '0');
       end if;
     end if;
   end process;
 
   req_proc : process(int_slv_req, req_queue_out, int_mst_req, cache_result_in,
-      req_ready, resp_valid, resp_virt, resp_phys, resp_mask, cache) is
+      req_ready, resp_valid, resp_virt, resp_phys, resp_mask, resp_fault, cache, pf, stats, faulted) is
     variable lcache    : cache_type;
+    variable lpf       : prefetch_type;
+    variable lstats    : stats_type;
+    variable lfaulted  : std_logic;
     variable in_cache  : boolean;
     variable cidx_m    : natural;
     variable handshake : std_logic;
+    variable next_page : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    variable remaining : unsigned(BUS_ADDR_WIDTH-1 downto 0);
+    variable next_hit  : boolean;
   begin
     lcache   := cache;
+    lpf      := pf;
+    lstats   := stats;
+    lfaulted := faulted;
     in_cache := false;
     cidx_m   := 0;
 
@@ -164,7 +240,19 @@ begin
     cache_result_in.valid    <= int_slv_req.valid;
     int_slv_req.ready        <= cache_result_in.ready;
     cache_result_in.d        <= int_slv_req.d;
-    if (int_slv_req.d.addr and VM_MASK) = slv(resize(VM_BASE, VM_MASK'length)) then
+    cache_result_in.d.pref   <= '0';
+    if PREFETCH and pf.valid = '1' then
+      -- Insert the prefetch before the next request.
+      cache_result_in.valid  <= '1';
+      int_slv_req.ready      <= '0';
+      cache_result_in.d.addr <= pf.addr;
+      cache_result_in.d.virt <= '1';
+      cache_result_in.d.pref <= '1';
+      if cache_result_in.ready = '1' then
+        lpf.valid            := '0';
+        lstats.prefetches    := stats.prefetches + 1;
+      end if;
+    elsif (int_slv_req.d.addr and VM_MASK) = slv(resize(VM_BASE, VM_MASK'length)) then
       -- Address is in virtual space, request translation.
 
       -- Check cache.
@@ -186,6 +274,36 @@ begin
         -- Not found in cache, forward request for page table walk.
         cache_result_in.d.virt   <= '1';
       end if;
+
+      if int_slv_req.valid = '1' and cache_result_in.ready = '1' then
+        if in_cache then
+          lstats.hits        := stats.hits + 1;
+        else
+          lstats.misses      := stats.misses + 1;
+        end if;
+      end if;
+
+      -- Prefetch the next page when a request hits near the end of a page.
+      if PREFETCH and in_cache and int_slv_req.valid = '1' and cache_result_in.ready = '1' then
+        next_page := slv(unsigned(cache(cidx_m).virt) + unsigned(not cache(cidx_m).mask) + 1);
+        remaining := unsigned(not cache(cidx_m).mask) - unsigned(int_slv_req.d.addr and not cache(cidx_m).mask);
+        next_hit  := false;
+        for cidx in 0 to CACHE_SIZE-1 loop
+          if cache(cidx).valid = '1' and (next_page and cache(cidx).mask) = cache(cidx).virt then
+            next_hit := true;
+          end if;
+        end loop;
+        if shift_right(remaining, PREFETCH_LOG2) = 0
+          and (next_page and VM_MASK) = slv(resize(VM_BASE, VM_MASK'length))
+          and not next_hit
+          and (pf.last_valid = '0' or pf.last /= next_page)
+        then
+          lpf.valid          := '1';
+          lpf.addr           := next_page;
+          lpf.last_valid     := '1';
+          lpf.last           := next_page;
+        end if;
+      end if;
     else
       -- Address is outside virtual space, do not request translation.
       cache_result_in.d.virt     <= '0';
@@ -194,19 +312,35 @@ begin
     -- Wait for response if necessary.
     int_mst_req.d            <= req_queue_out.d;
     int_mst_req.d.virt       <= '0';
+    int_mst_req.d.pref       <= '0';
     int_mst_req.valid        <= '0';
     resp_ready               <= '0';
     handshake                := '0';
     if req_queue_out.valid = '1' then
       if req_queue_out.d.virt = '1' then
-        -- This request needs a translation response.
-        handshake            := resp_valid and int_mst_req.ready;
-        int_mst_req.valid    <= resp_valid;
-        resp_ready           <= int_mst_req.ready;
-        int_mst_req.d.addr   <= resp_phys or (req_queue_out.d.addr and not resp_mask);
+        if req_queue_out.d.pref = '1' or resp_fault = '1' or faulted = '1' then
+          -- A prefetch only updates the cache. Requests to addresses that are
+          -- not mapped, and all requests after them, are dropped. Their
+          -- responses are still consumed, such that other translations can
+          -- proceed.
+          handshake          := resp_valid;
+          resp_ready         <= '1';
+          if req_queue_out.d.pref = '0' and resp_valid = '1' and resp_fault = '1' then
+            lfaulted         := '1';
+          end if;
+        else
+          -- This request needs a translation response.
+          handshake          := resp_valid and int_mst_req.ready;
+          int_mst_req.valid  <= resp_valid;
+          resp_ready         <= int_mst_req.ready;
+          int_mst_req.d.addr <= resp_phys or (req_queue_out.d.addr and not resp_mask);
+          if resp_valid = '0' then
+            lstats.walk_cycles := stats.walk_cycles + 1;
+          end if;
+        end if;
 
         -- Cache the response.
-        if handshake = '1' then
+        if handshake = '1' and resp_fault = '0' and faulted = '0' then
           -- Shift all cached responses to make room.
           for cidx in CACHE_SIZE-1 downto 1 loop
             lcache(cidx)     := lcache(cidx-1);
@@ -219,6 +353,9 @@ begin
             lcache(0).mask     := resp_mask;
           end if;
         end if;
+      elsif faulted = '1' then
+        -- Drop all requests after a fault.
+        handshake            := '1';
       else
         -- This request can be passed on as is.
         int_mst_req.valid    <= '1';
@@ -228,8 +365,18 @@ begin
     req_queue_out.ready      <= handshake;
 
     dcache <= lcache;
+    dpf    <= lpf;
+    dstats <= lstats;
+    dfaulted <= lfaulted;
   end process;
 
+  fault                      <= faulted;
+
+  cnt_hits                   <= slv(stats.hits);
+  cnt_misses                 <= slv(stats.misses);
+  cnt_prefetches             <= slv(stats.prefetches);
+  cnt_walk_cycles            <= slv(stats.walk_cycles);
+
 
   -- This slice is needed to latch the output of the cache lookup, before valid
   -- is asserted on the request channel. Since the cache contents can change
@@ -294,6 +441,7 @@ begin
   slv_req.d.addr   <= slv_req_addr;
   slv_req.d.len    <= slv_req_len;
   slv_req.d.user   <= slv_req_user;
+  slv_req.d.pref   <= '0';
 
   slv_slice: StreamBuffer
     generic map (
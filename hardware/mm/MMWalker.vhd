@@ -80,6 +80,8 @@ entity MMWalker is
     resp_virt                   : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     resp_phys                   : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     resp_mask                   : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+    -- The address is not mapped, the response holds no translation.
+    resp_fault                  : out std_logic;
 
     dir_req_valid               : out std_logic;
     dir_req_ready               : in  std_logic := '0';
@@ -87,7 +89,8 @@ entity MMWalker is
     
     dir_resp_valid              : in  std_logic := '0';
     dir_resp_ready              : out std_logic;
-    dir_resp_addr               : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0) := (others => '0')
+    dir_resp_addr               : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0) := (others => '0');
+    dir_resp_fault              : in  std_logic := '0'
   );
 end MMWalker;
 
@@ -148,7 +151,9 @@ architecture Behavioral of MMWalker is
     virt       : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     phys       : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
     use_dir    : std_logic;
-    concat     : std_logic_vector(BUS_ADDR_WIDTH*2 downto 0);
+    -- The L1 entry maps a block, phys holds the block base address.
+    block      : std_logic;
+    concat     : std_logic_vector(BUS_ADDR_WIDTH*2+1 downto 0);
   end record;
 
   signal queue_l1_in     : request_type;
@@ -169,6 +174,10 @@ architecture Behavioral of MMWalker is
 
   signal bus_l1          : bus_r_type;
   signal bus_l2          : bus_r_type;
+
+  -- The L2 page table entry is only read for L1 entries that are not blocks.
+  signal l2_req_enable   : std_logic;
+  signal l2_resp_use     : std_logic;
 begin
 
 
@@ -182,31 +191,42 @@ begin
 
 
   process (queue_l1_out, bus_l1) is
+    variable pte : unsigned(BYTE_SIZE * PTE_SIZE - 1 downto 0);
   begin
     -- Get address of L2 page table from response.
     queue_l1_resp_in.virt    <= queue_l1_out.virt;
+    queue_l1_resp_in.use_dir <= '0';
     -- Check on valid is not necessary, but avoids some simulator warnings about metavalues.
     if queue_l1_out.valid = '1' then
-      -- Use physical address to store page table pointer.
       -- Select the right PTE from the data bus.
-      queue_l1_resp_in.phys    <= slv(alignDown(
-            EXTRACT(
+      pte := EXTRACT(
               unsigned(bus_l1.dat_data),
               BYTE_SIZE * int(ADDR_BUS_OFFSET(VA_TO_PTE(PT_ADDR, u(queue_l1_out.virt), 1))),
               BYTE_SIZE * PTE_SIZE
-            ),
-            PT_SIZE_LOG2
-          ));
+            );
+      if pte(PTE_BLOCK) = '1' and pte(PTE_PRESENT) = '1' and pte(PTE_MAPPED) = '1' then
+        -- Entry maps a block directly, skip the L2 page table.
+        queue_l1_resp_in.phys  <= slv(resize(alignDown(pte, PAGE_SIZE_LOG2 + PT_ENTRIES_LOG2), BUS_ADDR_WIDTH));
+        queue_l1_resp_in.block <= '1';
+      else
+        -- Use physical address to store page table pointer.
+        queue_l1_resp_in.phys  <= slv(resize(alignDown(pte, PT_SIZE_LOG2), BUS_ADDR_WIDTH));
+        queue_l1_resp_in.block <= '0';
+      end if;
     else
       queue_l1_resp_in.phys  <= (others => 'U');
+      queue_l1_resp_in.block <= 'U';
     end if;
   end process;
 
 
   process (queue_l1_resp_out) is
   begin
-    -- Request L2 page table entry.
+    -- Request L2 page table entry, unless the L1 entry maps a block.
     queue_l2_in.virt         <= queue_l1_resp_out.virt;
+    queue_l2_in.phys         <= queue_l1_resp_out.phys;
+    queue_l2_in.use_dir      <= '0';
+    queue_l2_in.block        <= queue_l1_resp_out.block;
     bus_l2.req_addr          <= slv(
                                ADDR_BUS_ALIGN(
                                  VA_TO_PTE(
@@ -222,9 +242,14 @@ begin
   begin
     -- Resolve address from L2 page table entries.
     queue_l2_resp_in.virt    <= queue_l2_out.virt;
+    queue_l2_resp_in.block   <= queue_l2_out.block;
 
+    if queue_l2_out.block = '1' then
+      -- Block is always mapped and present, no L2 page table entry was read.
+      queue_l2_resp_in.phys    <= queue_l2_out.phys;
+      queue_l2_resp_in.use_dir <= '0';
     -- Check on valid is not necessary, but avoids some simulator warnings about metavalues.
-    if queue_l2_out.valid = '1' then
+    elsif queue_l2_out.valid = '1' then
     -- Use PT_ADDR instead of the real `addr_pt'. This is allowable,
     -- because the address offset into the data bus will be the same for these.
     -- TODO: maybe create separate function for this usage.
@@ -266,23 +291,33 @@ begin
     queue_dir_in.virt        <= queue_l2_resp_out.virt;
     queue_dir_in.phys        <= queue_l2_resp_out.phys;
     queue_dir_in.use_dir     <= queue_l2_resp_out.use_dir;
+    queue_dir_in.block       <= queue_l2_resp_out.block;
     dir_req_addr             <= queue_l2_resp_out.virt;
   end process;
 
 
-  process (queue_dir_out, dir_resp_addr)
+  process (queue_dir_out, dir_resp_addr, dir_resp_fault)
   begin
     -- Optionally wait for MMDirector response.
     resp_virt                <= queue_dir_out.virt;
     if queue_dir_out.use_dir = '1' then
       resp_phys              <= dir_resp_addr;
+      resp_fault             <= dir_resp_fault;
     else
       resp_phys              <= queue_dir_out.phys;
+      resp_fault             <= '0';
     end if;
-    -- Create mask for single page
-    resp_mask                <= slv(shift_left(
+    if queue_dir_out.block = '1' then
+      -- Create mask for a block
+      resp_mask              <= slv(shift_left(
+                                  u(std_logic_vector(to_signed(-1, BUS_ADDR_WIDTH))),
+                                  PAGE_SIZE_LOG2 + PT_ENTRIES_LOG2));
+    else
+      -- Create mask for single page
+      resp_mask              <= slv(shift_left(
                                   u(std_logic_vector(to_signed(-1, BUS_ADDR_WIDTH))),
                                   PAGE_SIZE_LOG2));
+    end if;
   end process;
 
 
@@ -354,7 +389,7 @@ begin
   queue_l1_resp_inst : StreamBuffer
     generic map (
       MIN_DEPTH                   => MAX_OUTSTANDING_BUS - 1,
-      DATA_WIDTH                  => BUS_ADDR_WIDTH * 2 + 1
+      DATA_WIDTH                  => BUS_ADDR_WIDTH * 2 + 2
     )
     port map (
       clk                         => clk,
@@ -369,10 +404,15 @@ begin
   queue_l1_resp_in.concat(BUS_ADDR_WIDTH-1 downto 0)                <= queue_l1_resp_in.virt;
   queue_l1_resp_in.concat(BUS_ADDR_WIDTH*2-1 downto BUS_ADDR_WIDTH) <= queue_l1_resp_in.phys;
   queue_l1_resp_in.concat(BUS_ADDR_WIDTH*2)                         <= queue_l1_resp_in.use_dir;
+  queue_l1_resp_in.concat(BUS_ADDR_WIDTH*2+1)                       <= queue_l1_resp_in.block;
   queue_l1_resp_out.virt    <= queue_l1_resp_out.concat(BUS_ADDR_WIDTH-1 downto 0);
   queue_l1_resp_out.phys    <= queue_l1_resp_out.concat(BUS_ADDR_WIDTH*2-1 downto BUS_ADDR_WIDTH);
   queue_l1_resp_out.use_dir <= queue_l1_resp_out.concat(BUS_ADDR_WIDTH*2);
+  queue_l1_resp_out.block   <= queue_l1_resp_out.concat(BUS_ADDR_WIDTH*2+1);
+
 
+  l2_req_enable <= not queue_l1_resp_out.block;
+  l2_resp_use   <= not queue_l2_out.block;
 
   sync_l2_inst : StreamSync
     generic map (
@@ -387,24 +427,34 @@ begin
       out_valid(0)                => queue_l2_in.valid,
       out_valid(1)                => bus_l2.req_valid,
       out_ready(0)                => queue_l2_in.ready,
-      out_ready(1)                => bus_l2.req_ready
+      out_ready(1)                => bus_l2.req_ready,
+      out_enable(0)               => '1',
+      out_enable(1)               => l2_req_enable
     );
 
   queue_l2_inst : StreamBuffer
     generic map (
       MIN_DEPTH                   => MAX_OUTSTANDING_BUS - 1,
-      DATA_WIDTH                  => BUS_ADDR_WIDTH
+      DATA_WIDTH                  => BUS_ADDR_WIDTH * 2 + 2
     )
     port map (
       clk                         => clk,
       reset                       => reset,
       in_valid                    => queue_l2_in.valid,
       in_ready                    => queue_l2_in.ready,
-      in_data                     => queue_l2_in.virt,
+      in_data                     => queue_l2_in.concat,
       out_valid                   => queue_l2_out.valid,
       out_ready                   => queue_l2_out.ready,
-      out_data                    => queue_l2_out.virt
+      out_data                    => queue_l2_out.concat
     );
+  queue_l2_in.concat(BUS_ADDR_WIDTH-1 downto 0)                <= queue_l2_in.virt;
+  queue_l2_in.concat(BUS_ADDR_WIDTH*2-1 downto BUS_ADDR_WIDTH) <= queue_l2_in.phys;
+  queue_l2_in.concat(BUS_ADDR_WIDTH*2)                         <= queue_l2_in.use_dir;
+  queue_l2_in.concat(BUS_ADDR_WIDTH*2+1)                       <= queue_l2_in.block;
+  queue_l2_out.virt    <= queue_l2_out.concat(BUS_ADDR_WIDTH-1 downto 0);
+  queue_l2_out.phys    <= queue_l2_out.concat(BUS_ADDR_WIDTH*2-1 downto BUS_ADDR_WIDTH);
+  queue_l2_out.use_dir <= queue_l2_out.concat(BUS_ADDR_WIDTH*2);
+  queue_l2_out.block   <= queue_l2_out.concat(BUS_ADDR_WIDTH*2+1);
 
   sync_l2_resp_inst : StreamSync
     generic map (
@@ -418,6 +468,8 @@ begin
       in_valid(1)                 => bus_l2.dat_valid,
       in_ready(0)                 => queue_l2_out.ready,
       in_ready(1)                 => bus_l2.dat_ready,
+      in_use(0)                   => '1',
+      in_use(1)                   => l2_resp_use,
       out_valid(0)                => queue_l2_resp_in.valid,
       out_ready(0)                => queue_l2_resp_in.ready
     );
@@ -425,7 +477,7 @@ begin
   queue_l2_resp_inst : StreamBuffer
     generic map (
       MIN_DEPTH                   => MAX_OUTSTANDING_BUS - 1,
-      DATA_WIDTH                  => BUS_ADDR_WIDTH * 2 + 1
+      DATA_WIDTH                  => BUS_ADDR_WIDTH * 2 + 2
     )
     port map (
       clk                         => clk,
@@ -440,9 +492,11 @@ begin
   queue_l2_resp_in.concat(BUS_ADDR_WIDTH-1 downto 0)                <= queue_l2_resp_in.virt;
   queue_l2_resp_in.concat(BUS_ADDR_WIDTH*2-1 downto BUS_ADDR_WIDTH) <= queue_l2_resp_in.phys;
   queue_l2_resp_in.concat(BUS_ADDR_WIDTH*2)                         <= queue_l2_resp_in.use_dir;
+  queue_l2_resp_in.concat(BUS_ADDR_WIDTH*2+1)                       <= queue_l2_resp_in.block;
   queue_l2_resp_out.virt    <= queue_l2_resp_out.concat(BUS_ADDR_WIDTH-1 downto 0);
   queue_l2_resp_out.phys    <= queue_l2_resp_out.concat(BUS_ADDR_WIDTH*2-1 downto BUS_ADDR_WIDTH);
   queue_l2_resp_out.use_dir <= queue_l2_resp_out.concat(BUS_ADDR_WIDTH*2);
+  queue_l2_resp_out.block   <= queue_l2_resp_out.concat(BUS_ADDR_WIDTH*2+1);
 
 
   sync_dir_inst : StreamSync
@@ -468,7 +522,7 @@ begin
   queue_dir_inst : StreamBuffer
     generic map (
       MIN_DEPTH                   => MAX_OUTSTANDING_DIR - 1,
-      DATA_WIDTH                  => BUS_ADDR_WIDTH * 2 + 1
+      DATA_WIDTH                  => BUS_ADDR_WIDTH * 2 + 2
     )
     port map (
       clk                         => clk,
@@ -483,9 +537,11 @@ begin
   queue_dir_in.concat(BUS_ADDR_WIDTH-1 downto 0)                <= queue_dir_in.virt;
   queue_dir_in.concat(BUS_ADDR_WIDTH*2-1 downto BUS_ADDR_WIDTH) <= queue_dir_in.phys;
   queue_dir_in.concat(BUS_ADDR_WIDTH*2)                         <= queue_dir_in.use_dir;
+  queue_dir_in.concat(BUS_ADDR_WIDTH*2+1)                       <= queue_dir_in.block;
   queue_dir_out.virt    <= queue_dir_out.concat(BUS_ADDR_WIDTH-1 downto 0);
   queue_dir_out.phys    <= queue_dir_out.concat(BUS_ADDR_WIDTH*2-1 downto BUS_ADDR_WIDTH);
   queue_dir_out.use_dir <= queue_dir_out.concat(BUS_ADDR_WIDTH*2);
+  queue_dir_out.block   <= queue_dir_out.concat(BUS_ADDR_WIDTH*2+1);
 
   sync_out_inst : StreamSync
     generic map (
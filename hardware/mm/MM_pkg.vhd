@@ -13,15 +13,22 @@ package MM_pkg is
   constant PTE_MAPPED       : natural := 0;
   constant PTE_PRESENT      : natural := 1;
   constant PTE_BOUNDARY     : natural := 2;
-  constant PTE_SEGMENT      : natural := 3;
+  -- Set in a level 1 entry that maps a block of 2**PT_ENTRIES_LOG2 frames
+  -- instead of referring to a level 2 page table.
+  constant PTE_BLOCK        : natural := 3;
+  constant PTE_SEGMENT      : natural := 4;
 
   constant MM_H2D_REG_OFFSET : natural := 6;
 
-  constant MM_FRAMES_CMD_WIDTH : natural := 2;
-  constant MM_FRAMES_FREE   : std_logic_vector := "00";
-  constant MM_FRAMES_ALLOC  : std_logic_vector := "01";
-  constant MM_FRAMES_FIND   : std_logic_vector := "10";
-  constant MM_FRAMES_CLEAR  : std_logic_vector := "11";
+  constant MM_FRAMES_CMD_WIDTH : natural := 3;
+  constant MM_FRAMES_FREE   : std_logic_vector := "000";
+  constant MM_FRAMES_ALLOC  : std_logic_vector := "001";
+  constant MM_FRAMES_FIND   : std_logic_vector := "010";
+  constant MM_FRAMES_CLEAR  : std_logic_vector := "011";
+  -- Find and reserve an aligned block of 2**BLOCK_FRAMES_LOG2 free frames.
+  constant MM_FRAMES_FIND_BLOCK : std_logic_vector := "100";
+  -- Free the block of frames starting at the given address.
+  constant MM_FRAMES_FREE_BLOCK : std_logic_vector := "101";
 
   function LOG2_TO_UNSIGNED (v : natural)
                              return unsigned;
@@ -65,6 +72,7 @@ package MM_pkg is
       MEM_SIZES                   : nat_array;
       MEM_MAP_BASE                : unsigned(ADDR_WIDTH_LIMIT-1 downto 0);
       MEM_MAP_SIZE_LOG2           : natural;
+      BLOCK_FRAMES_LOG2           : natural := 0;
       BUS_ADDR_WIDTH              : natural
     );
     port (
@@ -130,6 +138,7 @@ package MM_pkg is
       cmd_free                    : in  std_logic;
       cmd_alloc                   : in  std_logic;
       cmd_realloc                 : in  std_logic;
+      cmd_huge                    : in  std_logic := '0';
       cmd_valid                   : in  std_logic;
       cmd_ready                   : out std_logic;
 
@@ -145,6 +154,8 @@ package MM_pkg is
       mmu_resp_valid              : out std_logic;
       mmu_resp_ready              : in  std_logic := '1';
       mmu_resp_addr               : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+      -- The address is not mapped, mmu_resp_addr is invalid.
+      mmu_resp_fault              : out std_logic;
 
       ---------------------------------------------------------------------------
       -- Bus write channels
@@ -198,6 +209,7 @@ package MM_pkg is
       cmd_free                    : out std_logic;
       cmd_alloc                   : out std_logic;
       cmd_realloc                 : out std_logic;
+      cmd_huge                    : out std_logic;
       cmd_valid                   : out std_logic;
       cmd_ready                   : in  std_logic;
 
@@ -251,6 +263,7 @@ package MM_pkg is
       VM_BASE                     : unsigned(ADDR_WIDTH_LIMIT-1 downto 0) := (others => '0');
       PT_ENTRIES_LOG2             : natural := 64/2;
       PAGE_SIZE_LOG2              : natural := 0;
+      PREFETCH                    : boolean := false;
       PREFETCH_LOG2               : natural := 22;
       BUS_ADDR_WIDTH              : natural := 64;
       BUS_LEN_WIDTH               : natural := 8;
@@ -286,7 +299,20 @@ package MM_pkg is
       resp_ready                  : out std_logic;
       resp_virt                   : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
       resp_phys                   : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
-      resp_mask                   : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0)
+      resp_mask                   : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+      -- The address is not mapped, the response holds no translation.
+      resp_fault                  : in  std_logic := '0';
+
+      -- High after a request to an address that is not mapped. That request
+      -- and all later requests are dropped until reset.
+      fault                       : out std_logic;
+
+      -- Statistics
+      cnt_clear                   : in  std_logic := '0';
+      cnt_hits                    : out std_logic_vector(31 downto 0);
+      cnt_misses                  : out std_logic_vector(31 downto 0);
+      cnt_prefetches              : out std_logic_vector(31 downto 0);
+      cnt_walk_cycles             : out std_logic_vector(31 downto 0)
     );
   end component;
 
@@ -346,6 +372,8 @@ package MM_pkg is
       resp_virt                   : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
       resp_phys                   : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
       resp_mask                   : out std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+      -- The address is not mapped, the response holds no translation.
+      resp_fault                  : out std_logic;
 
       dir_req_valid               : out std_logic;
       dir_req_ready               : in  std_logic := '0';
@@ -353,7 +381,8 @@ package MM_pkg is
       
       dir_resp_valid              : in  std_logic := '0';
       dir_resp_ready              : out std_logic;
-      dir_resp_addr               : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0) := (others => '0')
+      dir_resp_addr               : in  std_logic_vector(BUS_ADDR_WIDTH-1 downto 0) := (others => '0');
+      dir_resp_fault              : in  std_logic := '0'
     );
   end component;
 
@@ -116,6 +116,27 @@ begin
     handshake_out(TbClock, frames_cmd_ready, frames_cmd_valid);
     handshake_in(TbClock, frames_resp_ready, frames_resp_valid);
 
+    -- Find an aligned block of free frames in given region
+    frames_cmd_action           <= MM_FRAMES_FIND_BLOCK;
+    frames_cmd_region           <= "1";
+    handshake_out(TbClock, frames_cmd_ready, frames_cmd_valid);
+    handshake_in(TbClock, frames_resp_ready, frames_resp_valid);
+
+    -- Find another one, should skip the reserved block
+    handshake_out(TbClock, frames_cmd_ready, frames_cmd_valid);
+    handshake_in(TbClock, frames_resp_ready, frames_resp_valid);
+
+    -- Free the last block (frames 8 to 11 of region 1)
+    frames_cmd_action           <= MM_FRAMES_FREE_BLOCK;
+    frames_cmd_addr             <= std_logic_vector(MEM_MAP_BASE + LOG2_TO_UNSIGNED(MEM_MAP_SIZE_LOG2) + 8 * LOG2_TO_UNSIGNED(PAGE_SIZE_LOG2));
+    handshake_out(TbClock, frames_cmd_ready, frames_cmd_valid);
+    handshake_in(TbClock, frames_resp_ready, frames_resp_valid);
+
+    -- Find a block again, should give the freed address
+    frames_cmd_action           <= MM_FRAMES_FIND_BLOCK;
+    handshake_out(TbClock, frames_cmd_ready, frames_cmd_valid);
+    handshake_in(TbClock, frames_resp_ready, frames_resp_valid);
+
 
     TbSimEnded                  <= '1';
 
@@ -132,6 +153,7 @@ begin
       MEM_SIZES                 => MEM_SIZES,
       MEM_MAP_BASE              => MEM_MAP_BASE,
       MEM_MAP_SIZE_LOG2         => MEM_MAP_SIZE_LOG2,
+      BLOCK_FRAMES_LOG2         => 2,
       BUS_ADDR_WIDTH            => BUS_ADDR_WIDTH
     )
     port map (
@@ -0,0 +1,281 @@
+-- Copyright 2019 Delft University of Technology
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing, software
+-- distributed under the License is distributed on an "AS IS" BASIS,
+-- WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+-- See the License for the specific language governing permissions and
+-- limitations under the License.
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+library work;
+use work.UtilInt_pkg.all;
+use work.UtilConv_pkg.all;
+use work.MM_pkg.all;
+use work.MM_tc_params.all;
+
+-- Prefetches past the end of an allocation must be dropped, while a request to
+-- an address that is not mapped must raise the fault output.
+entity MMTranslatorPrefetch_tc is
+end MMTranslatorPrefetch_tc;
+
+architecture tb of MMTranslatorPrefetch_tc is
+  constant PAGE_SIZE            : natural := 2**PAGE_SIZE_LOG2;
+  constant BEAT_BYTES           : natural := BUS_DATA_WIDTH/BYTE_SIZE;
+  constant PAGE_MASK            : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0)
+                                := std_logic_vector(shift_left(to_signed(-1, BUS_ADDR_WIDTH), PAGE_SIZE_LOG2));
+  -- The only mapped pages are VIRT0 and, later on, VIRT1.
+  constant VIRT0                : unsigned(BUS_ADDR_WIDTH-1 downto 0) := VM_BASE + 3 * PAGE_SIZE;
+  constant VIRT1                : unsigned(BUS_ADDR_WIDTH-1 downto 0) := VIRT0 + PAGE_SIZE;
+  constant VIRT_UNMAPPED        : unsigned(BUS_ADDR_WIDTH-1 downto 0) := VIRT0 + 5 * PAGE_SIZE;
+  constant PHYS0                : unsigned(BUS_ADDR_WIDTH-1 downto 0) := to_unsigned(7 * PAGE_SIZE, BUS_ADDR_WIDTH);
+  constant PHYS1                : unsigned(BUS_ADDR_WIDTH-1 downto 0) := to_unsigned(11 * PAGE_SIZE, BUS_ADDR_WIDTH);
+
+  signal bus_clk                : std_logic                                               := '0';
+  signal bus_reset              : std_logic                                               := '0';
+  -- Slave request channel
+  signal slv_req_valid          : std_logic;
+  signal slv_req_ready          : std_logic;
+  signal slv_req_addr           : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal slv_req_len            : std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+  -- Master request channel
+  signal mst_req_valid          : std_logic;
+  signal mst_req_ready          : std_logic;
+  signal mst_req_addr           : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal mst_req_len            : std_logic_vector(BUS_LEN_WIDTH-1 downto 0);
+
+  -- Translate request channel
+  signal req_valid              : std_logic;
+  signal req_ready              : std_logic;
+  signal req_addr               : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  -- Translate response channel
+  signal resp_valid             : std_logic;
+  signal resp_ready             : std_logic;
+  signal resp_virt              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal resp_phys              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal resp_mask              : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal resp_fault             : std_logic;
+  signal fault                  : std_logic;
+
+  -- Observed handshakes
+  signal mst_count              : natural                                                 := 0;
+  signal mst_last               : std_logic_vector(BUS_ADDR_WIDTH-1 downto 0);
+  signal req_count              : natural                                                 := 0;
+
+  signal TbClock                : std_logic                                               := '0';
+  signal TbReset                : std_logic                                               := '0';
+  signal TbSimEnded             : std_logic                                               := '0';
+
+  procedure handshake_out (signal clk : in std_logic; signal rdy : in std_logic;
+                           signal valid : out std_logic) is
+  begin
+    valid <= '1';
+    loop
+      wait until rising_edge(clk);
+      exit when rdy = '1';
+    end loop;
+    wait for 0 ns;
+    valid <= '0';
+  end handshake_out;
+
+  procedure handshake_in (signal clk : in std_logic; signal rdy : out std_logic;
+                          signal valid : in std_logic) is
+  begin
+    rdy <= '1';
+    loop
+      wait until rising_edge(clk);
+      exit when valid = '1';
+    end loop;
+    wait for 0 ns;
+    rdy <= '0';
+  end handshake_in;
+
+  procedure wait_cycles (signal clk : in std_logic; n : in natural) is
+  begin
+    for i in 1 to n loop
+      wait until rising_edge(clk);
+    end loop;
+  end wait_cycles;
+
+begin
+
+  -- Clock generation
+  TbClock <= not TbClock after TbPeriod/2 when TbSimEnded /= '1' else '0';
+
+  bus_clk <= TbClock;
+  bus_reset <= TbReset;
+
+  monitor : process (TbClock) is
+  begin
+    if rising_edge(TbClock) then
+      if mst_req_valid = '1' and mst_req_ready = '1' then
+        mst_count               <= mst_count + 1;
+        mst_last                <= mst_req_addr;
+      end if;
+      if req_valid = '1' and req_ready = '1' then
+        req_count               <= req_count + 1;
+      end if;
+    end if;
+  end process;
+
+  stimuli : process
+  begin
+    ---------------------------------------------------------------------------
+    wait until rising_edge(TbClock);
+    TbReset                     <= '1';
+
+    slv_req_valid               <= '0';
+    slv_req_len                 <= slv(to_unsigned(1, BUS_LEN_WIDTH));
+    mst_req_ready               <= '1';
+    req_ready                   <= '0';
+    resp_valid                  <= '0';
+    resp_fault                  <= '0';
+    resp_mask                   <= PAGE_MASK;
+
+    wait until rising_edge(TbClock);
+    TbReset                     <= '0';
+
+    wait until rising_edge(TbClock);
+
+    -- Request on the first page, which is translated.
+    slv_req_addr                <= slv(VIRT0 + BEAT_BYTES);
+    handshake_out(TbClock, slv_req_ready, slv_req_valid);
+    handshake_in(TbClock, req_ready, req_valid);
+    assert req_addr = slv(VIRT0 + BEAT_BYTES) report "unexpected translation request" severity failure;
+    resp_virt                   <= slv(VIRT0);
+    resp_phys                   <= slv(PHYS0);
+    handshake_out(TbClock, resp_ready, resp_valid);
+    resp_virt                   <= (others => 'U');
+    resp_phys                   <= (others => 'U');
+
+    wait_cycles(TbClock, 2);
+    assert mst_count = 1 and mst_last = slv(PHYS0 + BEAT_BYTES)
+      report "first request not translated" severity failure;
+
+    -- Request at the end of the first page hits in the cache, and causes a
+    -- prefetch of the next page.
+    slv_req_addr                <= slv(VIRT0 + PAGE_SIZE - BEAT_BYTES);
+    handshake_out(TbClock, slv_req_ready, slv_req_valid);
+    handshake_in(TbClock, req_ready, req_valid);
+    assert req_addr = slv(VIRT1) report "expected a prefetch of the next page" severity failure;
+
+    -- The allocation ends at the first page, so the next page is not mapped.
+    resp_virt                   <= (others => '0');
+    resp_phys                   <= (others => '0');
+    resp_fault                  <= '1';
+    handshake_out(TbClock, resp_ready, resp_valid);
+    resp_fault                  <= '0';
+    resp_virt                   <= (others => 'U');
+    resp_phys                   <= (others => 'U');
+
+    wait_cycles(TbClock, 2);
+    assert fault = '0' report "dropped prefetch raised a fault" severity failure;
+    assert mst_count = 2 and mst_last = slv(PHYS0 + PAGE_SIZE - BEAT_BYTES)
+      report "request at the end of the page not translated" severity failure;
+
+    -- The first page is still cached.
+    slv_req_addr                <= slv(VIRT0 + 2 * BEAT_BYTES);
+    handshake_out(TbClock, slv_req_ready, slv_req_valid);
+
+    wait_cycles(TbClock, 2);
+    assert req_count = 2 report "unexpected translation request" severity failure;
+    assert mst_count = 3 and mst_last = slv(PHYS0 + 2 * BEAT_BYTES)
+      report "cached request not translated" severity failure;
+
+    -- The faulting prefetch was not cached, so the next page, which is mapped
+    -- by now, is translated on demand.
+    slv_req_addr                <= slv(VIRT1 + BEAT_BYTES);
+    handshake_out(TbClock, slv_req_ready, slv_req_valid);
+    handshake_in(TbClock, req_ready, req_valid);
+    assert req_addr = slv(VIRT1 + BEAT_BYTES) report "expected a translation request" severity failure;
+    resp_virt                   <= slv(VIRT1);
+    resp_phys                   <= slv(PHYS1);
+    handshake_out(TbClock, resp_ready, resp_valid);
+    resp_virt                   <= (others => 'U');
+    resp_phys                   <= (others => 'U');
+
+    wait_cycles(TbClock, 2);
+    assert mst_count = 4 and mst_last = slv(PHYS1 + BEAT_BYTES)
+      report "request on the next page not translated" severity failure;
+
+    -- A request to an address that is not mapped raises the fault output.
+    slv_req_addr                <= slv(VIRT_UNMAPPED);
+    handshake_out(TbClock, slv_req_ready, slv_req_valid);
+    handshake_in(TbClock, req_ready, req_valid);
+    resp_virt                   <= (others => '0');
+    resp_phys                   <= (others => '0');
+    resp_fault                  <= '1';
+    handshake_out(TbClock, resp_ready, resp_valid);
+    resp_fault                  <= '0';
+
+    wait_cycles(TbClock, 2);
+    assert fault = '1' report "request to an unmapped address did not fault" severity failure;
+    assert mst_count = 4 report "request to an unmapped address was passed on" severity failure;
+
+    -- All later requests are dropped.
+    slv_req_addr                <= slv(VIRT0 + BEAT_BYTES);
+    handshake_out(TbClock, slv_req_ready, slv_req_valid);
+
+    wait_cycles(TbClock, 2);
+    assert fault = '1' report "fault was cleared" severity failure;
+    assert mst_count = 4 report "request after a fault was passed on" severity failure;
+
+    TbSimEnded                  <= '1';
+
+    report "END OF TEST"  severity note;
+
+    wait;
+
+  end process;
+
+  transl_inst : MMTranslator
+    generic map (
+      VM_BASE                   => VM_BASE,
+      PT_ENTRIES_LOG2           => PT_ENTRIES_LOG2,
+      PAGE_SIZE_LOG2            => PAGE_SIZE_LOG2,
+      PREFETCH                  => true,
+      PREFETCH_LOG2             => PAGE_SIZE_LOG2 - 4,
+      BUS_ADDR_WIDTH            => BUS_ADDR_WIDTH,
+      BUS_LEN_WIDTH             => BUS_LEN_WIDTH,
+      MAX_OUTSTANDING           => 2,
+      CACHE_SIZE                => 2
+    )
+    port map (
+      clk                       => bus_clk,
+      reset                     => bus_reset,
+
+      -- Slave request channel
+      slv_req_valid             => slv_req_valid,
+      slv_req_ready             => slv_req_ready,
+      slv_req_addr              => slv_req_addr,
+      slv_req_len               => slv_req_len,
+      -- Master request channel
+      mst_req_valid             => mst_req_valid,
+      mst_req_ready             => mst_req_ready,
+      mst_req_addr              => mst_req_addr,
+      mst_req_len               => mst_req_len,
+
+      -- Translate request channel
+      req_valid                 => req_valid,
+      req_ready                 => req_ready,
+      req_addr                  => req_addr,
+      -- Translate response channel
+      resp_valid                => resp_valid,
+      resp_ready                => resp_ready,
+      resp_virt                 => resp_virt,
+      resp_phys                 => resp_phys,
+      resp_mask                 => resp_mask,
+      resp_fault                => resp_fault,
+
+      fault                     => fault
+    );
+
+end architecture;
@@ -101,10 +101,12 @@ proc add_interconnect {{source_dir ""}} {
   echo "- Bus infrastructure."
   set source_dir [source_dir_or_default $source_dir]
   add_source $source_dir/interconnect/Interconnect_pkg.vhd
+  add_source $source_dir/interconnect/BusArbiterWeights.vhd
   add_source $source_dir/interconnect/BusReadArbiter.vhd
   add_source $source_dir/interconnect/BusReadArbiterVec.vhd
   add_source $source_dir/interconnect/BusReadBenchmarker.vhd
   add_source $source_dir/interconnect/BusReadBuffer.vhd
+  add_source $source_dir/interconnect/BusReadBurstLimiter.vhd
   add_source $source_dir/interconnect/BusWriteArbiter.vhd
   add_source $source_dir/interconnect/BusWriteArbiterVec.vhd
   add_source $source_dir/interconnect/BusWriteBenchmarker.vhd
@@ -122,6 +124,8 @@ proc add_interconnect_tb {{source_dir ""}} {
   add_source $source_dir/interconnect/test/BusWriteSlaveMock.vhd
   add_source $source_dir/interconnect/test/BusWriteMasterMock.vhd
   add_source $source_dir/interconnect/test/BusReadArbiter_tb.vhd
+  add_source $source_dir/interconnect/test/BusReadArbiterWeights_tb.vhd
+  add_source $source_dir/interconnect/test/BusReadBurstLimiter_tb.vhd
 }
 
 proc add_mm {{source_dir ""}} {
@@ -149,6 +153,7 @@ proc add_mm_tb {{source_dir ""}} {
   add_source $source_dir/mm/test/MMFrames_tc.vhd
   add_source $source_dir/mm/test/MMSystem_tc.vhd
   add_source $source_dir/mm/test/MMTranslator_tc.vhd
+  add_source $source_dir/mm/test/MMTranslatorPrefetch_tc.vhd
 }
 
 proc add_buffers {{source_dir ""}} {
@@ -174,6 +179,7 @@ proc add_arrays {{source_dir ""}} {
   add_source $source_dir/arrays/ArrayConfigParse_pkg.vhd
   add_source $source_dir/arrays/ArrayConfig_pkg.vhd
   add_source $source_dir/arrays/Array_pkg.vhd
+  add_source $source_dir/arrays/ArrayProfiler.vhd
   add_source $source_dir/arrays/ArrayReaderArb.vhd
   add_source $source_dir/arrays/ArrayReaderLevel.vhd
   add_source $source_dir/arrays/ArrayReaderList.vhd
@@ -191,6 +197,12 @@ proc add_arrays {{source_dir ""}} {
   add_source $source_dir/arrays/ArrayWriter.vhd
 }
 
+proc add_arrays_tb {{source_dir ""}} {
+  echo "- Array Readers/Writers simulation support."
+  set source_dir [source_dir_or_default $source_dir]
+  add_source $source_dir/arrays/test/ArrayProfiler_tb.vhd
+}
+
 proc add_axi {{source_dir ""}} {
   echo "- AXI support."
   set source_dir [source_dir_or_default $source_dir]
@@ -241,6 +253,7 @@ proc add_fletcher_tb {{source_dir ""}} {
   set source_dir [source_dir_or_default $source_dir]
   add_streams_tb $source_dir
   add_interconnect_tb $source_dir
+  add_arrays_tb $source_dir
   add_mm_tb $source_dir
   add_wrapper_tb $source_dir
   add_axi_tb $source_dir
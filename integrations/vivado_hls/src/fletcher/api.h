@@ -180,6 +180,30 @@ f_string new_f_string(const char* src){
 	return str;
 }
 
+/**
+ * Command and unlock streams of ArrayReaders/Writers.
+ */
+
+/// @brief Command packet, requesting the rows [firstIdx, lastIdx) of an Array at the buffer addresses in ctrl.
+template <unsigned int CTRL_WIDTH, unsigned int TAG_WIDTH>
+struct f_command
+{
+	ap_uint<32> firstIdx = 0;
+	ap_uint<32> lastIdx = 0;
+	ap_uint<CTRL_WIDTH> ctrl = 0;
+	ap_uint<TAG_WIDTH> tag = 0;
+	f_command() = default;
+	f_command(ap_uint<32> _firstIdx, ap_uint<32> _lastIdx, ap_uint<CTRL_WIDTH> _ctrl, ap_uint<TAG_WIDTH> _tag = 0)
+		: firstIdx(_firstIdx), lastIdx(_lastIdx), ctrl(_ctrl), tag(_tag) {}
+};
+
+/// @brief Unlock packet, signaling that the command with the same tag has completed.
+template <unsigned int TAG_WIDTH>
+struct f_unlock
+{
+	ap_uint<TAG_WIDTH> tag = 0;
+};
+
 /**
  * RecordBatch & Schema support
  */
@@ -28,7 +28,7 @@
 
 // Dirty globals
 AwsConfig aws_default_config = {0, 0, 1};
-PlatformState aws_state = {{0, 0, 0}, 4096, {0}, {0},  0, 0, {0}, {0}, 0x0};
+PlatformState aws_state = {{0, 0, 0}, 4096, {0}, {0},  0, 0, {0}, {0}, 0x0, FLETCHER_REG_MM_DEFAULT_REGION};
 
 static fstatus_t check_ddr(const uint8_t *source, da_t offset, size_t size) {
   uint8_t *check_buffer = (uint8_t *) malloc(size);
@@ -187,6 +187,19 @@ fstatus_t platformReadMMIO(uint64_t offset, uint32_t *value) {
   return FLETCHER_STATUS_OK;
 }
 
+fstatus_t platformGetMmioBase(volatile freg_t **base, uint64_t *num_regs) {
+  void *ptr = NULL;
+  int rc = fpga_pci_get_address(aws_state.pci_bar_handle, 0, sizeof(freg_t) * FLETCHER_AWS_MMIO_NUM_REGS, &ptr);
+  if ((rc != 0) || (ptr == NULL)) {
+    debug_print("[FLETCHER_AWS] Could not map MMIO registers. fpga_pci_get_address: %d\n", rc);
+    return FLETCHER_STATUS_ERROR;
+  }
+  *base = (volatile freg_t *) ptr;
+  *num_regs = FLETCHER_AWS_MMIO_NUM_REGS;
+  debug_print("[FLETCHER_AWS] Mapped MMIO registers @ [host] 0x%016lX.\n", (uint64_t) ptr);
+  return FLETCHER_STATUS_OK;
+}
+
 fstatus_t platformCopyHostToDevice(const uint8_t *host_source, da_t device_destination, int64_t size) {
   size_t total = 0;
 
@@ -327,9 +340,21 @@ fstatus_t platformTerminate(void *arg) {
   return FLETCHER_STATUS_OK;
 }
 
+fstatus_t platformSetDeviceRegion(uint32_t region) {
+  debug_print("[FLETCHER_AWS] Selecting device region.      [region] %u.\n", region);
+  aws_state.region = region;
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformSetDeviceHugePages(int enable) {
+  debug_print("[FLETCHER_AWS] Setting huge page hint.      [enable] %d.\n", enable);
+  aws_state.huge_pages = enable;
+  return FLETCHER_STATUS_OK;
+}
+
 fstatus_t platformDeviceMalloc(da_t *device_address, int64_t size) {
-  // Set default region
-  platformWriteMMIO(FLETCHER_REG_MM_HDR_REGION, FLETCHER_REG_MM_DEFAULT_REGION);
+  // Set region
+  platformWriteMMIO(FLETCHER_REG_MM_HDR_REGION, aws_state.region);
 
   // Set size
   uint32_t regval = size;
@@ -338,7 +363,11 @@ fstatus_t platformDeviceMalloc(da_t *device_address, int64_t size) {
   platformWriteMMIO(FLETCHER_REG_MM_HDR_SIZE_HI, regval);
 
   // Allocate
-  platformWriteMMIO(FLETCHER_REG_MM_HDR_CMD, FLETCHER_REG_MM_CMD_ALLOC);
+  regval = FLETCHER_REG_MM_CMD_ALLOC;
+  if (aws_state.huge_pages) {
+    regval |= FLETCHER_REG_MM_CMD_HUGE;
+  }
+  platformWriteMMIO(FLETCHER_REG_MM_HDR_CMD, regval);
 
   // Wait for completion
   do {
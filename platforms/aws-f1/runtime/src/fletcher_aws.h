@@ -35,6 +35,8 @@
 #define FLETCHER_AWS_NUM_QUEUES       1
 #define FLETCHER_AWS_DEVICE_ALIGNMENT 4096
 #define FLETCHER_AWS_QUEUE_THRESHOLD (1024*1024*1) // 1 MiB
+// Number of 32-bit registers in the mapped region of the OCL BAR
+#define FLETCHER_AWS_MMIO_NUM_REGS    (1024*4)
 
 typedef struct {
   int slot_id;
@@ -52,6 +54,8 @@ typedef struct {
   char wr_device_filename[256];
   char rd_device_filename[256];
   da_t buffer_ptr;
+  uint32_t region;
+  int huge_pages;
 } PlatformState;
 
 /// @brief Store the platform name in a buffer of size /p size pointed to by /p name.
@@ -67,6 +71,15 @@ fstatus_t platformWriteMMIO(uint64_t offset, uint32_t value);
 /// @brief Read MMIO register \p offset into \p value
 fstatus_t platformReadMMIO(uint64_t offset, uint32_t *value);
 
+/// @brief Store the host address of the mapped MMIO registers in \p base and their number in \p num_regs.
+fstatus_t platformGetMmioBase(volatile freg_t **base, uint64_t *num_regs);
+
+/// @brief Place subsequent device memory allocations in the region of memory channel \p region - 1.
+fstatus_t platformSetDeviceRegion(uint32_t region);
+
+/// @brief Map subsequent device memory allocations with huge pages where possible, if \p enable is nonzero.
+fstatus_t platformSetDeviceHugePages(int enable);
+
 /// @brief Copy \p size bytes from host address \p host_source to device address \p device_destination.
 fstatus_t platformCopyHostToDevice(const uint8_t *host_source, da_t device_destination, int64_t size);
 
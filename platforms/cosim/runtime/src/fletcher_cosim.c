@@ -0,0 +1,450 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fletcher/fletcher.h"
+
+#include "fletcher_cosim.h"
+
+#define cosim_print(...) do { if (!options.quiet) fprintf(stdout, __VA_ARGS__); } while (0)
+#define cosim_error(...) fprintf(stderr, __VA_ARGS__)
+
+/// Base address of the device memory image.
+#define FLETCHER_COSIM_MEM_BASE 0x1000
+
+/// Alignment of allocations in the device memory image.
+#define FLETCHER_COSIM_MEM_ALIGN 4096
+
+/// An allocation in the device memory image.
+typedef struct {
+  da_t address;
+  int64_t size;
+  uint8_t *data;
+} Allocation;
+
+/// An outstanding bus request on a bus slave mock.
+typedef struct {
+  uint64_t addr;
+  uint32_t len;
+} BusRequest;
+
+/// A queue of outstanding bus requests, and the beat of the oldest request that is transferred next.
+typedef struct {
+  BusRequest requests[FLETCHER_COSIM_MAX_REQUESTS];
+  size_t first;
+  size_t count;
+  uint32_t beat;
+} BusQueue;
+
+/// Handshakes that took place on the MMIO interface in a cycle.
+typedef struct {
+  int aw;
+  int w;
+  int b;
+  int ar;
+  int r;
+  uint32_t rdata;
+} MmioTransfers;
+
+InitOptions options = {0};
+
+// Simulation model
+void *model_handle = NULL;
+cosimModelInit_t model_init = NULL;
+cosimModelEval_t model_eval = NULL;
+cosimModelTick_t model_tick = NULL;
+cosimModelTerminate_t model_terminate = NULL;
+
+CosimPins pins;
+uint64_t cycles = 0;
+
+// Device memory image
+Allocation *allocations = NULL;
+size_t num_allocations = 0;
+size_t allocations_capacity = 0;
+da_t next_address = FLETCHER_COSIM_MEM_BASE;
+
+// Bus slave mocks
+BusQueue reads;
+BusQueue writes;
+
+/// @brief Return the allocation that contains \p address, or NULL if there is none.
+static Allocation *FindAllocation(da_t address) {
+  for (size_t i = 0; i < num_allocations; i++) {
+    if ((address >= allocations[i].address) && (address < allocations[i].address + allocations[i].size)) {
+      return &allocations[i];
+    }
+  }
+  return NULL;
+}
+
+/// @brief Read \p size bytes from the device memory image. Bytes outside of any allocation read as zero.
+static void MemRead(da_t address, uint8_t *destination, int64_t size) {
+  while (size > 0) {
+    Allocation *a = FindAllocation(address);
+    if (a == NULL) {
+      *destination = 0;
+      address++;
+      destination++;
+      size--;
+      continue;
+    }
+    int64_t n = a->address + a->size - address;
+    if (n > size) {
+      n = size;
+    }
+    memcpy(destination, a->data + (address - a->address), (size_t) n);
+    address += n;
+    destination += n;
+    size -= n;
+  }
+}
+
+/// @brief Write the bytes of a bus beat that are enabled by \p strobe to the device memory image.
+static void MemWriteBeat(da_t address, const uint8_t *source, uint64_t strobe) {
+  for (int i = 0; i < FLETCHER_COSIM_BUS_DATA_BYTES; i++) {
+    if (strobe & (1ull << i)) {
+      Allocation *a = FindAllocation(address + i);
+      if (a != NULL) {
+        a->data[address + i - a->address] = source[i];
+      } else {
+        cosim_error("[COSIM] Design wrote outside of device memory at [dev] 0x%016lX.\n", address + i);
+      }
+    }
+  }
+}
+
+static void Push(BusQueue *q, uint64_t addr, uint32_t len) {
+  size_t i = (q->first + q->count) % FLETCHER_COSIM_MAX_REQUESTS;
+  q->requests[i].addr = addr;
+  q->requests[i].len = len;
+  q->count++;
+}
+
+static void Pop(BusQueue *q) {
+  q->first = (q->first + 1) % FLETCHER_COSIM_MAX_REQUESTS;
+  q->count--;
+  q->beat = 0;
+}
+
+/**
+ * @brief Simulate a single clock cycle.
+ *
+ * The bus slave mocks drive their inputs of the design, the combinational logic of the design is evaluated, and all
+ * handshakes are determined before the rising clock edge. Afterwards, the bus slave mocks process the transfers.
+ */
+static MmioTransfers Cycle(void) {
+  MmioTransfers mmio = {0};
+
+  // Bus read slave: accept requests while there is room, and return the data of the oldest request.
+  pins.rreq_ready = reads.count < FLETCHER_COSIM_MAX_REQUESTS;
+  pins.rdat_valid = reads.count > 0;
+  pins.rdat_last = 0;
+  if (pins.rdat_valid) {
+    const BusRequest *r = &reads.requests[reads.first];
+    MemRead(r->addr + reads.beat * FLETCHER_COSIM_BUS_DATA_BYTES, pins.rdat_data, FLETCHER_COSIM_BUS_DATA_BYTES);
+    pins.rdat_last = reads.beat + 1 >= r->len;
+  }
+
+  // Bus write slave: accept requests while there is room, and data for the oldest request.
+  pins.wreq_ready = writes.count < FLETCHER_COSIM_MAX_REQUESTS;
+  pins.wdat_ready = writes.count > 0;
+
+  model_eval(&pins);
+
+  int rreq = pins.rreq_valid && pins.rreq_ready;
+  int rdat = pins.rdat_valid && pins.rdat_ready;
+  int wreq = pins.wreq_valid && pins.wreq_ready;
+  int wdat = pins.wdat_valid && pins.wdat_ready;
+  mmio.aw = pins.mmio_awvalid && pins.mmio_awready;
+  mmio.w = pins.mmio_wvalid && pins.mmio_wready;
+  mmio.b = pins.mmio_bvalid && pins.mmio_bready;
+  mmio.ar = pins.mmio_arvalid && pins.mmio_arready;
+  mmio.r = pins.mmio_rvalid && pins.mmio_rready;
+  mmio.rdata = pins.mmio_rdata;
+
+  model_tick();
+  cycles++;
+
+  if (rdat) {
+    reads.beat++;
+    if (pins.rdat_last) {
+      Pop(&reads);
+    }
+  }
+  if (wdat) {
+    const BusRequest *w = &writes.requests[writes.first];
+    MemWriteBeat(w->addr + writes.beat * FLETCHER_COSIM_BUS_DATA_BYTES, pins.wdat_data, pins.wdat_strobe);
+    writes.beat++;
+    if (pins.wdat_last || (writes.beat >= w->len)) {
+      Pop(&writes);
+    }
+  }
+  if (rreq) {
+    Push(&reads, pins.rreq_addr, pins.rreq_len);
+  }
+  if (wreq) {
+    Push(&writes, pins.wreq_addr, pins.wreq_len);
+  }
+
+  return mmio;
+}
+
+fstatus_t platformGetName(char *name, size_t size) {
+  size_t len = strlen(FLETCHER_PLATFORM_NAME);
+  if (len > size) {
+    memcpy(name, FLETCHER_PLATFORM_NAME, size - 1);
+    name[size - 1] = '\0';
+  } else {
+    memcpy(name, FLETCHER_PLATFORM_NAME, len + 1);
+  }
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformInit(void *arg) {
+  if (arg != NULL) {
+    options = *(InitOptions *) arg;
+  }
+  if (options.model == NULL) {
+    options.model = getenv(FLETCHER_COSIM_MODEL_ENV);
+  }
+  if (options.poll_cycles == 0) {
+    options.poll_cycles = FLETCHER_COSIM_DEFAULT_POLL_CYCLES;
+  }
+  if (options.timeout_cycles == 0) {
+    options.timeout_cycles = FLETCHER_COSIM_DEFAULT_TIMEOUT_CYCLES;
+  }
+  if (options.model == NULL) {
+    cosim_error("[COSIM] No simulation model. Set %s to the path of the model library.\n", FLETCHER_COSIM_MODEL_ENV);
+    return FLETCHER_STATUS_ERROR;
+  }
+
+  cosim_print("[COSIM] Loading simulation model.  %s\n", options.model);
+  model_handle = dlopen(options.model, RTLD_NOW);
+  if (model_handle == NULL) {
+    cosim_error("[COSIM] %s\n", dlerror());
+    return FLETCHER_STATUS_ERROR;
+  }
+  *(void **) (&model_init) = dlsym(model_handle, "cosimModelInit");
+  *(void **) (&model_eval) = dlsym(model_handle, "cosimModelEval");
+  *(void **) (&model_tick) = dlsym(model_handle, "cosimModelTick");
+  *(void **) (&model_terminate) = dlsym(model_handle, "cosimModelTerminate");
+  if ((model_init == NULL) || (model_eval == NULL) || (model_tick == NULL) || (model_terminate == NULL)) {
+    cosim_error("[COSIM] %s\n", dlerror());
+    dlclose(model_handle);
+    model_handle = NULL;
+    return FLETCHER_STATUS_ERROR;
+  }
+  if (model_init(options.model_args) != 0) {
+    cosim_error("[COSIM] Could not initialize simulation model.\n");
+    dlclose(model_handle);
+    model_handle = NULL;
+    return FLETCHER_STATUS_ERROR;
+  }
+
+  memset(&pins, 0, sizeof(pins));
+  memset(&reads, 0, sizeof(reads));
+  memset(&writes, 0, sizeof(writes));
+  cycles = 0;
+
+  // Reset the design.
+  pins.reset = 1;
+  for (int i = 0; i < FLETCHER_COSIM_RESET_CYCLES; i++) {
+    Cycle();
+  }
+  pins.reset = 0;
+
+  cosim_print("[COSIM] Initialized platform.      Arguments @ [host] %016lX.\n", (unsigned long) arg);
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformWriteMMIO(uint64_t offset, uint32_t value) {
+  if (model_handle == NULL) {
+    return FLETCHER_STATUS_ERROR;
+  }
+  pins.mmio_awaddr = (uint32_t) (offset * sizeof(freg_t));
+  pins.mmio_wdata = value;
+  pins.mmio_wstrb = 0xF;
+  int aw = 0, w = 0, b = 0;
+  uint64_t start = cycles;
+  while (!b) {
+    if (cycles - start > options.timeout_cycles) {
+      cosim_error("[COSIM] Timeout writing MMIO register %lu.\n", offset);
+      pins.mmio_awvalid = pins.mmio_wvalid = pins.mmio_bready = 0;
+      return FLETCHER_STATUS_ERROR;
+    }
+    pins.mmio_awvalid = !aw;
+    pins.mmio_wvalid = !w;
+    pins.mmio_bready = aw && w;
+    MmioTransfers t = Cycle();
+    aw |= t.aw;
+    w |= t.w;
+    b |= t.b;
+  }
+  pins.mmio_awvalid = pins.mmio_wvalid = pins.mmio_bready = 0;
+  cosim_print("[COSIM] Writing MMIO register.       %04lu <= 0x%08X\n", offset, value);
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformReadMMIO(uint64_t offset, uint32_t *value) {
+  if (model_handle == NULL) {
+    return FLETCHER_STATUS_ERROR;
+  }
+  // Let the design progress while the host polls.
+  for (uint64_t i = 0; i < options.poll_cycles; i++) {
+    Cycle();
+  }
+  pins.mmio_araddr = (uint32_t) (offset * sizeof(freg_t));
+  int ar = 0, r = 0;
+  uint64_t start = cycles;
+  while (!r) {
+    if (cycles - start > options.timeout_cycles) {
+      cosim_error("[COSIM] Timeout reading MMIO register %lu.\n", offset);
+      pins.mmio_arvalid = pins.mmio_rready = 0;
+      return FLETCHER_STATUS_ERROR;
+    }
+    pins.mmio_arvalid = !ar;
+    pins.mmio_rready = ar;
+    MmioTransfers t = Cycle();
+    ar |= t.ar;
+    if (t.r) {
+      r = 1;
+      *value = t.rdata;
+    }
+  }
+  pins.mmio_arvalid = pins.mmio_rready = 0;
+  cosim_print("[COSIM] Reading MMIO register.       %04lu => 0x%08X\n", offset, *value);
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformCopyHostToDevice(const uint8_t *host_source, da_t device_destination, int64_t size) {
+  Allocation *a = FindAllocation(device_destination);
+  if ((a == NULL) || (device_destination + size > a->address + a->size)) {
+    cosim_error("[COSIM] Copy to unallocated device memory at [dev] 0x%016lX.\n", device_destination);
+    return FLETCHER_STATUS_ERROR;
+  }
+  memcpy(a->data + (device_destination - a->address), host_source, (size_t) size);
+  cosim_print("[COSIM] Copying from host to device. [host] 0x%016lX --> [dev] 0x%016lX (%lu bytes)\n",
+              (uint64_t) host_source,
+              device_destination,
+              size);
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformCopyDeviceToHost(da_t device_source, uint8_t *host_destination, int64_t size) {
+  Allocation *a = FindAllocation(device_source);
+  if ((a == NULL) || (device_source + size > a->address + a->size)) {
+    cosim_error("[COSIM] Copy from unallocated device memory at [dev] 0x%016lX.\n", device_source);
+    return FLETCHER_STATUS_ERROR;
+  }
+  memcpy(host_destination, a->data + (device_source - a->address), (size_t) size);
+  cosim_print("[COSIM] Copying from device to host. [dev] 0x%016lX --> [host] 0x%016lX (%lu bytes)\n",
+              device_source,
+              (uint64_t) host_destination,
+              size);
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformTerminate(void *arg) {
+  cosim_print("[COSIM] Terminating platform.        Arguments @ [host] 0x%016lX, simulated %lu cycles.\n",
+              (uint64_t) arg,
+              cycles);
+  if (model_handle != NULL) {
+    model_terminate();
+    dlclose(model_handle);
+    model_handle = NULL;
+  }
+  for (size_t i = 0; i < num_allocations; i++) {
+    free(allocations[i].data);
+  }
+  free(allocations);
+  allocations = NULL;
+  num_allocations = 0;
+  allocations_capacity = 0;
+  next_address = FLETCHER_COSIM_MEM_BASE;
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformSetDeviceRegion(uint32_t region) {
+  cosim_print("[COSIM] Selecting device region.     [region] %u.\n", region);
+  if (region != FLETCHER_REG_MM_DEFAULT_REGION) {
+    cosim_error("[COSIM] Only the bus master of the first memory channel is simulated.\n");
+    return FLETCHER_STATUS_ERROR;
+  }
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformDeviceMalloc(da_t *device_address, int64_t size) {
+  if (num_allocations == allocations_capacity) {
+    size_t capacity = allocations_capacity == 0 ? 16 : 2 * allocations_capacity;
+    Allocation *resized = (Allocation *) realloc(allocations, capacity * sizeof(Allocation));
+    if (resized == NULL) {
+      return FLETCHER_STATUS_ERROR;
+    }
+    allocations = resized;
+    allocations_capacity = capacity;
+  }
+  // Round up to whole bus beats, such that bursts never read outside of the allocation.
+  int64_t padded = (size + FLETCHER_COSIM_BUS_DATA_BYTES - 1) / FLETCHER_COSIM_BUS_DATA_BYTES
+      * FLETCHER_COSIM_BUS_DATA_BYTES;
+  uint8_t *data = (uint8_t *) calloc(1, (size_t) (padded > 0 ? padded : 1));
+  if (data == NULL) {
+    return FLETCHER_STATUS_ERROR;
+  }
+  Allocation *a = &allocations[num_allocations++];
+  a->address = next_address;
+  a->size = padded;
+  a->data = data;
+  next_address = (next_address + padded + FLETCHER_COSIM_MEM_ALIGN - 1) / FLETCHER_COSIM_MEM_ALIGN
+      * FLETCHER_COSIM_MEM_ALIGN;
+  *device_address = a->address;
+  cosim_print("[COSIM] Allocating device memory.    [device] 0x%016lX (%10lu bytes).\n", *device_address, size);
+  return FLETCHER_STATUS_OK;
+}
+
+fstatus_t platformDeviceFree(da_t device_address) {
+  for (size_t i = 0; i < num_allocations; i++) {
+    if (allocations[i].address == device_address) {
+      free(allocations[i].data);
+      allocations[i] = allocations[--num_allocations];
+      cosim_print("[COSIM] Freeing device memory.       [device] 0x%016lX.\n", device_address);
+      return FLETCHER_STATUS_OK;
+    }
+  }
+  cosim_error("[COSIM] Freeing unallocated device memory at [dev] 0x%016lX.\n", device_address);
+  return FLETCHER_STATUS_ERROR;
+}
+
+fstatus_t platformPrepareHostBuffer(const uint8_t *host_source, da_t *device_destination, int64_t size, int *alloced) {
+  // The simulated design can only access the device memory image, so the buffer is always copied.
+  fstatus_t status = platformCacheHostBuffer(host_source, device_destination, size);
+  *alloced = status == FLETCHER_STATUS_OK;
+  return status;
+}
+
+fstatus_t platformCacheHostBuffer(const uint8_t *host_source, da_t *device_destination, int64_t size) {
+  if (platformDeviceMalloc(device_destination, size) != FLETCHER_STATUS_OK) {
+    return FLETCHER_STATUS_ERROR;
+  }
+  return platformCopyHostToDevice(host_source, *device_destination, size);
+}
+
+fstatus_t platformCosimGetCycles(uint64_t *cycles_out) {
+  *cycles_out = cycles;
+  return FLETCHER_STATUS_OK;
+}
@@ -0,0 +1,205 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include "fletcher/fletcher.h"
+
+#define FLETCHER_PLATFORM_NAME "cosim"
+
+/// Width of the data bus of the simulated design in bytes.
+#define FLETCHER_COSIM_BUS_DATA_BYTES 64
+
+/// Maximum number of outstanding bus requests of the bus slave mocks.
+#define FLETCHER_COSIM_MAX_REQUESTS 16
+
+/// Default number of cycles to simulate before every MMIO read.
+#define FLETCHER_COSIM_DEFAULT_POLL_CYCLES 256
+
+/// Default number of cycles after which an MMIO transaction times out.
+#define FLETCHER_COSIM_DEFAULT_TIMEOUT_CYCLES 1000000
+
+/// Number of cycles the reset is asserted during initialization.
+#define FLETCHER_COSIM_RESET_CYCLES 16
+
+/// Environment variable holding the path to the simulation model library, if not supplied through InitOptions.
+#define FLETCHER_COSIM_MODEL_ENV "FLETCHER_COSIM_MODEL"
+
+typedef struct {
+  int quiet;
+  /// Path to the simulation model library. If NULL, the path is taken from the FLETCHER_COSIM_MODEL variable.
+  const char *model;
+  /// Arguments passed to the simulation model.
+  const char *model_args;
+  /// Number of cycles to simulate before every MMIO read, such that the design progresses while the host polls.
+  uint64_t poll_cycles;
+  /// Number of cycles after which an MMIO transaction times out.
+  uint64_t timeout_cycles;
+} InitOptions;
+
+/**
+ * @brief The top-level pins of a simulated Mantle.
+ *
+ * The AXI4-lite MMIO slave, the bus read master and the bus write master of the Mantle. Both clock domains are driven
+ * by the same clock. Designs without a read or write master leave the respective pins untouched.
+ */
+typedef struct {
+  // Inputs of the design.
+  uint8_t reset;
+
+  uint8_t mmio_awvalid;
+  uint32_t mmio_awaddr;
+  uint8_t mmio_wvalid;
+  uint32_t mmio_wdata;
+  uint8_t mmio_wstrb;
+  uint8_t mmio_bready;
+  uint8_t mmio_arvalid;
+  uint32_t mmio_araddr;
+  uint8_t mmio_rready;
+
+  uint8_t rreq_ready;
+  uint8_t rdat_valid;
+  uint8_t rdat_data[FLETCHER_COSIM_BUS_DATA_BYTES];
+  uint8_t rdat_last;
+
+  uint8_t wreq_ready;
+  uint8_t wdat_ready;
+
+  // Outputs of the design.
+  uint8_t mmio_awready;
+  uint8_t mmio_wready;
+  uint8_t mmio_bvalid;
+  uint8_t mmio_bresp;
+  uint8_t mmio_arready;
+  uint8_t mmio_rvalid;
+  uint32_t mmio_rdata;
+  uint8_t mmio_rresp;
+
+  uint8_t rreq_valid;
+  uint64_t rreq_addr;
+  uint32_t rreq_len;
+  uint8_t rdat_ready;
+
+  uint8_t wreq_valid;
+  uint64_t wreq_addr;
+  uint32_t wreq_len;
+  uint8_t wdat_valid;
+  uint8_t wdat_data[FLETCHER_COSIM_BUS_DATA_BYTES];
+  uint64_t wdat_strobe;
+  uint8_t wdat_last;
+} CosimPins;
+
+/*
+ * Functions that a simulation model library must export. The library wraps a compiled RTL simulation of the design,
+ * e.g. a Verilator model or a GHDL design with a foreign function interface.
+ */
+
+/// @brief Initialize the simulation model with some model-specific arguments. Returns 0 on success.
+typedef int (*cosimModelInit_t)(const char *args);
+
+/// @brief Apply the inputs in \p pins, evaluate the combinational logic of the design and store its outputs in \p pins.
+typedef void (*cosimModelEval_t)(CosimPins *pins);
+
+/// @brief Simulate a rising clock edge, using the inputs of the last evaluation.
+typedef void (*cosimModelTick_t)(void);
+
+/// @brief Terminate the simulation model.
+typedef void (*cosimModelTerminate_t)(void);
+
+/// @brief Store the platform name in a buffer of size /p size pointed to by /p name.
+fstatus_t platformGetName(char *name, size_t size);
+
+/// @brief Initialize the platform. \p arg may point to a null pointer or some custom structure for initialization
+/// arguments.
+fstatus_t platformInit(void *arg);
+
+/// @brief Write \p value to MMIO register \p offset
+fstatus_t platformWriteMMIO(uint64_t offset, uint32_t value);
+
+/// @brief Read MMIO register \p offset into \p value
+fstatus_t platformReadMMIO(uint64_t offset, uint32_t *value);
+
+/**
+ * @brief Select the device memory region in which subsequent allocations are placed.
+ *
+ * This function is optional for platforms. Platforms with multiple memory channels place the buffers of every channel
+ * in a separate region. Memory channel N uses region FLETCHER_REG_MM_DEFAULT_REGION + N. The co-simulation only
+ * simulates the bus master of the first memory channel, so only the default region can be selected.
+ *
+ * @param region                The device memory region.
+ * @return                      FLETCHER_STATUS_OK if successful, FLETCHER_STATUS_ERROR otherwise.
+ */
+fstatus_t platformSetDeviceRegion(uint32_t region);
+
+/// @brief Copy \p size bytes from host address \p host_source to device address \p device_destination.
+fstatus_t platformCopyHostToDevice(const uint8_t *host_source, da_t device_destination, int64_t size);
+
+/// @brief Copy \p size bytes from device address \p device_source to host address \p host_destination.
+fstatus_t platformCopyDeviceToHost(da_t device_source, uint8_t *host_destination, int64_t size);
+
+/// @brief Allocate \p size bytes on the device.
+fstatus_t platformDeviceMalloc(da_t *device_address, int64_t size);
+
+/// @brief Free the memory allocated at \p device_address.
+fstatus_t platformDeviceFree(da_t device_address);
+
+/**
+ * @brief Ensure the device can read \p size bytes from a host buffer at \p host_source.
+ *
+ * The address that the device can use to do so will be stored in \p device destination.
+ *
+ * For systems that operate in the same virtual address space as the application, this means the host source address
+ * should just be copied into the device destination address. For systems that operate in a different address space
+ * (for example, that must make a copy to on-board memory), this means this function must allocate a memory region to
+ * copy the bytes to on the device. The address of this region will be the device destination address.
+ *
+ * This function can be used mainly for streamable applications. When data reuse is expected, on-board memory is often
+ * faster. For this purpose, platformCacheHostBuffer can be used.
+ *
+ * @param host_source           Host address of the source data.
+ * @param device_destination    Pointer to store the device destination address at.
+ * @param size                  Number of bytes to prepare.
+ * @param alloced               Whether the buffer caused a new allocation on the device, that should be freed after
+ *                              usage (0 = not alloced, 1 = alloced).
+ * @return                      FLETCHER_STATUS_OK if successful, FLETCHER_STATUS_ERROR otherwise.
+ */
+fstatus_t platformPrepareHostBuffer(const uint8_t *host_source, da_t *device_destination, int64_t size, int *alloced);
+
+/**
+ * @brief Explicitly cache \p size bytes from \p host_source on device on-board memory.
+ *
+ * The destination is stored at \p device_destination. This is essentially an allocate and copy. This function exists to
+ * provide the means of explicitly copying the data to the device on-board memory, even when the device can initiate
+ * loads in the same virtual address space as the application.
+ *
+ * @param host_source           Host address of the source data.
+ * @param device_destination    Pointer to store the device destination address at.
+ * @param size                  Number of bytes to prepare.
+ * @return                      FLETCHER_STATUS_OK if successful, FLETCHER_STATUS_ERROR otherwise.
+ */
+fstatus_t platformCacheHostBuffer(const uint8_t *host_source, da_t *device_destination, int64_t size);
+
+/**
+ * @brief Terminate the platform.
+ *
+ * \p arg may point to a null pointer or some custom structure for termination arguments. Free any allocated memory.
+ *
+ * @param arg                   Arguments for termination.
+ * @return                      FLETCHER_STATUS_OK if successful, FLETCHER_STATUS_ERROR otherwise.
+ */
+fstatus_t platformTerminate(void *arg);
+
+
+/// @brief Store the number of clock cycles simulated since initialization in \p cycles.
+fstatus_t platformCosimGetCycles(uint64_t *cycles);
@@ -0,0 +1,91 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include "fletcher_cosim.h"
+}
+
+#include "test_model.h"
+
+static InitOptions GetOptions(const char *model_args = nullptr) {
+  InitOptions options = {};
+  options.quiet = 1;
+  options.model = COSIM_TEST_MODEL;
+  options.model_args = model_args;
+  return options;
+}
+
+static void WriteAddress(uint64_t lo_reg, da_t address) {
+  ASSERT_EQ(platformWriteMMIO(lo_reg, static_cast<uint32_t>(address)), FLETCHER_STATUS_OK);
+  ASSERT_EQ(platformWriteMMIO(lo_reg + 1, static_cast<uint32_t>(address >> 32u)), FLETCHER_STATUS_OK);
+}
+
+TEST(Cosim, InitFailure) {
+  auto options = GetOptions("fail");
+  ASSERT_EQ(platformInit(&options), FLETCHER_STATUS_ERROR);
+  // The model was unloaded, so the platform cannot be used.
+  uint32_t value = 0;
+  ASSERT_EQ(platformReadMMIO(TEST_MODEL_REG_SCRATCH, &value), FLETCHER_STATUS_ERROR);
+  ASSERT_EQ(platformTerminate(nullptr), FLETCHER_STATUS_OK);
+}
+
+TEST(Cosim, MMIO) {
+  auto options = GetOptions();
+  ASSERT_EQ(platformInit(&options), FLETCHER_STATUS_OK);
+  ASSERT_EQ(platformWriteMMIO(TEST_MODEL_REG_SCRATCH, 0xDEADBEEF), FLETCHER_STATUS_OK);
+  uint32_t value = 0;
+  ASSERT_EQ(platformReadMMIO(TEST_MODEL_REG_SCRATCH, &value), FLETCHER_STATUS_OK);
+  ASSERT_EQ(value, 0xDEADBEEF);
+  ASSERT_EQ(platformReadMMIO(TEST_MODEL_REG_STATUS, &value), FLETCHER_STATUS_OK);
+  ASSERT_EQ(value, 0u);
+  ASSERT_EQ(platformTerminate(nullptr), FLETCHER_STATUS_OK);
+}
+
+TEST(Cosim, Bursts) {
+  auto options = GetOptions();
+  ASSERT_EQ(platformInit(&options), FLETCHER_STATUS_OK);
+
+  // The model copies the source buffer to the destination buffer with one read and one write burst.
+  const int64_t size = TEST_MODEL_BURST_BEATS * FLETCHER_COSIM_BUS_DATA_BYTES;
+  std::vector<uint8_t> source(size);
+  for (int64_t i = 0; i < size; i++) {
+    source[i] = static_cast<uint8_t>(i * 7 + 3);
+  }
+  da_t src = 0;
+  da_t dst = 0;
+  ASSERT_EQ(platformDeviceMalloc(&src, size), FLETCHER_STATUS_OK);
+  ASSERT_EQ(platformDeviceMalloc(&dst, size), FLETCHER_STATUS_OK);
+  ASSERT_EQ(platformCopyHostToDevice(source.data(), src, size), FLETCHER_STATUS_OK);
+
+  WriteAddress(TEST_MODEL_REG_SRC_LO, src);
+  WriteAddress(TEST_MODEL_REG_DST_LO, dst);
+  ASSERT_EQ(platformWriteMMIO(TEST_MODEL_REG_CONTROL, TEST_MODEL_CONTROL_START), FLETCHER_STATUS_OK);
+
+  // Every MMIO read lets the design progress, so the copy completes while polling.
+  uint32_t status = 0;
+  for (int i = 0; (i < 16) && (status != TEST_MODEL_STATUS_DONE); i++) {
+    ASSERT_EQ(platformReadMMIO(TEST_MODEL_REG_STATUS, &status), FLETCHER_STATUS_OK);
+  }
+  ASSERT_EQ(status, TEST_MODEL_STATUS_DONE);
+
+  std::vector<uint8_t> destination(size);
+  ASSERT_EQ(platformCopyDeviceToHost(dst, destination.data(), size), FLETCHER_STATUS_OK);
+  ASSERT_EQ(destination, source);
+  ASSERT_EQ(platformTerminate(nullptr), FLETCHER_STATUS_OK);
+}
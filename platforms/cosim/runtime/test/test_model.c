@@ -0,0 +1,183 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Simulation model library for the co-simulation platform tests.
+//
+// Instead of wrapping an RTL simulation, this model implements a small design in C: a register file behind the
+// AXI4-lite MMIO slave, and a copy engine that reads one burst from the bus and writes it back in one burst to another
+// address. Initialization fails if the model arguments are "fail".
+
+#include <string.h>
+
+#include "fletcher_cosim.h"
+
+#include "test_model.h"
+
+typedef enum {
+  IDLE,
+  READ_REQ,
+  READ_DATA,
+  WRITE_REQ,
+  WRITE_DATA
+} CopyState;
+
+/// Pins of the last evaluation, used to determine the handshakes at the next clock edge.
+static CosimPins last;
+
+// MMIO slave
+static uint32_t regs[TEST_MODEL_NUM_REGS];
+static int aw_done;
+static uint32_t aw_addr;
+static int w_done;
+static uint32_t w_data;
+static int b_pending;
+static int r_pending;
+static uint32_t r_data;
+
+// Copy engine
+static CopyState state;
+static uint32_t beat;
+static uint8_t buffer[TEST_MODEL_BURST_BEATS][FLETCHER_COSIM_BUS_DATA_BYTES];
+
+static void Reset(void) {
+  memset(regs, 0, sizeof(regs));
+  aw_done = 0;
+  w_done = 0;
+  b_pending = 0;
+  r_pending = 0;
+  state = IDLE;
+  beat = 0;
+}
+
+static uint64_t Address(uint32_t lo_reg) {
+  return ((uint64_t) regs[lo_reg + 1] << 32u) | regs[lo_reg];
+}
+
+int cosimModelInit(const char *args) {
+  if ((args != NULL) && (strcmp(args, "fail") == 0)) {
+    return 1;
+  }
+  memset(&last, 0, sizeof(last));
+  Reset();
+  return 0;
+}
+
+void cosimModelEval(CosimPins *pins) {
+  pins->mmio_awready = !aw_done && !b_pending;
+  pins->mmio_wready = !w_done && !b_pending;
+  pins->mmio_bvalid = b_pending;
+  pins->mmio_bresp = 0;
+  pins->mmio_arready = !r_pending;
+  pins->mmio_rvalid = r_pending;
+  pins->mmio_rdata = r_data;
+  pins->mmio_rresp = 0;
+
+  pins->rreq_valid = state == READ_REQ;
+  pins->rreq_addr = Address(TEST_MODEL_REG_SRC_LO);
+  pins->rreq_len = TEST_MODEL_BURST_BEATS;
+  pins->rdat_ready = state == READ_DATA;
+
+  pins->wreq_valid = state == WRITE_REQ;
+  pins->wreq_addr = Address(TEST_MODEL_REG_DST_LO);
+  pins->wreq_len = TEST_MODEL_BURST_BEATS;
+  pins->wdat_valid = state == WRITE_DATA;
+  memcpy(pins->wdat_data, buffer[beat % TEST_MODEL_BURST_BEATS], FLETCHER_COSIM_BUS_DATA_BYTES);
+  pins->wdat_strobe = ~0ull;
+  pins->wdat_last = beat == TEST_MODEL_BURST_BEATS - 1;
+
+  last = *pins;
+}
+
+void cosimModelTick(void) {
+  if (last.reset) {
+    Reset();
+    return;
+  }
+
+  // MMIO slave
+  if (last.mmio_awvalid && last.mmio_awready) {
+    aw_done = 1;
+    aw_addr = last.mmio_awaddr;
+  }
+  if (last.mmio_wvalid && last.mmio_wready) {
+    w_done = 1;
+    w_data = last.mmio_wdata;
+  }
+  if (last.mmio_bvalid && last.mmio_bready) {
+    b_pending = 0;
+  }
+  if (aw_done && w_done) {
+    uint32_t reg = aw_addr / sizeof(uint32_t);
+    if (reg < TEST_MODEL_NUM_REGS) {
+      regs[reg] = w_data;
+    }
+    if ((reg == TEST_MODEL_REG_CONTROL) && (w_data & TEST_MODEL_CONTROL_START) && (state == IDLE)) {
+      regs[TEST_MODEL_REG_STATUS] = 0;
+      state = READ_REQ;
+    }
+    aw_done = 0;
+    w_done = 0;
+    b_pending = 1;
+  }
+  if (last.mmio_rvalid && last.mmio_rready) {
+    r_pending = 0;
+  }
+  if (last.mmio_arvalid && last.mmio_arready) {
+    uint32_t reg = last.mmio_araddr / sizeof(uint32_t);
+    r_data = reg < TEST_MODEL_NUM_REGS ? regs[reg] : 0;
+    r_pending = 1;
+  }
+
+  // Copy engine
+  switch (state) {
+    case IDLE:
+      break;
+    case READ_REQ:
+      if (last.rreq_valid && last.rreq_ready) {
+        beat = 0;
+        state = READ_DATA;
+      }
+      break;
+    case READ_DATA:
+      if (last.rdat_valid && last.rdat_ready) {
+        memcpy(buffer[beat % TEST_MODEL_BURST_BEATS], last.rdat_data, FLETCHER_COSIM_BUS_DATA_BYTES);
+        beat++;
+        if (last.rdat_last) {
+          state = WRITE_REQ;
+        }
+      }
+      break;
+    case WRITE_REQ:
+      if (last.wreq_valid && last.wreq_ready) {
+        beat = 0;
+        state = WRITE_DATA;
+      }
+      break;
+    case WRITE_DATA:
+      if (last.wdat_valid && last.wdat_ready) {
+        if (last.wdat_last) {
+          regs[TEST_MODEL_REG_STATUS] = TEST_MODEL_STATUS_DONE;
+          beat = 0;
+          state = IDLE;
+        } else {
+          beat++;
+        }
+      }
+      break;
+  }
+}
+
+void cosimModelTerminate(void) {
+  Reset();
+}
@@ -0,0 +1,35 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/// Number of MMIO registers of the test model.
+#define TEST_MODEL_NUM_REGS 8
+
+/// Control register. Writing TEST_MODEL_CONTROL_START starts a copy.
+#define TEST_MODEL_REG_CONTROL 0
+/// Status register. Holds TEST_MODEL_STATUS_DONE once a copy has completed.
+#define TEST_MODEL_REG_STATUS 1
+/// Source address registers.
+#define TEST_MODEL_REG_SRC_LO 2
+/// Destination address registers.
+#define TEST_MODEL_REG_DST_LO 4
+/// Register without any function.
+#define TEST_MODEL_REG_SCRATCH 6
+
+#define TEST_MODEL_CONTROL_START 1u
+#define TEST_MODEL_STATUS_DONE 1u
+
+/// Number of beats of the read and write burst of a copy.
+#define TEST_MODEL_BURST_BEATS 2
@@ -0,0 +1,146 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Simulation model library for the Fletcher co-simulation platform, wrapping a Verilator model of a Mantle.
+//
+// Define COSIM_BUS_READ and/or COSIM_BUS_WRITE depending on the bus masters of the Mantle. If the top-level module is
+// not named Mantle, define COSIM_MODEL_CLASS and COSIM_MODEL_HEADER accordingly. See the README of the platform for
+// build instructions.
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include <verilated.h>
+
+extern "C" {
+#include "fletcher_cosim.h"
+}
+
+#ifndef COSIM_MODEL_CLASS
+#define COSIM_MODEL_CLASS VMantle
+#define COSIM_MODEL_HEADER "VMantle.h"
+#endif
+
+#include COSIM_MODEL_HEADER
+
+namespace {
+
+std::unique_ptr<COSIM_MODEL_CLASS> top;
+
+/// @brief Copy a bus data vector from the pins to a wide Verilator signal.
+template<typename W>
+void ToWide(W &wide, const uint8_t *data) {
+  for (size_t i = 0; i < FLETCHER_COSIM_BUS_DATA_BYTES / 4; i++) {
+    uint32_t word;
+    memcpy(&word, data + 4 * i, 4);
+    wide[i] = word;
+  }
+}
+
+/// @brief Copy a wide Verilator signal to a bus data vector of the pins.
+template<typename W>
+void FromWide(uint8_t *data, const W &wide) {
+  for (size_t i = 0; i < FLETCHER_COSIM_BUS_DATA_BYTES / 4; i++) {
+    uint32_t word = wide[i];
+    memcpy(data + 4 * i, &word, 4);
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+int cosimModelInit(const char *args) {
+  (void) args;
+  top = std::make_unique<COSIM_MODEL_CLASS>();
+  top->kcd_clk = 0;
+  top->bcd_clk = 0;
+  top->eval();
+  return 0;
+}
+
+void cosimModelEval(CosimPins *pins) {
+  // Inputs
+  top->kcd_reset = pins->reset;
+  top->bcd_reset = pins->reset;
+
+  top->mmio_awvalid = pins->mmio_awvalid;
+  top->mmio_awaddr = pins->mmio_awaddr;
+  top->mmio_wvalid = pins->mmio_wvalid;
+  top->mmio_wdata = pins->mmio_wdata;
+  top->mmio_wstrb = pins->mmio_wstrb;
+  top->mmio_bready = pins->mmio_bready;
+  top->mmio_arvalid = pins->mmio_arvalid;
+  top->mmio_araddr = pins->mmio_araddr;
+  top->mmio_rready = pins->mmio_rready;
+
+#ifdef COSIM_BUS_READ
+  top->rd_mst_rreq_ready = pins->rreq_ready;
+  top->rd_mst_rdat_valid = pins->rdat_valid;
+  ToWide(top->rd_mst_rdat_data, pins->rdat_data);
+  top->rd_mst_rdat_last = pins->rdat_last;
+#endif
+
+#ifdef COSIM_BUS_WRITE
+  top->wr_mst_wreq_ready = pins->wreq_ready;
+  top->wr_mst_wdat_ready = pins->wdat_ready;
+#endif
+
+  top->eval();
+
+  // Outputs
+  pins->mmio_awready = top->mmio_awready;
+  pins->mmio_wready = top->mmio_wready;
+  pins->mmio_bvalid = top->mmio_bvalid;
+  pins->mmio_bresp = top->mmio_bresp;
+  pins->mmio_arready = top->mmio_arready;
+  pins->mmio_rvalid = top->mmio_rvalid;
+  pins->mmio_rdata = top->mmio_rdata;
+  pins->mmio_rresp = top->mmio_rresp;
+
+#ifdef COSIM_BUS_READ
+  pins->rreq_valid = top->rd_mst_rreq_valid;
+  pins->rreq_addr = top->rd_mst_rreq_addr;
+  pins->rreq_len = top->rd_mst_rreq_len;
+  pins->rdat_ready = top->rd_mst_rdat_ready;
+#endif
+
+#ifdef COSIM_BUS_WRITE
+  pins->wreq_valid = top->wr_mst_wreq_valid;
+  pins->wreq_addr = top->wr_mst_wreq_addr;
+  pins->wreq_len = top->wr_mst_wreq_len;
+  pins->wdat_valid = top->wr_mst_wdat_valid;
+  FromWide(pins->wdat_data, top->wr_mst_wdat_data);
+  pins->wdat_strobe = top->wr_mst_wdat_strobe;
+  pins->wdat_last = top->wr_mst_wdat_last;
+#endif
+}
+
+void cosimModelTick(void) {
+  // Both clock domains are driven by the same clock.
+  top->kcd_clk = 1;
+  top->bcd_clk = 1;
+  top->eval();
+  top->kcd_clk = 0;
+  top->bcd_clk = 0;
+  top->eval();
+}
+
+void cosimModelTerminate(void) {
+  top->final();
+  top.reset();
+}
+
+}
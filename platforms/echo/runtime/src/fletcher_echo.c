@@ -24,6 +24,9 @@
 
 da_t buffer_ptr = 0x0;
 InitOptions options = {0};
+freg_t mmio_regs[FLETCHER_ECHO_NUM_REGS];
+uint32_t device_region = FLETCHER_REG_MM_DEFAULT_REGION;
+static int device_huge_pages = 0;
 
 fstatus_t platformGetName(char *name, size_t size) {
   size_t len = strlen(FLETCHER_PLATFORM_NAME);
@@ -40,17 +43,41 @@ fstatus_t platformInit(void *arg) {
   if (arg != NULL) {
     options = *(InitOptions *) arg;
   }
+  for (int i = 0; i < FLETCHER_ECHO_NUM_REGS; i++) {
+    mmio_regs[i] = FLETCHER_ECHO_REG_DEFAULT;
+  }
+  device_region = FLETCHER_REG_MM_DEFAULT_REGION;
+  device_huge_pages = 0;
   echo_print("[ECHO] Initializing platform.       Arguments @ [host] %016lX.\n", (unsigned long) arg);
   return FLETCHER_STATUS_OK;
 }
 
+fstatus_t platformGetMmioBase(volatile freg_t **base, uint64_t *num_regs) {
+  if (!options.map_mmio) {
+    return FLETCHER_STATUS_ERROR;
+  }
+  *base = mmio_regs;
+  *num_regs = FLETCHER_ECHO_NUM_REGS;
+  echo_print("[ECHO] Mapping MMIO registers.      [host] 0x%016lX (%lu registers).\n",
+             (uint64_t) *base,
+             *num_regs);
+  return FLETCHER_STATUS_OK;
+}
+
 fstatus_t platformWriteMMIO(uint64_t offset, uint32_t value) {
+  if (offset < FLETCHER_ECHO_NUM_REGS) {
+    mmio_regs[offset] = value;
+  }
   echo_print("[ECHO] Writing MMIO register.       %04lu <= 0x%08X\n", offset, value);
   return FLETCHER_STATUS_OK;
 }
 
 fstatus_t platformReadMMIO(uint64_t offset, uint32_t *value) {
-  *value = 0xDEADBEEF;
+  if (offset < FLETCHER_ECHO_NUM_REGS) {
+    *value = mmio_regs[offset];
+  } else {
+    *value = FLETCHER_ECHO_REG_DEFAULT;
+  }
   echo_print("[ECHO] Reading MMIO register.       %04lu => 0x%08X\n", offset, *value);
   return FLETCHER_STATUS_OK;
 }
@@ -76,6 +103,26 @@ fstatus_t platformTerminate(void *arg) {
   return FLETCHER_STATUS_OK;
 }
 
+fstatus_t platformSetDeviceRegion(uint32_t region) {
+  echo_print("[ECHO] Selecting device region.     [region] %u.\n", region);
+  device_region = region;
+  return FLETCHER_STATUS_OK;
+}
+
+uint32_t echoGetDeviceRegion(void) {
+  return device_region;
+}
+
+fstatus_t platformSetDeviceHugePages(int enable) {
+  echo_print("[ECHO] Setting huge page hint.      [enable] %d.\n", enable);
+  device_huge_pages = enable;
+  return FLETCHER_STATUS_OK;
+}
+
+int echoGetDeviceHugePages(void) {
+  return device_huge_pages;
+}
+
 fstatus_t platformDeviceMalloc(da_t *device_address, int64_t size) {
   *device_address = (uint64_t) malloc((size_t) size);
   echo_print("[ECHO] Allocating device memory.    [device] 0x%016lX (%10lu bytes).\n", (uint64_t) device_address, size);
@@ -18,8 +18,16 @@
 
 #define FLETCHER_PLATFORM_NAME "echo"
 
+/// Number of registers in the echo register file.
+#define FLETCHER_ECHO_NUM_REGS 1024
+
+/// Value of registers that were never written.
+#define FLETCHER_ECHO_REG_DEFAULT 0xDEADBEEF
+
 typedef struct {
   int quiet;
+  /// Expose the register file through platformGetMmioBase.
+  int map_mmio;
 } InitOptions;
 
 /// @brief Store the platform name in a buffer of size /p size pointed to by /p name.
@@ -35,6 +43,45 @@ fstatus_t platformWriteMMIO(uint64_t offset, uint32_t value);
 /// @brief Read MMIO register \p offset into \p value
 fstatus_t platformReadMMIO(uint64_t offset, uint32_t *value);
 
+/**
+ * @brief Obtain the host address of the memory-mapped MMIO register file.
+ *
+ * This function is optional for platforms. If the register file can be mapped into the host address space, the
+ * run-time may access it directly rather than through platformWriteMMIO and platformReadMMIO.
+ *
+ * @param base                  Pointer to store the host address of register 0 at.
+ * @param num_regs              Pointer to store the number of mapped registers at.
+ * @return                      FLETCHER_STATUS_OK if successful, FLETCHER_STATUS_ERROR otherwise.
+ */
+fstatus_t platformGetMmioBase(volatile freg_t **base, uint64_t *num_regs);
+
+/**
+ * @brief Select the device memory region in which subsequent allocations are placed.
+ *
+ * This function is optional for platforms. Platforms with multiple memory channels place the buffers of every channel
+ * in a separate region. Memory channel N uses region FLETCHER_REG_MM_DEFAULT_REGION + N.
+ *
+ * @param region                The device memory region.
+ * @return                      FLETCHER_STATUS_OK if successful, FLETCHER_STATUS_ERROR otherwise.
+ */
+fstatus_t platformSetDeviceRegion(uint32_t region);
+
+/// @brief Return the device memory region selected by platformSetDeviceRegion(). Not part of the platform interface.
+uint32_t echoGetDeviceRegion(void);
+
+/**
+ * @brief Map subsequent device memory allocations with huge pages where possible.
+ *
+ * This function is optional for platforms. Huge pages reduce the number of address translations for large buffers.
+ *
+ * @param enable                Nonzero to enable the hint, zero to disable it.
+ * @return                      FLETCHER_STATUS_OK if successful, FLETCHER_STATUS_ERROR otherwise.
+ */
+fstatus_t platformSetDeviceHugePages(int enable);
+
+/// @brief Return the hint set by platformSetDeviceHugePages(). Not part of the platform interface.
+int echoGetDeviceHugePages(void);
+
 /// @brief Copy \p size bytes from host address \p host_source to device address \p device_destination.
 fstatus_t platformCopyHostToDevice(const uint8_t *host_source, da_t device_destination, int64_t size);
 
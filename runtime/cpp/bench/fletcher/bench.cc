@@ -0,0 +1,455 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * Fletcher run-time micro-benchmarks
+ *
+ * Measures the latency and throughput of the host side of the run-time on any platform, such that changes in the
+ * run-time or the platform libraries that affect performance can be spotted by comparing reports.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <fletcher/api.h>
+
+#include "fletcher_echo.h"
+
+namespace {
+
+using fletcher::Status;
+using fletcher::Timer;
+
+/// @brief Benchmark options.
+struct Options {
+  std::string platform;
+  std::string format = "csv";
+  std::string output;
+  std::vector<std::string> benches = {"mmio", "malloc", "copy", "enable", "launch"};
+  size_t iterations = 100;
+  size_t mmio_iterations = 10000;
+  uint64_t min_size = 64;
+  uint64_t max_size = 64 * 1024 * 1024;
+  uint64_t copy_budget = 256 * 1024 * 1024;
+  int max_width = 64;
+  int64_t num_rows = 1024;
+};
+
+/// @brief The result of one benchmark for one parameter value.
+struct Result {
+  Result(std::string bench, std::string param, uint64_t value, uint64_t bytes = 0)
+      : bench(std::move(bench)), param(std::move(param)), value(value), bytes(bytes) {}
+
+  std::string bench;
+  std::string param;
+  uint64_t value;
+  /// Number of bytes processed per sample, or 0 for latency-only benchmarks.
+  uint64_t bytes;
+  std::vector<double> samples;
+
+  /// @brief Return the sample at percentile \p p, using the nearest-rank method. Requires sorted samples.
+  double percentile(double p) const {
+    if (samples.empty()) return 0.0;
+    auto rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    return samples[std::min(samples.size() - 1, rank > 0 ? rank - 1 : 0)];
+  }
+
+  double mean() const {
+    if (samples.empty()) return 0.0;
+    return std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+  }
+
+  /// @brief Return the throughput at the median in bytes per second.
+  double throughput() const {
+    double p50 = percentile(50);
+    return (bytes > 0) && (p50 > 0.0) ? bytes / p50 : 0.0;
+  }
+};
+
+void PrintUsage(const char *exe) {
+  std::cerr << "Usage: " << exe << " [options]\n"
+            << "  -p, --platform <name>      Platform to benchmark. Autodetected if omitted.\n"
+            << "  -b, --bench <list>         Comma-separated benchmarks: mmio,malloc,copy,enable,launch\n"
+            << "  -n, --iterations <n>       Samples per measurement. Default: 100\n"
+            << "      --mmio-iterations <n>  Samples per MMIO measurement. Default: 10000\n"
+            << "      --min-size <bytes>     Smallest buffer size. Default: 64\n"
+            << "      --max-size <bytes>     Largest buffer size. Default: 67108864\n"
+            << "      --max-width <n>        Largest number of columns for the enable benchmark. Default: 64\n"
+            << "      --rows <n>             Rows per RecordBatch for the enable and launch benchmarks. Default: 1024\n"
+            << "  -f, --format <csv|json>    Output format. Default: csv\n"
+            << "  -o, --output <file>        Output file. Default: stdout\n";
+}
+
+std::vector<std::string> Split(const std::string &str, char delim) {
+  std::vector<std::string> result;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, delim)) {
+    if (!item.empty()) {
+      result.push_back(item);
+    }
+  }
+  return result;
+}
+
+bool ParseArgs(int argc, char **argv, Options *opts) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if ((arg == "-h") || (arg == "--help")) {
+      return false;
+    }
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return false;
+    }
+    std::string val = argv[++i];
+    if ((arg == "-p") || (arg == "--platform")) {
+      opts->platform = val;
+    } else if ((arg == "-b") || (arg == "--bench")) {
+      opts->benches = Split(val, ',');
+    } else if ((arg == "-n") || (arg == "--iterations")) {
+      opts->iterations = std::strtoull(val.c_str(), nullptr, 10);
+    } else if (arg == "--mmio-iterations") {
+      opts->mmio_iterations = std::strtoull(val.c_str(), nullptr, 10);
+    } else if (arg == "--min-size") {
+      opts->min_size = std::strtoull(val.c_str(), nullptr, 10);
+    } else if (arg == "--max-size") {
+      opts->max_size = std::strtoull(val.c_str(), nullptr, 10);
+    } else if (arg == "--max-width") {
+      opts->max_width = std::atoi(val.c_str());
+    } else if (arg == "--rows") {
+      opts->num_rows = std::strtoll(val.c_str(), nullptr, 10);
+    } else if ((arg == "-f") || (arg == "--format")) {
+      opts->format = val;
+    } else if ((arg == "-o") || (arg == "--output")) {
+      opts->output = val;
+    } else {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+  if ((opts->format != "csv") && (opts->format != "json")) {
+    std::cerr << "Unknown format " << opts->format << std::endl;
+    return false;
+  }
+  if ((opts->iterations == 0) || (opts->mmio_iterations == 0) || (opts->min_size == 0)
+      || (opts->max_width < 1) || (opts->num_rows < 1)) {
+    std::cerr << "Iterations, sizes, widths and rows must be positive." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// @brief Return a RecordBatch with \p width uint64 columns of \p num_rows rows.
+std::shared_ptr<arrow::RecordBatch> GetRecordBatch(int width, int64_t num_rows, bool nullable) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (int c = 0; c < width; c++) {
+    arrow::UInt64Builder builder;
+    for (int64_t i = 0; i < num_rows; i++) {
+      if (!builder.Append(static_cast<uint64_t>(i)).ok()) {
+        return nullptr;
+      }
+    }
+    std::shared_ptr<arrow::Array> array;
+    if (!builder.Finish(&array).ok()) {
+      return nullptr;
+    }
+    fields.push_back(arrow::field("c" + std::to_string(c), arrow::uint64(), nullable));
+    arrays.push_back(array);
+  }
+  return arrow::RecordBatch::Make(arrow::schema(fields), num_rows, arrays);
+}
+
+Status BenchMMIO(const std::shared_ptr<fletcher::Platform> &platform, const Options &opts,
+                 std::vector<Result> *results) {
+  Timer t;
+  Result write{"mmio_write", "reg", FLETCHER_REG_SCHEMA};
+  Result read{"mmio_read", "reg", FLETCHER_REG_SCHEMA};
+  Result read64{"mmio_read64", "reg", FLETCHER_REG_RETURN0};
+  uint32_t value = 0;
+  uint64_t value64 = 0;
+  for (size_t i = 0; i < opts.mmio_iterations; i++) {
+    t.start();
+    auto status = platform->WriteMMIO(FLETCHER_REG_SCHEMA, static_cast<uint32_t>(i));
+    t.stop();
+    if (!status.ok()) return status;
+    write.samples.push_back(t.seconds());
+
+    t.start();
+    status = platform->ReadMMIO(FLETCHER_REG_SCHEMA, &value);
+    t.stop();
+    if (!status.ok()) return status;
+    read.samples.push_back(t.seconds());
+
+    t.start();
+    status = platform->ReadMMIO64(FLETCHER_REG_RETURN0, &value64);
+    t.stop();
+    if (!status.ok()) return status;
+    read64.samples.push_back(t.seconds());
+  }
+  results->push_back(write);
+  results->push_back(read);
+  results->push_back(read64);
+  return Status::OK();
+}
+
+Status BenchMalloc(const std::shared_ptr<fletcher::Platform> &platform, const Options &opts,
+                   std::vector<Result> *results) {
+  Timer t;
+  for (uint64_t size = opts.min_size; size <= opts.max_size; size *= 4) {
+    Result malloc{"device_malloc", "bytes", size};
+    Result free{"device_free", "bytes", size};
+    for (size_t i = 0; i < opts.iterations; i++) {
+      da_t addr = D_NULLPTR;
+      t.start();
+      auto status = platform->DeviceMalloc(&addr, size);
+      t.stop();
+      if (!status.ok()) return status;
+      malloc.samples.push_back(t.seconds());
+
+      t.start();
+      status = platform->DeviceFree(addr);
+      t.stop();
+      if (!status.ok()) return status;
+      free.samples.push_back(t.seconds());
+    }
+    results->push_back(malloc);
+    results->push_back(free);
+  }
+  return Status::OK();
+}
+
+Status BenchCopy(const std::shared_ptr<fletcher::Platform> &platform, const Options &opts,
+                 std::vector<Result> *results) {
+  Timer t;
+  for (uint64_t size = opts.min_size; size <= opts.max_size; size *= 2) {
+    // Limit the total number of bytes copied for large sizes, but take a few samples at least.
+    size_t iterations = std::min<size_t>(opts.iterations, std::max<uint64_t>(5, opts.copy_budget / size));
+    Result h2d{"copy_h2d", "bytes", size, size};
+    Result d2h{"copy_d2h", "bytes", size, size};
+    std::vector<uint8_t> host(size, 0xA5);
+    da_t dev = D_NULLPTR;
+    auto status = platform->DeviceMalloc(&dev, size);
+    if (!status.ok()) return status;
+    for (size_t i = 0; i < iterations; i++) {
+      t.start();
+      status = platform->CopyHostToDevice(host.data(), dev, size);
+      t.stop();
+      if (!status.ok()) break;
+      h2d.samples.push_back(t.seconds());
+
+      t.start();
+      status = platform->CopyDeviceToHost(dev, host.data(), size);
+      t.stop();
+      if (!status.ok()) break;
+      d2h.samples.push_back(t.seconds());
+    }
+    platform->DeviceFree(dev);
+    if (!status.ok()) return status;
+    results->push_back(h2d);
+    results->push_back(d2h);
+  }
+  return Status::OK();
+}
+
+Status BenchEnable(const std::shared_ptr<fletcher::Platform> &platform, const Options &opts,
+                   std::vector<Result> *results) {
+  Timer t;
+  // Nullable columns have a validity buffer, doubling the number of buffers for the same width.
+  for (bool nullable : {false, true}) {
+    for (int width = 1; width <= opts.max_width; width *= 2) {
+      auto batch = GetRecordBatch(width, opts.num_rows, nullable);
+      if (batch == nullptr) {
+        return Status::ERROR("Could not create RecordBatch.");
+      }
+      Result enable{"context_enable", nullable ? "nullable_columns" : "columns", static_cast<uint64_t>(width)};
+      for (size_t i = 0; i < opts.iterations; i++) {
+        std::shared_ptr<fletcher::Context> context;
+        auto status = fletcher::Context::Make(&context, platform);
+        if (!status.ok()) return status;
+        status = context->QueueRecordBatch(batch);
+        if (!status.ok()) return status;
+        enable.bytes = context->GetQueueSize();
+        t.start();
+        status = context->Enable();
+        t.stop();
+        if (!status.ok()) return status;
+        enable.samples.push_back(t.seconds());
+      }
+      results->push_back(enable);
+    }
+  }
+  return Status::OK();
+}
+
+Status BenchLaunch(const std::shared_ptr<fletcher::Platform> &platform, const Options &opts,
+                   std::vector<Result> *results) {
+  Timer t;
+  auto batch = GetRecordBatch(1, opts.num_rows, false);
+  if (batch == nullptr) {
+    return Status::ERROR("Could not create RecordBatch.");
+  }
+  std::shared_ptr<fletcher::Context> context;
+  auto status = fletcher::Context::Make(&context, platform);
+  if (!status.ok()) return status;
+  status = context->QueueRecordBatch(batch);
+  if (!status.ok()) return status;
+  status = context->Enable();
+  if (!status.ok()) return status;
+
+  fletcher::Kernel kernel(context);
+  Result launch{"kernel_launch", "rows", static_cast<uint64_t>(opts.num_rows)};
+  for (size_t i = 0; i < opts.iterations; i++) {
+    uint32_t ret0 = 0, ret1 = 0;
+    t.start();
+    status = kernel.Reset();
+    if (status.ok()) status = kernel.SetRange(0, 0, static_cast<int32_t>(opts.num_rows));
+    if (status.ok()) status = kernel.Start();
+    if (status.ok()) status = kernel.WaitForFinish();
+    if (status.ok()) status = kernel.GetReturn(&ret0, &ret1);
+    t.stop();
+    if (!status.ok()) return status;
+    launch.samples.push_back(t.seconds());
+  }
+  results->push_back(launch);
+  return Status::OK();
+}
+
+void WriteCSV(std::ostream &os, const std::string &platform, const std::vector<Result> &results) {
+  os << "platform,bench,param,value,samples,min,p50,p90,p99,max,mean,bytes_per_second\n";
+  os << std::setprecision(9);
+  for (const auto &r : results) {
+    os << platform << "," << r.bench << "," << r.param << "," << r.value << "," << r.samples.size() << ","
+       << r.percentile(0) << "," << r.percentile(50) << "," << r.percentile(90) << "," << r.percentile(99) << ","
+       << r.percentile(100) << "," << r.mean() << "," << r.throughput() << "\n";
+  }
+}
+
+void WriteJSON(std::ostream &os, const std::string &platform, const std::vector<Result> &results) {
+  os << std::setprecision(9);
+  os << "{\n  \"platform\": \"" << platform << "\",\n  \"results\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto &r = results[i];
+    os << (i > 0 ? "," : "") << "\n    {"
+       << "\"bench\": \"" << r.bench << "\", "
+       << "\"param\": \"" << r.param << "\", "
+       << "\"value\": " << r.value << ", "
+       << "\"samples\": " << r.samples.size() << ", "
+       << "\"min\": " << r.percentile(0) << ", "
+       << "\"p50\": " << r.percentile(50) << ", "
+       << "\"p90\": " << r.percentile(90) << ", "
+       << "\"p99\": " << r.percentile(99) << ", "
+       << "\"max\": " << r.percentile(100) << ", "
+       << "\"mean\": " << r.mean() << ", "
+       << "\"bytes_per_second\": " << r.throughput() << "}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options opts;
+  if (!ParseArgs(argc, argv, &opts)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::shared_ptr<fletcher::Platform> platform;
+  Status status;
+  if (opts.platform.empty()) {
+    status = fletcher::Platform::Make(&platform);
+  } else {
+    status = fletcher::Platform::Make(opts.platform, &platform, false);
+  }
+  if (!status.ok()) {
+    std::cerr << "Could not create platform." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Prevent the echo platform from printing every call.
+  InitOptions echo_opts = {1, 0};
+  if (platform->name() == "echo") {
+    platform->init_data = &echo_opts;
+  }
+  status = platform->Init();
+  if (!status.ok()) {
+    std::cerr << "Could not initialize platform." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The run-time logs to stdout. Divert it to stderr while benchmarking, such that stdout only holds the report.
+  auto cout_buf = std::cout.rdbuf(std::cerr.rdbuf());
+
+  std::vector<Result> results;
+  for (const auto &b : opts.benches) {
+    std::cerr << "Running " << b << " benchmark..." << std::endl;
+    if (b == "mmio") {
+      status = BenchMMIO(platform, opts, &results);
+    } else if (b == "malloc") {
+      status = BenchMalloc(platform, opts, &results);
+    } else if (b == "copy") {
+      status = BenchCopy(platform, opts, &results);
+    } else if (b == "enable") {
+      status = BenchEnable(platform, opts, &results);
+    } else if (b == "launch") {
+      status = BenchLaunch(platform, opts, &results);
+    } else {
+      status = fletcher::Status::ERROR("Unknown benchmark.");
+    }
+    if (!status.ok()) {
+      std::cerr << "Benchmark " << b << " failed: " << status.message << std::endl;
+      std::cout.rdbuf(cout_buf);
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout.rdbuf(cout_buf);
+
+  for (auto &r : results) {
+    std::sort(r.samples.begin(), r.samples.end());
+  }
+
+  std::ofstream file;
+  if (!opts.output.empty()) {
+    file.open(opts.output);
+    if (!file.good()) {
+      std::cerr << "Could not open " << opts.output << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::ostream &os = opts.output.empty() ? std::cout : file;
+  if (opts.format == "json") {
+    WriteJSON(os, platform->name(), results);
+  } else {
+    WriteCSV(os, platform->name(), results);
+  }
+
+  platform->Terminate();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,297 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * Fletcher bus benchmarks
+ *
+ * Drives the BusReadBenchmarker and BusWriteBenchmarker instances of a design to measure the bandwidth and latency of
+ * the device memory interface, for a range of burst lengths, numbers of outstanding bursts and address patterns.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <fletcher/api.h>
+
+#include "fletcher_echo.h"
+
+namespace {
+
+using fletcher::Status;
+using fletcher::BusBenchmarker;
+using fletcher::BusPattern;
+
+/// @brief Benchmark options.
+struct Options {
+  std::string platform;
+  std::string regmap;
+  std::vector<std::string> names;
+  /// Index of the first register of an instance that is not in the register map, or -1.
+  int64_t base_reg = -1;
+  uint64_t num_regs = 13;
+  std::string output;
+  fletcher::BusBenchmarkSweep sweep;
+  BusBenchmarker::Options bench;
+  bool allocate = true;
+};
+
+void PrintUsage(const char *exe) {
+  std::cerr << "Usage: " << exe << " [options]\n"
+            << "  -p, --platform <name>       Platform to benchmark. Autodetected if omitted.\n"
+            << "  -r, --regmap <file>         Register map header generated by fletchgen --regmap.\n"
+            << "  -n, --names <list>          Comma-separated names of the instances to run. Default: all\n"
+            << "      --base-reg <index>      First register of an instance with successive registers, instead of a\n"
+            << "                              register map.\n"
+            << "      --num-regs <n>          Number of successive registers of that instance. Default: 13\n"
+            << "      --patterns <list>       Comma-separated patterns: sequential,strided,random.\n"
+            << "                              Default: sequential,random\n"
+            << "      --burst-lengths <list>  Comma-separated burst lengths in beats. Default: 1,2,4,8,16,32,64\n"
+            << "      --outstanding <list>    Comma-separated maximum outstanding bursts, 0 for no limit. Default: 0\n"
+            << "      --strides <list>        Comma-separated strides in bytes for the strided pattern. Default: 4096\n"
+            << "      --bytes <n>             Address range of bandwidth runs in bytes. Default: 67108864\n"
+            << "      --region-size <n>       Address range of the random pattern in bytes. Default: 67108864\n"
+            << "      --base-addr <addr>      Device address of the range. Allocated on the device if omitted.\n"
+            << "      --latency <0|1>         Measure the latency of a single burst. Default: 1\n"
+            << "      --clock-mhz <f>         Clock frequency of the benchmarkers. Default: 250\n"
+            << "      --bus-bytes <n>         Width of the data bus in bytes. Default: 64\n"
+            << "  -o, --output <file>         Output CSV file. Default: stdout\n";
+}
+
+std::vector<std::string> Split(const std::string &str, char delim) {
+  std::vector<std::string> result;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, delim)) {
+    if (!item.empty()) {
+      result.push_back(item);
+    }
+  }
+  return result;
+}
+
+std::vector<uint32_t> SplitNumbers(const std::string &str) {
+  std::vector<uint32_t> result;
+  for (const auto &s : Split(str, ',')) {
+    result.push_back(static_cast<uint32_t>(std::strtoul(s.c_str(), nullptr, 0)));
+  }
+  return result;
+}
+
+bool ParsePatterns(const std::string &str, std::vector<BusPattern> *patterns) {
+  patterns->clear();
+  for (const auto &p : Split(str, ',')) {
+    if (p == "sequential") {
+      patterns->push_back(BusPattern::SEQUENTIAL);
+    } else if (p == "strided") {
+      patterns->push_back(BusPattern::STRIDED);
+    } else if (p == "random") {
+      patterns->push_back(BusPattern::RANDOM);
+    } else {
+      std::cerr << "Unknown pattern " << p << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParseArgs(int argc, char **argv, Options *opts) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if ((arg == "-h") || (arg == "--help")) {
+      return false;
+    }
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return false;
+    }
+    std::string val = argv[++i];
+    if ((arg == "-p") || (arg == "--platform")) {
+      opts->platform = val;
+    } else if ((arg == "-r") || (arg == "--regmap")) {
+      opts->regmap = val;
+    } else if ((arg == "-n") || (arg == "--names")) {
+      opts->names = Split(val, ',');
+    } else if (arg == "--base-reg") {
+      opts->base_reg = std::strtoll(val.c_str(), nullptr, 0);
+    } else if (arg == "--num-regs") {
+      opts->num_regs = std::strtoull(val.c_str(), nullptr, 0);
+    } else if (arg == "--patterns") {
+      if (!ParsePatterns(val, &opts->sweep.patterns)) return false;
+    } else if (arg == "--burst-lengths") {
+      opts->sweep.burst_lengths = SplitNumbers(val);
+    } else if (arg == "--outstanding") {
+      opts->sweep.max_outstanding = SplitNumbers(val);
+    } else if (arg == "--strides") {
+      opts->sweep.strides = SplitNumbers(val);
+    } else if (arg == "--bytes") {
+      opts->sweep.bytes = std::strtoull(val.c_str(), nullptr, 0);
+    } else if (arg == "--region-size") {
+      opts->sweep.region_size = std::strtoull(val.c_str(), nullptr, 0);
+    } else if (arg == "--base-addr") {
+      opts->sweep.base_addr = std::strtoull(val.c_str(), nullptr, 0);
+      opts->allocate = false;
+    } else if (arg == "--latency") {
+      opts->sweep.latency = std::atoi(val.c_str()) != 0;
+    } else if (arg == "--clock-mhz") {
+      opts->bench.clock_hz = std::strtod(val.c_str(), nullptr) * 1e6;
+    } else if (arg == "--bus-bytes") {
+      opts->bench.bus_data_bytes = static_cast<uint32_t>(std::strtoul(val.c_str(), nullptr, 0));
+    } else if ((arg == "-o") || (arg == "--output")) {
+      opts->output = val;
+    } else {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+  if (opts->regmap.empty() && (opts->base_reg < 0)) {
+    std::cerr << "Either a register map or a base register is required." << std::endl;
+    return false;
+  }
+  if (opts->sweep.burst_lengths.empty() || opts->sweep.max_outstanding.empty() || opts->sweep.strides.empty()
+      || (std::count(opts->sweep.burst_lengths.begin(), opts->sweep.burst_lengths.end(), 0u) > 0)
+      || (opts->sweep.bytes == 0) || (opts->bench.clock_hz <= 0.0) || (opts->bench.bus_data_bytes == 0)) {
+    std::cerr << "Burst lengths, sizes, clock frequency and bus width must be positive." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// @brief Find the benchmarkers selected by the options.
+Status GetBenchmarkers(const std::shared_ptr<fletcher::Platform> &platform, const Options &opts,
+                       std::vector<std::shared_ptr<BusBenchmarker>> *benchmarkers) {
+  if (opts.base_reg >= 0) {
+    std::shared_ptr<BusBenchmarker> benchmarker;
+    auto name = opts.names.empty() ? "BENCH" : opts.names.front();
+    auto regs = fletcher::BusBenchmarkerRegisters::Contiguous(static_cast<uint64_t>(opts.base_reg), opts.num_regs);
+    auto status = BusBenchmarker::Make(&benchmarker, platform, name, regs, opts.bench);
+    if (!status.ok()) return status;
+    benchmarkers->push_back(benchmarker);
+    return Status::OK();
+  }
+
+  std::ifstream file(opts.regmap);
+  if (!file.good()) {
+    return Status::ERROR("Could not open " + opts.regmap);
+  }
+  std::stringstream source;
+  source << file.rdbuf();
+  std::map<std::string, uint64_t> regmap;
+  auto status = BusBenchmarker::ParseRegisterMap(source.str(), &regmap);
+  if (!status.ok()) return status;
+
+  std::vector<std::shared_ptr<BusBenchmarker>> all;
+  status = BusBenchmarker::Discover(&all, platform, regmap, opts.bench);
+  if (!status.ok()) return status;
+  for (const auto &b : all) {
+    if (opts.names.empty() || (std::find(opts.names.begin(), opts.names.end(), b->name()) != opts.names.end())) {
+      benchmarkers->push_back(b);
+    }
+  }
+  if (benchmarkers->empty()) {
+    return Status::ERROR("No benchmarkers found in " + opts.regmap);
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options opts;
+  if (!ParseArgs(argc, argv, &opts)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::shared_ptr<fletcher::Platform> platform;
+  Status status;
+  if (opts.platform.empty()) {
+    status = fletcher::Platform::Make(&platform);
+  } else {
+    status = fletcher::Platform::Make(opts.platform, &platform, false);
+  }
+  if (!status.ok()) {
+    std::cerr << "Could not create platform." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Prevent the echo platform from printing every call.
+  InitOptions echo_opts = {1, 0};
+  if (platform->name() == "echo") {
+    platform->init_data = &echo_opts;
+  }
+  status = platform->Init();
+  if (!status.ok()) {
+    std::cerr << "Could not initialize platform." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::shared_ptr<BusBenchmarker>> benchmarkers;
+  status = GetBenchmarkers(platform, opts, &benchmarkers);
+  if (!status.ok()) {
+    std::cerr << status.message << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Allocate the address range on the device, unless it was given.
+  da_t range = 0;
+  if (opts.allocate) {
+    status = platform->DeviceMalloc(&range, std::max(opts.sweep.bytes, opts.sweep.region_size));
+    if (!status.ok()) {
+      std::cerr << "Could not allocate device memory." << std::endl;
+      return EXIT_FAILURE;
+    }
+    opts.sweep.base_addr = range;
+  }
+
+  std::ofstream file;
+  if (!opts.output.empty()) {
+    file.open(opts.output);
+    if (!file.good()) {
+      std::cerr << "Could not open " << opts.output << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::ostream &os = opts.output.empty() ? std::cout : file;
+  BusBenchmarker::WriteCSVHeader(os);
+
+  int result = EXIT_SUCCESS;
+  for (const auto &b : benchmarkers) {
+    std::cerr << "Running " << b->name() << "..." << std::endl;
+    std::vector<fletcher::BusBenchmarkResult> results;
+    status = b->Sweep(opts.sweep, &results);
+    for (const auto &r : results) {
+      b->WriteCSV(os, r);
+    }
+    if (!status.ok()) {
+      std::cerr << "Benchmarker " << b->name() << " failed: " << status.message << std::endl;
+      result = EXIT_FAILURE;
+      break;
+    }
+  }
+
+  if (opts.allocate) {
+    platform->DeviceFree(range);
+  }
+  platform->Terminate();
+  return result;
+}
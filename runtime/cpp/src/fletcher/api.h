@@ -27,3 +27,6 @@
 #include "fletcher/context.h"
 #include "fletcher/platform.h"
 #include "fletcher/kernel.h"
+#include "fletcher/scheduler.h"
+#include "fletcher/hybrid.h"
+#include "fletcher/benchmarker.h"
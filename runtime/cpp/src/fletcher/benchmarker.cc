@@ -0,0 +1,364 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fletcher/benchmarker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace fletcher {
+
+// Control register bits
+#define BENCH_CONTROL_START 0
+#define BENCH_CONTROL_STOP 1
+#define BENCH_CONTROL_RESET 2
+
+// Status register bits
+#define BENCH_STATUS_IDLE 0
+#define BENCH_STATUS_BUSY 1
+#define BENCH_STATUS_DONE 2
+#define BENCH_STATUS_ERROR 3
+#define BENCH_STATUS_RANDOM 4
+
+BusBenchmarkerRegisters BusBenchmarkerRegisters::Contiguous(uint64_t base, uint64_t num_regs) {
+  BusBenchmarkerRegisters regs;
+  regs.control = base + 0;
+  regs.status = base + 1;
+  regs.burst_length = base + 2;
+  regs.max_bursts = base + 3;
+  regs.base_addr_lo = base + 4;
+  regs.base_addr_hi = base + 5;
+  regs.addr_mask_lo = base + 6;
+  regs.addr_mask_hi = base + 7;
+  regs.cycles_per_word = base + 8;
+  regs.cycles = base + 9;
+  if (num_regs > 10) regs.checksum = base + 10;
+  if (num_regs > 11) regs.stride = base + 11;
+  if (num_regs > 12) regs.max_outstanding = base + 12;
+  return regs;
+}
+
+std::string ToString(BusPattern pattern) {
+  switch (pattern) {
+    case BusPattern::SEQUENTIAL: return "sequential";
+    case BusPattern::STRIDED: return "strided";
+    case BusPattern::RANDOM: return "random";
+  }
+  return "unknown";
+}
+
+BusBenchmarker::BusBenchmarker(std::shared_ptr<Platform> platform,
+                               std::string name,
+                               BusBenchmarkerRegisters regs,
+                               Options options)
+    : platform_(std::move(platform)), name_(std::move(name)), regs_(regs), options_(options) {}
+
+Status BusBenchmarker::Make(std::shared_ptr<BusBenchmarker> *benchmarker,
+                            const std::shared_ptr<Platform> &platform,
+                            const std::string &name,
+                            const BusBenchmarkerRegisters &regs,
+                            Options options) {
+  if (platform == nullptr) {
+    return Status::ERROR("Platform is nullptr.");
+  }
+  if ((options.clock_hz <= 0.0) || (options.bus_data_bytes == 0)) {
+    return Status::ERROR("Clock frequency and bus width must be positive.");
+  }
+  *benchmarker = std::make_shared<BusBenchmarker>(platform, name, regs, options);
+  return Status::OK();
+}
+
+Status BusBenchmarker::Discover(std::vector<std::shared_ptr<BusBenchmarker>> *benchmarkers,
+                                const std::shared_ptr<Platform> &platform,
+                                const std::map<std::string, uint64_t> &regmap,
+                                Options options) {
+  const std::string suffix = "_CONTROL";
+  for (const auto &reg : regmap) {
+    const auto &name = reg.first;
+    if ((name.size() <= suffix.size()) || (name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)) {
+      continue;
+    }
+    auto prefix = name.substr(0, name.size() - suffix.size());
+    BusBenchmarkerRegisters regs;
+    bool complete = true;
+    auto get = [&](const std::string &field, uint64_t *index) {
+      auto it = regmap.find(prefix + "_" + field);
+      if (it == regmap.end()) {
+        complete = false;
+      } else {
+        *index = it->second;
+      }
+    };
+    auto get_optional = [&](const std::string &field, int64_t *index) {
+      auto it = regmap.find(prefix + "_" + field);
+      if (it != regmap.end()) {
+        *index = static_cast<int64_t>(it->second);
+      }
+    };
+    get("CONTROL", &regs.control);
+    get("STATUS", &regs.status);
+    get("BURST_LENGTH", &regs.burst_length);
+    get("MAX_BURSTS", &regs.max_bursts);
+    get("BASE_ADDR_LO", &regs.base_addr_lo);
+    get("BASE_ADDR_HI", &regs.base_addr_hi);
+    get("ADDR_MASK_LO", &regs.addr_mask_lo);
+    get("ADDR_MASK_HI", &regs.addr_mask_hi);
+    get("CYCLES_PER_WORD", &regs.cycles_per_word);
+    get("CYCLES", &regs.cycles);
+    get_optional("CHECKSUM", &regs.checksum);
+    get_optional("STRIDE", &regs.stride);
+    get_optional("MAX_OUTSTANDING", &regs.max_outstanding);
+    if (!complete) {
+      continue;
+    }
+    std::shared_ptr<BusBenchmarker> benchmarker;
+    auto status = Make(&benchmarker, platform, prefix, regs, options);
+    if (!status.ok()) return status;
+    benchmarkers->push_back(benchmarker);
+  }
+  return Status::OK();
+}
+
+Status BusBenchmarker::ParseRegisterMap(const std::string &source, std::map<std::string, uint64_t> *regmap) {
+  std::istringstream lines(source);
+  std::string line;
+  size_t num_found = 0;
+  while (std::getline(lines, line)) {
+    std::istringstream tokens(line);
+    std::string constexpr_, type, name, eq, value;
+    if (!(tokens >> constexpr_ >> type >> name >> eq >> value)) continue;
+    if ((constexpr_ != "constexpr") || (type != "uint32_t") || (eq != "=")) continue;
+    // Skip constants that are not plain numbers, such as the default registers.
+    char *end = nullptr;
+    auto index = std::strtoull(value.c_str(), &end, 0);
+    if ((end == value.c_str()) || (std::string(end) != ";")) continue;
+    (*regmap)[name] = index;
+    num_found++;
+  }
+  if (num_found == 0) {
+    return Status::ERROR("No registers found in register map.");
+  }
+  return Status::OK();
+}
+
+/// @brief Return the number of bits required to address \p x bytes.
+static uint64_t Log2Ceil(uint64_t x) {
+  uint64_t i = 0;
+  while ((i < 64) && (((x - 1) >> i) != 0)) {
+    i++;
+  }
+  return i;
+}
+
+uint64_t BusBenchmarker::AddressMask(uint64_t region_size, uint64_t burst_bytes) {
+  auto region_bits = Log2Ceil(region_size);
+  auto burst_bits = Log2Ceil(burst_bytes);
+  uint64_t region_mask = region_bits >= 64 ? ~0ULL : (1ULL << region_bits) - 1;
+  uint64_t burst_mask = burst_bits >= 64 ? ~0ULL : (1ULL << burst_bits) - 1;
+  return region_mask & ~burst_mask;
+}
+
+Status BusBenchmarker::IsRandom(bool *random) {
+  uint32_t status = 0;
+  auto result = platform_->ReadMMIO(regs_.status, &status);
+  if (!result.ok()) return result;
+  *random = (status & (1u << BENCH_STATUS_RANDOM)) != 0;
+  return Status::OK();
+}
+
+Status BusBenchmarker::Supports(BusPattern pattern, bool *supported) {
+  bool random = false;
+  auto status = IsRandom(&random);
+  if (!status.ok()) return status;
+  if (pattern == BusPattern::RANDOM) {
+    *supported = random;
+  } else if (pattern == BusPattern::STRIDED) {
+    *supported = !random && (regs_.stride >= 0);
+  } else {
+    *supported = !random;
+  }
+  return Status::OK();
+}
+
+Status BusBenchmarker::Run(const BusBenchmarkConfig &config, BusBenchmarkResult *result) {
+  using clock = std::chrono::steady_clock;
+
+  if ((config.burst_length == 0) || (config.num_bursts == 0)) {
+    return Status::ERROR("Burst length and number of bursts must be positive.");
+  }
+  bool supported = false;
+  auto status = Supports(config.pattern, &supported);
+  if (!status.ok()) return status;
+  if (!supported) {
+    return Status::ERROR("Benchmarker " + name_ + " does not support the " + ToString(config.pattern) + " pattern.");
+  }
+  if ((config.pattern == BusPattern::STRIDED) && (config.stride == 0)) {
+    return Status::ERROR("Strided pattern requires a stride.");
+  }
+  if ((config.max_outstanding != 0) && (regs_.max_outstanding < 0)) {
+    return Status::ERROR("Benchmarker " + name_ + " cannot limit the number of outstanding bursts.");
+  }
+  uint64_t burst_bytes = static_cast<uint64_t>(config.burst_length) * options_.bus_data_bytes;
+  uint64_t addr_mask = 0;
+  if (config.pattern == BusPattern::RANDOM) {
+    if (config.region_size < burst_bytes) {
+      return Status::ERROR("Random pattern requires a region of at least one burst.");
+    }
+    addr_mask = AddressMask(config.region_size, burst_bytes);
+  }
+
+  // Configure the benchmarker.
+  std::vector<std::pair<uint64_t, uint32_t>> writes = {
+      {regs_.burst_length, config.burst_length},
+      {regs_.max_bursts, config.num_bursts},
+      {regs_.base_addr_lo, static_cast<uint32_t>(config.base_addr)},
+      {regs_.base_addr_hi, static_cast<uint32_t>(config.base_addr >> 32)},
+      {regs_.addr_mask_lo, static_cast<uint32_t>(addr_mask)},
+      {regs_.addr_mask_hi, static_cast<uint32_t>(addr_mask >> 32)},
+      {regs_.cycles_per_word, config.cycles_per_word}};
+  if (regs_.stride >= 0) {
+    writes.emplace_back(regs_.stride, config.pattern == BusPattern::STRIDED ? config.stride : 0);
+  }
+  if (regs_.max_outstanding >= 0) {
+    writes.emplace_back(regs_.max_outstanding, config.max_outstanding);
+  }
+  for (const auto &w : writes) {
+    status = platform_->WriteMMIO(w.first, w.second);
+    if (!status.ok()) return status;
+  }
+
+  // Reset, then pulse start. The benchmark starts when the start bit goes low.
+  status = platform_->WriteMMIO(regs_.control, 1u << BENCH_CONTROL_RESET);
+  if (!status.ok()) return status;
+  status = platform_->WriteMMIO(regs_.control, 1u << BENCH_CONTROL_START);
+  if (!status.ok()) return status;
+  status = platform_->WriteMMIO(regs_.control, 0);
+  if (!status.ok()) return status;
+
+  // Wait until done.
+  auto start = clock::now();
+  uint32_t bench_status = 0;
+  while (true) {
+    status = platform_->ReadMMIO(regs_.status, &bench_status);
+    if (!status.ok()) return status;
+    if (bench_status & ((1u << BENCH_STATUS_DONE) | (1u << BENCH_STATUS_ERROR))) {
+      break;
+    }
+    if (std::chrono::duration<double>(clock::now() - start).count() > options_.timeout) {
+      return Status::ERROR("Benchmarker " + name_ + " timed out.");
+    }
+    if (options_.poll_interval_usec > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(options_.poll_interval_usec));
+    }
+  }
+  if (bench_status & (1u << BENCH_STATUS_ERROR)) {
+    return Status::ERROR("Benchmarker " + name_ + " reported an error.");
+  }
+
+  result->config = config;
+  status = platform_->ReadMMIO(regs_.cycles, &result->cycles);
+  if (!status.ok()) return status;
+  result->bytes = burst_bytes * config.num_bursts;
+  result->seconds = result->cycles / options_.clock_hz;
+  return Status::OK();
+}
+
+Status BusBenchmarker::Sweep(const BusBenchmarkSweep &sweep, std::vector<BusBenchmarkResult> *results) {
+  for (auto pattern : sweep.patterns) {
+    bool supported = false;
+    auto status = Supports(pattern, &supported);
+    if (!status.ok()) return status;
+    if (!supported) continue;
+
+    std::vector<uint32_t> strides = {0};
+    if (pattern == BusPattern::STRIDED) {
+      strides = sweep.strides;
+    }
+    for (auto burst_length : sweep.burst_lengths) {
+      uint64_t burst_bytes = static_cast<uint64_t>(burst_length) * options_.bus_data_bytes;
+      for (auto stride : strides) {
+        BusBenchmarkConfig config;
+        config.pattern = pattern;
+        config.burst_length = burst_length;
+        config.stride = stride;
+        config.base_addr = sweep.base_addr;
+        config.region_size = sweep.region_size;
+
+        BusBenchmarkResult result;
+        if (sweep.latency) {
+          config.num_bursts = 1;
+          status = Run(config, &result);
+          if (!status.ok()) return status;
+          results->push_back(result);
+        }
+
+        // Cover the requested address range, with at least one burst.
+        uint64_t step = std::max<uint64_t>(burst_bytes, stride);
+        uint64_t num_bursts = std::max<uint64_t>(1, sweep.bytes / step);
+        config.num_bursts = static_cast<uint32_t>(std::min<uint64_t>(num_bursts,
+                                                                     std::numeric_limits<uint32_t>::max()));
+        for (auto max_outstanding : sweep.max_outstanding) {
+          config.max_outstanding = max_outstanding;
+          status = Run(config, &result);
+          if (!status.ok()) return status;
+          results->push_back(result);
+        }
+      }
+    }
+  }
+  return Status::OK();
+}
+
+void BusBenchmarker::WriteCSVHeader(std::ostream &os) {
+  os << "benchmarker,pattern,burst_length,num_bursts,max_outstanding,stride,bytes,cycles,seconds,"
+        "bytes_per_second,cycles_per_burst,seconds_per_burst\n";
+}
+
+void BusBenchmarker::WriteCSV(std::ostream &os, const BusBenchmarkResult &result) const {
+  const auto &c = result.config;
+  os << std::setprecision(9);
+  os << name_ << "," << ToString(c.pattern) << "," << c.burst_length << "," << c.num_bursts << ","
+     << c.max_outstanding << "," << c.stride << "," << result.bytes << "," << result.cycles << ","
+     << result.seconds << "," << result.bandwidth() << "," << result.cycles_per_burst() << ","
+     << result.cycles_per_burst() / options_.clock_hz << "\n";
+}
+
+Status TranslatorCounters::Read(Platform *platform, uint64_t base, TranslatorCounters *counters) {
+  freg_t regs[4];
+  auto status = platform->ReadMMIORange(base, 4, regs);
+  if (!status.ok()) return status;
+  counters->hits = regs[0];
+  counters->misses = regs[1];
+  counters->prefetches = regs[2];
+  counters->walk_cycles = regs[3];
+  return Status::OK();
+}
+
+TranslatorCounters TranslatorCounters::Since(const TranslatorCounters &start) const {
+  // Unsigned subtraction yields the right difference if a counter wrapped around at most once.
+  TranslatorCounters result;
+  result.hits = hits - start.hits;
+  result.misses = misses - start.misses;
+  result.prefetches = prefetches - start.prefetches;
+  result.walk_cycles = walk_cycles - start.walk_cycles;
+  return result;
+}
+
+}  // namespace fletcher
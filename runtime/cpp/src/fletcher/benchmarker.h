@@ -0,0 +1,269 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "fletcher/status.h"
+#include "fletcher/platform.h"
+
+namespace fletcher {
+
+/// @brief Register indices of a BusReadBenchmarker or BusWriteBenchmarker instance.
+struct BusBenchmarkerRegisters {
+  uint64_t control = 0;
+  uint64_t status = 0;
+  uint64_t burst_length = 0;
+  uint64_t max_bursts = 0;
+  uint64_t base_addr_lo = 0;
+  uint64_t base_addr_hi = 0;
+  uint64_t addr_mask_lo = 0;
+  uint64_t addr_mask_hi = 0;
+  uint64_t cycles_per_word = 0;
+  uint64_t cycles = 0;
+  /// Optional registers, or -1 if the instance does not connect them.
+  int64_t checksum = -1;
+  int64_t stride = -1;
+  int64_t max_outstanding = -1;
+
+  /**
+   * @brief Return the registers of an instance that occupies \p num_regs successive registers starting at \p base.
+   *
+   * The registers are in the order of the ports of the benchmarker. The first 10 registers are required, the
+   * checksum, stride and maximum outstanding registers are present if \p num_regs is large enough.
+   */
+  static BusBenchmarkerRegisters Contiguous(uint64_t base, uint64_t num_regs = 13);
+};
+
+/// @brief Address pattern of a bus benchmark.
+enum class BusPattern {
+  /// Bursts are requested back to back.
+  SEQUENTIAL,
+  /// Bursts are requested at a fixed distance from each other.
+  STRIDED,
+  /// Bursts are requested at random, burst aligned, addresses within a region.
+  RANDOM
+};
+
+/// @brief Return a human-readable name of a bus pattern.
+std::string ToString(BusPattern pattern);
+
+/// @brief Configuration of a single bus benchmark run.
+struct BusBenchmarkConfig {
+  BusPattern pattern = BusPattern::SEQUENTIAL;
+  /// Number of beats per burst.
+  uint32_t burst_length = 1;
+  /// Number of bursts.
+  uint32_t num_bursts = 1;
+  /// Maximum number of outstanding bursts, or 0 for no limit.
+  uint32_t max_outstanding = 0;
+  /// Distance between successive bursts in bytes, for the strided pattern.
+  uint32_t stride = 0;
+  /// Number of cycles to absorb a word, or 0 to always accept immediately.
+  uint32_t cycles_per_word = 0;
+  /// Device address of the first burst, and of the region for the random pattern.
+  uint64_t base_addr = 0;
+  /// Size of the region in bytes for the random pattern.
+  uint64_t region_size = 0;
+};
+
+/// @brief The result of a single bus benchmark run.
+struct BusBenchmarkResult {
+  BusBenchmarkConfig config;
+  /// Number of bytes transferred.
+  uint64_t bytes = 0;
+  /// Number of clock cycles of the run.
+  uint32_t cycles = 0;
+  /// Duration of the run in seconds.
+  double seconds = 0.0;
+
+  /// @brief Return the bandwidth in bytes per second.
+  double bandwidth() const { return seconds > 0.0 ? bytes / seconds : 0.0; }
+  /// @brief Return the average number of cycles per burst. For a single burst, this is the latency.
+  double cycles_per_burst() const {
+    return config.num_bursts > 0 ? static_cast<double>(cycles) / config.num_bursts : 0.0;
+  }
+};
+
+/// @brief A sweep of bus benchmark runs over all combinations of the parameters.
+struct BusBenchmarkSweep {
+  std::vector<BusPattern> patterns = {BusPattern::SEQUENTIAL, BusPattern::RANDOM};
+  std::vector<uint32_t> burst_lengths = {1, 2, 4, 8, 16, 32, 64};
+  /// Maximum number of outstanding bursts. Use 0 for no limit.
+  std::vector<uint32_t> max_outstanding = {0};
+  /// Strides in bytes for the strided pattern.
+  std::vector<uint32_t> strides = {4096};
+  /// Size of the address range covered by bandwidth measurements. Strided runs transfer only a part of it.
+  uint64_t bytes = 64 * 1024 * 1024;
+  /// Whether to measure the latency of a single burst for every burst length.
+  bool latency = true;
+  /// Device address of the address range.
+  uint64_t base_addr = 0;
+  /// Size of the region for the random pattern.
+  uint64_t region_size = 64 * 1024 * 1024;
+};
+
+/**
+ * @brief Drives a BusReadBenchmarker or BusWriteBenchmarker instance through MMIO.
+ *
+ * The benchmarker measures the number of cycles it takes to request a number of bursts and to transfer all data.
+ * Whether it generates random or sequential addresses is decided by its PATTERN generic, which it reports through its
+ * status register.
+ */
+class BusBenchmarker {
+ public:
+  /// @brief Options for the BusBenchmarker.
+  struct Options {
+    /// Clock frequency of the benchmarker in Hz.
+    double clock_hz = 250e6;
+    /// Width of the data bus in bytes.
+    uint32_t bus_data_bytes = 64;
+    /// Status polling interval in microseconds.
+    unsigned int poll_interval_usec = 100;
+    /// Give up on a run after this many seconds.
+    double timeout = 10.0;
+  };
+
+  BusBenchmarker(std::shared_ptr<Platform> platform, std::string name, BusBenchmarkerRegisters regs, Options options);
+
+  /**
+   * @brief Create a new bus benchmarker.
+   * @param benchmarker The new benchmarker.
+   * @param platform    An initialized platform.
+   * @param name        Name of the instance.
+   * @param regs        The registers of the instance.
+   * @param options     Benchmarker options.
+   * @return            Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  static Status Make(std::shared_ptr<BusBenchmarker> *benchmarker,
+                     const std::shared_ptr<Platform> &platform,
+                     const std::string &name,
+                     const BusBenchmarkerRegisters &regs,
+                     Options options);
+
+  /**
+   * @brief Discover all benchmarker instances in a register map.
+   *
+   * An instance named X is discovered when registers X_CONTROL, X_STATUS, X_BURST_LENGTH, X_MAX_BURSTS,
+   * X_BASE_ADDR_LO, X_BASE_ADDR_HI, X_ADDR_MASK_LO, X_ADDR_MASK_HI, X_CYCLES_PER_WORD and X_CYCLES exist. Registers
+   * X_CHECKSUM, X_STRIDE and X_MAX_OUTSTANDING are optional. Fletchgen names user registers USER_<NAME>, so
+   * user registers named e.g. bench_control, bench_status, ... result in an instance named USER_BENCH.
+   *
+   * @param benchmarkers  The discovered instances, sorted by name.
+   * @param platform      An initialized platform.
+   * @param regmap        The register map, from register name to index.
+   * @param options       Benchmarker options.
+   * @return              Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  static Status Discover(std::vector<std::shared_ptr<BusBenchmarker>> *benchmarkers,
+                         const std::shared_ptr<Platform> &platform,
+                         const std::map<std::string, uint64_t> &regmap,
+                         Options options);
+
+  /**
+   * @brief Parse the register constants of a header generated by fletchgen --regmap.
+   *
+   * Every line of the form "constexpr uint32_t NAME = INDEX;" adds a register. Other lines are ignored.
+   *
+   * @param source  The header source.
+   * @param regmap  The register map to add the registers to.
+   * @return        Status::OK() if successful, Status::ERROR() if no registers were found.
+   */
+  static Status ParseRegisterMap(const std::string &source, std::map<std::string, uint64_t> *regmap);
+
+  /**
+   * @brief Return a mask that keeps random burst addresses inside a region and aligned to the burst size.
+   * @param region_size Size of the region in bytes, rounded up to a power of two.
+   * @param burst_bytes Size of a burst in bytes, rounded up to a power of two.
+   */
+  static uint64_t AddressMask(uint64_t region_size, uint64_t burst_bytes);
+
+  /// @brief Determine whether the instance generates random or sequential addresses.
+  Status IsRandom(bool *random);
+
+  /// @brief Determine whether the instance supports a pattern.
+  Status Supports(BusPattern pattern, bool *supported);
+
+  /**
+   * @brief Perform a single run.
+   * @param config  The configuration of the run.
+   * @param result  The result of the run.
+   * @return        Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status Run(const BusBenchmarkConfig &config, BusBenchmarkResult *result);
+
+  /**
+   * @brief Perform a sweep. Patterns that the instance does not support are skipped.
+   * @param sweep   The parameters of the sweep.
+   * @param results The results are appended to this vector.
+   * @return        Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status Sweep(const BusBenchmarkSweep &sweep, std::vector<BusBenchmarkResult> *results);
+
+  /// @brief Write the CSV header of WriteCSV.
+  static void WriteCSVHeader(std::ostream &os);
+
+  /// @brief Write a result as a CSV line.
+  void WriteCSV(std::ostream &os, const BusBenchmarkResult &result) const;
+
+  /// @brief Return the name of the instance.
+  const std::string &name() const { return name_; }
+
+  /// @brief Return the registers of the instance.
+  const BusBenchmarkerRegisters &regs() const { return regs_; }
+
+ private:
+  std::shared_ptr<Platform> platform_;
+  std::string name_;
+  BusBenchmarkerRegisters regs_;
+  Options options_;
+};
+
+/**
+ * @brief Statistics counters of an MMTranslator instance.
+ *
+ * The translator counts translation hits and misses, prefetched page table walks and the number of cycles requests
+ * spent waiting for a page table walk. The counters occupy four successive registers and only reset with the device.
+ */
+struct TranslatorCounters {
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t prefetches = 0;
+  uint32_t walk_cycles = 0;
+
+  /**
+   * @brief Read the counters of a translator.
+   * @param platform  An initialized platform.
+   * @param base      Index of the first counter register.
+   * @param counters  The counters that were read.
+   * @return          Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  static Status Read(Platform *platform, uint64_t base, TranslatorCounters *counters);
+
+  /// @brief Return the counters accumulated since \p start. Counters that wrapped around are accounted for.
+  TranslatorCounters Since(const TranslatorCounters &start) const;
+
+  /// @brief Return the fraction of translations that hit in the cache.
+  double hit_rate() const {
+    return (hits + misses) > 0 ? static_cast<double>(hits) / (static_cast<double>(hits) + misses) : 0.0;
+  }
+};
+
+}  // namespace fletcher
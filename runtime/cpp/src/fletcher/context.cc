@@ -49,6 +49,36 @@ Status Context::Enable() {
 
   FLETCHER_LOG(DEBUG, "Enabling Context...");
 
+  bool regions = (platform_->capabilities() & FLETCHER_PLATFORM_CAP_DEVICE_REGIONS) != 0;
+  bool huge_pages = (platform_->capabilities() & FLETCHER_PLATFORM_CAP_HUGE_PAGES) != 0;
+
+  // Buffers are typically large and streamed sequentially, map them with huge pages to reduce translation misses.
+  auto status = Status::OK();
+  if (huge_pages) {
+    status = platform_->SetDeviceHugePages(true);
+  }
+  if (status.ok()) {
+    status = PrepareDeviceBuffers(regions);
+  }
+  // Allocations outside of the context use regular pages and are placed in the default region, also when preparing
+  // the buffers failed.
+  if (huge_pages) {
+    auto restore = platform_->SetDeviceHugePages(false);
+    if (status.ok()) {
+      status = restore;
+    }
+  }
+  if (regions) {
+    auto restore = platform_->SetDeviceRegion(FLETCHER_REG_MM_DEFAULT_REGION);
+    if (status.ok()) {
+      status = restore;
+    }
+  }
+  return status;
+}
+
+Status Context::PrepareDeviceBuffers(bool regions) {
+  bool warned = false;
   // Loop over all batches queued on host
   for (size_t i = 0; i < host_batches_.size(); i++) {
     auto rbd = host_batch_desc_[i];
@@ -56,6 +86,18 @@ Status Context::Enable() {
     for (const auto &b : rbd.buffers) {
       fletcher::Status status;
       DeviceBuffer device_buf(b.raw_buffer_, b.size_, type, rbd.mode);
+      device_buf.channel = b.channel_;
+      // Place the buffer in the device memory region of its memory channel.
+      if (regions) {
+        status = platform_->SetDeviceRegion(FLETCHER_REG_MM_DEFAULT_REGION + b.channel_);
+        if (!status.ok()) {
+          return status;
+        }
+      } else if ((b.channel_ != 0) && !warned) {
+        FLETCHER_LOG(WARNING, "Platform does not support multiple device memory regions. "
+                              "Buffers of all memory channels are placed in the default region.");
+        warned = true;
+      }
       if (type == MemType::ANY) {
         status = platform_->PrepareHostBuffer(device_buf.host_address,
                                               &device_buf.device_address,
@@ -79,7 +121,9 @@ Status Context::Enable() {
   return Status::OK();
 }
 
-Status Context::QueueRecordBatch(const std::shared_ptr<arrow::RecordBatch> &record_batch, MemType mem_type) {
+Status Context::QueueRecordBatch(const std::shared_ptr<arrow::RecordBatch> &record_batch,
+                                 MemType mem_type,
+                                 bool covered_only) {
   // Sanity check the recordbatch
   if (record_batch == nullptr) {
     return Status::ERROR("RecordBatch is nullptr.");
@@ -94,7 +138,7 @@ Status Context::QueueRecordBatch(const std::shared_ptr<arrow::RecordBatch> &reco
 
   // Create a description of the recordbatch
   RecordBatchDescription rbd;
-  RecordBatchAnalyzer rba(&rbd);
+  RecordBatchAnalyzer rba(&rbd, covered_only);
   rba.Analyze(*record_batch);
   host_batch_desc_.push_back(rbd);
 
@@ -112,6 +156,46 @@ uint64_t Context::num_buffers() const {
   return ret;
 }
 
+uint64_t Context::num_burst_registers() const {
+  uint64_t ret = 0;
+  for (const auto &rbd : host_batch_desc_) {
+    for (const auto &f : rbd.fields) {
+      ret += f.burst_reg_ ? 1 : 0;
+    }
+  }
+  return ret;
+}
+
+Status Context::GetBurstRegister(size_t recordbatch_index, const std::string &field_name, uint64_t *index) const {
+  if (recordbatch_index >= host_batch_desc_.size()) {
+    return Status::ERROR("RecordBatch index out of range.");
+  }
+  uint64_t reg = FLETCHER_REG_SCHEMA + 2 * num_recordbatches() + 2 * num_buffers();
+  for (size_t i = 0; i < host_batch_desc_.size(); i++) {
+    for (const auto &f : host_batch_desc_[i].fields) {
+      if (!f.burst_reg_) {
+        continue;
+      }
+      if ((i == recordbatch_index) && (f.name_ == field_name)) {
+        *index = reg;
+        return Status::OK();
+      }
+      reg++;
+    }
+  }
+  return Status::ERROR("Field " + field_name + " has no burst length register.");
+}
+
+uint64_t Context::num_counter_registers() const {
+  uint64_t ret = 0;
+  for (const auto &rbd : host_batch_desc_) {
+    for (const auto &f : rbd.fields) {
+      ret += f.profile_ ? FLETCHER_PROFILE_COUNTERS : 0;
+    }
+  }
+  return ret;
+}
+
 size_t Context::GetQueueSize() const {
   size_t size = 0;
   for (const auto &desc : host_batch_desc_) {
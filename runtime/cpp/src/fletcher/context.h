@@ -15,6 +15,7 @@
 #pragma once
 
 #include <utility>
+#include <string>
 #include <vector>
 #include <memory>
 #include <iostream>
@@ -62,6 +63,8 @@ struct DeviceBuffer {
 
   MemType memory = MemType::CACHE;
   Mode mode = Mode::READ;
+  /// The memory channel over which the device accesses this buffer.
+  int channel = 0;
 
   bool available_to_device = false;
   bool was_alloced = false;
@@ -97,10 +100,12 @@ class Context {
    *
    * @param record_batch  The arrow::RecordBatch to queue
    * @param mem_type      Force caching; i.e. the RecordBatch is guaranteed to be copied to on-board memory.
+   * @param covered_only  Only use the part of the buffers that a sliced RecordBatch covers on the device.
    * @return              Status::OK() if successful, Status::ERROR() otherwise.
    */
   Status QueueRecordBatch(const std::shared_ptr<arrow::RecordBatch> &record_batch,
-                          MemType mem_type = MemType::ANY);
+                          MemType mem_type = MemType::ANY,
+                          bool covered_only = false);
 
   /// @brief Obtain the size (in bytes) of all buffers currently enqueued.
   size_t GetQueueSize() const;
@@ -111,11 +116,44 @@ class Context {
   /// @brief Return the number of buffers in this context.
   uint64_t num_buffers() const;
 
+  /// @brief Return the number of RecordBatches in this context.
+  uint64_t num_recordbatches() const { return host_batches_.size(); }
+
+  /// @brief Return the number of fields in this context of which the maximum burst length is set through a register.
+  uint64_t num_burst_registers() const;
+
+  /**
+   * @brief Obtain the index of the register that holds the maximum burst length of a field.
+   *
+   * The burst length registers follow the buffer address registers, in the order of the RecordBatches and their
+   * fields. Only fields with "fletcher_burst_reg" metadata have a register.
+   *
+   * @param recordbatch_index The index of the RecordBatch in this context.
+   * @param field_name        The name of the field.
+   * @param index             The register index.
+   * @return                  Status::OK() if the field has a burst length register, Status::ERROR() otherwise.
+   */
+  Status GetBurstRegister(size_t recordbatch_index, const std::string &field_name, uint64_t *index) const;
+
+  /**
+   * @brief Return the number of profile counter registers in this context.
+   *
+   * Every field with "fletcher_profile" metadata has FLETCHER_PROFILE_COUNTERS read-only registers, which follow the
+   * burst length registers in the order of the RecordBatches and their fields.
+   */
+  uint64_t num_counter_registers() const;
+
   std::shared_ptr<Platform> platform() const { return platform_; }
 
   DeviceBuffer device_buffer(size_t i) const { return device_buffers_[i]; }
 
+  /// @brief Return the description of the i-th RecordBatch in this context.
+  const RecordBatchDescription &recordbatch_description(size_t i) const { return host_batch_desc_[i]; }
+
  protected:
+  /// @brief Prepare the device buffers of all queued RecordBatches, in the region of their memory channel.
+  Status PrepareDeviceBuffers(bool regions);
+
   bool written_ = false;
   /// The platform this context is running on.
   std::shared_ptr<Platform> platform_;
@@ -0,0 +1,255 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fletcher/hybrid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <utility>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+#include <fletcher/common.h>
+
+#include "fletcher/kernel.h"
+
+namespace fletcher {
+
+void CostModel::Update(double bytes, double seconds) {
+  sw_ = decay_ * sw_ + 1.0;
+  sx_ = decay_ * sx_ + bytes;
+  sy_ = decay_ * sy_ + seconds;
+  sxx_ = decay_ * sxx_ + bytes * bytes;
+  sxy_ = decay_ * sxy_ + bytes * seconds;
+  num_samples_++;
+  Solve();
+}
+
+void CostModel::Solve() {
+  double det = sw_ * sxx_ - sx_ * sx_;
+  // The samples must span a range of sizes to separate the fixed overhead from the per-byte cost.
+  calibrated_ = det > 1e-9 * sw_ * sxx_;
+  if (calibrated_) {
+    seconds_per_byte_ = (sw_ * sxy_ - sx_ * sy_) / det;
+    fixed_overhead_ = (sy_ - seconds_per_byte_ * sx_) / sw_;
+  } else if (sx_ > 0.0) {
+    // Assume all time is proportional to the size.
+    seconds_per_byte_ = sy_ / sx_;
+    fixed_overhead_ = 0.0;
+  } else {
+    seconds_per_byte_ = 0.0;
+    fixed_overhead_ = sy_ / sw_;
+  }
+  // Negative parameters are noise; refit with the parameter clamped to zero.
+  if (seconds_per_byte_ < 0.0) {
+    seconds_per_byte_ = 0.0;
+    fixed_overhead_ = sy_ / sw_;
+  } else if (fixed_overhead_ < 0.0) {
+    fixed_overhead_ = 0.0;
+    seconds_per_byte_ = sxx_ > 0.0 ? sxy_ / sxx_ : 0.0;
+  }
+}
+
+double CostModel::Predict(double bytes) const {
+  return fixed_overhead_ + bytes * seconds_per_byte_;
+}
+
+HybridExecutor::HybridExecutor(std::shared_ptr<Platform> platform,
+                               CpuFunction cpu,
+                               CombineFunction combine,
+                               Options options)
+    : platform_(std::move(platform)),
+      cpu_(std::move(cpu)),
+      combine_(std::move(combine)),
+      options_(options),
+      cpu_model_(options.decay),
+      fpga_model_(options.decay) {}
+
+Status HybridExecutor::Make(std::shared_ptr<HybridExecutor> *executor,
+                            const std::shared_ptr<Platform> &platform,
+                            CpuFunction cpu,
+                            CombineFunction combine,
+                            Options options) {
+  if (platform == nullptr) {
+    return Status::ERROR("Platform is nullptr.");
+  }
+  if (!cpu) {
+    return Status::ERROR("CPU function is empty.");
+  }
+  if (!combine) {
+    options.allow_split = false;
+  }
+  *executor = std::make_shared<HybridExecutor>(platform, std::move(cpu), std::move(combine), options);
+  return Status::OK();
+}
+
+Status HybridExecutor::Make(std::shared_ptr<HybridExecutor> *executor,
+                            const std::shared_ptr<Platform> &platform,
+                            CpuFunction cpu,
+                            CombineFunction combine) {
+  return Make(executor, platform, std::move(cpu), std::move(combine), Options());
+}
+
+double HybridExecutor::FpgaFraction(const CostModel &cpu, const CostModel &fpga, double bytes) {
+  double per_byte = bytes * (cpu.seconds_per_byte() + fpga.seconds_per_byte());
+  if (per_byte <= 0.0) {
+    return cpu.fixed_overhead() <= fpga.fixed_overhead() ? 0.0 : 1.0;
+  }
+  // Both parts finish at the same time when:
+  // fpga.fixed + f * bytes * fpga.per_byte = cpu.fixed + (1 - f) * bytes * cpu.per_byte
+  double f = (cpu.fixed_overhead() - fpga.fixed_overhead() + bytes * cpu.seconds_per_byte()) / per_byte;
+  return std::min(1.0, std::max(0.0, f));
+}
+
+Status HybridExecutor::RunFpga(const std::shared_ptr<arrow::RecordBatch> &batch,
+                               const std::vector<uint32_t> &arguments,
+                               int64_t num_rows,
+                               uint64_t *result,
+                               double *bytes) {
+  std::shared_ptr<Context> context;
+  auto status = Context::Make(&context, platform_);
+  if (!status.ok()) return status;
+  // Only transfer the rows that are processed on the FPGA.
+  auto fpga_batch = num_rows < batch->num_rows() ? batch->Slice(0, num_rows) : batch;
+  status = context->QueueRecordBatch(fpga_batch, options_.mem_type, true);
+  if (!status.ok()) return status;
+  status = context->Enable();
+  if (!status.ok()) return status;
+  *bytes = 0.0;
+  for (const auto &buf : context->recordbatch_description(0).buffers) {
+    *bytes += static_cast<double>(buf.size_);
+  }
+
+  Kernel kernel(context);
+  status = kernel.Reset();
+  if (!status.ok()) return status;
+  status = kernel.SetRange(0, 0, static_cast<int32_t>(num_rows));
+  if (!status.ok()) return status;
+  status = kernel.SetArguments(arguments);
+  if (!status.ok()) return status;
+  status = kernel.Start();
+  if (!status.ok()) return status;
+  status = kernel.WaitForFinish(options_.poll_interval_usec);
+  if (!status.ok()) return status;
+
+  uint32_t ret0 = 0, ret1 = 0;
+  status = kernel.GetReturn(&ret0, &ret1);
+  *result = (static_cast<uint64_t>(ret1) << 32) | ret0;
+  return status;
+}
+
+Status HybridExecutor::Process(const std::shared_ptr<arrow::RecordBatch> &batch,
+                               const std::vector<uint32_t> &arguments,
+                               uint64_t *result) {
+  using clock = std::chrono::steady_clock;
+
+  if (batch == nullptr) {
+    return Status::ERROR("RecordBatch is nullptr.");
+  }
+
+  // Determine the number of bytes in the RecordBatch, in the same way as the FPGA path determines its transfers.
+  RecordBatchDescription rbd;
+  RecordBatchAnalyzer rba(&rbd, true);
+  rba.Analyze(*batch);
+  double bytes = 0.0;
+  for (const auto &buf : rbd.buffers) {
+    bytes += static_cast<double>(buf.size_);
+  }
+  int64_t rows = batch->num_rows();
+
+  // Decide how many rows to process on the FPGA.
+  HybridDecision decision;
+  if (fpga_model_.num_samples() < options_.min_samples) {
+    decision.fpga_rows = rows;
+  } else if (cpu_model_.num_samples() < options_.min_samples) {
+    decision.fpga_rows = 0;
+  } else {
+    double t_cpu = cpu_model_.Predict(bytes);
+    double t_fpga = fpga_model_.Predict(bytes);
+    decision.fpga_rows = t_fpga < t_cpu ? rows : 0;
+    decision.predicted_time = std::min(t_cpu, t_fpga);
+    if (options_.allow_split) {
+      double f = FpgaFraction(cpu_model_, fpga_model_, bytes);
+      auto fpga_rows = static_cast<int64_t>(std::llround(f * rows));
+      if ((fpga_rows >= options_.min_split_rows) && (rows - fpga_rows >= options_.min_split_rows)) {
+        decision.fpga_rows = fpga_rows;
+        decision.predicted_time = fpga_model_.Predict(f * bytes);
+      }
+    }
+    if ((decision.fpga_rows > 0) && (decision.fpga_rows < rows)) {
+      since_explore_ = 0;
+    } else if ((options_.explore_interval > 0) && (++since_explore_ >= options_.explore_interval)) {
+      decision.fpga_rows = rows - decision.fpga_rows;
+      decision.explored = true;
+      since_explore_ = 0;
+    }
+  }
+  decision.cpu_rows = rows - decision.fpga_rows;
+
+  // The rows are assumed to be of equal size. The FPGA model is fit against the bytes that were actually transferred.
+  double fpga_bytes = rows > 0 ? bytes * decision.fpga_rows / rows : 0.0;
+  double cpu_bytes = bytes - fpga_bytes;
+
+  // Run the CPU part concurrently with the FPGA part.
+  uint64_t cpu_result = 0;
+  uint64_t fpga_result = 0;
+  Status cpu_status = Status::OK();
+  Status fpga_status = Status::OK();
+  std::thread cpu_thread;
+  if (decision.cpu_rows > 0) {
+    cpu_thread = std::thread([&]() {
+      auto start = clock::now();
+      cpu_status = cpu_(*batch, decision.fpga_rows, rows, &cpu_result);
+      decision.cpu_time = std::chrono::duration<double>(clock::now() - start).count();
+    });
+  }
+  if (decision.fpga_rows > 0) {
+    auto start = clock::now();
+    fpga_status = RunFpga(batch, arguments, decision.fpga_rows, &fpga_result, &fpga_bytes);
+    decision.fpga_time = std::chrono::duration<double>(clock::now() - start).count();
+  }
+  if (cpu_thread.joinable()) {
+    cpu_thread.join();
+  }
+
+  if (!fpga_status.ok()) {
+    return fpga_status;
+  }
+  if (!cpu_status.ok()) {
+    return cpu_status;
+  }
+
+  // Learn from the measurements.
+  if (decision.fpga_rows > 0) {
+    fpga_model_.Update(fpga_bytes, decision.fpga_time);
+  }
+  if (decision.cpu_rows > 0) {
+    cpu_model_.Update(cpu_bytes, decision.cpu_time);
+  }
+  last_decision_ = decision;
+
+  if (decision.fpga_rows == 0) {
+    *result = cpu_result;
+  } else if (decision.cpu_rows == 0) {
+    *result = fpga_result;
+  } else {
+    *result = combine_(fpga_result, cpu_result);
+  }
+  return Status::OK();
+}
+
+}  // namespace fletcher
@@ -0,0 +1,200 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "fletcher/status.h"
+#include "fletcher/platform.h"
+#include "fletcher/context.h"
+
+namespace fletcher {
+
+/**
+ * @brief An online linear model of the time it takes to process some number of bytes.
+ *
+ * Models time = fixed_overhead + bytes * seconds_per_byte, fitted by least squares over all samples. Older samples are
+ * weighted down by the decay factor for every new sample, such that the model follows changes in the system.
+ */
+class CostModel {
+ public:
+  explicit CostModel(double decay = 0.95) : decay_(decay) {}
+
+  /// @brief Add a sample of processing \p bytes in \p seconds.
+  void Update(double bytes, double seconds);
+
+  /// @brief Predict the time in seconds to process \p bytes.
+  double Predict(double bytes) const;
+
+  /// @brief Return the fixed overhead in seconds.
+  double fixed_overhead() const { return fixed_overhead_; }
+
+  /// @brief Return the throughput-dependent cost in seconds per byte.
+  double seconds_per_byte() const { return seconds_per_byte_; }
+
+  /// @brief Return the number of samples the model has seen.
+  uint64_t num_samples() const { return num_samples_; }
+
+  /// @brief Return true if the samples allowed to separate the fixed overhead from the per-byte cost.
+  bool calibrated() const { return calibrated_; }
+
+ private:
+  /// @brief Fit the model parameters to the weighted sums.
+  void Solve();
+
+  double decay_;
+  // Weighted sums of the samples
+  double sw_ = 0.0;
+  double sx_ = 0.0;
+  double sy_ = 0.0;
+  double sxx_ = 0.0;
+  double sxy_ = 0.0;
+
+  double fixed_overhead_ = 0.0;
+  double seconds_per_byte_ = 0.0;
+  uint64_t num_samples_ = 0;
+  bool calibrated_ = false;
+};
+
+/// @brief A routing decision of the HybridExecutor.
+struct HybridDecision {
+  /// Number of rows processed by the FPGA, starting at the first row.
+  int64_t fpga_rows = 0;
+  /// Number of rows processed by the CPU, following the FPGA rows.
+  int64_t cpu_rows = 0;
+  /// Predicted completion time in seconds.
+  double predicted_time = 0.0;
+  /// Measured time of the FPGA part in seconds.
+  double fpga_time = 0.0;
+  /// Measured time of the CPU part in seconds.
+  double cpu_time = 0.0;
+  /// Whether the batch was routed to the path that the models did not choose, to measure that path again.
+  bool explored = false;
+};
+
+/**
+ * @brief Executes batches on the FPGA, the CPU, or both, whichever is expected to finish first.
+ *
+ * For every batch, the executor predicts the completion time of both paths with a CostModel. It runs the batch on the
+ * fastest path, or splits it by rows such that both paths are expected to finish at the same time, whichever completes
+ * first. The measured times are fed back into the models. Only the rows that the FPGA processes are transferred to the
+ * device.
+ *
+ * Once one path wins, the other path is no longer measured, so its model would not notice if it became faster. Every
+ * Options::explore_interval batches that run on a single path, a batch is routed to the other path instead.
+ *
+ * The FPGA result is obtained from the two kernel return registers, with the second register holding the high bits.
+ */
+class HybridExecutor {
+ public:
+  /// A function that processes rows [first, last) of a RecordBatch on the CPU.
+  using CpuFunction = std::function<Status(const arrow::RecordBatch &batch, int64_t first, int64_t last,
+                                           uint64_t *result)>;
+  /// A function that combines the results of two parts of a split batch.
+  using CombineFunction = std::function<uint64_t(uint64_t fpga_result, uint64_t cpu_result)>;
+
+  /// @brief Options for the HybridExecutor.
+  struct Options {
+    /// Number of samples each path must have before predictions are trusted.
+    uint64_t min_samples = 2;
+    /// Whether batches may be split over both paths. Requires a combine function.
+    bool allow_split = true;
+    /// Do not split batches with fewer rows than this.
+    int64_t min_split_rows = 1024;
+    /// Memory type used for the FPGA path.
+    MemType mem_type = MemType::ANY;
+    /// Kernel status polling interval in microseconds.
+    unsigned int poll_interval_usec = 0;
+    /// Decay factor of the cost models.
+    double decay = 0.95;
+    /// Route a batch to the losing path after this many batches ran on a single path. Zero disables exploration.
+    uint64_t explore_interval = 32;
+  };
+
+  HybridExecutor(std::shared_ptr<Platform> platform, CpuFunction cpu, CombineFunction combine, Options options);
+
+  /**
+   * @brief Create a new hybrid executor.
+   * @param executor    The new executor.
+   * @param platform    An initialized platform with a kernel that is equivalent to the CPU function.
+   * @param cpu         The CPU function.
+   * @param combine     Function to combine the results of split batches. Splitting is disabled if it is empty.
+   * @param options     Executor options.
+   * @return            Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  static Status Make(std::shared_ptr<HybridExecutor> *executor,
+                     const std::shared_ptr<Platform> &platform,
+                     CpuFunction cpu,
+                     CombineFunction combine,
+                     Options options);
+
+  /// @brief Create a new hybrid executor with default options.
+  static Status Make(std::shared_ptr<HybridExecutor> *executor,
+                     const std::shared_ptr<Platform> &platform,
+                     CpuFunction cpu,
+                     CombineFunction combine = nullptr);
+
+  /**
+   * @brief Process a RecordBatch.
+   * @param batch       The RecordBatch to process.
+   * @param arguments   The kernel arguments.
+   * @param result      The result.
+   * @return            Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status Process(const std::shared_ptr<arrow::RecordBatch> &batch,
+                 const std::vector<uint32_t> &arguments,
+                 uint64_t *result);
+
+  /**
+   * @brief Return the fraction of bytes to process on the FPGA that minimizes the predicted completion time.
+   *
+   * Returns 0.0 or 1.0 if processing on a single path is expected to be at least as fast as splitting.
+   */
+  static double FpgaFraction(const CostModel &cpu, const CostModel &fpga, double bytes);
+
+  /// @brief Return the cost model of the CPU path.
+  const CostModel &cpu_model() const { return cpu_model_; }
+
+  /// @brief Return the cost model of the FPGA path.
+  const CostModel &fpga_model() const { return fpga_model_; }
+
+  /// @brief Return the decision made for the last processed batch.
+  const HybridDecision &last_decision() const { return last_decision_; }
+
+ private:
+  /// @brief Process the first \p num_rows rows of a batch on the FPGA. Sets \p bytes to the number of bytes transferred.
+  Status RunFpga(const std::shared_ptr<arrow::RecordBatch> &batch,
+                 const std::vector<uint32_t> &arguments,
+                 int64_t num_rows,
+                 uint64_t *result,
+                 double *bytes);
+
+  std::shared_ptr<Platform> platform_;
+  CpuFunction cpu_;
+  CombineFunction combine_;
+  Options options_;
+  CostModel cpu_model_;
+  CostModel fpga_model_;
+  HybridDecision last_decision_;
+  /// Number of batches that ran on a single path since the last exploration.
+  uint64_t since_explore_ = 0;
+};
+
+}  // namespace fletcher
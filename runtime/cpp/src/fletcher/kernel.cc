@@ -14,12 +14,48 @@
 #include "fletcher/kernel.h"
 
 #include <unistd.h>
+#include <iomanip>
+#include <sstream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "fletcher/context.h"
 
 namespace fletcher {
 
+FieldCounters FieldCounters::Since(const FieldCounters &start) const {
+  // Unsigned subtraction yields the right difference if a counter wrapped around at most once.
+  FieldCounters result = *this;
+  result.busy_cycles = busy_cycles - start.busy_cycles;
+  result.request_beats = request_beats - start.request_beats;
+  result.data_beats = data_beats - start.data_beats;
+  result.stall_cycles = stall_cycles - start.stall_cycles;
+  result.bytes = bytes - start.bytes;
+  return result;
+}
+
+CounterReport CounterReport::Since(const CounterReport &start) const {
+  CounterReport result;
+  for (size_t i = 0; i < fields.size(); i++) {
+    result.fields.push_back(i < start.fields.size() ? fields[i].Since(start.fields[i]) : fields[i]);
+  }
+  return result;
+}
+
+std::string CounterReport::ToString() const {
+  std::stringstream str;
+  str << std::left << std::setw(32) << "Field" << std::right
+      << std::setw(12) << "Busy" << std::setw(12) << "Req. beats" << std::setw(12) << "Data beats"
+      << std::setw(12) << "Stalls" << std::setw(14) << "Bytes" << "\n";
+  for (const auto &f : fields) {
+    str << std::left << std::setw(32) << (f.recordbatch + "." + f.field) << std::right
+        << std::setw(12) << f.busy_cycles << std::setw(12) << f.request_beats << std::setw(12) << f.data_beats
+        << std::setw(12) << f.stall_cycles << std::setw(14) << f.bytes << "\n";
+  }
+  return str.str();
+}
+
 Kernel::Kernel(std::shared_ptr<Context> context) : context_(std::move(context)) {}
 
 bool Kernel::ImplementsSchema(const std::shared_ptr<arrow::Schema> &schema) {
@@ -30,6 +66,8 @@ bool Kernel::ImplementsSchema(const std::shared_ptr<arrow::Schema> &schema) {
 }
 
 Status Kernel::Reset() {
+  // The kernel may clear its registers on reset, so every register must be written again afterwards.
+  context_->platform()->ResetMMIOShadow();
   auto status = context_->platform()->WriteMMIO(FLETCHER_REG_CONTROL, ctrl_reset);
   if (status.ok()) {
     return context_->platform()->WriteMMIO(FLETCHER_REG_CONTROL, 0);
@@ -44,19 +82,73 @@ Status Kernel::SetRange(size_t recordbatch_index, int32_t first, int32_t last) {
     return Status::ERROR();
   }
 
-  Status ret;
-  if (!context_->platform()->WriteMMIO(FLETCHER_REG_SCHEMA + 2 * recordbatch_index, static_cast<uint32_t>(first)).ok()) {
-    ret = Status::ERROR();
+  // Range registers hold configuration only, so redundant writes can be skipped.
+  auto status = context_->platform()->WriteMMIOShadowed(FLETCHER_REG_SCHEMA + 2 * recordbatch_index,
+                                                        static_cast<uint32_t>(first));
+  if (!status.ok()) {
+    return status;
+  }
+  return context_->platform()->WriteMMIOShadowed(FLETCHER_REG_SCHEMA + 2 * recordbatch_index + 1,
+                                                 static_cast<uint32_t>(last));
+}
+
+Status Kernel::SetBurstMaxLen(size_t recordbatch_index, const std::string &field_name, uint32_t beats) {
+  uint64_t reg = 0;
+  auto status = context_->GetBurstRegister(recordbatch_index, field_name, &reg);
+  if (!status.ok()) {
+    return status;
   }
-  if (!context_->platform()->WriteMMIO(FLETCHER_REG_SCHEMA + 2 * recordbatch_index + 1, static_cast<uint32_t>(last)).ok()) {
-    ret = Status::ERROR();
+  return context_->platform()->WriteMMIOShadowed(reg, beats);
+}
+
+Status Kernel::ReadCounters(CounterReport *report) {
+  report->fields.clear();
+  auto num_regs = context_->num_counter_registers();
+  if (num_regs == 0) {
+    return Status::OK();
+  }
+
+  // The counter registers follow the burst length registers.
+  auto offset = FLETCHER_REG_SCHEMA + 2 * context_->num_recordbatches() + 2 * context_->num_buffers()
+      + context_->num_burst_registers();
+  std::vector<freg_t> regs(num_regs);
+  auto status = context_->platform()->ReadMMIORange(offset, num_regs, regs.data());
+  if (!status.ok()) {
+    return status;
+  }
+
+  size_t reg = 0;
+  for (size_t i = 0; i < context_->num_recordbatches(); i++) {
+    const auto &rbd = context_->recordbatch_description(i);
+    for (const auto &f : rbd.fields) {
+      if (!f.profile_) {
+        continue;
+      }
+      FieldCounters counters;
+      counters.recordbatch = rbd.name;
+      counters.field = f.name_;
+      counters.busy_cycles = regs[reg];
+      counters.request_beats = regs[reg + 1];
+      counters.data_beats = regs[reg + 2];
+      counters.stall_cycles = regs[reg + 3];
+      counters.bytes = regs[reg + 4];
+      report->fields.push_back(counters);
+      reg += FLETCHER_PROFILE_COUNTERS;
+    }
   }
   return Status::OK();
 }
 
 Status Kernel::SetArguments(std::vector<uint32_t> arguments) {
+  // The arguments follow the range registers of every RecordBatch, the address registers of every buffer, the burst
+  // length registers and the profile counter registers.
+  auto offset = FLETCHER_REG_SCHEMA + 2 * context_->num_recordbatches() + 2 * context_->num_buffers()
+      + context_->num_burst_registers() + context_->num_counter_registers();
   for (int i = 0; (size_t) i < arguments.size(); i++) {
-    context_->platform()->WriteMMIO(FLETCHER_REG_SCHEMA + context_->num_buffers() * 2 + i, arguments[i]);
+    auto status = context_->platform()->WriteMMIOShadowed(offset + i, arguments[i]);
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   return Status::OK();
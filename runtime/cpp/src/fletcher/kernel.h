@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -27,6 +28,40 @@
 
 namespace fletcher {
 
+/**
+ * @brief Profile counters of a field.
+ *
+ * The hardware counts the cycles in which the ArrayReader/Writer of the field has commands in flight, the beats it
+ * requests and transfers over the bus, the cycles in which a valid stream between it and the kernel is not ready, and
+ * the bytes it transfers. The counters are 32 bits wide, wrap around and only reset with the device.
+ */
+struct FieldCounters {
+  /// Name of the RecordBatch.
+  std::string recordbatch;
+  /// Name of the field.
+  std::string field;
+  uint32_t busy_cycles = 0;
+  uint32_t request_beats = 0;
+  uint32_t data_beats = 0;
+  uint32_t stall_cycles = 0;
+  uint32_t bytes = 0;
+
+  /// @brief Return the counters accumulated since \p start. Counters that wrapped around are accounted for.
+  FieldCounters Since(const FieldCounters &start) const;
+};
+
+/// @brief Profile counters of all profiled fields of a Kernel.
+struct CounterReport {
+  /// The counters of every profiled field, in the order of the RecordBatches and their fields.
+  std::vector<FieldCounters> fields;
+
+  /// @brief Return the counters accumulated since \p start, which must be a report of the same Kernel.
+  CounterReport Since(const CounterReport &start) const;
+
+  /// @brief Return a human-readable table of the counters.
+  std::string ToString() const;
+};
+
 /**
  * @brief Abstract class for Kernel management
  */
@@ -37,13 +72,28 @@ class Kernel {
   /// @brief Check if the Schema of this Kernel is compatible with another Schema
   bool ImplementsSchema(const std::shared_ptr<arrow::Schema> &schema);
 
-  /// @brief Reset the Kernel
+  /// @brief Reset the Kernel. Invalidates the MMIO register shadow, so the next shadowed writes reach the device.
   Status Reset();
 
-  /// @brief Set the first (inclusive) and last (exclusive) row to process
+  /// @brief Set the first (inclusive) and last (exclusive) row to process. Unchanged registers are not rewritten.
   Status SetRange(size_t recordbatch_index, int32_t first, int32_t last);
 
-  /// @brief Set the parameters of the Kernel
+  /**
+   * @brief Set the maximum burst length in beats of a field with a burst length register.
+   *
+   * The synthesized maximum burst length bounds the burst length. Zero selects the synthesized maximum. Unchanged
+   * registers are not rewritten.
+   */
+  Status SetBurstMaxLen(size_t recordbatch_index, const std::string &field_name, uint32_t beats);
+
+  /**
+   * @brief Read the profile counters of all fields with "fletcher_profile" metadata.
+   *
+   * The counter registers are read in one batch. The report is empty if no field is profiled.
+   */
+  Status ReadCounters(CounterReport *report);
+
+  /// @brief Set the parameters of the Kernel. Unchanged registers are not rewritten.
   Status SetArguments(std::vector<uint32_t> arguments);
 
   /// @brief Start the Kernel
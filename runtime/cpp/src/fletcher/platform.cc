@@ -14,6 +14,7 @@
 
 #include "fletcher/platform.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <memory>
@@ -87,55 +88,190 @@ Status Platform::Link(void *handle, bool quiet) {
 
     char *err = dlerror();
 
-    if (err == nullptr) {
-      return Status::OK();
-    } else {
+    if (err != nullptr) {
       if (!quiet) {
         FLETCHER_LOG(ERROR, err);
       }
       return Status::ERROR();
     }
+
+    // Optional functions. Clear the error that results from their absence.
+    *reinterpret_cast<void **>((&platformGetMmioBase)) = dlsym(handle, "platformGetMmioBase");
+    *reinterpret_cast<void **>((&platformSetDeviceRegion)) = dlsym(handle, "platformSetDeviceRegion");
+    *reinterpret_cast<void **>((&platformSetDeviceHugePages)) = dlsym(handle, "platformSetDeviceHugePages");
+    dlerror();
+
+    return Status::OK();
   } else {
     FLETCHER_LOG(ERROR, "Cannot link FPGA platform functions. Invalid handle.");
     return Status::ERROR();
   }
 }
 
-Status Platform::ReadMMIO64(uint64_t offset, uint64_t *value){
-  freg_t hi, lo;
+Status Platform::Init() {
+  Status stat(platformInit(init_data));
+  if (!stat.ok()) {
+    return stat;
+  }
+
+  capabilities_ = 0;
+  mmio_base_ = nullptr;
+  mmio_num_regs_ = 0;
+  ResetMMIOShadow();
+
+  // Attempt to map the MMIO register file into the host address space.
+  if (platformGetMmioBase != nullptr) {
+    volatile freg_t *base = nullptr;
+    uint64_t num_regs = 0;
+    if ((platformGetMmioBase(&base, &num_regs) == FLETCHER_STATUS_OK) && (base != nullptr)) {
+      mmio_base_ = base;
+      mmio_num_regs_ = num_regs;
+      capabilities_ |= FLETCHER_PLATFORM_CAP_MMIO_MAPPED;
+    }
+  }
+
+  if (platformSetDeviceRegion != nullptr) {
+    capabilities_ |= FLETCHER_PLATFORM_CAP_DEVICE_REGIONS;
+  }
+
+  if (platformSetDeviceHugePages != nullptr) {
+    capabilities_ |= FLETCHER_PLATFORM_CAP_HUGE_PAGES;
+  }
+
+  return Status::OK();
+}
+
+Status Platform::SetDeviceRegion(uint32_t region) {
+  if (platformSetDeviceRegion == nullptr) {
+    if (region == FLETCHER_REG_MM_DEFAULT_REGION) {
+      return Status::OK();
+    }
+    return Status::ERROR("Platform does not support multiple device memory regions.");
+  }
+  return Status(platformSetDeviceRegion(region));
+}
+
+Status Platform::SetDeviceHugePages(bool enable) {
+  if (platformSetDeviceHugePages == nullptr) {
+    if (!enable) {
+      return Status::OK();
+    }
+    return Status::ERROR("Platform does not support huge pages.");
+  }
+  return Status(platformSetDeviceHugePages(enable ? 1 : 0));
+}
+
+Status Platform::WriteMMIOShadowed(uint64_t offset, uint32_t value) {
+  if (offset < mmio_shadow_.size()) {
+    if (mmio_shadow_valid_[offset] && (mmio_shadow_[offset] == value)) {
+      mmio_shadow_hits_++;
+      return Status::OK();
+    }
+  } else {
+    mmio_shadow_.resize(offset + 1, 0);
+    mmio_shadow_valid_.resize(offset + 1, false);
+  }
+  // WriteMMIO updates the shadow.
+  return WriteMMIO(offset, value);
+}
+
+void Platform::ResetMMIOShadow() {
+  std::fill(mmio_shadow_valid_.begin(), mmio_shadow_valid_.end(), false);
+  mmio_shadow_hits_ = 0;
+}
+
+Status Platform::ReadMMIO64(uint64_t offset, uint64_t *value) {
+  // Maximum number of attempts to obtain a consistent value
+  constexpr int max_attempts = 16;
+  freg_t hi, lo, hi_check;
   Status stat;
 
   // Read high bits
   stat = ReadMMIO(offset + 1, &hi);
-  if(!stat.ok()){
+  if (!stat.ok()) {
     return stat;
   }
-  *value = ((uint64_t) hi) << 32;
 
-  // Read low bits
-  stat = ReadMMIO(offset, &lo);
-  if(!stat.ok()){
-    return stat;
+  for (int attempt = 0; attempt < max_attempts; attempt++) {
+    // Read low bits
+    stat = ReadMMIO(offset, &lo);
+    if (!stat.ok()) {
+      return stat;
+    }
+    // Read high bits again, to check if the low bits didn't overflow into the high bits in between.
+    stat = ReadMMIO(offset + 1, &hi_check);
+    if (!stat.ok()) {
+      return stat;
+    }
+    if (hi_check == hi) {
+      *value = (static_cast<uint64_t>(hi) << 32) | lo;
+      return Status::OK();
+    }
+    hi = hi_check;
   }
-  *value |= lo;
 
+  return Status::ERROR("Could not obtain consistent 64-bit value from MMIO registers " + std::to_string(offset)
+                           + " and " + std::to_string(offset + 1) + ".");
+}
+
+Status Platform::ReadMMIORange(uint64_t offset, uint64_t num_regs, freg_t *values) {
+  if (offset + num_regs <= mmio_num_regs_) {
+    for (uint64_t i = 0; i < num_regs; i++) {
+      values[i] = mmio_base_[offset + i];
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return Status::OK();
+  }
+  for (uint64_t i = 0; i < num_regs; i++) {
+    auto stat = Status(platformReadMMIO(offset + i, &values[i]));
+    if (!stat.ok()) {
+      return stat;
+    }
+  }
   return Status::OK();
 }
 
-Status Platform::MmioToString(std::string* str, uint64_t start, uint64_t stop, bool quiet) {
-  std::stringstream ss;
-  Status stat;
-  for (uint64_t off = start; off < stop; off++) {
-    uint32_t val;
-    stat = ReadMMIO(off, &val);
+Status Platform::WriteMMIORange(uint64_t offset, uint64_t num_regs, const freg_t *values) {
+  if (offset + num_regs > mmio_shadow_.size()) {
+    mmio_shadow_.resize(offset + num_regs, 0);
+    mmio_shadow_valid_.resize(offset + num_regs, false);
+  }
+  for (uint64_t i = 0; i < num_regs; i++) {
+    mmio_shadow_[offset + i] = values[i];
+    mmio_shadow_valid_[offset + i] = true;
+  }
+  if (offset + num_regs <= mmio_num_regs_) {
+    // Make sure all preceding memory operations are visible before the device observes the writes.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (uint64_t i = 0; i < num_regs; i++) {
+      mmio_base_[offset + i] = values[i];
+    }
+    return Status::OK();
+  }
+  for (uint64_t i = 0; i < num_regs; i++) {
+    auto stat = Status(platformWriteMMIO(offset + i, values[i]));
     if (!stat.ok()) {
       return stat;
-    } else {
-      if (!quiet) {
-        ss << "R" << std::uppercase << std::hex << std::setw(3) << std::setfill('0') << off
-                  << ":" << std::uppercase << std::hex << std::setw(8) << std::setfill('0') << val
-                  << std::endl;
-      }
+    }
+  }
+  return Status::OK();
+}
+
+Status Platform::MmioToString(std::string* str, uint64_t start, uint64_t stop, bool quiet) {
+  if (stop < start) {
+    return Status::ERROR("Invalid MMIO range.");
+  }
+  std::vector<freg_t> values(stop - start);
+  Status stat = ReadMMIORange(start, stop - start, values.data());
+  if (!stat.ok()) {
+    return stat;
+  }
+  std::stringstream ss;
+  if (!quiet) {
+    for (uint64_t off = start; off < stop; off++) {
+      ss << "R" << std::uppercase << std::hex << std::setw(3) << std::setfill('0') << off
+         << ":" << std::uppercase << std::hex << std::setw(8) << std::setfill('0') << values[off - start]
+         << std::endl;
     }
   }
   *str = ss.str();
@@ -15,9 +15,11 @@
 #pragma once
 
 #include <dlfcn.h>
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 #include <cassert>
 
 #include "fletcher/status.h"
@@ -51,11 +53,25 @@ class Platform {
   /// @brief Return the name of the platform
   std::string name();
 
-  /// @brief Print the contents of the MMIO registers within some range
+  /**
+   * @brief Print the contents of the MMIO registers within some range
+   *
+   * The registers are read in one batch through ReadMMIORange before they are formatted.
+   */
   Status MmioToString(std::string* str, uint64_t start, uint64_t stop, bool quiet = false);
 
-  /// @brief Initialize the platform
-  inline Status Init() { return Status(platformInit(init_data)); }
+  /**
+   * @brief Initialize the platform
+   *
+   * If the platform library provides platformGetMmioBase, the MMIO register file is mapped into the host address
+   * space after initialization, and subsequent MMIO accesses bypass the platform library.
+   *
+   * @return            Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status Init();
+
+  /// @brief Return the capabilities of the platform as a bitmask of FLETCHER_PLATFORM_CAP_* flags.
+  inline uint64_t capabilities() const { return capabilities_; }
 
   /**
    * @brief Write to MMIO register
@@ -63,7 +79,49 @@ class Platform {
    * @param value       Value to write
    * @return            Status::OK() if successful, Status::ERROR() otherwise.
    */
-  inline Status WriteMMIO(uint64_t offset, uint32_t value) { return Status(platformWriteMMIO(offset, value)); }
+  inline Status WriteMMIO(uint64_t offset, uint32_t value) {
+    if (offset < mmio_shadow_.size()) {
+      mmio_shadow_[offset] = value;
+      mmio_shadow_valid_[offset] = true;
+    }
+    if (offset < mmio_num_regs_) {
+      // Make sure all preceding memory operations are visible before the device observes the write.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      mmio_base_[offset] = value;
+      return Status::OK();
+    }
+    return Status(platformWriteMMIO(offset, value));
+  }
+
+  /**
+   * @brief Write a range of successive MMIO registers.
+   *
+   * If the MMIO register file is mapped, all registers are written after a single memory fence.
+   *
+   * @param offset      Offset of the first register
+   * @param num_regs    Number of registers to write
+   * @param values      Buffer of at least num_regs values to write
+   * @return            Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status WriteMMIORange(uint64_t offset, uint64_t num_regs, const freg_t *values);
+
+  /**
+   * @brief Write to MMIO register, unless the same value was written to it since the last shadow reset.
+   *
+   * Only use this for registers that hold configuration, i.e. that are not modified by the device and where writing
+   * has no side effects other than storing the value.
+   *
+   * @param offset      Register offset
+   * @param value       Value to write
+   * @return            Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status WriteMMIOShadowed(uint64_t offset, uint32_t value);
+
+  /// @brief Invalidate all entries in the MMIO register shadow, forcing subsequent shadowed writes to the device.
+  void ResetMMIOShadow();
+
+  /// @brief Return the number of shadowed writes that were skipped since the last shadow reset.
+  inline uint64_t mmio_shadow_hits() const { return mmio_shadow_hits_; }
 
   /**
   * @brief Read from MMIO register
@@ -71,16 +129,37 @@ class Platform {
   * @param value       Value to read to
   * @return            Status::OK() if successful, Status::ERROR() otherwise.
   */
-  inline Status ReadMMIO(uint64_t offset, uint32_t *value) { return Status(platformReadMMIO(offset, value)); }
+  inline Status ReadMMIO(uint64_t offset, uint32_t *value) {
+    if (offset < mmio_num_regs_) {
+      *value = mmio_base_[offset];
+      // Make sure no subsequent memory operation is performed before the device has answered.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      return Status::OK();
+    }
+    return Status(platformReadMMIO(offset, value));
+  }
 
   /**
   * @brief Read 64 bit value from two successive 32 bit MMIO registers.
+  *
+  * The high register is read before and after the low register. If the device changed the high register in between,
+  * the read is retried, such that the returned value is consistent.
+  *
   * @param offset      Register offset
   * @param value       Value to read to
   * @return            Status::OK() if successful, Status::ERROR() otherwise.
   */
   Status ReadMMIO64(uint64_t offset, uint64_t *value);
 
+  /**
+   * @brief Read a range of successive MMIO registers.
+   * @param offset      Offset of the first register
+   * @param num_regs    Number of registers to read
+   * @param values      Buffer of at least num_regs registers to read to
+   * @return            Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status ReadMMIORange(uint64_t offset, uint64_t num_regs, freg_t *values);
+
   /**
    * @brief Allocate a region of memory on the device
    * @param device_address  The resulting device address
@@ -91,6 +170,29 @@ class Platform {
     return Status(platformDeviceMalloc(device_address, size));
   }
 
+  /**
+   * @brief Select the device memory region in which subsequent allocations are placed.
+   *
+   * Platforms with multiple memory channels place the buffers of every channel in a separate region. Memory channel N
+   * uses region FLETCHER_REG_MM_DEFAULT_REGION + N. Platforms without the FLETCHER_PLATFORM_CAP_DEVICE_REGIONS
+   * capability only support the default region.
+   *
+   * @param region          The device memory region.
+   * @return                Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status SetDeviceRegion(uint32_t region);
+
+  /**
+   * @brief Map subsequent device memory allocations with huge pages where possible.
+   *
+   * This is a hint; the device may still map (parts of) an allocation with regular pages. Platforms without the
+   * FLETCHER_PLATFORM_CAP_HUGE_PAGES capability only support regular pages.
+   *
+   * @param enable          Whether to use huge pages.
+   * @return                Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  Status SetDeviceHugePages(bool enable);
+
   /**
    * @brief Free a previously allocated memory region on the device.
    * @param device_address  The device address of the memory region.
@@ -152,6 +254,11 @@ class Platform {
   inline Status Terminate() {
     assert(platformTerminate != nullptr);
     terminated = true;
+    ResetMMIOShadow();
+    // The mapping is no longer valid after termination.
+    mmio_base_ = nullptr;
+    mmio_num_regs_ = 0;
+    capabilities_ = 0;
     return Status(platformTerminate(terminate_data));
   }
 
@@ -176,11 +283,30 @@ class Platform {
   fstatus_t (*platformCacheHostBuffer)(const uint8_t *host_source, da_t *device_destination, int64_t size) = nullptr;
   fstatus_t (*platformTerminate)(void *arg) = nullptr;
 
+  // Optional functions to be linked
+  fstatus_t (*platformGetMmioBase)(volatile freg_t **base, uint64_t *num_regs) = nullptr;
+  fstatus_t (*platformSetDeviceRegion)(uint32_t region) = nullptr;
+  fstatus_t (*platformSetDeviceHugePages)(int enable) = nullptr;
+
   /// @brief Attempt to link all functions using a handle obtained by dlopen
   Status Link(void *handle, bool quiet = true);
 
   bool terminated = false;
 
+  /// Bitmask of FLETCHER_PLATFORM_CAP_* flags.
+  uint64_t capabilities_ = 0;
+  /// Host address of the mapped MMIO register file, if any.
+  volatile freg_t *mmio_base_ = nullptr;
+  /// Number of registers accessible through the mapping. Zero if the MMIO registers are not mapped.
+  uint64_t mmio_num_regs_ = 0;
+
+  /// Last values written to the MMIO registers.
+  std::vector<freg_t> mmio_shadow_;
+  /// Whether the shadow value of a register is known to be equal to the register value.
+  std::vector<bool> mmio_shadow_valid_;
+  /// Number of shadowed writes that were skipped.
+  uint64_t mmio_shadow_hits_ = 0;
+
 };
 
 }  // namespace fletcher
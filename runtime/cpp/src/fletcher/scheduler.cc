@@ -0,0 +1,304 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fletcher/scheduler.h"
+
+#include <algorithm>
+#include <utility>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+#include <fletcher/common.h>
+
+#include "fletcher/kernel.h"
+
+namespace fletcher {
+
+double SchedulerMetrics::mean_wait_time() const {
+  auto executed = completed + failed;
+  if (executed == 0) {
+    return 0.0;
+  }
+  return total_wait_time / executed;
+}
+
+Status DeviceScheduler::Make(std::shared_ptr<DeviceScheduler> *scheduler,
+                             const std::shared_ptr<Platform> &platform,
+                             SchedulerOptions options) {
+  if (platform == nullptr) {
+    return Status::ERROR("Platform is nullptr.");
+  }
+  if (options.max_staged == 0) {
+    return Status::ERROR("Scheduler must be able to stage at least one job.");
+  }
+  *scheduler = std::make_shared<DeviceScheduler>(platform, options);
+  return Status::OK();
+}
+
+DeviceScheduler::~DeviceScheduler() {
+  Stop();
+}
+
+Status DeviceScheduler::Submit(Job job, std::future<JobResult> *result) {
+  auto pending = std::make_shared<PendingJob>();
+  pending->job = std::move(job);
+  pending->submitted = clock::now();
+  *result = pending->promise.get_future();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopping_) {
+    return Status::ERROR("Scheduler is stopping.");
+  }
+  pending->id = next_id_++;
+  queues_[pending->job.tenant].push_back(pending);
+  num_queued_++;
+  metrics_.submitted++;
+  cv_.notify_all();
+  return Status::OK();
+}
+
+Status DeviceScheduler::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (started_) {
+    return Status::ERROR("Scheduler was already started.");
+  }
+  started_ = true;
+  transfer_thread_ = std::thread(&DeviceScheduler::TransferLoop, this);
+  execute_thread_ = std::thread(&DeviceScheduler::ExecuteLoop, this);
+  return Status::OK();
+}
+
+void DeviceScheduler::Stop() {
+  bool started;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    started = started_;
+    cv_.notify_all();
+  }
+  if (started) {
+    if (transfer_thread_.joinable()) {
+      transfer_thread_.join();
+    }
+    if (execute_thread_.joinable()) {
+      execute_thread_.join();
+    }
+  } else {
+    // Nothing will ever execute the queued jobs.
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (HasQueued()) {
+      Fail(PopNext(), Status::ERROR("Scheduler was stopped before it was started."));
+    }
+  }
+}
+
+SchedulerMetrics DeviceScheduler::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto result = metrics_;
+  result.queue_depth = num_queued_;
+  result.staged = staged_.size();
+  return result;
+}
+
+bool DeviceScheduler::HasQueued() const {
+  return num_queued_ > 0;
+}
+
+std::shared_ptr<DeviceScheduler::PendingJob> DeviceScheduler::PopNext() {
+  std::deque<std::shared_ptr<PendingJob>> *best = nullptr;
+  uint64_t best_tenant = 0;
+  for (auto &q : queues_) {
+    if (q.second.empty()) {
+      continue;
+    }
+    if (best == nullptr) {
+      best = &q.second;
+      best_tenant = q.first;
+      continue;
+    }
+    const auto &cand = q.second.front();
+    const auto &cur = best->front();
+    auto cand_served = last_served_[q.first];
+    auto cur_served = last_served_[best_tenant];
+    // Highest priority first, then the tenant that was served least recently, then the oldest job.
+    if ((cand->job.priority > cur->job.priority)
+        || ((cand->job.priority == cur->job.priority) && (cand_served < cur_served))
+        || ((cand->job.priority == cur->job.priority) && (cand_served == cur_served) && (cand->id < cur->id))) {
+      best = &q.second;
+      best_tenant = q.first;
+    }
+  }
+  auto result = best->front();
+  best->pop_front();
+  num_queued_--;
+  last_served_[best_tenant] = ++picks_;
+  return result;
+}
+
+Status DeviceScheduler::Stage(PendingJob *pending) {
+  std::lock_guard<std::mutex> platform_lock(platform_mutex_);
+  auto status = Context::Make(&pending->context, platform_);
+  if (!status.ok()) {
+    return status;
+  }
+  for (const auto &batch : pending->job.batches) {
+    status = pending->context->QueueRecordBatch(batch, pending->job.mem_type);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return pending->context->Enable();
+}
+
+JobResult DeviceScheduler::Execute(PendingJob *pending) {
+  JobResult result;
+  Kernel kernel(pending->context);
+
+  auto start = clock::now();
+  result.wait_time = std::chrono::duration<double>(start - pending->submitted).count();
+
+  {
+    std::lock_guard<std::mutex> platform_lock(platform_mutex_);
+    result.status = kernel.Reset();
+    for (size_t i = 0; (i < pending->job.batches.size()) && result.status.ok(); i++) {
+      result.status = kernel.SetRange(i, 0, static_cast<int32_t>(pending->job.batches[i]->num_rows()));
+    }
+    if (result.status.ok()) {
+      result.status = kernel.SetArguments(pending->job.arguments);
+    }
+    if (result.status.ok()) {
+      result.status = kernel.Start();
+    }
+  }
+
+  // Poll the status without holding the platform lock in between, so the transfer thread can stage the next job.
+  uint32_t status = 0;
+  while (result.status.ok()) {
+    {
+      std::lock_guard<std::mutex> platform_lock(platform_mutex_);
+      result.status = kernel.GetStatus(&status);
+    }
+    if ((status & kernel.done_status_mask) == kernel.done_status) {
+      break;
+    }
+    if (options_.poll_interval_usec > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(options_.poll_interval_usec));
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  if (result.status.ok()) {
+    std::lock_guard<std::mutex> platform_lock(platform_mutex_);
+    result.status = kernel.GetReturn(&result.return0, &result.return1);
+  }
+
+  result.run_time = std::chrono::duration<double>(clock::now() - start).count();
+  return result;
+}
+
+void DeviceScheduler::Fail(const std::shared_ptr<PendingJob> &pending, const Status &status) {
+  JobResult result;
+  result.status = status;
+  metrics_.failed++;
+  pending->promise.set_value(result);
+}
+
+void DeviceScheduler::TransferLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] {
+      return !retired_.empty()
+          || (HasQueued() && (staged_.size() < options_.max_staged))
+          || (stopping_ && !HasQueued() && staged_.empty() && !executing_);
+    });
+
+    if (!retired_.empty()) {
+      // Free the device memory of executed jobs first, to make room for new ones.
+      auto pending = retired_.front();
+      retired_.pop_front();
+      lock.unlock();
+      {
+        std::lock_guard<std::mutex> platform_lock(platform_mutex_);
+        pending->context.reset();
+      }
+      pending.reset();
+      lock.lock();
+    } else if (HasQueued() && (staged_.size() < options_.max_staged)) {
+      auto pending = PopNext();
+      staging_ = true;
+      lock.unlock();
+      auto status = Stage(pending.get());
+      lock.lock();
+      staging_ = false;
+      if (status.ok()) {
+        staged_.push_back(pending);
+      } else {
+        lock.unlock();
+        {
+          std::lock_guard<std::mutex> platform_lock(platform_mutex_);
+          pending->context.reset();
+        }
+        lock.lock();
+        Fail(pending, status);
+      }
+      cv_.notify_all();
+    } else {
+      // Stopping, and there is nothing left to do.
+      break;
+    }
+  }
+}
+
+void DeviceScheduler::ExecuteLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] {
+      return !staged_.empty() || (stopping_ && !HasQueued() && !staging_);
+    });
+
+    if (staged_.empty()) {
+      // Stopping, and there is nothing left to do.
+      executing_ = false;
+      cv_.notify_all();
+      break;
+    }
+
+    auto pending = staged_.front();
+    staged_.pop_front();
+    executing_ = true;
+    cv_.notify_all();
+    lock.unlock();
+
+    auto result = Execute(pending.get());
+
+    lock.lock();
+    result.sequence = sequence_++;
+    if (result.status.ok()) {
+      metrics_.completed++;
+    } else {
+      metrics_.failed++;
+    }
+    metrics_.total_wait_time += result.wait_time;
+    metrics_.max_wait_time = std::max(metrics_.max_wait_time, result.wait_time);
+    metrics_.total_run_time += result.run_time;
+    pending->promise.set_value(result);
+    retired_.push_back(pending);
+    executing_ = false;
+    cv_.notify_all();
+  }
+}
+
+}  // namespace fletcher
@@ -0,0 +1,201 @@
+// Copyright 2018 Delft University of Technology
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "fletcher/status.h"
+#include "fletcher/platform.h"
+#include "fletcher/context.h"
+
+namespace fletcher {
+
+/// @brief A unit of work to be scheduled on the device.
+struct Job {
+  /// The RecordBatches to process. The kernel processes all rows of every RecordBatch.
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  /// The kernel arguments.
+  std::vector<uint32_t> arguments;
+  /// The memory type used to make the RecordBatches available to the device.
+  MemType mem_type = MemType::ANY;
+  /// Jobs with a higher priority are scheduled first.
+  int priority = 0;
+  /// Jobs with equal priority are scheduled round-robin over tenants.
+  uint64_t tenant = 0;
+};
+
+/// @brief The outcome of a Job.
+struct JobResult {
+  /// Status::OK() if the job was executed successfully.
+  Status status;
+  /// Value of the first return register.
+  uint32_t return0 = 0;
+  /// Value of the second return register.
+  uint32_t return1 = 0;
+  /// Seconds between submission of the job and the start of its kernel.
+  double wait_time = 0.0;
+  /// Seconds between the start of the kernel and its completion.
+  double run_time = 0.0;
+  /// Position of the job in the order of execution on the device.
+  uint64_t sequence = 0;
+};
+
+/// @brief Metrics of a DeviceScheduler.
+struct SchedulerMetrics {
+  /// Number of jobs waiting to be transferred to the device.
+  size_t queue_depth = 0;
+  /// Number of jobs transferred to the device, waiting for their kernel to start.
+  size_t staged = 0;
+  /// Number of jobs submitted.
+  uint64_t submitted = 0;
+  /// Number of jobs completed successfully.
+  uint64_t completed = 0;
+  /// Number of jobs that failed.
+  uint64_t failed = 0;
+  /// Sum of wait times of executed jobs, in seconds.
+  double total_wait_time = 0.0;
+  /// Maximum wait time of executed jobs, in seconds.
+  double max_wait_time = 0.0;
+  /// Sum of kernel run times of executed jobs, in seconds.
+  double total_run_time = 0.0;
+
+  /// @brief Return the mean wait time of executed jobs, in seconds.
+  double mean_wait_time() const;
+};
+
+/// @brief Options for a DeviceScheduler.
+struct SchedulerOptions {
+  /// Maximum number of jobs that are transferred to the device ahead of the running job.
+  size_t max_staged = 1;
+  /// Kernel status polling interval in microseconds. Polls at maximum speed when zero.
+  unsigned int poll_interval_usec = 0;
+};
+
+/**
+ * @brief Schedules jobs from multiple threads onto a single device.
+ *
+ * The scheduler owns all access to the platform while it is running. One thread transfers the RecordBatches of queued
+ * jobs to the device and frees them when jobs complete, while another thread runs the kernel of the staged jobs. This
+ * way, the transfers of queued jobs overlap with the execution of the running job on the device.
+ *
+ * Platforms are not thread-safe, so calls into the platform never overlap: the transfer thread holds the platform lock
+ * while it stages or frees a job, and the execute thread holds it for every kernel register access. The execute thread
+ * releases the lock between status polls, so transfers proceed while the kernel runs.
+ *
+ * The next job to transfer is the one with the highest priority. Among jobs with equal priority, the tenant that was
+ * served least recently goes first.
+ */
+class DeviceScheduler {
+ public:
+  explicit DeviceScheduler(std::shared_ptr<Platform> platform, SchedulerOptions options = SchedulerOptions())
+      : platform_(std::move(platform)), options_(options) {}
+  ~DeviceScheduler();
+
+  /**
+   * @brief Create a new scheduler for a platform.
+   * @param scheduler   The new scheduler.
+   * @param platform    The initialized platform to schedule jobs on.
+   * @param options     Scheduling options.
+   * @return            Status::OK() if successful, Status::ERROR() otherwise.
+   */
+  static Status Make(std::shared_ptr<DeviceScheduler> *scheduler,
+                     const std::shared_ptr<Platform> &platform,
+                     SchedulerOptions options = SchedulerOptions());
+
+  /**
+   * @brief Submit a job. Thread-safe.
+   * @param job         The job to submit.
+   * @param result      A future that obtains the result of the job when it has been executed.
+   * @return            Status::OK() if successful, Status::ERROR() if the scheduler is stopping.
+   */
+  Status Submit(Job job, std::future<JobResult> *result);
+
+  /// @brief Start the worker threads. Jobs may be submitted before the scheduler is started.
+  Status Start();
+
+  /// @brief Execute all submitted jobs, then stop the worker threads.
+  void Stop();
+
+  /// @brief Return a snapshot of the scheduler metrics. Thread-safe.
+  SchedulerMetrics metrics() const;
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  struct PendingJob {
+    Job job;
+    std::promise<JobResult> promise;
+    clock::time_point submitted;
+    uint64_t id = 0;
+    std::shared_ptr<Context> context;
+  };
+
+  /// @brief Return true if any job is waiting to be transferred. Requires the lock.
+  bool HasQueued() const;
+  /// @brief Remove the next job to transfer from the queues. Requires the lock.
+  std::shared_ptr<PendingJob> PopNext();
+  /// @brief Transfer the RecordBatches of a job to the device.
+  Status Stage(PendingJob *pending);
+  /// @brief Run the kernel for a staged job.
+  JobResult Execute(PendingJob *pending);
+  /// @brief Fail a job and update the metrics. Requires the lock.
+  void Fail(const std::shared_ptr<PendingJob> &pending, const Status &status);
+
+  void TransferLoop();
+  void ExecuteLoop();
+
+  std::shared_ptr<Platform> platform_;
+  SchedulerOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  /// Serializes all calls into the platform, including those that modify its MMIO shadow.
+  std::mutex platform_mutex_;
+
+  /// Jobs waiting for transfer, per tenant.
+  std::map<uint64_t, std::deque<std::shared_ptr<PendingJob>>> queues_;
+  /// Pick stamp of the last job of every tenant.
+  std::map<uint64_t, uint64_t> last_served_;
+  /// Jobs transferred to the device, waiting for execution.
+  std::deque<std::shared_ptr<PendingJob>> staged_;
+  /// Jobs that were executed, waiting for their device memory to be freed.
+  std::deque<std::shared_ptr<PendingJob>> retired_;
+
+  size_t num_queued_ = 0;
+  bool staging_ = false;
+  bool executing_ = false;
+  bool started_ = false;
+  bool stopping_ = false;
+  uint64_t next_id_ = 0;
+  uint64_t picks_ = 0;
+  uint64_t sequence_ = 0;
+  SchedulerMetrics metrics_;
+
+  std::thread transfer_thread_;
+  std::thread execute_thread_;
+};
+
+}  // namespace fletcher
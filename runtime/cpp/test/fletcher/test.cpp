@@ -17,13 +17,40 @@
 #include <arrow/record_batch.h>
 #include <fletcher_echo.h>
 #include <gtest/gtest.h>
+#include <dlfcn.h>
 
 #include <string>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <future>
+#include <map>
+#include <sstream>
 
 #include "fletcher/platform.h"
 #include "fletcher/context.h"
+#include "fletcher/kernel.h"
+#include "fletcher/scheduler.h"
+#include "fletcher/hybrid.h"
+#include "fletcher/benchmarker.h"
+
+/// @brief Return a function of the loaded echo platform that is not part of the platform interface.
+template<typename Function>
+static Function *GetEchoFunction(const std::string &name) {
+  void *handle = dlopen("libfletcher_echo.so", RTLD_NOW | RTLD_NOLOAD);
+  return handle != nullptr ? reinterpret_cast<Function *>(dlsym(handle, name.c_str())) : nullptr;
+}
+
+static std::shared_ptr<arrow::RecordBatch> GetIntRecordBatch(int64_t num_rows) {
+  arrow::UInt64Builder builder;
+  for (int64_t i = 0; i < num_rows; i++) {
+    EXPECT_TRUE(builder.Append(static_cast<uint64_t>(i)).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  EXPECT_TRUE(builder.Finish(&array).ok());
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false)});
+  return arrow::RecordBatch::Make(schema, num_rows, {array});
+}
 
 TEST(Platform, NoPlatform) {
   std::shared_ptr<fletcher::Platform> platform;
@@ -66,6 +93,90 @@ TEST(Platform, EchoPlatform) {
 
 }
 
+TEST(Platform, EchoMappedMMIO) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+
+  // Without mapping
+  auto opts = std::make_shared<InitOptions>();
+  opts->quiet = 1;
+  platform->init_data = opts.get();
+  ASSERT_TRUE(platform->Init().ok());
+  ASSERT_EQ(platform->capabilities() & FLETCHER_PLATFORM_CAP_MMIO_MAPPED, 0u);
+  ASSERT_TRUE(platform->WriteMMIO(FLETCHER_REG_SCHEMA, 0x01234567).ok());
+  uint32_t val = 0;
+  ASSERT_TRUE(platform->ReadMMIO(FLETCHER_REG_SCHEMA, &val).ok());
+  ASSERT_EQ(val, 0x01234567u);
+  ASSERT_TRUE(platform->Terminate().ok());
+
+  // With mapping
+  opts->map_mmio = 1;
+  ASSERT_TRUE(platform->Init().ok());
+  ASSERT_EQ(platform->capabilities() & FLETCHER_PLATFORM_CAP_MMIO_MAPPED, FLETCHER_PLATFORM_CAP_MMIO_MAPPED);
+  ASSERT_TRUE(platform->WriteMMIO(FLETCHER_REG_SCHEMA, 0x89ABCDEF).ok());
+  ASSERT_TRUE(platform->WriteMMIO(FLETCHER_REG_SCHEMA + 1, 0x76543210).ok());
+  ASSERT_TRUE(platform->ReadMMIO(FLETCHER_REG_SCHEMA, &val).ok());
+  ASSERT_EQ(val, 0x89ABCDEFu);
+  uint64_t val64 = 0;
+  ASSERT_TRUE(platform->ReadMMIO64(FLETCHER_REG_SCHEMA, &val64).ok());
+  ASSERT_EQ(val64, 0x7654321089ABCDEFul);
+
+  // Registers outside of the mapped range go through the platform library.
+  ASSERT_TRUE(platform->ReadMMIO(FLETCHER_ECHO_NUM_REGS, &val).ok());
+  ASSERT_EQ(val, FLETCHER_ECHO_REG_DEFAULT);
+
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(Platform, MMIOShadow) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  auto opts = std::make_shared<InitOptions>();
+  opts->quiet = 1;
+  platform->init_data = opts.get();
+  ASSERT_TRUE(platform->Init().ok());
+
+  // Redundant writes are skipped
+  ASSERT_TRUE(platform->WriteMMIOShadowed(FLETCHER_REG_SCHEMA, 42).ok());
+  ASSERT_TRUE(platform->WriteMMIOShadowed(FLETCHER_REG_SCHEMA, 42).ok());
+  ASSERT_EQ(platform->mmio_shadow_hits(), 1u);
+  ASSERT_TRUE(platform->WriteMMIOShadowed(FLETCHER_REG_SCHEMA, 43).ok());
+  ASSERT_EQ(platform->mmio_shadow_hits(), 1u);
+
+  // Unshadowed writes keep the shadow coherent
+  ASSERT_TRUE(platform->WriteMMIO(FLETCHER_REG_SCHEMA, 44).ok());
+  ASSERT_TRUE(platform->WriteMMIOShadowed(FLETCHER_REG_SCHEMA, 43).ok());
+  ASSERT_EQ(platform->mmio_shadow_hits(), 1u);
+  uint32_t val = 0;
+  ASSERT_TRUE(platform->ReadMMIO(FLETCHER_REG_SCHEMA, &val).ok());
+  ASSERT_EQ(val, 43u);
+
+  // A reset forces the next write
+  platform->ResetMMIOShadow();
+  ASSERT_TRUE(platform->WriteMMIOShadowed(FLETCHER_REG_SCHEMA, 43).ok());
+  ASSERT_EQ(platform->mmio_shadow_hits(), 0u);
+
+  // Range reads
+  ASSERT_TRUE(platform->WriteMMIO(FLETCHER_REG_SCHEMA + 1, 0xCAFE).ok());
+  freg_t values[2];
+  ASSERT_TRUE(platform->ReadMMIORange(FLETCHER_REG_SCHEMA, 2, values).ok());
+  ASSERT_EQ(values[0], 43u);
+  ASSERT_EQ(values[1], 0xCAFEu);
+  std::string str;
+  ASSERT_TRUE(platform->MmioToString(&str, FLETCHER_REG_SCHEMA, FLETCHER_REG_SCHEMA + 2).ok());
+  ASSERT_EQ(str, "R004:0000002B\nR005:0000CAFE\n");
+
+  // Range writes update the shadow
+  const freg_t written[3] = {1, 2, 3};
+  ASSERT_TRUE(platform->WriteMMIORange(FLETCHER_REG_SCHEMA, 3, written).ok());
+  ASSERT_TRUE(platform->ReadMMIORange(FLETCHER_REG_SCHEMA, 3, values).ok());
+  ASSERT_EQ(values[1], 2u);
+  ASSERT_TRUE(platform->WriteMMIOShadowed(FLETCHER_REG_SCHEMA + 2, 3).ok());
+  ASSERT_EQ(platform->mmio_shadow_hits(), 1u);
+
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
 TEST(Context, ContextFunctions) {
   std::shared_ptr<fletcher::Platform> platform;
   ASSERT_TRUE(fletcher::Platform::Make(&platform).ok());
@@ -129,6 +240,544 @@ TEST(Context, ContextFunctions) {
   ASSERT_TRUE(platform->Terminate().ok());
 }
 
+TEST(Context, MemoryChannels) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  ASSERT_TRUE(platform->Init().ok());
+  ASSERT_TRUE(platform->capabilities() & FLETCHER_PLATFORM_CAP_DEVICE_REGIONS);
+
+  // All fields of the schema use channel 1, except field b, which uses channel 2.
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               fletcher::AppendMetaBusChannel(*arrow::field("b", arrow::uint64(), false), 2)},
+                              arrow::key_value_metadata({"fletcher_bus_channel"}, {"1"}));
+
+  arrow::UInt64Builder ba;
+  arrow::UInt64Builder bb;
+  std::shared_ptr<arrow::Array> a;
+  std::shared_ptr<arrow::Array> b;
+  ASSERT_TRUE(ba.AppendValues({1, 2, 3, 4}).ok());
+  ASSERT_TRUE(bb.AppendValues({5, 6, 7, 8}).ok());
+  ASSERT_TRUE(ba.Finish(&a).ok());
+  ASSERT_TRUE(bb.Finish(&b).ok());
+  auto rb = arrow::RecordBatch::Make(schema, 4, {a, b});
+
+  std::shared_ptr<fletcher::Context> context;
+  ASSERT_TRUE(fletcher::Context::Make(&context, platform).ok());
+  ASSERT_TRUE(context->QueueRecordBatch(rb).ok());
+  ASSERT_TRUE(context->Enable().ok());
+  ASSERT_EQ(context->num_buffers(), 2);
+  ASSERT_EQ(context->device_buffer(0).channel, 1);
+  ASSERT_EQ(context->device_buffer(1).channel, 2);
+
+  // Allocations outside of the context use the default region again.
+  auto get_region = GetEchoFunction<uint32_t()>("echoGetDeviceRegion");
+  ASSERT_NE(get_region, nullptr);
+  ASSERT_EQ(get_region(), static_cast<uint32_t>(FLETCHER_REG_MM_DEFAULT_REGION));
+
+  // Also when preparing the buffers fails, the default region and regular pages are restored.
+  auto get_huge_pages = GetEchoFunction<int()>("echoGetDeviceHugePages");
+  ASSERT_NE(get_huge_pages, nullptr);
+  std::shared_ptr<fletcher::Context> invalid;
+  ASSERT_TRUE(fletcher::Context::Make(&invalid, platform).ok());
+  ASSERT_TRUE(invalid->QueueRecordBatch(rb, static_cast<fletcher::MemType>(-1)).ok());
+  ASSERT_FALSE(invalid->Enable().ok());
+  ASSERT_EQ(get_region(), static_cast<uint32_t>(FLETCHER_REG_MM_DEFAULT_REGION));
+  ASSERT_EQ(get_huge_pages(), 0);
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(Context, HugePages) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  ASSERT_TRUE(platform->Init().ok());
+  ASSERT_TRUE(platform->capabilities() & FLETCHER_PLATFORM_CAP_HUGE_PAGES);
+
+  auto get_huge_pages = GetEchoFunction<int()>("echoGetDeviceHugePages");
+  ASSERT_NE(get_huge_pages, nullptr);
+  ASSERT_TRUE(platform->SetDeviceHugePages(true).ok());
+  ASSERT_NE(get_huge_pages(), 0);
+
+  arrow::UInt64Builder builder;
+  std::shared_ptr<arrow::Array> array;
+  ASSERT_TRUE(builder.AppendValues({1, 2, 3, 4}).ok());
+  ASSERT_TRUE(builder.Finish(&array).ok());
+  auto rb = arrow::RecordBatch::Make(arrow::schema({arrow::field("a", arrow::uint64(), false)}), 4, {array});
+
+  std::shared_ptr<fletcher::Context> context;
+  ASSERT_TRUE(fletcher::Context::Make(&context, platform).ok());
+  ASSERT_TRUE(context->QueueRecordBatch(rb).ok());
+  ASSERT_TRUE(context->Enable().ok());
+
+  // Allocations outside of the context use regular pages again.
+  ASSERT_EQ(get_huge_pages(), 0);
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(Kernel, Arguments) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  ASSERT_TRUE(platform->Init().ok());
+
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false)});
+  arrow::UInt64Builder ba;
+  std::shared_ptr<arrow::Array> a;
+  ASSERT_TRUE(ba.AppendValues({1, 2, 3, 4}).ok());
+  ASSERT_TRUE(ba.Finish(&a).ok());
+  auto rb = arrow::RecordBatch::Make(schema, 4, {a});
+
+  std::shared_ptr<fletcher::Context> context;
+  ASSERT_TRUE(fletcher::Context::Make(&context, platform).ok());
+  ASSERT_TRUE(context->QueueRecordBatch(rb).ok());
+  ASSERT_TRUE(context->Enable().ok());
+  ASSERT_EQ(context->num_recordbatches(), 1);
+
+  // The arguments follow the range registers and the buffer address registers.
+  fletcher::Kernel kernel(context);
+  ASSERT_TRUE(kernel.SetArguments({42}).ok());
+  uint32_t val = 0;
+  auto offset = FLETCHER_REG_SCHEMA + 2 * context->num_recordbatches() + 2 * context->num_buffers();
+  ASSERT_TRUE(platform->ReadMMIO(offset, &val).ok());
+  ASSERT_EQ(val, 42u);
+
+  // After a kernel reset, the same arguments are written again.
+  ASSERT_TRUE(kernel.Reset().ok());
+  ASSERT_TRUE(kernel.SetArguments({42}).ok());
+  ASSERT_EQ(platform->mmio_shadow_hits(), 0u);
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(Kernel, BurstMaxLen) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  ASSERT_TRUE(platform->Init().ok());
+
+  // Only field b has a burst length register.
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               arrow::field("b", arrow::uint64(), false,
+                                            arrow::key_value_metadata({"fletcher_burst_reg"}, {"true"}))});
+  arrow::UInt64Builder ba;
+  arrow::UInt64Builder bb;
+  std::shared_ptr<arrow::Array> a;
+  std::shared_ptr<arrow::Array> b;
+  ASSERT_TRUE(ba.AppendValues({1, 2, 3, 4}).ok());
+  ASSERT_TRUE(bb.AppendValues({5, 6, 7, 8}).ok());
+  ASSERT_TRUE(ba.Finish(&a).ok());
+  ASSERT_TRUE(bb.Finish(&b).ok());
+  auto rb = arrow::RecordBatch::Make(schema, 4, {a, b});
+
+  std::shared_ptr<fletcher::Context> context;
+  ASSERT_TRUE(fletcher::Context::Make(&context, platform).ok());
+  ASSERT_TRUE(context->QueueRecordBatch(rb).ok());
+  ASSERT_TRUE(context->Enable().ok());
+  ASSERT_EQ(context->num_burst_registers(), 1);
+
+  // The burst length registers follow the buffer address registers.
+  fletcher::Kernel kernel(context);
+  ASSERT_TRUE(kernel.SetBurstMaxLen(0, "b", 8).ok());
+  ASSERT_FALSE(kernel.SetBurstMaxLen(0, "a", 8).ok());
+  ASSERT_FALSE(kernel.SetBurstMaxLen(1, "b", 8).ok());
+  uint32_t val = 0;
+  auto offset = FLETCHER_REG_SCHEMA + 2 * context->num_recordbatches() + 2 * context->num_buffers();
+  ASSERT_TRUE(platform->ReadMMIO(offset, &val).ok());
+  ASSERT_EQ(val, 8u);
+
+  // The arguments follow the burst length registers.
+  ASSERT_TRUE(kernel.SetArguments({42}).ok());
+  ASSERT_TRUE(platform->ReadMMIO(offset + 1, &val).ok());
+  ASSERT_EQ(val, 42u);
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(Kernel, ReadCounters) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  ASSERT_TRUE(platform->Init().ok());
+
+  // Only field b is profiled.
+  auto schema = arrow::schema({arrow::field("a", arrow::uint64(), false),
+                               arrow::field("b", arrow::uint64(), false,
+                                            arrow::key_value_metadata({"fletcher_profile"}, {"true"}))});
+  arrow::UInt64Builder ba;
+  arrow::UInt64Builder bb;
+  std::shared_ptr<arrow::Array> a;
+  std::shared_ptr<arrow::Array> b;
+  ASSERT_TRUE(ba.AppendValues({1, 2, 3, 4}).ok());
+  ASSERT_TRUE(bb.AppendValues({5, 6, 7, 8}).ok());
+  ASSERT_TRUE(ba.Finish(&a).ok());
+  ASSERT_TRUE(bb.Finish(&b).ok());
+  auto rb = arrow::RecordBatch::Make(schema, 4, {a, b});
+
+  std::shared_ptr<fletcher::Context> context;
+  ASSERT_TRUE(fletcher::Context::Make(&context, platform).ok());
+  ASSERT_TRUE(context->QueueRecordBatch(rb).ok());
+  ASSERT_TRUE(context->Enable().ok());
+  ASSERT_EQ(context->num_counter_registers(), FLETCHER_PROFILE_COUNTERS);
+
+  // The counter registers follow the buffer address registers. The echo platform returns what was written.
+  auto offset = FLETCHER_REG_SCHEMA + 2 * context->num_recordbatches() + 2 * context->num_buffers();
+  std::vector<freg_t> counters = {100, 8, 8, 3, 64};
+  ASSERT_TRUE(platform->WriteMMIORange(offset, counters.size(), counters.data()).ok());
+
+  fletcher::Kernel kernel(context);
+  fletcher::CounterReport start;
+  ASSERT_TRUE(kernel.ReadCounters(&start).ok());
+  ASSERT_EQ(start.fields.size(), 1);
+  ASSERT_EQ(start.fields[0].field, "b");
+  ASSERT_EQ(start.fields[0].busy_cycles, 100u);
+  ASSERT_EQ(start.fields[0].request_beats, 8u);
+  ASSERT_EQ(start.fields[0].data_beats, 8u);
+  ASSERT_EQ(start.fields[0].stall_cycles, 3u);
+  ASSERT_EQ(start.fields[0].bytes, 64u);
+
+  // Counters that wrapped around still yield the right difference.
+  counters = {50, 16, 16, 3, 128};
+  ASSERT_TRUE(platform->WriteMMIORange(offset, counters.size(), counters.data()).ok());
+  fletcher::CounterReport end;
+  ASSERT_TRUE(kernel.ReadCounters(&end).ok());
+  auto delta = end.Since(start);
+  ASSERT_EQ(delta.fields[0].busy_cycles, 50u - 100u);
+  ASSERT_EQ(delta.fields[0].data_beats, 8u);
+  ASSERT_EQ(delta.fields[0].stall_cycles, 0u);
+  ASSERT_EQ(delta.fields[0].bytes, 64u);
+  ASSERT_NE(delta.ToString().find(".b"), std::string::npos);
+
+  // The arguments follow the counter registers.
+  ASSERT_TRUE(kernel.SetArguments({42}).ok());
+  uint32_t val = 0;
+  ASSERT_TRUE(platform->ReadMMIO(offset + FLETCHER_PROFILE_COUNTERS, &val).ok());
+  ASSERT_EQ(val, 42u);
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(DeviceScheduler, ConcurrentSubmit) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  auto opts = std::make_shared<InitOptions>();
+  opts->quiet = 1;
+  platform->init_data = opts.get();
+  ASSERT_TRUE(platform->Init().ok());
+
+  std::shared_ptr<fletcher::DeviceScheduler> scheduler;
+  fletcher::SchedulerOptions sched_opts;
+  sched_opts.max_staged = 2;
+  ASSERT_TRUE(fletcher::DeviceScheduler::Make(&scheduler, platform, sched_opts).ok());
+  ASSERT_TRUE(scheduler->Start().ok());
+
+  constexpr int num_threads = 4;
+  constexpr int jobs_per_thread = 8;
+  std::vector<std::thread> threads;
+  std::vector<int> ok(num_threads, 0);
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      std::vector<std::future<fletcher::JobResult>> results;
+      for (int j = 0; j < jobs_per_thread; j++) {
+        fletcher::Job job;
+        job.batches = {GetIntRecordBatch(16 + j)};
+        job.arguments = {static_cast<uint32_t>(j)};
+        job.tenant = static_cast<uint64_t>(t);
+        std::future<fletcher::JobResult> result;
+        if (!scheduler->Submit(job, &result).ok()) {
+          return;
+        }
+        results.push_back(std::move(result));
+      }
+      bool all_ok = true;
+      for (auto &r : results) {
+        all_ok = all_ok && r.get().status.ok();
+      }
+      ok[t] = all_ok ? 1 : 0;
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  scheduler->Stop();
+
+  for (int t = 0; t < num_threads; t++) {
+    ASSERT_EQ(ok[t], 1);
+  }
+  auto metrics = scheduler->metrics();
+  ASSERT_EQ(metrics.submitted, num_threads * jobs_per_thread);
+  ASSERT_EQ(metrics.completed, num_threads * jobs_per_thread);
+  ASSERT_EQ(metrics.failed, 0u);
+  ASSERT_EQ(metrics.queue_depth, 0u);
+  ASSERT_EQ(metrics.staged, 0u);
+
+  // No more jobs are accepted after stopping.
+  std::future<fletcher::JobResult> result;
+  ASSERT_FALSE(scheduler->Submit(fletcher::Job(), &result).ok());
+
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(DeviceScheduler, PriorityAndFairness) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  auto opts = std::make_shared<InitOptions>();
+  opts->quiet = 1;
+  platform->init_data = opts.get();
+  ASSERT_TRUE(platform->Init().ok());
+
+  std::shared_ptr<fletcher::DeviceScheduler> scheduler;
+  ASSERT_TRUE(fletcher::DeviceScheduler::Make(&scheduler, platform).ok());
+
+  // Submit before starting, such that all jobs compete.
+  // Tenant 0 submits three jobs, tenant 1 submits two, and tenant 2 submits one high priority job last.
+  std::vector<std::future<fletcher::JobResult>> results(6);
+  std::vector<uint64_t> tenants = {0, 0, 0, 1, 1, 2};
+  for (size_t i = 0; i < tenants.size(); i++) {
+    fletcher::Job job;
+    job.batches = {GetIntRecordBatch(8)};
+    job.tenant = tenants[i];
+    job.priority = tenants[i] == 2 ? 1 : 0;
+    ASSERT_TRUE(scheduler->Submit(job, &results[i]).ok());
+  }
+  ASSERT_EQ(scheduler->metrics().queue_depth, 6u);
+
+  ASSERT_TRUE(scheduler->Start().ok());
+  std::vector<uint64_t> sequence;
+  for (auto &r : results) {
+    auto result = r.get();
+    ASSERT_TRUE(result.status.ok());
+    sequence.push_back(result.sequence);
+  }
+  scheduler->Stop();
+
+  // High priority first, then alternating between tenants 0 and 1, then the remainder of tenant 0.
+  std::vector<uint64_t> expected = {1, 3, 5, 2, 4, 0};
+  ASSERT_EQ(sequence, expected);
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(HybridExecutor, CostModel) {
+  fletcher::CostModel model(1.0);
+  ASSERT_FALSE(model.calibrated());
+  // 1 ms overhead, 1 ns per byte
+  model.Update(1000, 1e-3 + 1000 * 1e-9);
+  ASSERT_FALSE(model.calibrated());
+  model.Update(1000000, 1e-3 + 1000000 * 1e-9);
+  model.Update(10000000, 1e-3 + 10000000 * 1e-9);
+  ASSERT_TRUE(model.calibrated());
+  ASSERT_EQ(model.num_samples(), 3u);
+  ASSERT_NEAR(model.fixed_overhead(), 1e-3, 1e-9);
+  ASSERT_NEAR(model.seconds_per_byte(), 1e-9, 1e-15);
+  ASSERT_NEAR(model.Predict(2000000), 3e-3, 1e-9);
+
+  // A CPU without overhead that is twice as slow per byte as an FPGA with overhead.
+  fletcher::CostModel cpu(1.0);
+  cpu.Update(1000, 1000 * 2e-9);
+  cpu.Update(2000, 2000 * 2e-9);
+  // Small batches stay on the CPU.
+  ASSERT_EQ(fletcher::HybridExecutor::FpgaFraction(cpu, model, 100), 0.0);
+  // Large batches are split such that both finish at the same time.
+  double bytes = 1e9;
+  double f = fletcher::HybridExecutor::FpgaFraction(cpu, model, bytes);
+  ASSERT_GT(f, 0.0);
+  ASSERT_LT(f, 1.0);
+  ASSERT_NEAR(model.Predict(f * bytes), cpu.Predict((1.0 - f) * bytes), 1e-9);
+}
+
+TEST(HybridExecutor, Process) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  auto opts = std::make_shared<InitOptions>();
+  opts->quiet = 1;
+  platform->init_data = opts.get();
+  ASSERT_TRUE(platform->Init().ok());
+
+  auto sum = [](const arrow::RecordBatch &batch, int64_t first, int64_t last, uint64_t *result) {
+    auto values = std::static_pointer_cast<arrow::UInt64Array>(batch.column(0));
+    uint64_t s = 0;
+    for (int64_t i = first; i < last; i++) {
+      s += values->Value(i);
+    }
+    *result = s;
+    return fletcher::Status::OK();
+  };
+  auto add = [](uint64_t a, uint64_t b) { return a + b; };
+
+  std::shared_ptr<fletcher::HybridExecutor> executor;
+  ASSERT_TRUE(fletcher::HybridExecutor::Make(&executor, platform, sum, add).ok());
+
+  uint64_t result = 0;
+  // The first batches explore both paths.
+  ASSERT_TRUE(executor->Process(GetIntRecordBatch(100), {}, &result).ok());
+  ASSERT_EQ(executor->last_decision().fpga_rows, 100);
+  ASSERT_TRUE(executor->Process(GetIntRecordBatch(200), {}, &result).ok());
+  ASSERT_EQ(executor->last_decision().fpga_rows, 200);
+  ASSERT_EQ(executor->fpga_model().num_samples(), 2u);
+  ASSERT_TRUE(executor->Process(GetIntRecordBatch(100), {}, &result).ok());
+  ASSERT_EQ(executor->last_decision().cpu_rows, 100);
+  ASSERT_EQ(result, 4950u);
+  ASSERT_TRUE(executor->Process(GetIntRecordBatch(200), {}, &result).ok());
+  ASSERT_EQ(executor->cpu_model().num_samples(), 2u);
+
+  // Afterwards, every batch is routed according to the models.
+  for (int i = 0; i < 8; i++) {
+    ASSERT_TRUE(executor->Process(GetIntRecordBatch(4096), {}, &result).ok());
+    auto decision = executor->last_decision();
+    ASSERT_EQ(decision.fpga_rows + decision.cpu_rows, 4096);
+  }
+  ASSERT_GT(executor->cpu_model().seconds_per_byte() + executor->cpu_model().fixed_overhead(), 0.0);
+
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(HybridExecutor, Explore) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  auto opts = std::make_shared<InitOptions>();
+  opts->quiet = 1;
+  platform->init_data = opts.get();
+  ASSERT_TRUE(platform->Init().ok());
+
+  auto count = [](const arrow::RecordBatch & /* batch */, int64_t first, int64_t last, uint64_t *result) {
+    *result = static_cast<uint64_t>(last - first);
+    return fletcher::Status::OK();
+  };
+  fletcher::HybridExecutor::Options options;
+  options.explore_interval = 4;
+
+  // Without a combine function, every batch runs on a single path.
+  std::shared_ptr<fletcher::HybridExecutor> executor;
+  ASSERT_TRUE(fletcher::HybridExecutor::Make(&executor, platform, count, nullptr, options).ok());
+  uint64_t result = 0;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(executor->Process(GetIntRecordBatch(64), {}, &result).ok());
+  }
+
+  // Every fourth batch is routed to the path that the models did not choose.
+  int explored = 0;
+  for (int i = 0; i < 8; i++) {
+    ASSERT_TRUE(executor->Process(GetIntRecordBatch(64), {}, &result).ok());
+    auto decision = executor->last_decision();
+    ASSERT_TRUE((decision.fpga_rows == 0) || (decision.cpu_rows == 0));
+    ASSERT_EQ(decision.explored, i % 4 == 3);
+    explored += decision.explored ? 1 : 0;
+  }
+  ASSERT_EQ(explored, 2);
+  ASSERT_EQ(executor->cpu_model().num_samples() + executor->fpga_model().num_samples(), 12u);
+
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(BusBenchmarker, Discover) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  auto opts = std::make_shared<InitOptions>();
+  opts->quiet = 1;
+  platform->init_data = opts.get();
+  ASSERT_TRUE(platform->Init().ok());
+
+  // A register map as generated by fletchgen, with a complete and an incomplete benchmarker.
+  std::string header = "constexpr uint32_t CONTROL = FLETCHER_REG_CONTROL;\n"
+                       "constexpr uint32_t NUM_REGS = 27;\n";
+  std::vector<std::string> fields = {"CONTROL", "STATUS", "BURST_LENGTH", "MAX_BURSTS", "BASE_ADDR_LO", "BASE_ADDR_HI",
+                                     "ADDR_MASK_LO", "ADDR_MASK_HI", "CYCLES_PER_WORD", "CYCLES", "CHECKSUM", "STRIDE"};
+  for (size_t i = 0; i < fields.size(); i++) {
+    header += "constexpr uint32_t USER_BENCH_" + fields[i] + " = " + std::to_string(4 + i) + ";\n";
+  }
+  header += "constexpr uint32_t USER_OTHER_CONTROL = 16;\n";
+
+  std::map<std::string, uint64_t> regmap;
+  ASSERT_TRUE(fletcher::BusBenchmarker::ParseRegisterMap(header, &regmap).ok());
+  ASSERT_EQ(regmap.count("CONTROL"), 0u);
+  ASSERT_EQ(regmap.at("NUM_REGS"), 27u);
+
+  std::vector<std::shared_ptr<fletcher::BusBenchmarker>> benchmarkers;
+  fletcher::BusBenchmarker::Options bench_opts;
+  bench_opts.clock_hz = 100e6;
+  bench_opts.poll_interval_usec = 0;
+  ASSERT_TRUE(fletcher::BusBenchmarker::Discover(&benchmarkers, platform, regmap, bench_opts).ok());
+  ASSERT_EQ(benchmarkers.size(), 1u);
+  auto bench = benchmarkers[0];
+  ASSERT_EQ(bench->name(), "USER_BENCH");
+  ASSERT_EQ(bench->regs().cycles, 13u);
+  ASSERT_EQ(bench->regs().stride, 15);
+  ASSERT_EQ(bench->regs().max_outstanding, -1);
+
+  // The echo platform returns what was written. Pretend the benchmarker is done after 1000 cycles.
+  ASSERT_TRUE(platform->WriteMMIO(5, 1u << 2).ok());
+  ASSERT_TRUE(platform->WriteMMIO(13, 1000).ok());
+
+  fletcher::BusBenchmarkConfig config;
+  config.pattern = fletcher::BusPattern::STRIDED;
+  config.burst_length = 4;
+  config.num_bursts = 10;
+  config.stride = 8192;
+  fletcher::BusBenchmarkResult result;
+  ASSERT_TRUE(bench->Run(config, &result).ok());
+  uint32_t value = 0;
+  ASSERT_TRUE(platform->ReadMMIO(15, &value).ok());
+  ASSERT_EQ(value, 8192u);
+  ASSERT_EQ(result.bytes, 4u * 64 * 10);
+  ASSERT_DOUBLE_EQ(result.seconds, 1000 / 100e6);
+  ASSERT_DOUBLE_EQ(result.cycles_per_burst(), 100.0);
+
+  // The sequential benchmarker cannot run random patterns or limit the number of outstanding bursts.
+  config.pattern = fletcher::BusPattern::RANDOM;
+  ASSERT_FALSE(bench->Run(config, &result).ok());
+  config.pattern = fletcher::BusPattern::SEQUENTIAL;
+  config.max_outstanding = 2;
+  ASSERT_FALSE(bench->Run(config, &result).ok());
+
+  fletcher::BusBenchmarkSweep sweep;
+  sweep.burst_lengths = {1, 64};
+  sweep.patterns = {fletcher::BusPattern::SEQUENTIAL, fletcher::BusPattern::RANDOM};
+  sweep.bytes = 1024 * 1024;
+  std::vector<fletcher::BusBenchmarkResult> results;
+  ASSERT_TRUE(bench->Sweep(sweep, &results).ok());
+  // A latency and a bandwidth run per burst length, random runs are skipped.
+  ASSERT_EQ(results.size(), 4u);
+  ASSERT_EQ(results[0].config.num_bursts, 1u);
+  ASSERT_EQ(results[1].config.num_bursts, 1024u * 1024 / 64);
+  ASSERT_EQ(results[3].config.num_bursts, 1024u * 1024 / 64 / 64);
+
+  std::stringstream csv;
+  fletcher::BusBenchmarker::WriteCSVHeader(csv);
+  bench->WriteCSV(csv, results[0]);
+  ASSERT_EQ(csv.str().substr(csv.str().find('\n') + 1, 21), "USER_BENCH,sequential");
+
+  // Random addresses stay within the region and are aligned to the burst size.
+  ASSERT_EQ(fletcher::BusBenchmarker::AddressMask(1024 * 1024, 64 * 64), 0xFF000u);
+  ASSERT_EQ(fletcher::BusBenchmarker::AddressMask(1000, 64), 0x3C0u);
+
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
+TEST(TranslatorCounters, Read) {
+  std::shared_ptr<fletcher::Platform> platform;
+  ASSERT_TRUE(fletcher::Platform::Make("echo", &platform).ok());
+  auto opts = std::make_shared<InitOptions>();
+  opts->quiet = 1;
+  platform->init_data = opts.get();
+  ASSERT_TRUE(platform->Init().ok());
+
+  // Pretend a translator with counters at register 40 had 3 hits, 1 miss and 1 prefetch.
+  ASSERT_TRUE(platform->WriteMMIO(40, 3).ok());
+  ASSERT_TRUE(platform->WriteMMIO(41, 1).ok());
+  ASSERT_TRUE(platform->WriteMMIO(42, 1).ok());
+  ASSERT_TRUE(platform->WriteMMIO(43, 100).ok());
+  fletcher::TranslatorCounters start;
+  ASSERT_TRUE(fletcher::TranslatorCounters::Read(platform.get(), 40, &start).ok());
+  ASSERT_EQ(start.hits, 3u);
+  ASSERT_EQ(start.walk_cycles, 100u);
+  ASSERT_DOUBLE_EQ(start.hit_rate(), 0.75);
+
+  // Differences are taken modulo the counter width.
+  ASSERT_TRUE(platform->WriteMMIO(40, 9).ok());
+  ASSERT_TRUE(platform->WriteMMIO(43, 10).ok());
+  fletcher::TranslatorCounters end;
+  ASSERT_TRUE(fletcher::TranslatorCounters::Read(platform.get(), 40, &end).ok());
+  auto delta = end.Since(start);
+  ASSERT_EQ(delta.hits, 6u);
+  ASSERT_EQ(delta.misses, 0u);
+  ASSERT_EQ(delta.walk_cycles, 10u - 100u);
+  ASSERT_DOUBLE_EQ(delta.hit_rate(), 1.0);
+
+  ASSERT_TRUE(platform->Terminate().ok());
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();